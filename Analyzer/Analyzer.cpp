@@ -161,7 +161,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
                            aggtype,
                            arg == nullptr ? nullptr : arg->deep_copy(),
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -201,7 +201,7 @@ std::shared_ptr<Analyzer::Expr> OffsetInFragment::deep_copy() const {
 
 std::shared_ptr<Analyzer::Expr> WindowFunction::deep_copy() const {
   return makeExpr<WindowFunction>(
-      type_info, kind_, args_, partition_keys_, order_keys_, collation_);
+      type_info, kind_, args_, partition_keys_, order_keys_, collation_, frame_);
 }
 
 ExpressionPtr ArrayExpr::deep_copy() const {
@@ -1881,7 +1881,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
                            aggtype,
                            arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr,
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -2267,6 +2267,10 @@ bool AggExpr::operator==(const Expr& rhs) const {
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct()) {
     return false;
   }
+  if (aggtype == kAPPROX_PERCENTILE &&
+      (!arg1 || !rhs_ae.get_arg1() || !(*arg1 == *rhs_ae.get_arg1()))) {
+    return false;
+  }
   if (arg.get() == rhs_ae.get_arg()) {
     return true;
   }
@@ -2349,7 +2353,8 @@ bool WindowFunction::operator==(const Expr& rhs) const {
   }
   return expr_list_match(args_, rhs_window->args_) &&
          expr_list_match(partition_keys_, rhs_window->partition_keys_) &&
-         expr_list_match(order_keys_, rhs_window->order_keys_);
+         expr_list_match(order_keys_, rhs_window->order_keys_) &&
+         frame_ == rhs_window->frame_;
 }
 
 bool ArrayExpr::operator==(Expr const& rhs) const {
@@ -2662,6 +2667,9 @@ std::string AggExpr::toString() const {
     case kSAMPLE:
       agg = "SAMPLE";
       break;
+    case kAPPROX_PERCENTILE:
+      agg = "APPROX_PERCENTILE";
+      break;
   }
   std::string str{"(" + agg};
   if (is_distinct) {
@@ -2672,6 +2680,9 @@ std::string AggExpr::toString() const {
   } else {
     str += "*";
   }
+  if (arg1) {
+    str += arg1->toString();
+  }
   return str + ") ";
 }
 
@@ -2719,6 +2730,9 @@ std::string WindowFunction::toString() const {
   for (const auto& arg : args_) {
     result += " " + arg->toString();
   }
+  if (frame_) {
+    result += " " + frame_->toString();
+  }
   return result + ") ";
 }
 
@@ -2812,6 +2826,27 @@ std::string OrderEntry::toString() const {
   return str;
 }
 
+std::string WindowFrameBound::toString() const {
+  switch (type) {
+    case Type::UnboundedPreceding:
+      return "UNBOUNDED PRECEDING";
+    case Type::Preceding:
+      return std::to_string(offset) + " PRECEDING";
+    case Type::CurrentRow:
+      return "CURRENT ROW";
+    case Type::Following:
+      return std::to_string(offset) + " FOLLOWING";
+    case Type::UnboundedFollowing:
+      return "UNBOUNDED FOLLOWING";
+  }
+  return "";
+}
+
+std::string WindowFrame::toString() const {
+  return std::string(is_rows ? "ROWS" : "RANGE") + " BETWEEN " + lower.toString() +
+         " AND " + upper.toString();
+}
+
 void Expr::add_unique(std::list<const Expr*>& expr_list) const {
   // only add unique instances to the list
   for (auto e : expr_list) {
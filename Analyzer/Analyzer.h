@@ -27,6 +27,7 @@
 #include <cstdint>
 #include <iostream>
 #include <list>
+#include <optional>
 #include <set>
 #include <string>
 #include <type_traits>
@@ -1080,7 +1081,7 @@ class AggExpr : public Expr {
           std::shared_ptr<Analyzer::Expr> g,
           bool d,
           std::shared_ptr<Analyzer::Constant> e)
-      : Expr(ti, true), aggtype(a), arg(g), is_distinct(d), error_rate(e) {}
+      : Expr(ti, true), aggtype(a), arg(g), is_distinct(d), arg1(e) {}
   AggExpr(SQLTypes t,
           SQLAgg a,
           Expr* g,
@@ -1091,12 +1092,12 @@ class AggExpr : public Expr {
       , aggtype(a)
       , arg(g)
       , is_distinct(d)
-      , error_rate(e) {}
+      , arg1(e) {}
   SQLAgg get_aggtype() const { return aggtype; }
   Expr* get_arg() const { return arg.get(); }
   std::shared_ptr<Analyzer::Expr> get_own_arg() const { return arg; }
   bool get_is_distinct() const { return is_distinct; }
-  std::shared_ptr<Analyzer::Constant> get_error_rate() const { return error_rate; }
+  std::shared_ptr<Analyzer::Constant> get_arg1() const { return arg1; }
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
   void group_predicates(std::list<const Expr*>& scan_predicates,
                         std::list<const Expr*>& join_predicates,
@@ -1129,7 +1130,8 @@ class AggExpr : public Expr {
   SQLAgg aggtype;                       // aggregate type: kAVG, kMIN, kMAX, kSUM, kCOUNT
   std::shared_ptr<Analyzer::Expr> arg;  // argument to aggregate
   bool is_distinct;                     // true only if it is for COUNT(DISTINCT x)
-  std::shared_ptr<Analyzer::Constant> error_rate;  // error rate of kAPPROX_COUNT_DISTINCT
+  // APPROX_COUNT_DISTINCT error rate or APPROX_PERCENTILE quantile
+  std::shared_ptr<Analyzer::Constant> arg1;
 };
 
 /*
@@ -1420,9 +1422,56 @@ struct OrderEntry {
   bool nulls_first; /* true if nulls are ordered first.  otherwise last. */
 };
 
+/*
+ * @type WindowFrameBound
+ * @brief One end of an explicit window frame.
+ */
+struct WindowFrameBound {
+  enum class Type {
+    UnboundedPreceding,
+    Preceding,
+    CurrentRow,
+    Following,
+    UnboundedFollowing
+  };
+
+  bool operator==(const WindowFrameBound& rhs) const {
+    return type == rhs.type && offset == rhs.offset;
+  }
+  std::string toString() const;
+
+  Type type;
+  double offset; /* rows for ROWS frames, order key distance for RANGE frames */
+};
+
+/*
+ * @type WindowFrame
+ * @brief An explicit ROWS or RANGE frame of an aggregate window function.
+ */
+struct WindowFrame {
+  bool operator==(const WindowFrame& rhs) const {
+    return is_rows == rhs.is_rows && lower == rhs.lower && upper == rhs.upper;
+  }
+  std::string toString() const;
+
+  // Returns true iff any of the bounds is at an offset from the current row.
+  bool hasOffset() const {
+    const auto is_offset = [](const WindowFrameBound& bound) {
+      return bound.type == WindowFrameBound::Type::Preceding ||
+             bound.type == WindowFrameBound::Type::Following;
+    };
+    return is_offset(lower) || is_offset(upper);
+  }
+
+  bool is_rows;
+  WindowFrameBound lower;
+  WindowFrameBound upper;
+};
+
 /*
  * @type WindowFunction
- * @brief A window function.
+ * @brief A window function. The frame is only set for aggregates whose frame isn't the
+ * default one (the whole partition, or up to the last peer of the current row).
  */
 class WindowFunction : public Expr {
  public:
@@ -1431,13 +1480,15 @@ class WindowFunction : public Expr {
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& args,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& partition_keys,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& order_keys,
-                 const std::vector<OrderEntry>& collation)
+                 const std::vector<OrderEntry>& collation,
+                 const std::optional<WindowFrame>& frame = std::nullopt)
       : Expr(ti)
       , kind_(kind)
       , args_(args)
       , partition_keys_(partition_keys)
       , order_keys_(order_keys)
-      , collation_(collation){};
+      , collation_(collation)
+      , frame_(frame){};
 
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
 
@@ -1458,12 +1509,15 @@ class WindowFunction : public Expr {
 
   const std::vector<OrderEntry>& getCollation() const { return collation_; }
 
+  const std::optional<WindowFrame>& getFrame() const { return frame_; }
+
  private:
   const SqlWindowFunctionKind kind_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> args_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> partition_keys_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> order_keys_;
   const std::vector<OrderEntry> collation_;
+  const std::optional<WindowFrame> frame_;
 };
 
 /*
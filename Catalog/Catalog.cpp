@@ -262,6 +262,11 @@ void Catalog::updateTableDescriptorSchema() {
       string queryString("ALTER TABLE mapd_tables ADD storage_type TEXT DEFAULT ''");
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("page_compression")) ==
+        cols.end()) {
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD page_compression TEXT DEFAULT ''");
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -951,7 +956,7 @@ void Catalog::buildMaps() {
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, "
       "max_chunk_size, frag_page_size, "
       "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, "
-      "sort_column_id, storage_type "
+      "sort_column_id, storage_type, page_compression "
       "from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
@@ -994,6 +999,8 @@ void Catalog::buildMaps() {
     td->userId = sqliteConnector_.getData<int>(r, 15);
     td->sortedColumnId =
         sqliteConnector_.isNull(r, 16) ? 0 : sqliteConnector_.getData<int>(r, 16);
+    td->pageCompression =
+        sqliteConnector_.isNull(r, 18) ? "" : sqliteConnector_.getData<string>(r, 18);
     if (!td->isView) {
       td->fragmenter = nullptr;
     }
@@ -1377,6 +1384,13 @@ void Catalog::instantiateFragmenter(TableDescriptor* td) const {
     getAllColumnMetadataForTableImpl(td, columnDescs, true, false, true);
     Chunk::translateColumnDescriptorsToChunkVec(columnDescs, chunkVec);
     ChunkKey chunkKeyPrefix = {currentDB_.dbId, td->tableId};
+    if (!td->pageCompression.empty() && td->storageType.empty() &&
+        td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
+      dataMgr_->getGlobalFileMgr()->setTablePageCompression(
+          currentDB_.dbId,
+          td->tableId,
+          File_Namespace::page_compression_from_string(td->pageCompression));
+    }
     if (td->sortedColumnId > 0) {
       td->fragmenter = std::make_shared<SortedOrderFragmenter>(chunkKeyPrefix,
                                                                chunkVec,
@@ -2193,7 +2207,7 @@ void Catalog::createTable(
   if (td.persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
     try {
       sqliteConnector_.query_with_text_params(
-          R"(INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, sort_column_id, storage_type, key_metainfo) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))",
+          R"(INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, sort_column_id, storage_type, key_metainfo, page_compression) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))",
           std::vector<std::string>{td.tableName,
                                    std::to_string(td.userId),
                                    std::to_string(td.nColumns),
@@ -2210,7 +2224,8 @@ void Catalog::createTable(
                                    std::to_string(td.nShards),
                                    std::to_string(td.sortedColumnId),
                                    td.storageType,
-                                   td.keyMetainfo});
+                                   td.keyMetainfo,
+                                   td.pageCompression});
 
       // now get the auto generated tableid
       sqliteConnector_.query_with_text_param(
@@ -4012,6 +4027,9 @@ std::string Catalog::dumpSchema(const TableDescriptor* td) const {
     CHECK(sort_cd);
     with_options.push_back("SORT_COLUMN='" + sort_cd->columnName + "'");
   }
+  if (!td->pageCompression.empty()) {
+    with_options.push_back("PAGE_COMPRESSION='" + td->pageCompression + "'");
+  }
   os << ") WITH (" + boost::algorithm::join(with_options, ", ") + ");";
   return os.str();
 }
@@ -4196,6 +4214,9 @@ std::string Catalog::dumpCreateTable(const TableDescriptor* td,
     CHECK(sort_cd);
     with_options.push_back("SORT_COLUMN='" + sort_cd->columnName + "'");
   }
+  if (!td->pageCompression.empty()) {
+    with_options.push_back("PAGE_COMPRESSION='" + td->pageCompression + "'");
+  }
   os << ")";
   if (!with_options.empty()) {
     if (!multiline_formatting) {
@@ -72,6 +72,7 @@ struct TableDescriptor {
   // RexInput node
   std::vector<int> columnIdBySpi_;  // spi = 1,2,3,...
   std::string storageType;          // foreign/local storage
+  std::string pageCompression;      // compression of the data pages, empty if none
 
   // write mutex, only to be used inside catalog package
   std::shared_ptr<std::mutex> mutex_;
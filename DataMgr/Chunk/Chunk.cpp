@@ -269,6 +269,12 @@ ChunkIter Chunk::begin_iterator(const std::shared_ptr<ChunkMetadata>& chunk_meta
         index_buf_->getMemoryPtr() + start_idx * sizeof(StringOffsetT);
     it.end_pos = index_buf_->getMemoryPtr() + index_buf_->size() - sizeof(StringOffsetT);
     it.second_buf = buffer_->getMemoryPtr();
+  } else if (column_desc_->columnType.get_compression() == kENCODING_RL ||
+             column_desc_->columnType.get_compression() == kENCODING_DIFF) {
+    // positions only track row indices, see ChunkIter.cpp
+    it.second_buf = buffer_->getMemoryPtr();
+    it.current_pos = it.start_pos = it.second_buf + start_idx * it.skip_size;
+    it.end_pos = it.second_buf + chunk_metadata->numElements * it.skip_size;
   } else {
     it.current_pos = it.start_pos = buffer_->getMemoryPtr() + start_idx * it.skip_size;
     it.end_pos = buffer_->getMemoryPtr() + buffer_->size();
@@ -17,15 +17,20 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include "../Shared/sqltypes.h"
 #include "Shared/types.h"
 
 #include "Logger/Logger.h"
 
+class ChunkValueFilter;
+
 struct ChunkStats {
   Datum min;
   Datum max;
   bool has_nulls;
+  // Optional membership filter over the chunk values, see ChunkValueFilter.h.
+  std::shared_ptr<const ChunkValueFilter> value_filter{nullptr};
 };
 
 struct ChunkMetadata {
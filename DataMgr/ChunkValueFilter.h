@@ -0,0 +1,301 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkValueFilter.h
+ * @brief   Per-chunk membership filter, lets the executor skip fragments on equality and
+ *          IN predicates whose values fall within the min/max range of every fragment.
+ *
+ * The filter holds the exact set of distinct values as long as the chunk has at most
+ * kMaxDistinctValues of them and turns into a bloom filter afterwards. The bloom filter
+ * is a list of layers, each sized for kBloomFilterBitsPerValue bits per distinct value it
+ * holds. Once a layer holds as many values as it is sized for, the values go to a new
+ * layer twice as large, so the false positive rate stays about the same however many
+ * distinct values the chunk has. The filter saturates and admits every value from then
+ * on once the layers would take more than kMaxBloomFilterBits bits. FileMgr stores the
+ * filter in pages of its own, referenced by the metadata page of the chunk.
+ *
+ * The filter also counts the rows added to it. The encoder only hands it out with the
+ * chunk metadata if it has seen at least as many rows as the chunk holds, so a chunk
+ * written without going through the filter never gets skipped based on it.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Logger/Logger.h"
+#include "Shared/sqltypes.h"
+
+class ChunkValueFilter {
+ public:
+  static constexpr size_t kMaxDistinctValues{256};
+  static constexpr size_t kBloomFilterBitsPerValue{10};
+  static constexpr size_t kBloomFilterHashCount{7};
+  static constexpr size_t kMinBloomFilterBits{8192};
+  static constexpr size_t kMaxBloomFilterBits{size_t(1) << 22};
+
+  ChunkValueFilter() : kind_(Kind::Distinct), row_count_(0) {}
+
+  // Columns whose values are stored as integers the executor can compare constants to:
+  // integers, booleans, times and dictionary encoded strings.
+  static bool isSupported(const SQLTypeInfo& ti) {
+    if (ti.is_string()) {
+      return ti.get_compression() == kENCODING_DICT;
+    }
+    if (ti.is_integer() || ti.is_boolean()) {
+      return ti.get_compression() == kENCODING_NONE ||
+             ti.get_compression() == kENCODING_FIXED;
+    }
+    if (ti.is_time()) {
+      return ti.get_compression() == kENCODING_NONE ||
+             (ti.get_compression() == kENCODING_FIXED && ti.get_type() != kDATE);
+    }
+    return false;
+  }
+
+  void add(const int64_t value) {
+    ++row_count_;
+    switch (kind_) {
+      case Kind::Distinct: {
+        const auto it = std::lower_bound(values_.begin(), values_.end(), value);
+        if (it != values_.end() && *it == value) {
+          return;
+        }
+        values_.insert(it, value);
+        if (values_.size() > kMaxDistinctValues) {
+          toBloomFilter();
+        }
+        return;
+      }
+      case Kind::Bloom: {
+        const auto hashes = getHashes(value);
+        if (!bloomFilterContains(hashes)) {
+          addToBloomFilter(hashes);
+        }
+        return;
+      }
+      case Kind::Saturated: {
+        return;
+      }
+    }
+  }
+
+  // Null values don't need to be looked up, IS NULL is answered by the chunk stats.
+  void addNull() { ++row_count_; }
+
+  // Returns false only if the value has never been added to the filter.
+  bool mayContain(const int64_t value) const {
+    switch (kind_) {
+      case Kind::Distinct: {
+        return std::binary_search(values_.begin(), values_.end(), value);
+      }
+      case Kind::Bloom: {
+        return bloomFilterContains(getHashes(value));
+      }
+      case Kind::Saturated: {
+        return true;
+      }
+    }
+    return true;
+  }
+
+  size_t getRowCount() const { return row_count_; }
+
+  bool isSaturated() const { return kind_ == Kind::Saturated; }
+
+  // Appends the serialized filter to data.
+  void write(std::vector<int8_t>& data) const {
+    const int32_t kind = static_cast<int32_t>(kind_);
+    append(data, kind);
+    append(data, row_count_);
+    if (kind_ == Kind::Distinct) {
+      append(data, static_cast<uint32_t>(values_.size()));
+      appendBytes(data, values_.data(), values_.size() * sizeof(int64_t));
+    } else if (kind_ == Kind::Bloom) {
+      append(data, static_cast<uint32_t>(layers_.size()));
+      for (const auto& layer : layers_) {
+        append(data, static_cast<uint64_t>(layer.bits.size()));
+        append(data, static_cast<uint64_t>(layer.value_count));
+        appendBytes(data, layer.bits.data(), layer.bits.size());
+      }
+    }
+  }
+
+  // Returns false if data isn't a serialized filter, the filter then admits every value
+  // and hasn't seen any row, so the encoder doesn't hand it out.
+  bool read(const std::vector<int8_t>& data) {
+    size_t offset = 0;
+    int32_t kind{0};
+    values_.clear();
+    layers_.clear();
+    bool valid = extract(data, offset, kind) && extract(data, offset, row_count_);
+    kind_ = static_cast<Kind>(kind);
+    if (valid && kind_ == Kind::Distinct) {
+      uint32_t value_count{0};
+      valid = extract(data, offset, value_count) && value_count <= kMaxDistinctValues;
+      if (valid) {
+        values_.resize(value_count);
+        valid = extractBytes(data, offset, values_.data(), value_count * sizeof(int64_t));
+      }
+    } else if (valid && kind_ == Kind::Bloom) {
+      uint32_t layer_count{0};
+      size_t total_bits = 0;
+      valid = extract(data, offset, layer_count);
+      for (uint32_t i = 0; valid && i < layer_count; ++i) {
+        uint64_t byte_count{0};
+        uint64_t value_count{0};
+        valid = extract(data, offset, byte_count) && extract(data, offset, value_count);
+        // The layer sizes are powers of two, the bits are found through a mask
+        valid = valid && byte_count > 0 && (byte_count & (byte_count - 1)) == 0 &&
+                byte_count <= kMaxBloomFilterBits / 8 - total_bits / 8;
+        total_bits += 8 * byte_count;
+        if (valid) {
+          layers_.push_back({std::vector<uint8_t>(byte_count), value_count});
+          valid = extractBytes(data, offset, layers_.back().bits.data(), byte_count);
+        }
+      }
+      valid = valid && !layers_.empty();
+    } else {
+      valid = valid && kind_ == Kind::Saturated;
+    }
+    if (!valid || offset != data.size()) {
+      saturate();
+      row_count_ = 0;
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  enum class Kind : int32_t { Distinct = 0, Bloom = 1, Saturated = 2 };
+
+  // A bloom filter sized for bits.size() * 8 / kBloomFilterBitsPerValue values.
+  struct BloomLayer {
+    std::vector<uint8_t> bits;
+    size_t value_count;
+  };
+
+  // Two independent hashes of the value, combined as h1 + i * h2 for the i-th probe.
+  static std::pair<uint64_t, uint64_t> getHashes(const int64_t value) {
+    const uint64_t h1 = mix(static_cast<uint64_t>(value));
+    const uint64_t h2 = mix(h1) | 1;
+    return {h1, h2};
+  }
+
+  // Finalizer of splitmix64.
+  static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  template <typename T>
+  static void append(std::vector<int8_t>& data, const T value) {
+    appendBytes(data, &value, sizeof(value));
+  }
+
+  static void appendBytes(std::vector<int8_t>& data,
+                          const void* bytes,
+                          const size_t num_bytes) {
+    const auto begin = reinterpret_cast<const int8_t*>(bytes);
+    data.insert(data.end(), begin, begin + num_bytes);
+  }
+
+  template <typename T>
+  static bool extract(const std::vector<int8_t>& data, size_t& offset, T& value) {
+    return extractBytes(data, offset, &value, sizeof(value));
+  }
+
+  static bool extractBytes(const std::vector<int8_t>& data,
+                           size_t& offset,
+                           void* bytes,
+                           const size_t num_bytes) {
+    if (num_bytes > data.size() - offset) {
+      return false;
+    }
+    std::memcpy(bytes, data.data() + offset, num_bytes);
+    offset += num_bytes;
+    return true;
+  }
+
+  bool bloomFilterContains(const std::pair<uint64_t, uint64_t>& hashes) const {
+    for (const auto& layer : layers_) {
+      const uint64_t mask = 8 * layer.bits.size() - 1;
+      bool contains = true;
+      for (size_t i = 0; contains && i < kBloomFilterHashCount; ++i) {
+        const uint64_t bit = (hashes.first + i * hashes.second) & mask;
+        contains = layer.bits[bit >> 3] & (1 << (bit & 7));
+      }
+      if (contains) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void toBloomFilter() {
+    CHECK(kind_ == Kind::Distinct);
+    kind_ = Kind::Bloom;
+    layers_.push_back({std::vector<uint8_t>(kMinBloomFilterBits / 8, 0), 0});
+    std::vector<int64_t> values;
+    values.swap(values_);
+    for (const auto value : values) {
+      addToBloomFilter(getHashes(value));
+    }
+  }
+
+  // Adds a value the filter doesn't contain yet to the last layer.
+  void addToBloomFilter(const std::pair<uint64_t, uint64_t>& hashes) {
+    auto& layer = layers_.back();
+    const uint64_t mask = 8 * layer.bits.size() - 1;
+    for (size_t i = 0; i < kBloomFilterHashCount; ++i) {
+      const uint64_t bit = (hashes.first + i * hashes.second) & mask;
+      layer.bits[bit >> 3] |= 1 << (bit & 7);
+    }
+    if (++layer.value_count * kBloomFilterBitsPerValue < 8 * layer.bits.size()) {
+      return;
+    }
+    size_t total_bits = 0;
+    for (const auto& full_layer : layers_) {
+      total_bits += 8 * full_layer.bits.size();
+    }
+    const size_t layer_bytes = 2 * layer.bits.size();
+    if (total_bits + 8 * layer_bytes > kMaxBloomFilterBits) {
+      saturate();
+      return;
+    }
+    layers_.push_back({std::vector<uint8_t>(layer_bytes, 0), 0});
+  }
+
+  void saturate() {
+    kind_ = Kind::Saturated;
+    std::vector<int64_t>().swap(values_);
+    std::vector<BloomLayer>().swap(layers_);
+  }
+
+  Kind kind_;
+  size_t row_count_;
+  // Sorted distinct values, only used while kind_ is Distinct.
+  std::vector<int64_t> values_;
+  // Bloom filter layers, from the smallest to the largest, only used while kind_ is
+  // Bloom. New values go to the last one.
+  std::vector<BloomLayer> layers_;
+};
@@ -0,0 +1,313 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIFF_ENCODER_H
+#define DIFF_ENCODER_H
+#include "Logger/Logger.h"
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "AbstractBuffer.h"
+#include "Encoder.h"
+
+#include <Shared/DatumFetchers.h>
+#include <Shared/EncodedChunkLayout.h>
+
+/**
+ * Frame-of-reference encoder backing DIFF encoding. Every value is stored as a V-sized
+ * delta from a per-chunk base kept in a FrameOfReferenceChunkHeader at the start of the
+ * buffer, see EncodedChunkLayout.h. The base is picked on the first append so that the
+ * smallest value of that batch maps to the smallest non-null delta, which leaves the
+ * whole delta range for the ascending values of sorted columns such as timestamps. A
+ * later batch out of the range of the base moves the base and re-encodes the deltas
+ * already in the chunk, the append fails only if the values of the chunk span more than
+ * the delta range.
+ */
+template <typename T, typename V>
+class DiffEncoder : public Encoder {
+ public:
+  DiffEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : Encoder(buffer)
+      , dataMin(std::numeric_limits<T>::max())
+      , dataMax(std::numeric_limits<T>::min())
+      , has_nulls(false) {}
+
+  std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
+                                            const size_t num_elems_to_append,
+                                            const SQLTypeInfo& ti,
+                                            const bool replicating = false,
+                                            const int64_t offset = -1) override {
+    T* unencoded_data = reinterpret_cast<T*>(src_data);
+    int64_t batch_min{0};
+    int64_t batch_max{0};
+    const bool batch_has_values = getRange(
+        unencoded_data, replicating ? 1 : num_elems_to_append, batch_min, batch_max);
+    FrameOfReferenceChunkHeader header;
+    const bool new_chunk = buffer_->size() == 0;
+    if (new_chunk) {
+      header.base = chooseBase(batch_min);
+    } else {
+      buffer_->read(
+          reinterpret_cast<int8_t*>(&header), sizeof(FrameOfReferenceChunkHeader), 0);
+      if (batch_has_values && (!fitsBase(batch_min, header.base) ||
+                               !fitsBase(batch_max, header.base))) {
+        header.base = rebase(header.base, batch_min, batch_max);
+      }
+    }
+
+    // Encode everything first, so that an out of range value leaves the chunk as is.
+    auto encoded_data = std::make_unique<V[]>(num_elems_to_append);
+    for (size_t i = 0; i < num_elems_to_append; ++i) {
+      size_t ri = replicating ? 0 : i;
+      encoded_data.get()[i] = encodeValue(unencoded_data[ri], header.base);
+    }
+    for (size_t i = 0; i < num_elems_to_append; ++i) {
+      size_t ri = replicating ? 0 : i;
+      updateStats(static_cast<int64_t>(unencoded_data[ri]),
+                  unencoded_data[ri] == inline_int_null_value<T>());
+    }
+
+    if (new_chunk) {
+      buffer_->append(reinterpret_cast<int8_t*>(&header),
+                      sizeof(FrameOfReferenceChunkHeader));
+    }
+    if (offset == -1) {
+      num_elems_ += num_elems_to_append;
+      buffer_->append(reinterpret_cast<int8_t*>(encoded_data.get()),
+                      num_elems_to_append * sizeof(V));
+      if (!replicating) {
+        src_data += num_elems_to_append * sizeof(T);
+      }
+    } else {
+      num_elems_ = offset + num_elems_to_append;
+      CHECK(!replicating);
+      CHECK_GE(offset, 0);
+      buffer_->write(
+          reinterpret_cast<int8_t*>(encoded_data.get()),
+          num_elems_to_append * sizeof(V),
+          sizeof(FrameOfReferenceChunkHeader) + static_cast<size_t>(offset) * sizeof(V));
+    }
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    getMetadata(chunk_metadata);
+    return chunk_metadata;
+  }
+
+  void getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) override {
+    Encoder::getMetadata(chunkMetadata);  // call on parent class
+    chunkMetadata->fillChunkStats(dataMin, dataMax, has_nulls);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>(ti, 0, 0, ChunkStats{});
+    chunk_metadata->fillChunkStats(dataMin, dataMax, has_nulls);
+    return chunk_metadata;
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    for (size_t i = 0; i < num_elements; ++i) {
+      const auto data = unencoded_data[i];
+      if (data != inline_int_null_value<T>()) {
+        decimal_overflow_validator_.validate(data);
+      }
+      updateStats(static_cast<int64_t>(data), data == inline_int_null_value<T>());
+    }
+  }
+
+  void updateStats(const std::vector<std::string>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  void updateStats(const std::vector<ArrayDatum>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void reduceStats(const Encoder& that) override {
+    const auto that_typed = static_cast<const DiffEncoder<T, V>&>(that);
+    if (that_typed.has_nulls) {
+      has_nulls = true;
+    }
+    dataMin = std::min(dataMin, that_typed.dataMin);
+    dataMax = std::max(dataMax, that_typed.dataMax);
+  }
+
+  void copyMetadata(const Encoder* copyFromEncoder) override {
+    num_elems_ = copyFromEncoder->getNumElems();
+    auto castedEncoder = reinterpret_cast<const DiffEncoder<T, V>*>(copyFromEncoder);
+    dataMin = castedEncoder->dataMin;
+    dataMax = castedEncoder->dataMax;
+    has_nulls = castedEncoder->has_nulls;
+  }
+
+  void writeMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fwrite((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&dataMin, sizeof(T), 1, f);
+    fwrite((int8_t*)&dataMax, sizeof(T), 1, f);
+    fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
+  }
+
+  void readMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fread((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fread((int8_t*)&dataMin, 1, sizeof(T), f);
+    fread((int8_t*)&dataMax, 1, sizeof(T), f);
+    fread((int8_t*)&has_nulls, 1, sizeof(bool), f);
+  }
+
+  bool resetChunkStats(const ChunkStats& stats) override {
+    const auto new_min = DatumFetcher::getDatumVal<T>(stats.min);
+    const auto new_max = DatumFetcher::getDatumVal<T>(stats.max);
+
+    if (dataMin == new_min && dataMax == new_max && has_nulls == stats.has_nulls) {
+      return false;
+    }
+
+    dataMin = new_min;
+    dataMax = new_max;
+    has_nulls = stats.has_nulls;
+    return true;
+  }
+
+  T dataMin;
+  T dataMax;
+  bool has_nulls;
+
+ private:
+  // Range of the non-null values, false if they are all null
+  static bool getRange(const T* unencoded_data,
+                       const size_t num_elems,
+                       int64_t& min,
+                       int64_t& max) {
+    bool found{false};
+    for (size_t i = 0; i < num_elems; ++i) {
+      if (unencoded_data[i] == inline_int_null_value<T>()) {
+        continue;
+      }
+      const auto val = static_cast<int64_t>(unencoded_data[i]);
+      min = found ? std::min(min, val) : val;
+      max = found ? std::max(max, val) : val;
+      found = true;
+    }
+    return found;
+  }
+
+  static int64_t chooseBase(const int64_t min) {
+    int64_t base;
+    if (__builtin_add_overflow(
+            min, static_cast<int64_t>(std::numeric_limits<V>::max()), &base)) {
+      return min;
+    }
+    return base;
+  }
+
+  static bool fitsBase(const int64_t val, const int64_t base) {
+    int64_t delta;
+    return !__builtin_sub_overflow(val, base, &delta) &&
+           delta > static_cast<int64_t>(std::numeric_limits<V>::min()) &&
+           delta <= static_cast<int64_t>(std::numeric_limits<V>::max());
+  }
+
+  // Moves the base so that it covers both the values already in the chunk and
+  // [min, max], and rewrites the deltas of the chunk against it. Throws before writing
+  // anything if no base covers all the values.
+  int64_t rebase(const int64_t old_base, int64_t min, int64_t max) {
+    const size_t num_deltas =
+        (buffer_->size() - sizeof(FrameOfReferenceChunkHeader)) / sizeof(V);
+    std::vector<V> deltas(num_deltas);
+    if (num_deltas) {
+      buffer_->read(reinterpret_cast<int8_t*>(deltas.data()),
+                    num_deltas * sizeof(V),
+                    sizeof(FrameOfReferenceChunkHeader));
+    }
+    for (const auto delta : deltas) {
+      if (delta != std::numeric_limits<V>::min()) {
+        min = std::min(min, old_base + delta);
+        max = std::max(max, old_base + delta);
+      }
+    }
+    const auto base = chooseBase(min);
+    if (!fitsBase(min, base) || !fitsBase(max, base)) {
+      throw std::runtime_error("DIFF encoding overflow: values from " +
+                               std::to_string(min) + " to " + std::to_string(max) +
+                               " do not fit in " + std::to_string(sizeof(V) * 8) +
+                               "-bit deltas");
+    }
+    for (auto& delta : deltas) {
+      if (delta != std::numeric_limits<V>::min()) {
+        delta = static_cast<V>(old_base + delta - base);
+      }
+    }
+    FrameOfReferenceChunkHeader header;
+    header.base = base;
+    buffer_->write(
+        reinterpret_cast<int8_t*>(&header), sizeof(FrameOfReferenceChunkHeader), 0);
+    if (num_deltas) {
+      buffer_->write(reinterpret_cast<int8_t*>(deltas.data()),
+                     num_deltas * sizeof(V),
+                     sizeof(FrameOfReferenceChunkHeader));
+    }
+    return base;
+  }
+
+  V encodeValue(const T& unencoded_data, const int64_t base) {
+    if (unencoded_data == inline_int_null_value<T>()) {
+      return std::numeric_limits<V>::min();
+    }
+    decimal_overflow_validator_.validate(unencoded_data);
+    int64_t delta;
+    if (__builtin_sub_overflow(static_cast<int64_t>(unencoded_data), base, &delta) ||
+        delta <= static_cast<int64_t>(std::numeric_limits<V>::min()) ||
+        delta > static_cast<int64_t>(std::numeric_limits<V>::max())) {
+      throw std::runtime_error("DIFF encoding overflow: value " +
+                               std::to_string(unencoded_data) +
+                               " is out of range for chunk base " + std::to_string(base) +
+                               " with " + std::to_string(sizeof(V) * 8) + "-bit deltas");
+    }
+    return static_cast<V>(delta);
+  }
+};  // DiffEncoder
+
+#endif  // DIFF_ENCODER_H
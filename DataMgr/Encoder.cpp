@@ -17,14 +17,20 @@
 #include "Encoder.h"
 #include "ArrayNoneEncoder.h"
 #include "DateDaysEncoder.h"
+#include "DiffEncoder.h"
 #include "FixedLengthArrayNoneEncoder.h"
 #include "FixedLengthEncoder.h"
 #include "Logger/Logger.h"
 #include "NoneEncoder.h"
+#include "RunLengthEncoder.h"
 #include "StringNoneEncoder.h"
 
-Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
-                         const SQLTypeInfo sqlType) {
+bool g_enable_chunk_value_filters{false};
+
+namespace {
+
+Encoder* create_encoder(Data_Namespace::AbstractBuffer* buffer,
+                        const SQLTypeInfo sqlType) {
   switch (sqlType.get_compression()) {
     case kENCODING_NONE: {
       switch (sqlType.get_type()) {
@@ -171,6 +177,72 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
       }  // switch (sqlType)
       break;
     }  // Case: kENCODING_FIXED
+    case kENCODING_RL: {
+      switch (sqlType.get_type()) {
+        case kBOOLEAN:
+        case kTINYINT:
+          return new RunLengthEncoder<int8_t>(buffer);
+        case kSMALLINT:
+          return new RunLengthEncoder<int16_t>(buffer);
+        case kINT:
+          return new RunLengthEncoder<int32_t>(buffer);
+        case kBIGINT:
+        case kNUMERIC:
+        case kDECIMAL:
+        case kTIME:
+        case kTIMESTAMP:
+        case kDATE:
+          return new RunLengthEncoder<int64_t>(buffer);
+        default:
+          return 0;
+      }
+      break;
+    }  // Case: kENCODING_RL
+    case kENCODING_DIFF: {
+      switch (sqlType.get_type()) {
+        case kSMALLINT: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int16_t, int8_t>(buffer);
+            default:
+              return 0;
+          }
+          break;
+        }
+        case kINT: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int32_t, int8_t>(buffer);
+            case 16:
+              return new DiffEncoder<int32_t, int16_t>(buffer);
+            default:
+              return 0;
+          }
+          break;
+        }
+        case kBIGINT:
+        case kNUMERIC:
+        case kDECIMAL:
+        case kTIME:
+        case kTIMESTAMP:
+        case kDATE: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int64_t, int8_t>(buffer);
+            case 16:
+              return new DiffEncoder<int64_t, int16_t>(buffer);
+            case 32:
+              return new DiffEncoder<int64_t, int32_t>(buffer);
+            default:
+              return 0;
+          }
+          break;
+        }
+        default:
+          return 0;
+      }
+      break;
+    }  // Case: kENCODING_DIFF
     case kENCODING_DICT: {
       if (sqlType.get_type() == kARRAY) {
         CHECK(IS_STRING(sqlType.get_subtype()));
@@ -218,6 +290,17 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
   return 0;
 }
 
+}  // namespace
+
+Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
+                         const SQLTypeInfo sqlType) {
+  auto encoder = create_encoder(buffer, sqlType);
+  if (encoder && g_enable_chunk_value_filters && ChunkValueFilter::isSupported(sqlType)) {
+    encoder->value_filter_ = std::make_shared<ChunkValueFilter>();
+  }
+  return encoder;
+}
+
 Encoder::Encoder(Data_Namespace::AbstractBuffer* buffer)
     : num_elems_(0)
     , buffer_(buffer)
@@ -228,4 +311,26 @@ void Encoder::getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) {
   chunkMetadata->sqlType = buffer_->getSqlType();
   chunkMetadata->numBytes = buffer_->size();
   chunkMetadata->numElements = num_elems_;
+  // A filter which hasn't seen every row of the chunk could rule out values it holds.
+  chunkMetadata->chunkStats.value_filter =
+      value_filter_ && value_filter_->getRowCount() >= num_elems_
+          ? std::make_shared<const ChunkValueFilter>(*value_filter_)
+          : nullptr;
+}
+
+void Encoder::writeValueFilter(std::vector<int8_t>& data) const {
+  CHECK(value_filter_);
+  value_filter_->write(data);
+}
+
+bool Encoder::readValueFilter(const std::vector<int8_t>& data) {
+  value_filter_ = std::make_shared<ChunkValueFilter>();
+  return value_filter_->read(data);
+}
+
+void Encoder::copyValueFilter(const Encoder* copy_from_encoder) {
+  value_filter_ = copy_from_encoder->value_filter_
+                      ? std::make_shared<ChunkValueFilter>(
+                            *copy_from_encoder->value_filter_)
+                      : nullptr;
 }
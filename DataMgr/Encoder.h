@@ -21,13 +21,17 @@
 #include "../Shared/sqltypes.h"
 #include "../Shared/types.h"
 #include "ChunkMetadata.h"
+#include "ChunkValueFilter.h"
 
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
+extern bool g_enable_chunk_value_filters;
+
 namespace Data_Namespace {
 class AbstractBuffer;
 }
@@ -214,13 +218,40 @@ class Encoder {
   size_t getNumElems() const { return num_elems_; }
   void setNumElems(const size_t num_elems) { num_elems_ = num_elems; }
 
+  bool hasValueFilter() const { return value_filter_ != nullptr; }
+  // The value filter is persisted by FileMgr in pages of its own, see FileBuffer.
+  void writeValueFilter(std::vector<int8_t>& data) const;
+  // Returns false if data isn't a serialized value filter, which isn't used then.
+  bool readValueFilter(const std::vector<int8_t>& data);
+  // Drops the value filter, for chunks whose metadata was written without one.
+  void clearValueFilter() { value_filter_.reset(); }
+  void copyValueFilter(const Encoder* copy_from_encoder);
+
  protected:
+  template <typename T>
+  void updateValueFilter(const T val, const bool is_null) {
+    if constexpr (std::is_integral<T>::value) {
+      if (value_filter_) {
+        if (is_null) {
+          value_filter_->addNull();
+        } else {
+          value_filter_->add(static_cast<int64_t>(val));
+        }
+      }
+    }
+  }
+
   size_t num_elems_;
 
   Data_Namespace::AbstractBuffer* buffer_;
 
   DecimalOverflowValidator decimal_overflow_validator_;
   DateDaysOverflowValidator date_days_overflow_validator_;
+
+  // Membership filter over the values of the chunk, only set for the column types
+  // ChunkValueFilter supports when g_enable_chunk_value_filters is on. Shared because
+  // encoders get copied to read their stats, only the owner of the buffer updates it.
+  std::shared_ptr<ChunkValueFilter> value_filter_;
 };
 
 #endif  // Encoder_h
@@ -22,13 +22,17 @@
 
 #include "DataMgr/FileMgr/FileBuffer.h"
 
+#include <algorithm>
+#include <cstring>
 #include <future>
 #include <map>
 #include <thread>
 
 #include "DataMgr/FileMgr/FileMgr.h"
+#include "Shared/Compressor.h"
 #include "Shared/File.h"
 #include "Shared/checked_alloc.h"
+#include "Shared/crc32c.h"
 
 #define METADATA_PAGE_SIZE 4096
 
@@ -44,12 +48,15 @@ FileBuffer::FileBuffer(FileMgr* fm,
     : AbstractBuffer(fm->getDeviceId())
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
+    , valueFilterBytes_(0)
     , pageSize_(pageSize)
+    , compression_(fm->getPageCompression())
+    , checksums_(fm->getPageChecksums())
     , chunkKey_(chunkKey) {
   // Create a new FileBuffer
   CHECK(fm_);
   calcHeaderBuffer();
-  pageDataSize_ = pageSize_ - reservedHeaderSize_;
+  calcPageLayout();
   //@todo reintroduce initialSize - need to develop easy way of
   // differentiating these pre-allocated pages from "written-to" pages
   /*
@@ -73,31 +80,52 @@ FileBuffer::FileBuffer(FileMgr* fm,
     : AbstractBuffer(fm->getDeviceId(), sqlType)
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
+    , valueFilterBytes_(0)
     , pageSize_(pageSize)
+    , compression_(fm->getPageCompression())
+    , checksums_(fm->getPageChecksums())
     , chunkKey_(chunkKey) {
   CHECK(fm_);
   calcHeaderBuffer();
-  pageDataSize_ = pageSize_ - reservedHeaderSize_;
+  calcPageLayout();
 }
 
 FileBuffer::FileBuffer(FileMgr* fm,
                        /* const size_t pageSize,*/ const ChunkKey& chunkKey,
                        const std::vector<HeaderInfo>::const_iterator& headerStartIt,
-                       const std::vector<HeaderInfo>::const_iterator& headerEndIt)
+                       const std::vector<HeaderInfo>::const_iterator& headerEndIt,
+                       FILE* metadataFile)
     : AbstractBuffer(fm->getDeviceId())
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
+    , valueFilterBytes_(0)
     , pageSize_(0)
+    , compression_(PageCompression::NONE)
+    , checksums_(false)
     , chunkKey_(chunkKey) {
   // We are being assigned an existing FileBuffer on disk
 
   CHECK(fm_);
   calcHeaderBuffer();
   // MultiPage multiPage(pageSize_); // why was this here?
+  // The metadata in metadataFile is the one of the last page, it's read only once
+  bool metadataFileRead = false;
+  auto readLastMetadata = [&]() {
+    if (!metadataFile) {
+      readMetadata(metadataPages_.pageVersions.back());
+    } else if (!metadataFileRead) {
+      readMetadataFrom(metadataFile);
+      metadataFileRead = true;
+    }
+  };
   int lastPageId = -1;
   // Page lastMetadataPage;
   for (auto vecIt = headerStartIt; vecIt != headerEndIt; ++vecIt) {
     int curPageId = vecIt->pageId;
+    if (curPageId == VALUE_FILTER_PAGE_ID) {
+      // Referenced by the metadata page, see readValueFilterPages
+      continue;
+    }
 
     // We only want to read last metadata page
     if (curPageId == -1) {  // stats page
@@ -114,8 +142,8 @@ FileBuffer::FileBuffer(FileMgr* fm,
         if (lastPageId == -1) {
           // If we are on first real page
           CHECK(metadataPages_.pageVersions.back().fileId != -1);  // was initialized
-          readMetadata(metadataPages_.pageVersions.back());
-          pageDataSize_ = pageSize_ - reservedHeaderSize_;
+          readLastMetadata();
+          calcPageLayout();
         }
         MultiPage multiPage(pageSize_);
         multiPages_.push_back(multiPage);
@@ -125,8 +153,8 @@ FileBuffer::FileBuffer(FileMgr* fm,
       multiPages_.back().pageVersions.push_back(vecIt->page);
     }
     if (curPageId == -1) {  // meaning there was only a metadata page
-      readMetadata(metadataPages_.pageVersions.back());
-      pageDataSize_ = pageSize_ - reservedHeaderSize_;
+      readLastMetadata();
+      calcPageLayout();
     }
   }
   // auto lastHeaderIt = std::prev(headerEndIt);
@@ -139,6 +167,7 @@ FileBuffer::~FileBuffer() {
 }
 
 void FileBuffer::reserve(const size_t numBytes) {
+  mapd_unique_lock<mapd_shared_mutex> pagesWriteLock(pagesMutex_);
   size_t numPagesRequested = (numBytes + pageSize_ - 1) / pageSize_;
   size_t numCurrentPages = multiPages_.size();
   int epoch = fm_->epoch();
@@ -161,6 +190,21 @@ void FileBuffer::calcHeaderBuffer() {
   // pageDataSize_ = pageSize_-reservedHeaderSize_;
 }
 
+void FileBuffer::calcPageLayout() {
+  pageDataOffset_ = reservedHeaderSize_ + (checksums_ ? PAGE_CHECKSUM_SIZE : 0);
+  pageDataSize_ = pageSize_ - pageDataOffset_;
+  if (compression_ != PageCompression::NONE) {
+    pageDataSize_ -= COMPRESSED_PAGE_PREFIX_SIZE;
+  }
+}
+
+void FileBuffer::resetPageFormat() {
+  CHECK(multiPages_.empty());
+  compression_ = PageCompression::NONE;
+  checksums_ = false;
+  calcPageLayout();
+}
+
 void FileBuffer::freeMetadataPages() {
   for (auto metaPageIt = metadataPages_.pageVersions.begin();
        metaPageIt != metadataPages_.pageVersions.end();
@@ -174,6 +218,7 @@ void FileBuffer::freeMetadataPages() {
 }
 
 size_t FileBuffer::freeChunkPages() {
+  mapd_unique_lock<mapd_shared_mutex> pagesWriteLock(pagesMutex_);
   size_t num_pages_freed = multiPages_.size();
   for (auto multiPageIt = multiPages_.begin(); multiPageIt != multiPages_.end();
        ++multiPageIt) {
@@ -190,61 +235,10 @@ size_t FileBuffer::freeChunkPages() {
 
 void FileBuffer::freePages() {
   freeMetadataPages();
+  freeValueFilterPages();
   freeChunkPages();
 }
 
-struct readThreadDS {
-  FileMgr* t_fm;       // ptr to FileMgr
-  size_t t_startPage;  // start page for the thread
-  size_t t_endPage;    // last page for the thread
-  int8_t* t_curPtr;    // pointer to the current location of the target for the thread
-  size_t t_bytesLeft;  // number of bytes to be read in the thread
-  size_t t_startPageOffset;  // offset - used for the first page of the buffer
-  bool t_isFirstPage;        // true - for first page of the buffer, false - otherwise
-  std::vector<MultiPage> multiPages;  // MultiPages of the FileBuffer passed to the thread
-};
-
-static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS) {
-  size_t startPage = threadDS.t_startPage;  // start reading at startPage, including it
-  size_t endPage = threadDS.t_endPage;      // stop reading at endPage, not including it
-  int8_t* curPtr = threadDS.t_curPtr;
-  size_t bytesLeft = threadDS.t_bytesLeft;
-  size_t totalBytesRead = 0;
-  bool isFirstPage = threadDS.t_isFirstPage;
-
-  // Traverse the logical pages
-  for (size_t pageNum = startPage; pageNum < endPage; ++pageNum) {
-    CHECK(threadDS.multiPages[pageNum].pageSize == fileBuffer->pageSize());
-    Page page = threadDS.multiPages[pageNum].current();
-
-    FileInfo* fileInfo = threadDS.t_fm->getFileInfoForFileId(page.fileId);
-    CHECK(fileInfo);
-
-    // Read the page into the destination (dst) buffer at its
-    // current (cur) location
-    size_t bytesRead = 0;
-    if (isFirstPage) {
-      bytesRead = fileInfo->read(
-          page.pageNum * fileBuffer->pageSize() + threadDS.t_startPageOffset +
-              fileBuffer->reservedHeaderSize(),
-          min(fileBuffer->pageDataSize() - threadDS.t_startPageOffset, bytesLeft),
-          curPtr);
-      isFirstPage = false;
-    } else {
-      bytesRead = fileInfo->read(
-          page.pageNum * fileBuffer->pageSize() + fileBuffer->reservedHeaderSize(),
-          min(fileBuffer->pageDataSize(), bytesLeft),
-          curPtr);
-    }
-    curPtr += bytesRead;
-    bytesLeft -= bytesRead;
-    totalBytesRead += bytesRead;
-  }
-  CHECK(bytesLeft == 0);
-
-  return (totalBytesRead);
-}
-
 void FileBuffer::read(int8_t* const dst,
                       const size_t numBytes,
                       const size_t offset,
@@ -253,6 +247,10 @@ void FileBuffer::read(int8_t* const dst,
   if (dstBufferType != CPU_LEVEL) {
     LOG(FATAL) << "Unsupported Buffer type";
   }
+  if (compression_ != PageCompression::NONE || checksums_) {
+    readWholePages(dst, numBytes, offset);
+    return;
+  }
 
   // variable declarations
   size_t startPage = offset / pageDataSize_;
@@ -271,78 +269,47 @@ void FileBuffer::read(int8_t* const dst,
 
   CHECK(startPage + numPagesToRead <= multiPages_.size());
 
-  size_t numPagesPerThread = 0;
-  size_t numBytesCurrent = numBytes;  // total number of bytes still to be read
-  size_t bytesRead = 0;               // total number of bytes already being read
-  size_t bytesLeftForThread = 0;      // number of bytes to be read in the thread
-  size_t numExtraPages = 0;  // extra pages to be assigned one per thread as needed
-  size_t numThreads = fm_->getNumReaderThreads();
-  std::vector<readThreadDS>
-      threadDSArr;  // array of threadDS, needed to avoid racing conditions
-
-  if (numPagesToRead > numThreads) {
-    numPagesPerThread = numPagesToRead / numThreads;
-    numExtraPages = numPagesToRead - (numThreads * numPagesPerThread);
-  } else {
-    numThreads = numPagesToRead;
-    numPagesPerThread = 1;
-  }
-
-  /* set threadDS for the first thread */
-  readThreadDS threadDS;
-  threadDS.t_fm = fm_;
-  threadDS.t_startPage = offset / pageDataSize_;
-  if (numExtraPages > 0) {
-    threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread + 1;
-    numExtraPages--;
-  } else {
-    threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread;
+  // Reads of the pages, in the order of their destination in dst
+  std::vector<PageRead> pageReads;
+  pageReads.reserve(numPagesToRead);
+  int8_t* curPtr = dst;
+  size_t bytesLeft = numBytes;
+  for (size_t pageNum = startPage; pageNum < startPage + numPagesToRead; ++pageNum) {
+    CHECK(multiPages_[pageNum].pageSize == pageSize_);
+    Page page = multiPages_[pageNum].current();
+    FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+    CHECK(fileInfo);
+    const size_t pageOffset = pageNum == startPage ? startPageOffset : 0;
+    const size_t readSize = min(pageDataSize_ - pageOffset, bytesLeft);
+    pageReads.push_back(
+        {fileInfo,
+         page.pageNum * pageSize_ + pageDataOffset_ + pageOffset,
+         readSize,
+         curPtr});
+    curPtr += readSize;
+    bytesLeft -= readSize;
   }
-  threadDS.t_curPtr = dst;
-  threadDS.t_startPageOffset = offset % pageDataSize_;
-  threadDS.t_isFirstPage = true;
-
-  bytesLeftForThread = min(((threadDS.t_endPage - threadDS.t_startPage) * pageDataSize_ -
-                            threadDS.t_startPageOffset),
-                           numBytesCurrent);
-  threadDS.t_bytesLeft = bytesLeftForThread;
-  threadDS.multiPages = getMultiPage();
+  CHECK_EQ(bytesLeft, size_t(0));
 
-  if (numThreads == 1) {
-    bytesRead += readForThread(this, threadDS);
+  // Contiguous batches of pages go to the reader pool, the first one is read here
+  size_t bytesRead = 0;
+  auto readerPool = fm_->getReaderPool();
+  const size_t numBatches =
+      readerPool ? std::min(fm_->getNumReaderThreads(), pageReads.size()) : 1;
+  if (numBatches <= 1) {
+    bytesRead = FileReaderPool::readPages(pageReads);
   } else {
-    std::vector<std::future<size_t>> threads;
-
-    for (size_t i = 0; i < numThreads; i++) {
-      threadDSArr.push_back(threadDS);
-      threads.push_back(
-          std::async(std::launch::async, readForThread, this, threadDSArr[i]));
-
-      // calculate elements of threadDS
-      threadDS.t_fm = fm_;
-      threadDS.t_isFirstPage = false;
-      threadDS.t_curPtr += bytesLeftForThread;
-      threadDS.t_startPage +=
-          threadDS.t_endPage -
-          threadDS.t_startPage;  // based on # of pages read on previous iteration
-      if (numExtraPages > 0) {
-        threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread + 1;
-        numExtraPages--;
-      } else {
-        threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread;
-      }
-      numBytesCurrent -= bytesLeftForThread;
-      bytesLeftForThread = min(
-          ((threadDS.t_endPage - threadDS.t_startPage) * pageDataSize_), numBytesCurrent);
-      threadDS.t_bytesLeft = bytesLeftForThread;
-      threadDS.multiPages = getMultiPage();
+    std::vector<std::vector<PageRead>> batches(numBatches);
+    for (size_t i = 0; i < pageReads.size(); ++i) {
+      batches[i * numBatches / pageReads.size()].push_back(pageReads[i]);
     }
-
-    for (auto& p : threads) {
-      p.wait();
+    std::vector<std::future<size_t>> batchFutures;
+    for (size_t i = 1; i < numBatches; ++i) {
+      batchFutures.push_back(readerPool->submit(std::move(batches[i])));
     }
-    for (auto& p : threads) {
-      bytesRead += p.get();
+    bytesRead += FileReaderPool::readPages(batches.front());
+    for (auto& batchFuture : batchFutures) {
+      bytesRead += batchFuture.get();
     }
   }
   CHECK(bytesRead == numBytes);
@@ -360,10 +327,10 @@ void FileBuffer::copyPage(Page& srcPage,
 
   int8_t* buffer = reinterpret_cast<int8_t*>(checked_malloc(numBytes));
   size_t bytesRead = srcFileInfo->read(
-      srcPage.pageNum * pageSize_ + offset + reservedHeaderSize_, numBytes, buffer);
+      srcPage.pageNum * pageSize_ + offset + pageDataOffset_, numBytes, buffer);
   CHECK(bytesRead == numBytes);
   size_t bytesWritten = destFileInfo->write(
-      destPage.pageNum * pageSize_ + offset + reservedHeaderSize_, numBytes, buffer);
+      destPage.pageNum * pageSize_ + offset + pageDataOffset_, numBytes, buffer);
   CHECK(bytesWritten == numBytes);
   free(buffer);
 }
@@ -399,13 +366,28 @@ void FileBuffer::writeHeader(Page& page,
 void FileBuffer::readMetadata(const Page& page) {
   FILE* f = fm_->getFileForFileId(page.fileId);
   fseek(f, page.pageNum * METADATA_PAGE_SIZE + reservedHeaderSize_, SEEK_SET);
+  readMetadataFrom(f);
+}
+
+void FileBuffer::readMetadataFrom(FILE* f) {
   fread((int8_t*)&pageSize_, sizeof(size_t), 1, f);
   fread((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(NUM_METADATA);  // assumes we will encode hasEncoder, bufferType,
                                        // encodingType, encodingBits all as int
   fread((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   int version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  CHECK(version >= 0 && version <= METADATA_VERSION);
+  bool has_value_filter = version == 1;
+  compression_ = PageCompression::NONE;
+  checksums_ = false;
+  if (version >= 2) {
+    // compression, hasValueFilter and, from version 3, checksums
+    int pageFormat[3] = {0, 0, 0};
+    fread((int8_t*)pageFormat, sizeof(int), version == 2 ? 2 : 3, f);
+    compression_ = static_cast<PageCompression>(pageFormat[0]);
+    has_value_filter = static_cast<bool>(pageFormat[1]);
+    checksums_ = static_cast<bool>(pageFormat[2]);
+  }
   bool has_encoder = static_cast<bool>(typeData[1]);
   if (has_encoder) {
     sql_type_.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -418,21 +400,46 @@ void FileBuffer::readMetadata(const Page& page) {
     sql_type_.set_size(typeData[9]);
     initEncoder(sql_type_);
     encoder_->readMetadata(f);
+    // Read by readValueFilterPages
+    encoder_->clearValueFilter();
+  }
+  valueFilterPages_.clear();
+  valueFilterBytes_ = 0;
+  if (has_value_filter) {
+    uint32_t numPages{0};
+    fread((int8_t*)&valueFilterBytes_, sizeof(size_t), 1, f);
+    fread((int8_t*)&numPages, sizeof(uint32_t), 1, f);
+    for (uint32_t i = 0; i < numPages; ++i) {
+      int pageData[2] = {-1, -1};  // fileId, pageNum
+      fread((int8_t*)pageData, sizeof(int), 2, f);
+      valueFilterPages_.emplace_back(pageData[0], pageData[1]);
+    }
   }
 }
 
 void FileBuffer::writeMetadata(const int epoch) {
+  writeValueFilterPages(epoch);
   // Right now stats page is size_ (in bytes), bufferType, encodingType,
   // encodingDataType, numElements
   Page page = fm_->requestFreePage(METADATA_PAGE_SIZE, true);
   writeHeader(page, -1, epoch, true);
   FILE* f = fm_->getFileForFileId(page.fileId);
   fseek(f, page.pageNum * METADATA_PAGE_SIZE + reservedHeaderSize_, SEEK_SET);
+  writeMetadataTo(f);
+  CHECK_LE(static_cast<size_t>(ftell(f)),
+           page.pageNum * METADATA_PAGE_SIZE + METADATA_PAGE_SIZE);
+  metadataPages_.epochs.push_back(epoch);
+  metadataPages_.pageVersions.push_back(page);
+}
+
+void FileBuffer::writeMetadataTo(FILE* f) {
   fwrite((int8_t*)&pageSize_, sizeof(size_t), 1, f);
   fwrite((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(NUM_METADATA);  // assumes we will encode hasEncoder, bufferType,
                                        // encodingType, encodingBits all as int
-  typeData[0] = METADATA_VERSION;
+  const bool has_value_filter = !valueFilterPages_.empty();
+  const bool hasPageFormat = compression_ != PageCompression::NONE || checksums_;
+  typeData[0] = hasPageFormat ? METADATA_VERSION : (has_value_filter ? 1 : 0);
   typeData[1] = static_cast<int>(hasEncoder());
   if (hasEncoder()) {
     typeData[2] = static_cast<int>(sql_type_.get_type());
@@ -445,18 +452,102 @@ void FileBuffer::writeMetadata(const int epoch) {
     typeData[9] = sql_type_.get_size();
   }
   fwrite((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
+  if (hasPageFormat) {
+    const int pageFormatData[3] = {static_cast<int>(compression_),
+                                   static_cast<int>(has_value_filter),
+                                   static_cast<int>(checksums_)};
+    fwrite((int8_t*)pageFormatData, sizeof(int), 3, f);
+  }
   if (hasEncoder()) {  // redundant
     encoder_->writeMetadata(f);
   }
-  metadataPages_.epochs.push_back(epoch);
-  metadataPages_.pageVersions.push_back(page);
+  if (has_value_filter) {
+    const uint32_t numPages = valueFilterPages_.size();
+    fwrite((int8_t*)&valueFilterBytes_, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&numPages, sizeof(uint32_t), 1, f);
+    for (const auto& page : valueFilterPages_) {
+      const int pageData[2] = {page.fileId, static_cast<int>(page.pageNum)};
+      fwrite((int8_t*)pageData, sizeof(int), 2, f);
+    }
+  }
+}
+
+void FileBuffer::writeValueFilterPages(const int epoch) {
+  freeValueFilterPages();
+  if (!hasEncoder() || !encoder_->hasValueFilter()) {
+    return;
+  }
+  std::vector<int8_t> data;
+  encoder_->writeValueFilter(data);
+  const size_t pageBytes = METADATA_PAGE_SIZE - reservedHeaderSize_;
+  for (size_t offset = 0; offset < data.size(); offset += pageBytes) {
+    Page page = fm_->requestFreePage(METADATA_PAGE_SIZE, true);
+    writeHeader(page, VALUE_FILTER_PAGE_ID, epoch, true);
+    const size_t numBytes = std::min(pageBytes, data.size() - offset);
+    FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+    CHECK_EQ(fileInfo->write(page.pageNum * METADATA_PAGE_SIZE + reservedHeaderSize_,
+                             numBytes,
+                             data.data() + offset),
+             numBytes);
+    valueFilterPages_.push_back(page);
+  }
+  valueFilterBytes_ = data.size();
+}
+
+void FileBuffer::readValueFilterPages() {
+  if (valueFilterPages_.empty()) {
+    return;
+  }
+  CHECK(hasEncoder());
+  const size_t pageBytes = METADATA_PAGE_SIZE - reservedHeaderSize_;
+  std::vector<int8_t> data(valueFilterBytes_);
+  std::vector<int> header(chunkKey_.size() + 3);
+  bool valid = valueFilterPages_.size() == (data.size() + pageBytes - 1) / pageBytes;
+  for (size_t i = 0; valid && i < valueFilterPages_.size(); ++i) {
+    const auto& page = valueFilterPages_[i];
+    FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+    // The pages may have been reused since the epoch the table was rolled back to
+    CHECK_EQ(fileInfo->read(page.pageNum * METADATA_PAGE_SIZE,
+                            header.size() * sizeof(int),
+                            reinterpret_cast<int8_t*>(header.data())),
+             header.size() * sizeof(int));
+    valid = header[header.size() - 2] == VALUE_FILTER_PAGE_ID &&
+            std::equal(chunkKey_.begin() + 2, chunkKey_.end(), header.begin() + 3);
+    const size_t offset = i * pageBytes;
+    const size_t numBytes = std::min(pageBytes, data.size() - offset);
+    valid = valid &&
+            fileInfo->read(page.pageNum * METADATA_PAGE_SIZE + reservedHeaderSize_,
+                           numBytes,
+                           data.data() + offset) == numBytes;
+  }
+  if (!valid || !encoder_->readValueFilter(data)) {
+    LOG(WARNING) << "Dropping the unreadable value filter of chunk "
+                 << showChunk(chunkKey_);
+    encoder_->clearValueFilter();
+  }
+}
+
+void FileBuffer::freeValueFilterPages() {
+  for (const auto& page : valueFilterPages_) {
+    FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+    fileInfo->freePage(page.pageNum);
+  }
+  valueFilterPages_.clear();
+  valueFilterBytes_ = 0;
 }
 
 void FileBuffer::append(int8_t* src,
                         const size_t numBytes,
                         const MemoryLevel srcBufferType,
                         const int deviceId) {
+  mapd_unique_lock<mapd_shared_mutex> pagesWriteLock(pagesMutex_);
   setAppended();
+  if (compression_ != PageCompression::NONE) {
+    const size_t oldSize = size_;
+    size_ = size_ + numBytes;
+    writeCompressed(src, numBytes, oldSize, oldSize);
+    return;
+  }
 
   size_t startPage = size_ / pageDataSize_;
   size_t startPageOffset = size_ % pageDataSize_;
@@ -482,14 +573,18 @@ void FileBuffer::append(int8_t* src,
     size_t bytesWritten;
     if (pageNum == startPage) {
       bytesWritten = fileInfo->write(
-          page.pageNum * pageSize_ + startPageOffset + reservedHeaderSize_,
+          page.pageNum * pageSize_ + startPageOffset + pageDataOffset_,
           min(pageDataSize_ - startPageOffset, bytesLeft),
           curPtr);
     } else {
-      bytesWritten = fileInfo->write(page.pageNum * pageSize_ + reservedHeaderSize_,
+      bytesWritten = fileInfo->write(page.pageNum * pageSize_ + pageDataOffset_,
                                      min(pageDataSize_, bytesLeft),
                                      curPtr);
     }
+    if (checksums_) {
+      extendPageChecksum(
+          page, pageNum == startPage ? startPageOffset : 0, curPtr, bytesWritten);
+    }
     curPtr += bytesWritten;
     bytesLeft -= bytesWritten;
   }
@@ -505,7 +600,9 @@ void FileBuffer::write(int8_t* src,
     LOG(FATAL) << "Unsupported Buffer type";
   }
 
+  mapd_unique_lock<mapd_shared_mutex> pagesWriteLock(pagesMutex_);
   bool tempIsAppended = false;
+  const size_t oldSize = size_;
   setDirty();
   if (offset < size_) {
     setUpdated();
@@ -516,6 +613,10 @@ void FileBuffer::write(int8_t* src,
     setAppended();
     size_ = offset + numBytes;
   }
+  if (compression_ != PageCompression::NONE) {
+    writeCompressed(src, numBytes, offset, oldSize);
+    return;
+  }
 
   size_t startPage = offset / pageDataSize_;
   size_t startPageOffset = offset % pageDataSize_;
@@ -570,11 +671,11 @@ void FileBuffer::write(int8_t* src,
     size_t bytesWritten;
     if (pageNum == startPage) {
       bytesWritten = fileInfo->write(
-          page.pageNum * pageSize_ + startPageOffset + reservedHeaderSize_,
+          page.pageNum * pageSize_ + startPageOffset + pageDataOffset_,
           min(pageDataSize_ - startPageOffset, bytesLeft),
           curPtr);
     } else {
-      bytesWritten = fileInfo->write(page.pageNum * pageSize_ + reservedHeaderSize_,
+      bytesWritten = fileInfo->write(page.pageNum * pageSize_ + pageDataOffset_,
                                      min(pageDataSize_, bytesLeft),
                                      curPtr);
     }
@@ -587,6 +688,383 @@ void FileBuffer::write(int8_t* src,
     }
   }
   CHECK(bytesLeft == 0);
+  if (checksums_) {
+    // The written pages, and the pages of a gap before them, are checksummed again whole
+    for (size_t pageNum = std::min(initialNumPages, startPage);
+         pageNum < startPage + numPagesToWrite;
+         ++pageNum) {
+      updatePageChecksum(multiPages_[pageNum].current(),
+                         std::min(pageDataSize_, size_ - pageNum * pageDataSize_));
+    }
+  }
+}
+
+void FileBuffer::readWholePages(int8_t* const dst,
+                                const size_t numBytes,
+                                const size_t offset) {
+  // Copy of the part of a page which goes to dst
+  struct PageCopy {
+    Page page;
+    size_t validBytes;
+    size_t pageOffset;
+    size_t size;
+    int8_t* dst;
+  };
+  const size_t startPage = offset / pageDataSize_;
+  const size_t startPageOffset = offset % pageDataSize_;
+  const size_t numPagesToRead =
+      (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
+  CHECK(startPage + numPagesToRead <= multiPages_.size());
+
+  std::vector<PageCopy> pageCopies;
+  pageCopies.reserve(numPagesToRead);
+  int8_t* curPtr = dst;
+  size_t bytesLeft = numBytes;
+  for (size_t pageNum = startPage; pageNum < startPage + numPagesToRead; ++pageNum) {
+    CHECK(multiPages_[pageNum].pageSize == pageSize_);
+    const size_t pageOffset = pageNum == startPage ? startPageOffset : 0;
+    const size_t copySize = min(pageDataSize_ - pageOffset, bytesLeft);
+    const size_t pageStart = pageNum * pageDataSize_;
+    const size_t validBytes = std::max(
+        pageStart < size_ ? min(pageDataSize_, size_ - pageStart) : 0,
+        pageOffset + copySize);
+    pageCopies.push_back(
+        {multiPages_[pageNum].current(), validBytes, pageOffset, copySize, curPtr});
+    curPtr += copySize;
+    bytesLeft -= copySize;
+  }
+  CHECK_EQ(bytesLeft, size_t(0));
+
+  // Whole pages are decompressed or read and checked in place, the others go through
+  // pageData or stored
+  const bool compressed = compression_ != PageCompression::NONE;
+  auto copyPages = [this, compressed](const std::vector<PageCopy>& copies) {
+    std::vector<int8_t> pageData(compressed ? pageDataSize_ : 0);
+    std::vector<int8_t> stored;
+    size_t bytesCopied = 0;
+    for (const auto& copy : copies) {
+      if (compressed) {
+        const bool wholePage = copy.pageOffset == 0 && copy.size == pageDataSize_;
+        int8_t* pageDst = wholePage ? copy.dst : pageData.data();
+        const size_t pageBytes = readCompressedPage(copy.page, pageDst, stored);
+        CHECK_LE(copy.pageOffset + copy.size, pageBytes);
+        if (!wholePage) {
+          std::memcpy(copy.dst, pageData.data() + copy.pageOffset, copy.size);
+        }
+      } else {
+        const bool wholePage = copy.pageOffset == 0 && copy.size == pageDataSize_;
+        const auto storedPage = readStoredPage(
+            copy.page, copy.validBytes, stored, wholePage ? copy.dst : nullptr);
+        failOnCorruptPage(copy.page, storedPage.check);
+        CHECK_LE(copy.pageOffset + copy.size, storedPage.numBytes);
+        if (!wholePage) {
+          std::memcpy(copy.dst, storedPage.data + copy.pageOffset, copy.size);
+        }
+      }
+      bytesCopied += copy.size;
+    }
+    return bytesCopied;
+  };
+
+  // Same batching as the reads of the other pages, the decompression and the checksums
+  // run on the reader threads too
+  size_t bytesRead = 0;
+  auto readerPool = fm_->getReaderPool();
+  const size_t numBatches =
+      readerPool ? std::min(fm_->getNumReaderThreads(), pageCopies.size()) : 1;
+  if (numBatches <= 1) {
+    bytesRead = copyPages(pageCopies);
+  } else {
+    std::vector<std::vector<PageCopy>> batches(numBatches);
+    for (size_t i = 0; i < pageCopies.size(); ++i) {
+      batches[i * numBatches / pageCopies.size()].push_back(pageCopies[i]);
+    }
+    std::vector<std::future<size_t>> batchFutures;
+    for (size_t i = 1; i < numBatches; ++i) {
+      batchFutures.push_back(readerPool->submit(
+          [&copyPages, &batch = batches[i]] { return copyPages(batch); }));
+    }
+    bytesRead += copyPages(batches.front());
+    for (auto& batchFuture : batchFutures) {
+      bytesRead += batchFuture.get();
+    }
+  }
+  CHECK(bytesRead == numBytes);
+}
+
+void FileBuffer::writeCompressed(const int8_t* src,
+                                 const size_t numBytes,
+                                 const size_t offset,
+                                 const size_t oldSize) {
+  CHECK_LE(offset + numBytes, size_);
+  const size_t startPage = offset / pageDataSize_;
+  const size_t endPage = (offset + numBytes + pageDataSize_ - 1) / pageDataSize_;
+  const int epoch = fm_->epoch();
+  std::vector<int8_t> pageData(pageDataSize_);
+  std::vector<int8_t> compressed;
+
+  // The pages of a gap before offset hold zeros
+  for (size_t pageNum = multiPages_.size(); pageNum < startPage; ++pageNum) {
+    Page page = addNewMultiPage(epoch);
+    writeHeader(page, pageNum, epoch);
+    writeCompressedPage(page, pageData.data(), pageDataSize_);
+  }
+  for (size_t pageNum = startPage; pageNum < endPage; ++pageNum) {
+    const size_t pageStart = pageNum * pageDataSize_;
+    const size_t writeBegin = std::max(offset, pageStart) - pageStart;
+    const size_t writeEnd =
+        std::min(offset + numBytes, pageStart + pageDataSize_) - pageStart;
+    std::fill(pageData.begin(), pageData.end(), 0);
+    Page page;
+    if (pageNum >= multiPages_.size()) {
+      page = addNewMultiPage(epoch);
+      writeHeader(page, pageNum, epoch);
+    } else {
+      // Keep the bytes of the page around the written ones. Pages past the old size,
+      // e.g. reserved ones, don't have any.
+      const Page lastPage = multiPages_[pageNum].current();
+      if (pageStart < oldSize &&
+          (writeBegin > 0 || writeEnd < std::min(pageDataSize_, oldSize - pageStart))) {
+        readCompressedPage(lastPage, pageData.data(), compressed);
+      }
+      if (multiPages_[pageNum].epochs.back() < epoch) {
+        // The version of the page at an older epoch must be kept
+        page = fm_->requestFreePage(pageSize_, false);
+        multiPages_[pageNum].epochs.push_back(epoch);
+        multiPages_[pageNum].pageVersions.push_back(page);
+        writeHeader(page, pageNum, epoch);
+      } else {
+        page = lastPage;
+      }
+    }
+    std::memcpy(pageData.data() + writeBegin,
+                src + pageStart + writeBegin - offset,
+                writeEnd - writeBegin);
+    writeCompressedPage(
+        page, pageData.data(), std::min(pageDataSize_, size_ - pageStart));
+  }
+}
+
+size_t FileBuffer::readCompressedPage(const Page& page,
+                                      int8_t* dst,
+                                      std::vector<int8_t>& stored) const {
+  const auto storedPage = readStoredPage(page, 0, stored);
+  failOnCorruptPage(page, storedPage.check);
+  uint32_t word;
+  std::memcpy(&word, storedPage.data, sizeof(word));
+  const int8_t* storedData = storedPage.data + COMPRESSED_PAGE_PREFIX_SIZE;
+  const size_t storedBytes = storedPage.numBytes - COMPRESSED_PAGE_PREFIX_SIZE;
+  if (word & RAW_COMPRESSED_PAGE_FLAG) {
+    std::memcpy(dst, storedData, storedBytes);
+    return storedBytes;
+  }
+  try {
+    return BloscCompressor::decompressWithContext(
+        reinterpret_cast<const uint8_t*>(storedData),
+        reinterpret_cast<uint8_t*>(dst),
+        pageDataSize_);
+  } catch (const CompressionFailedError& e) {
+    LOG(FATAL) << "Could not decompress page " << page.pageNum << " in file "
+               << page.fileId << " of chunk " << showChunk(chunkKey_) << ": " << e.what();
+  }
+  return 0;
+}
+
+void FileBuffer::writeCompressedPage(const Page& page,
+                                     const int8_t* data,
+                                     const size_t numBytes) {
+  CHECK_LE(numBytes, pageDataSize_);
+  // The checksum, if any, the compressed page word and the stored bytes are written at
+  // once
+  const size_t checksumSize = pageDataOffset_ - reservedHeaderSize_;
+  std::vector<int8_t> stored(checksumSize + COMPRESSED_PAGE_PREFIX_SIZE + numBytes);
+  int8_t* storedData = stored.data() + checksumSize + COMPRESSED_PAGE_PREFIX_SIZE;
+  // Shuffling the bytes of the values helps the fixed width columns
+  const int typeSize = sql_type_.get_size();
+  int64_t compressedBytes = 0;
+  if (numBytes > 1) {
+    try {
+      compressedBytes = BloscCompressor::compressWithContext(
+          reinterpret_cast<const uint8_t*>(data),
+          numBytes,
+          reinterpret_cast<uint8_t*>(storedData),
+          numBytes - 1,
+          typeSize > 0 && typeSize <= 8 ? typeSize : 1,
+          blosc_compressor_name(compression_),
+          blosc_compression_level(compression_));
+    } catch (const CompressionFailedError& e) {
+      VLOG(1) << "Storing page " << page.pageNum << " of chunk " << showChunk(chunkKey_)
+              << " uncompressed: " << e.what();
+      compressedBytes = 0;
+    }
+  }
+  uint32_t storedBytes;
+  if (compressedBytes > 0) {
+    storedBytes = static_cast<uint32_t>(compressedBytes);
+  } else {
+    std::memcpy(storedData, data, numBytes);
+    storedBytes = static_cast<uint32_t>(numBytes);
+  }
+  const uint32_t prefix = compressedBytes > 0 ? storedBytes
+                                              : storedBytes | RAW_COMPRESSED_PAGE_FLAG;
+  std::memcpy(stored.data() + checksumSize, &prefix, sizeof(prefix));
+  const size_t pageBytes = COMPRESSED_PAGE_PREFIX_SIZE + storedBytes;
+  if (checksums_) {
+    const PageChecksum checksum{static_cast<uint32_t>(pageBytes),
+                                crc32c(0, stored.data() + checksumSize, pageBytes)};
+    std::memcpy(stored.data(), &checksum, sizeof(checksum));
+  }
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  const size_t storedSize = checksumSize + pageBytes;
+  CHECK_EQ(fileInfo->write(
+               page.pageNum * pageSize_ + reservedHeaderSize_, storedSize, stored.data()),
+           storedSize);
+}
+
+FileBuffer::StoredPage FileBuffer::readStoredPage(const Page& page,
+                                                  const size_t validBytes,
+                                                  std::vector<int8_t>& buffer,
+                                                  int8_t* dst) const {
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  CHECK(fileInfo);
+  const bool compressed = compression_ != PageCompression::NONE;
+  CHECK(!compressed || !dst);
+  // The checksum, if any, is right before the data, they're read at once unless the
+  // data goes to dst
+  const size_t checksumSize = pageDataOffset_ - reservedHeaderSize_;
+  const size_t readOffset = page.pageNum * pageSize_ + reservedHeaderSize_;
+  const size_t firstBytes = compressed ? COMPRESSED_PAGE_PREFIX_SIZE : validBytes;
+  PageChecksum checksum{0, 0};
+  size_t bytesRead;
+  if (dst) {
+    CHECK_LE(firstBytes, pageDataSize_);
+    if (checksums_) {
+      checksum = readPageChecksum(page);
+    }
+    CHECK_EQ(fileInfo->read(readOffset + checksumSize, firstBytes, dst), firstBytes);
+    bytesRead = checksumSize + firstBytes;
+  } else {
+    buffer.resize(checksumSize + firstBytes);
+    bytesRead = fileInfo->read(readOffset, buffer.size(), buffer.data());
+    CHECK_EQ(bytesRead, buffer.size());
+    if (checksums_) {
+      std::memcpy(&checksum, buffer.data(), sizeof(checksum));
+    }
+  }
+
+  // Bytes in the data area of the page
+  size_t numBytes = firstBytes;
+  size_t maxBytes = pageDataSize_;
+  if (compressed) {
+    uint32_t word;
+    std::memcpy(&word, buffer.data() + checksumSize, sizeof(word));
+    numBytes += word & ~RAW_COMPRESSED_PAGE_FLAG;
+    maxBytes += COMPRESSED_PAGE_PREFIX_SIZE;
+  } else if (checksums_) {
+    numBytes = std::max(numBytes, static_cast<size_t>(checksum.numBytes));
+  }
+  if (numBytes > maxBytes) {
+    return {nullptr, 0, bytesRead, PageCheck::CORRUPT};
+  }
+  if (numBytes > firstBytes && !dst) {
+    buffer.resize(checksumSize + numBytes);
+  }
+  int8_t* data = dst ? dst : buffer.data() + checksumSize;
+  if (numBytes > firstBytes) {
+    const size_t restBytes = numBytes - firstBytes;
+    CHECK_EQ(fileInfo->read(
+                 readOffset + checksumSize + firstBytes, restBytes, data + firstBytes),
+             restBytes);
+    bytesRead += restBytes;
+  }
+
+  StoredPage storedPage{data, numBytes, bytesRead, PageCheck::UNCHECKED};
+  if (checksums_) {
+    // The checksum of an uncompressed page covers at least its valid bytes
+    const bool covered = compressed ? checksum.numBytes == numBytes
+                                    : checksum.numBytes >= validBytes;
+    if (covered && crc32c(0, storedPage.data, checksum.numBytes) == checksum.crc) {
+      storedPage.check = PageCheck::VERIFIED;
+    } else if (compressed || checksum.numBytes <= validBytes) {
+      storedPage.check = PageCheck::CORRUPT;
+    }
+    // Otherwise the checksum covers appends rolled back after it was written
+  }
+  return storedPage;
+}
+
+void FileBuffer::failOnCorruptPage(const Page& page, const PageCheck check) const {
+  if (check == PageCheck::CORRUPT) {
+    LOG(FATAL) << "Checksum mismatch in page " << page.pageNum << " in file "
+               << page.fileId << " of chunk " << showChunk(chunkKey_);
+  }
+}
+
+bool FileBuffer::verifyPage(const size_t pageNum,
+                            std::vector<int8_t>& stored,
+                            PageVerification& verification) const {
+  // The pages, their checksums and the size are read at once
+  mapd_shared_lock<mapd_shared_mutex> pagesReadLock(pagesMutex_);
+  if (pageNum >= multiPages_.size()) {
+    return false;
+  }
+  const Page page = multiPages_[pageNum].current();
+  if (!checksums_) {
+    verification = {PageCheck::UNCHECKED, page, 0};
+    return true;
+  }
+  const size_t pageStart = pageNum * pageDataSize_;
+  const size_t validBytes = pageStart < size_ ? min(pageDataSize_, size_ - pageStart) : 0;
+  const auto storedPage = readStoredPage(page, validBytes, stored);
+  verification = {storedPage.check, page, storedPage.bytesRead};
+  return true;
+}
+
+PageChecksum FileBuffer::readPageChecksum(const Page& page) const {
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  PageChecksum checksum;
+  CHECK_EQ(fileInfo->read(page.pageNum * pageSize_ + reservedHeaderSize_,
+                          sizeof(checksum),
+                          reinterpret_cast<int8_t*>(&checksum)),
+           sizeof(checksum));
+  return checksum;
+}
+
+void FileBuffer::writePageChecksum(const Page& page, const PageChecksum& checksum) {
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  PageChecksum pageChecksum = checksum;
+  CHECK_EQ(fileInfo->write(page.pageNum * pageSize_ + reservedHeaderSize_,
+                           sizeof(pageChecksum),
+                           reinterpret_cast<int8_t*>(&pageChecksum)),
+           sizeof(pageChecksum));
+}
+
+void FileBuffer::updatePageChecksum(const Page& page, const size_t numBytes) {
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  std::vector<int8_t> pageData(numBytes);
+  CHECK_EQ(fileInfo->read(
+               page.pageNum * pageSize_ + pageDataOffset_, numBytes, pageData.data()),
+           numBytes);
+  writePageChecksum(
+      page, {static_cast<uint32_t>(numBytes), crc32c(0, pageData.data(), numBytes)});
+}
+
+void FileBuffer::extendPageChecksum(const Page& page,
+                                    const size_t dataBegin,
+                                    const int8_t* data,
+                                    const size_t numBytes) {
+  PageChecksum checksum{0, 0};
+  if (dataBegin > 0) {
+    checksum = readPageChecksum(page);
+    if (checksum.numBytes != dataBegin) {
+      // Appends after the last checkpoint were rolled back
+      updatePageChecksum(page, dataBegin);
+      checksum = readPageChecksum(page);
+    }
+  }
+  checksum.crc = crc32c(checksum.crc, data, numBytes);
+  checksum.numBytes = static_cast<uint32_t>(dataBegin + numBytes);
+  writePageChecksum(page, checksum);
 }
 
 }  // namespace File_Namespace
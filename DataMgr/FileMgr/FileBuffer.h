@@ -24,16 +24,27 @@
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/FileMgr/Page.h"
+#include "DataMgr/FileMgr/PageChecksum.h"
+#include "DataMgr/FileMgr/PageCompression.h"
 
 #include <iostream>
 #include <stdexcept>
 
 #include "Logger/Logger.h"
+#include "Shared/mapd_shared_mutex.h"
 
 using namespace Data_Namespace;
 
 #define NUM_METADATA 10
-#define METADATA_VERSION 0
+// Version 1 metadata pages store a reference to the pages of the encoder's value filter
+// after the encoder metadata. Chunks without a value filter keep writing version 0
+// pages. Version 2 pages, written for compressed chunks only, store the page compression
+// and whether a value filter reference follows the encoder metadata. Version 3 pages,
+// written for compressed chunks and chunks with page checksums, also store whether the
+// data pages have checksums.
+#define METADATA_VERSION 3
+// Page id in the headers of the pages of value filters, which are metadata sized
+#define VALUE_FILTER_PAGE_ID -2
 
 namespace File_Namespace {
 
@@ -70,10 +81,13 @@ class FileBuffer : public AbstractBuffer {
              const SQLTypeInfo sqlType,
              const size_t initialSize = 0);
 
+  // Reads the metadata of the buffer from metadataFile, at its current position, instead
+  // of the last metadata page if metadataFile is set.
   FileBuffer(FileMgr* fm,
              /* const size_t pageSize,*/ const ChunkKey& chunkKey,
              const std::vector<HeaderInfo>::const_iterator& headerStartIt,
-             const std::vector<HeaderInfo>::const_iterator& headerEndIt);
+             const std::vector<HeaderInfo>::const_iterator& headerEndIt,
+             FILE* metadataFile = nullptr);
 
   /// Destructor
   ~FileBuffer() override;
@@ -128,6 +142,24 @@ class FileBuffer : public AbstractBuffer {
   /// Returns the size in bytes of each page in the FileBuffer.
   inline size_t pageSize() const override { return pageSize_; }
 
+  /// Returns the compression of the data pages, set when the chunk is created.
+  inline PageCompression pageCompression() const { return compression_; }
+
+  /// Returns true if the data pages have checksums, set when the chunk is created.
+  inline bool hasPageChecksums() const { return checksums_; }
+
+  /**
+   * @brief Verifies the checksum of the current version of the data page at pageNum.
+   * Returns false if the buffer has no such page anymore.
+   *
+   * Unlike reads, which stop the server on a checksum mismatch, sets verification to the
+   * outcome. Pages without checksums are unchecked and aren't read. stored is a scratch
+   * buffer. The writes of the buffer wait for the verification to finish.
+   */
+  bool verifyPage(const size_t pageNum,
+                  std::vector<int8_t>& stored,
+                  PageVerification& verification) const;
+
   /// Returns the size in bytes of the data portion of each page in the FileBuffer.
   inline virtual size_t pageDataSize() const { return pageDataSize_; }
 
@@ -158,17 +190,87 @@ class FileBuffer : public AbstractBuffer {
                    const bool writeMetadata = false);
   void writeMetadata(const int epoch);
   void readMetadata(const Page& page);
+  // The value filter of the encoder goes to pages of its own, the metadata page only
+  // references them. Writing it frees the pages of the previous version, which are
+  // restored like the other freed pages if the checkpoint doesn't complete.
+  void writeValueFilterPages(const int epoch);
+  // Reads the value filter referenced by the metadata into the encoder, once the files
+  // of the FileMgr are open. Chunks whose filter can't be read get none.
+  void readValueFilterPages();
+  void freeValueFilterPages();
+  // Write and read the contents of a metadata page at the current position of f
+  void writeMetadataTo(FILE* f);
+  void readMetadataFrom(FILE* f);
   void calcHeaderBuffer();
+  // The checksum, if any, comes after the header and the data of compressed pages starts
+  // with the number of bytes stored in the page
+  void calcPageLayout();
+  // Stores the data pages as is, for copies of the pages of older data files
+  void resetPageFormat();
+
+  // Data area of a page as stored, read by readStoredPage
+  struct StoredPage {
+    const int8_t* data;
+    size_t numBytes;
+    size_t bytesRead;
+    PageCheck check;
+  };
+  // Reads the data area of page into buffer and verifies its checksum, if any. Reads the
+  // compressed page word and the bytes after it for compressed pages, at least the first
+  // validBytes bytes, the valid ones given the size of the chunk, for the others. The
+  // data of uncompressed pages goes to dst instead of buffer if given, dst holds
+  // pageDataSize_ bytes.
+  StoredPage readStoredPage(const Page& page,
+                            const size_t validBytes,
+                            std::vector<int8_t>& buffer,
+                            int8_t* dst = nullptr) const;
+  void failOnCorruptPage(const Page& page, const PageCheck check) const;
+
+  PageChecksum readPageChecksum(const Page& page) const;
+  void writePageChecksum(const Page& page, const PageChecksum& checksum);
+  // Computes the checksum of the first numBytes bytes of the data of page again
+  void updatePageChecksum(const Page& page, const size_t numBytes);
+  // Extends the checksum of the first dataBegin bytes of the data of page to the numBytes
+  // bytes of data written after them
+  void extendPageChecksum(const Page& page,
+                          const size_t dataBegin,
+                          const int8_t* data,
+                          const size_t numBytes);
+
+  // Reads of compressed chunks and of chunks with page checksums, through the stored
+  // pages.
+  void readWholePages(int8_t* const dst, const size_t numBytes, const size_t offset);
+  // Writes of compressed chunks, the pages are always written whole. Called once size_
+  // covers the written bytes.
+  void writeCompressed(const int8_t* src,
+                       const size_t numBytes,
+                       const size_t offset,
+                       const size_t oldSize);
+  // Decompresses the data of page into dst, which holds pageDataSize_ bytes, and returns
+  // the number of bytes written to dst. stored holds the stored bytes.
+  size_t readCompressedPage(const Page& page,
+                            int8_t* dst,
+                            std::vector<int8_t>& stored) const;
+  void writeCompressedPage(const Page& page, const int8_t* data, const size_t numBytes);
 
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available
                  // files
   static size_t headerBufferOffset_;
   MultiPage metadataPages_;
+  // Pages of the value filter, in order, and its size
+  std::vector<Page> valueFilterPages_;
+  size_t valueFilterBytes_;
   std::vector<MultiPage> multiPages_;
   size_t pageSize_;
   size_t pageDataSize_;
   size_t reservedHeaderSize_;  // lets make this a constant now for simplicity - 128 bytes
+  size_t pageDataOffset_;      // offset of the data in the data pages
+  PageCompression compression_;
+  bool checksums_;
   ChunkKey chunkKey_;
+  // Held by the writes which change the pages, their checksums or the size, and by the
+  // page verification, which reads them while the table may be written
+  mutable mapd_shared_mutex pagesMutex_;
 };
 
 }  // namespace File_Namespace
@@ -58,12 +58,17 @@ void FileInfo::initNewFile() {
 
 size_t FileInfo::write(const size_t offset, const size_t size, int8_t* buf) {
   std::lock_guard<std::mutex> lock(readWriteMutex_);
-  return File_Namespace::write(f, offset, size, buf);
+  const auto bytesWritten = File_Namespace::write(f, offset, size, buf);
+  // Reads go around the buffer of the stream, flush it for them to see the data
+  if (fflush(f) != 0) {
+    LOG(FATAL) << "Error trying to flush changes to file, the error was: "
+               << std::strerror(errno);
+  }
+  return bytesWritten;
 }
 
 size_t FileInfo::read(const size_t offset, const size_t size, int8_t* buf) {
-  std::lock_guard<std::mutex> lock(readWriteMutex_);
-  return File_Namespace::read(f, offset, size, buf);
+  return File_Namespace::positionalRead(f, offset, size, buf);
 }
 
 void FileInfo::openExistingFile(std::vector<HeaderInfo>& headerVec,
@@ -200,6 +205,7 @@ static void sighandler(int sig) {
 #endif
 
 void FileInfo::freePage(int pageId) {
+  fileMgr->invalidateIndex();
 #define RESILIENT_PAGE_HEADER
 #ifdef RESILIENT_PAGE_HEADER
   int epoch_freed_page[2] = {DELETE_CONTINGENT, fileMgr->epoch()};
@@ -79,6 +79,7 @@ struct FileInfo {
   void freePage(int pageId);
   int getFreePage();
   size_t write(const size_t offset, const size_t size, int8_t* buf);
+  /// Positional read, doesn't lock the file and can run concurrently with other reads
   size_t read(const size_t offset, const size_t size, int8_t* buf);
 
   void openExistingFile(std::vector<HeaderInfo>& headerVec, const int fileMgrEpoch);
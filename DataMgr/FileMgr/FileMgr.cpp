@@ -25,7 +25,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <algorithm>
+#include <cstring>
 #include <future>
+#include <map>
 #include <string>
 #include <thread>
 #include <utility>
@@ -42,11 +44,33 @@
 
 #define EPOCH_FILENAME "epoch"
 #define DB_META_FILENAME "dbmeta"
+#define INDEX_FILENAME "index"
 
 using namespace std;
 
+bool g_enable_file_mgr_index{true};
+bool g_enable_page_checksums{true};
+
 namespace File_Namespace {
 
+namespace {
+
+constexpr uint64_t INDEX_MAGIC{0x58444E4947464D4FULL};  // "OMFGINDX"
+// Version 2 indexes list the pages of the value filters, which version 1 inlined
+constexpr int INDEX_VERSION{2};
+constexpr size_t MAX_INDEX_CHUNK_KEY_SIZE{16};
+
+void syncDirectory(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0 || fsync(fd) != 0) {
+    LOG(FATAL) << "Could not sync directory '" << path
+               << "' to disk, the error was: " << std::strerror(errno);
+  }
+  ::close(fd);
+}
+
+}  // namespace
+
 bool headerCompare(const HeaderInfo& firstElem, const HeaderInfo& secondElem) {
   // HeaderInfo.first is a pair of Chunk key with a vector containing
   // pageId and version
@@ -162,6 +186,7 @@ void FileMgr::init(const size_t num_reader_threads) {
     int threadCount = std::thread::hardware_concurrency();
     std::vector<HeaderInfo> headerVec;
     std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
+    std::vector<DataFileInfo> dataFiles;
     for (boost::filesystem::directory_iterator fileIt(path); fileIt != endItr; ++fileIt) {
       if (boost::filesystem::is_regular_file(fileIt->status())) {
         // note that boost::filesystem leaves preceding dot on
@@ -193,16 +218,27 @@ void FileMgr::init(const size_t num_reader_threads) {
           VLOG(4) << "File id: " << fileId << " Page size: " << pageSize
                   << " Num pages: " << numPages;
 
-          file_futures.emplace_back(std::async(
-              std::launch::async, [filePath, fileId, pageSize, numPages, this] {
-                std::vector<HeaderInfo> tempHeaderVec;
-                openExistingFile(filePath, fileId, pageSize, numPages, tempHeaderVec);
-                return tempHeaderVec;
-              }));
-          fileCount++;
-          if (fileCount % threadCount == 0) {
-            processFileFutures(file_futures, headerVec);
-          }
+          dataFiles.push_back({fileId, pageSize, numPages, filePath});
+        }
+      }
+    }
+
+    // Only read the headers of all the pages if the index file can't be used
+    const bool openedFromIndex = openFilesFromIndex(dataFiles);
+    if (!openedFromIndex) {
+      for (const auto& dataFile : dataFiles) {
+        file_futures.emplace_back(std::async(std::launch::async, [dataFile, this] {
+          std::vector<HeaderInfo> tempHeaderVec;
+          openExistingFile(dataFile.path,
+                           dataFile.fileId,
+                           dataFile.pageSize,
+                           dataFile.numPages,
+                           tempHeaderVec);
+          return tempHeaderVec;
+        }));
+        fileCount++;
+        if (fileCount % threadCount == 0) {
+          processFileFutures(file_futures, headerVec);
         }
       }
     }
@@ -213,7 +249,9 @@ void FileMgr::init(const size_t num_reader_threads) {
     int64_t queue_time_ms = timer_stop(clock_begin);
 
     LOG(INFO) << "Completed Reading table's file metadata, Elapsed time : "
-              << queue_time_ms << "ms Epoch: " << epoch_ << " files read: " << fileCount
+              << queue_time_ms << "ms Epoch: " << epoch_
+              << " files read: " << dataFiles.size()
+              << (openedFromIndex ? " (from index file)" : "")
               << " table location: '" << fileMgrBasePath_ << "'";
 
     /* Sort headerVec so that all HeaderInfos
@@ -267,6 +305,10 @@ void FileMgr::init(const size_t num_reader_threads) {
           new FileBuffer(this, /*pageSize,*/ lastChunkKey, startIt, headerVec.end());
       //}
     }
+    // The value filters are in pages of their own, read once all the files are open
+    for (auto& chunk : chunkIndex_) {
+      chunk.second->readValueFilterPages();
+    }
     nextFileId_ = maxFileId + 1;
     // std::cout << "next file id: " << nextFileId_ << std::endl;
   } else {
@@ -289,6 +331,8 @@ void FileMgr::init(const size_t num_reader_threads) {
       num_reader_threads_ = num_reader_threads;
     }
   }
+  reader_pool_ = gfm_ ? gfm_->getReaderPool(num_reader_threads_)
+                      : std::make_shared<FileReaderPool>(num_reader_threads_);
 }
 
 void FileMgr::processFileFutures(
@@ -305,6 +349,150 @@ void FileMgr::processFileFutures(
   file_futures.clear();
 }
 
+bool FileMgr::openFilesFromIndex(const std::vector<DataFileInfo>& dataFiles) {
+  const std::string indexFilePath(fileMgrBasePath_ + "/" + INDEX_FILENAME);
+  if (!boost::filesystem::exists(indexFilePath)) {
+    return false;
+  }
+  FILE* f = g_enable_file_mgr_index ? fopen(indexFilePath.c_str(), "rb") : nullptr;
+  const auto readValue = [f](auto& value) {
+    return fread(&value, sizeof(value), 1, f) == 1;
+  };
+  std::map<int, const DataFileInfo*> dataFilesById;
+  for (const auto& dataFile : dataFiles) {
+    dataFilesById[dataFile.fileId] = &dataFile;
+  }
+  std::map<int, std::vector<bool>> usedPages;
+  ChunkKeyToChunkMap chunks;
+  // Returns the reason why the index file can't be used, if any
+  const auto readIndex = [&]() -> std::string {
+    if (!g_enable_file_mgr_index) {
+      return "index files are disabled";
+    }
+    if (!f) {
+      return std::string("could not open it, the error was: ") + std::strerror(errno);
+    }
+    uint64_t magic;
+    int version;
+    int epoch;
+    if (!readValue(magic) || magic != INDEX_MAGIC || !readValue(version) ||
+        version != INDEX_VERSION) {
+      return "unknown format";
+    }
+    if (!readValue(epoch) || epoch != epoch_) {
+      return "written at another epoch";
+    }
+    size_t numFiles;
+    if (!readValue(numFiles) || numFiles != dataFiles.size()) {
+      return "data files don't match";
+    }
+    for (size_t i = 0; i < numFiles; ++i) {
+      int fileId;
+      size_t pageSize;
+      size_t numPages;
+      if (!readValue(fileId) || !readValue(pageSize) || !readValue(numPages)) {
+        return "truncated";
+      }
+      const auto dataFileIt = dataFilesById.find(fileId);
+      if (dataFileIt == dataFilesById.end() ||
+          dataFileIt->second->pageSize != pageSize ||
+          dataFileIt->second->numPages != numPages) {
+        return "data files don't match";
+      }
+      usedPages[fileId].resize(numPages, false);
+    }
+    size_t numChunks;
+    if (!readValue(numChunks)) {
+      return "truncated";
+    }
+    std::vector<HeaderInfo> headerVec;
+    for (size_t i = 0; i < numChunks; ++i) {
+      size_t keySize;
+      if (!readValue(keySize) || keySize < 2 || keySize > MAX_INDEX_CHUNK_KEY_SIZE) {
+        return "truncated";
+      }
+      ChunkKey chunkKey(keySize);
+      size_t numHeaders;
+      if (fread(chunkKey.data(), sizeof(int), keySize, f) != keySize ||
+          !readValue(numHeaders) || numHeaders == 0) {
+        return "truncated";
+      }
+      // always derive dbid/tbid from FileMgr
+      chunkKey[0] = fileMgrKey_.first;
+      chunkKey[1] = fileMgrKey_.second;
+      headerVec.clear();
+      for (size_t j = 0; j < numHeaders; ++j) {
+        int header[4];  // pageId, versionEpoch, fileId, pageNum
+        if (fread(header, sizeof(int), 4, f) != 4) {
+          return "truncated";
+        }
+        const auto usedPagesIt = usedPages.find(header[2]);
+        if (usedPagesIt == usedPages.end() || header[3] < 0 ||
+            static_cast<size_t>(header[3]) >= usedPagesIt->second.size() ||
+            usedPagesIt->second[header[3]]) {
+          return "pages don't match the data files";
+        }
+        usedPagesIt->second[header[3]] = true;
+        headerVec.emplace_back(
+            chunkKey, header[0], header[1], Page(header[2], header[3]));
+      }
+      // The value filter pages, if any, come before the metadata pages
+      const auto metadataIt =
+          std::find_if(headerVec.begin(), headerVec.end(), [](const HeaderInfo& header) {
+            return header.pageId != VALUE_FILTER_PAGE_ID;
+          });
+      if (metadataIt == headerVec.end() || metadataIt->pageId != -1 ||
+          chunks.count(chunkKey)) {
+        return "pages don't match the data files";
+      }
+      chunks[chunkKey] =
+          new FileBuffer(this, chunkKey, headerVec.begin(), headerVec.end(), f);
+    }
+    uint64_t endMagic;
+    if (!readValue(endMagic) || endMagic != INDEX_MAGIC) {
+      return "truncated";
+    }
+    return "";
+  };
+  const auto error = readIndex();
+  if (f) {
+    fclose(f);
+  }
+  if (!error.empty()) {
+    for (auto& chunk : chunks) {
+      delete chunk.second;
+    }
+    // The header scan may change the pages, the index file must not outlive it
+    LOG(INFO) << "Not using index file '" << indexFilePath << "': " << error;
+    boost::filesystem::remove(indexFilePath);
+    syncDirectory(fileMgrBasePath_);
+    return false;
+  }
+
+  for (const auto& dataFile : dataFiles) {
+    FileInfo* fInfo = new FileInfo(this,
+                                   dataFile.fileId,
+                                   open(dataFile.path),
+                                   dataFile.pageSize,
+                                   dataFile.numPages,
+                                   false);  // false means don't init file
+    const auto& fileUsedPages = usedPages[dataFile.fileId];
+    for (size_t pageNum = 0; pageNum < dataFile.numPages; ++pageNum) {
+      if (!fileUsedPages[pageNum]) {
+        fInfo->freePages.insert(pageNum);
+      }
+    }
+    if (dataFile.fileId >= static_cast<int>(files_.size())) {
+      files_.resize(dataFile.fileId + 1);
+    }
+    files_[dataFile.fileId] = fInfo;
+    fileIndex_.insert(std::pair<size_t, int>(dataFile.pageSize, dataFile.fileId));
+  }
+  chunkIndex_.swap(chunks);
+  isIndexOnDisk_ = true;
+  return true;
+}
+
 void FileMgr::init(const std::string dataPathToConvertFrom) {
   int converted_data_epoch = 0;
   boost::filesystem::path path(dataPathToConvertFrom);
@@ -398,6 +586,8 @@ void FileMgr::init(const std::string dataPathToConvertFrom) {
           FileBuffer* srcBuf = new FileBuffer(this, lastChunkKey, startIt, headerIt);
           chunkIndex_[lastChunkKey] = srcBuf;
           FileBuffer* destBuf = new FileBuffer(c_fm_, srcBuf->pageSize(), lastChunkKey);
+          // The pages are copied as is, in the legacy format
+          destBuf->resetPageFormat();
           c_fm_->chunkIndex_[lastChunkKey] = destBuf;
           destBuf->syncEncoder(srcBuf);
           destBuf->setSize(srcBuf->size());
@@ -430,6 +620,7 @@ void FileMgr::init(const std::string dataPathToConvertFrom) {
       FileBuffer* srcBuf = new FileBuffer(this, lastChunkKey, startIt, headerVec.end());
       chunkIndex_[lastChunkKey] = srcBuf;
       FileBuffer* destBuf = new FileBuffer(c_fm_, srcBuf->pageSize(), lastChunkKey);
+      destBuf->resetPageFormat();
       c_fm_->chunkIndex_[lastChunkKey] = destBuf;
       destBuf->syncEncoder(srcBuf);
       destBuf->setSize(srcBuf->size());
@@ -614,6 +805,105 @@ void FileMgr::checkpoint() {
     free_page.first->freePageDeferred(free_page.second);
   }
   free_pages.clear();
+
+  writeIndex();
+}
+
+void FileMgr::writeIndex() {
+  if (!g_enable_file_mgr_index) {
+    return;
+  }
+  // files_rw_mutex_ is held by checkpoint()
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  std::lock_guard<std::mutex> indexLock(indexMutex_);
+  for (const auto& chunk : chunkIndex_) {
+    if (chunk.second->metadataPages_.pageVersions.empty() &&
+        !chunk.second->multiPages_.empty()) {
+      LOG(WARNING) << "Not writing index file for table location '" << fileMgrBasePath_
+                   << "', chunk " << showChunk(chunk.first) << " has no metadata page";
+      return;
+    }
+  }
+  const std::string indexFilePath(fileMgrBasePath_ + "/" + INDEX_FILENAME);
+  const std::string tempFilePath(indexFilePath + ".tmp");
+  FILE* f = fopen(tempFilePath.c_str(), "wb");
+  if (!f) {
+    LOG(WARNING) << "Could not create index file '" << tempFilePath
+                 << "', the error was: " << std::strerror(errno);
+    return;
+  }
+  const auto writeValue = [f](const auto& value) { fwrite(&value, sizeof(value), 1, f); };
+  writeValue(INDEX_MAGIC);
+  writeValue(INDEX_VERSION);
+  writeValue(epoch_);
+  const size_t numFiles =
+      std::count_if(files_.begin(), files_.end(), [](FileInfo* fileInfo) {
+        return fileInfo != nullptr;
+      });
+  writeValue(numFiles);
+  for (const auto fileInfo : files_) {
+    if (fileInfo) {
+      writeValue(fileInfo->fileId);
+      writeValue(fileInfo->pageSize);
+      writeValue(fileInfo->numPages);
+    }
+  }
+  // Chunks without pages aren't found by the header scan either
+  const size_t numChunks =
+      std::count_if(chunkIndex_.begin(), chunkIndex_.end(), [](const auto& chunk) {
+        return !chunk.second->metadataPages_.pageVersions.empty();
+      });
+  writeValue(numChunks);
+  for (const auto& chunk : chunkIndex_) {
+    const auto buffer = chunk.second;
+    const auto& metadataPages = buffer->metadataPages_;
+    if (metadataPages.pageVersions.empty()) {
+      continue;
+    }
+    writeValue(chunk.first.size());
+    fwrite(chunk.first.data(), sizeof(int), chunk.first.size(), f);
+    // The headers of the pages, in the order of headerCompare
+    size_t numHeaders =
+        buffer->valueFilterPages_.size() + metadataPages.pageVersions.size();
+    for (const auto& multiPage : buffer->multiPages_) {
+      numHeaders += multiPage.pageVersions.size();
+    }
+    writeValue(numHeaders);
+    const auto writeHeaders = [&writeValue](const MultiPage& multiPage,
+                                            const int pageId) {
+      for (size_t i = 0; i < multiPage.pageVersions.size(); ++i) {
+        const auto& page = multiPage.pageVersions[i];
+        writeValue(pageId);
+        writeValue(multiPage.epochs[i]);
+        writeValue(page.fileId);
+        writeValue(static_cast<int>(page.pageNum));
+      }
+    };
+    // The value filter pages are written along with the last metadata page
+    for (const auto& page : buffer->valueFilterPages_) {
+      writeValue(VALUE_FILTER_PAGE_ID);
+      writeValue(metadataPages.epochs.back());
+      writeValue(page.fileId);
+      writeValue(static_cast<int>(page.pageNum));
+    }
+    writeHeaders(metadataPages, -1);
+    for (size_t pageId = 0; pageId < buffer->multiPages_.size(); ++pageId) {
+      writeHeaders(buffer->multiPages_[pageId], static_cast<int>(pageId));
+    }
+    buffer->writeMetadataTo(f);
+  }
+  writeValue(INDEX_MAGIC);
+
+  const bool written = !ferror(f) && fflush(f) == 0 && fsync(fileno(f)) == 0;
+  fclose(f);
+  if (!written || std::rename(tempFilePath.c_str(), indexFilePath.c_str()) != 0) {
+    LOG(WARNING) << "Could not write index file '" << indexFilePath
+                 << "', the error was: " << std::strerror(errno);
+    boost::filesystem::remove(tempFilePath);
+    return;
+  }
+  syncDirectory(fileMgrBasePath_);
+  isIndexOnDisk_ = true;
 }
 
 FileBuffer* FileMgr::createBuffer(const ChunkKey& key,
@@ -702,6 +992,28 @@ FileBuffer* FileMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
   return chunkIt->second;
 }
 
+bool FileMgr::verifyPage(const ChunkKey& key,
+                         const size_t pageNum,
+                         std::vector<int8_t>& stored,
+                         PageVerification& verification) {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  auto chunkIt = chunkIndex_.find(key);
+  if (chunkIt == chunkIndex_.end()) {
+    return false;
+  }
+  return chunkIt->second->verifyPage(pageNum, stored, verification);
+}
+
+std::vector<ChunkKey> FileMgr::getChunkKeys() const {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  std::vector<ChunkKey> chunkKeys;
+  chunkKeys.reserve(chunkIndex_.size());
+  for (const auto& chunk : chunkIndex_) {
+    chunkKeys.push_back(chunk.first);
+  }
+  return chunkKeys;
+}
+
 void FileMgr::fetchBuffer(const ChunkKey& key,
                           AbstractBuffer* destBuffer,
                           const size_t numBytes) {
@@ -800,6 +1112,7 @@ void FileMgr::free(AbstractBuffer* buffer) {
 
 Page FileMgr::requestFreePage(size_t pageSize, const bool isMetadata) {
   std::lock_guard<std::mutex> lock(getPageMutex_);
+  invalidateIndex();
 
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   int pageNum = -1;
@@ -829,6 +1142,7 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
   // not used currently
   // @todo add method to FileInfo to get more than one page
   std::lock_guard<std::mutex> lock(getPageMutex_);
+  invalidateIndex();
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   size_t numPagesNeeded = numPagesRequested;
   for (auto fileIt = candidateFiles.first; fileIt != candidateFiles.second; ++fileIt) {
@@ -984,6 +1298,7 @@ void FileMgr::createTopLevelMetadata() {
 }
 
 void FileMgr::setEpoch(int epoch) {
+  invalidateIndex();
   epoch_ = epoch;
   writeAndSyncEpochToDisk();
 }
@@ -993,6 +1308,18 @@ void FileMgr::free_page(std::pair<FileInfo*, int>&& page) {
   free_pages.push_back(page);
 }
 
+void FileMgr::invalidateIndex() {
+  std::lock_guard<std::mutex> indexLock(indexMutex_);
+  if (!isIndexOnDisk_) {
+    return;
+  }
+  // The removal has to be on disk before the pages are, a crash in between would leave
+  // an index file which doesn't match the data files otherwise
+  boost::filesystem::remove(fileMgrBasePath_ + "/" + INDEX_FILENAME);
+  syncDirectory(fileMgrBasePath_);
+  isIndexOnDisk_ = false;
+}
+
 void FileMgr::removeTableRelatedDS(const int db_id, const int table_id) {
   UNREACHABLE();
 }
@@ -28,6 +28,7 @@
 #include <future>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <vector>
@@ -36,11 +37,14 @@
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/FileMgr/FileBuffer.h"
 #include "DataMgr/FileMgr/FileInfo.h"
+#include "DataMgr/FileMgr/FileReaderPool.h"
 #include "DataMgr/FileMgr/Page.h"
 #include "Shared/mapd_shared_mutex.h"
 
 using namespace Data_Namespace;
 
+extern bool g_enable_page_checksums;
+
 namespace File_Namespace {
 
 class GlobalFileMgr;  // forward declaration
@@ -207,6 +211,44 @@ class FileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  /**
+   * @brief Returns the pool reading the pages of the buffers of this FileMgr, null if the
+   * FileMgr has been opened without reader threads.
+   */
+  inline FileReaderPool* getReaderPool() { return reader_pool_.get(); }
+
+  /**
+   * @brief Returns the compression of the data pages of the buffers created from now on,
+   * the existing buffers keep the one they were created with.
+   */
+  inline PageCompression getPageCompression() const { return pageCompression_; }
+
+  inline void setPageCompression(const PageCompression compression) {
+    pageCompression_ = compression;
+  }
+
+  /**
+   * @brief Returns whether the data pages of the buffers created from now on have
+   * checksums, the existing buffers keep their page format.
+   */
+  inline bool getPageChecksums() const { return pageChecksums_; }
+
+  inline void setPageChecksums(const bool checksums) { pageChecksums_ = checksums; }
+
+  /**
+   * @brief Verifies the checksum of the current version of page pageNum of the buffer of
+   * key. Returns false if there's no such buffer or page anymore.
+   *
+   * The writes of the buffer wait for the verification of the page, see
+   * FileBuffer::verifyPage.
+   */
+  bool verifyPage(const ChunkKey& key,
+                  const size_t pageNum,
+                  std::vector<int8_t>& stored,
+                  PageVerification& verification);
+
+  std::vector<ChunkKey> getChunkKeys() const;
+
   /**
    * @brief Returns FILE pointer associated with
    * requested fileId
@@ -233,6 +275,14 @@ class FileMgr : public AbstractBufferMgr {  // implements
   void free_page(std::pair<FileInfo*, int>&& page);
   const std::pair<const int, const int> get_fileMgrKey() const { return fileMgrKey_; }
 
+  /**
+   * @brief Removes the index file written at the last checkpoint, if it's still there.
+   *
+   * Has to be called before the pages of the data files are changed, the index file then
+   * no longer matches them.
+   */
+  void invalidateIndex();
+
  private:
   GlobalFileMgr* gfm_;  /// Global FileMgr
   std::pair<const int, const int> fileMgrKey_;
@@ -241,7 +291,10 @@ class FileMgr : public AbstractBufferMgr {  // implements
   std::vector<FileInfo*> files_;  /// A vector of files accessible via a file identifier.
   PageSizeFileMMap fileIndex_;    /// Maps page sizes to FileInfo objects.
   size_t num_reader_threads_;     /// number of threads used when loading data
+  std::shared_ptr<FileReaderPool> reader_pool_;  /// threads reading the buffer pages
   size_t defaultPageSize_;
+  PageCompression pageCompression_ = PageCompression::NONE;
+  bool pageChecksums_ = g_enable_page_checksums;
   unsigned nextFileId_;  /// the index of the next file id
   int epoch_;            /// the current epoch (time of last checkpoint)
   FILE* epochFile_ = nullptr;
@@ -256,6 +309,17 @@ class FileMgr : public AbstractBufferMgr {  // implements
   mutable mapd_shared_mutex mutex_free_page;
   std::vector<std::pair<FileInfo*, int>> free_pages;
 
+  std::mutex indexMutex_;
+  bool isIndexOnDisk_ = false;  /// true if the index file matches the data files
+
+  // Data file found in the directory of the FileMgr at startup
+  struct DataFileInfo {
+    int fileId;
+    size_t pageSize;
+    size_t numPages;
+    std::string path;
+  };
+
   /**
    * @brief Adds a file to the file manager repository.
    *
@@ -287,6 +351,20 @@ class FileMgr : public AbstractBufferMgr {  // implements
   void setEpoch(int epoch);  // resets current value of epoch at startup
   void processFileFutures(std::vector<std::future<std::vector<HeaderInfo>>>& file_futures,
                           std::vector<HeaderInfo>& headerVec);
+  /**
+   * @brief Writes the pages and the metadata of all the chunks to the index file.
+   *
+   * Called at the end of every checkpoint, the index file allows the next startup to
+   * rebuild chunkIndex_ without reading the headers of all the pages of the data files.
+   */
+  void writeIndex();
+  /**
+   * @brief Opens the data files and rebuilds chunkIndex_ from the index file.
+   *
+   * Returns false, without opening anything, if the index file is missing or doesn't
+   * match the epoch or the data files.
+   */
+  bool openFilesFromIndex(const std::vector<DataFileInfo>& dataFiles);
   FileBuffer* createBufferUnlocked(const ChunkKey& key,
                                    size_t pageSize = 0,
                                    const size_t numBytes = 0);
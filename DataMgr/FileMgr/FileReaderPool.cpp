@@ -0,0 +1,183 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/FileMgr/FileReaderPool.h"
+
+#include <algorithm>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#include <cstring>
+#endif
+
+#include "DataMgr/FileMgr/FileInfo.h"
+#include "Logger/Logger.h"
+
+namespace File_Namespace {
+
+namespace {
+
+size_t pread_pages(const std::vector<PageRead>& page_reads) {
+  size_t bytes_read{0};
+  for (const auto& page_read : page_reads) {
+    bytes_read +=
+        page_read.file_info->read(page_read.offset, page_read.size, page_read.dst);
+  }
+  return bytes_read;
+}
+
+#ifdef HAVE_LIBURING
+
+constexpr unsigned kQueueDepth{64};
+
+// Ring of the calling thread, set up the first time the thread reads pages.
+class ThreadRing {
+ public:
+  ThreadRing() : initialized_(io_uring_queue_init(kQueueDepth, &ring_, 0) == 0) {
+    if (!initialized_) {
+      VLOG(1) << "Could not set up io_uring, reading data pages with pread.";
+    }
+  }
+
+  ~ThreadRing() {
+    if (initialized_) {
+      io_uring_queue_exit(&ring_);
+    }
+  }
+
+  size_t readPages(const std::vector<PageRead>& page_reads) {
+    if (!initialized_) {
+      return pread_pages(page_reads);
+    }
+    size_t bytes_read{0};
+    for (size_t batch_start = 0; batch_start < page_reads.size();
+         batch_start += kQueueDepth) {
+      const size_t batch_end = std::min(batch_start + kQueueDepth, page_reads.size());
+      for (size_t i = batch_start; i < batch_end; ++i) {
+        const auto& page_read = page_reads[i];
+        auto sqe = io_uring_get_sqe(&ring_);
+        CHECK(sqe);
+        io_uring_prep_read(sqe,
+                           fileno(page_read.file_info->f),
+                           page_read.dst,
+                           page_read.size,
+                           page_read.offset);
+        io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(i));
+      }
+      const int submitted = io_uring_submit(&ring_);
+      if (submitted < 0) {
+        LOG(FATAL) << "Error trying to submit reads to io_uring, the error was: "
+                   << std::strerror(-submitted);
+      }
+      CHECK_EQ(static_cast<size_t>(submitted), batch_end - batch_start);
+      for (size_t i = batch_start; i < batch_end; ++i) {
+        io_uring_cqe* cqe{nullptr};
+        const int ret = io_uring_wait_cqe(&ring_, &cqe);
+        if (ret < 0) {
+          LOG(FATAL) << "Error trying to wait for io_uring reads, the error was: "
+                     << std::strerror(-ret);
+        }
+        const auto& page_read =
+            page_reads[reinterpret_cast<size_t>(io_uring_cqe_get_data(cqe))];
+        const int res = cqe->res;
+        io_uring_cqe_seen(&ring_, cqe);
+        if (res < 0) {
+          LOG(FATAL) << "Error trying to read from file (during io_uring read) the "
+                        "error was: "
+                     << std::strerror(-res);
+        }
+        // Short reads are rare, finish them with pread
+        size_t page_bytes_read = res;
+        if (page_bytes_read < page_read.size) {
+          page_bytes_read += page_read.file_info->read(page_read.offset + page_bytes_read,
+                                                       page_read.size - page_bytes_read,
+                                                       page_read.dst + page_bytes_read);
+        }
+        bytes_read += page_bytes_read;
+      }
+    }
+    return bytes_read;
+  }
+
+ private:
+  io_uring ring_;
+  const bool initialized_;
+};
+
+#endif  // HAVE_LIBURING
+
+}  // namespace
+
+FileReaderPool::FileReaderPool(const size_t num_threads) : shutting_down_(false) {
+  for (size_t i = 0; i < std::max(num_threads, size_t(1)); ++i) {
+    threads_.emplace_back([this] { runWorker(); });
+  }
+}
+
+FileReaderPool::~FileReaderPool() {
+  {
+    std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+    shutting_down_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+std::future<size_t> FileReaderPool::submit(std::vector<PageRead> page_reads) {
+  return submit(std::function<size_t()>(
+      [page_reads = std::move(page_reads)] { return readPages(page_reads); }));
+}
+
+std::future<size_t> FileReaderPool::submit(std::function<size_t()> task_func) {
+  std::packaged_task<size_t()> task(std::move(task_func));
+  auto result = task.get_future();
+  {
+    std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+    CHECK(!shutting_down_);
+    queue_.push_back(std::move(task));
+  }
+  queue_cv_.notify_one();
+  return result;
+}
+
+size_t FileReaderPool::readPages(const std::vector<PageRead>& page_reads) {
+#ifdef HAVE_LIBURING
+  thread_local ThreadRing ring;
+  return ring.readPages(page_reads);
+#else
+  return pread_pages(page_reads);
+#endif
+}
+
+void FileReaderPool::runWorker() {
+  while (true) {
+    std::packaged_task<size_t()> task;
+    {
+      std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+      queue_cv_.wait(queue_lock, [this] { return shutting_down_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace File_Namespace
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    FileReaderPool.h
+ * @brief   Fixed set of threads reading the pages of file buffers.
+ *
+ * FileBuffer::read splits the pages it reads into contiguous batches and hands all of
+ * them but the first to the pool, which is shared by all the tables of a GlobalFileMgr,
+ * instead of starting threads for every read. Pages are read with pread, so the readers
+ * of a file don't serialize on it. When built with io_uring support (HAVE_LIBURING) every
+ * thread submits the reads of a batch to a ring of its own at once and waits for all of
+ * them, falling back to pread if the kernel doesn't support io_uring.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace File_Namespace {
+
+struct FileInfo;
+
+// Read of size bytes at offset in a data file into dst
+struct PageRead {
+  FileInfo* file_info;
+  size_t offset;
+  size_t size;
+  int8_t* dst;
+};
+
+class FileReaderPool {
+ public:
+  explicit FileReaderPool(const size_t num_threads);
+
+  ~FileReaderPool();
+
+  FileReaderPool(const FileReaderPool&) = delete;
+  FileReaderPool& operator=(const FileReaderPool&) = delete;
+
+  size_t getNumThreads() const { return threads_.size(); }
+
+  // Queues the reads, the future holds the number of bytes read once they're all done.
+  std::future<size_t> submit(std::vector<PageRead> page_reads);
+
+  // Queues a task which returns a number of bytes, e.g. reads and decompresses pages.
+  std::future<size_t> submit(std::function<size_t()> task_func);
+
+  // Runs the reads on the calling thread and returns the number of bytes read.
+  static size_t readPages(const std::vector<PageRead>& page_reads);
+
+ private:
+  void runWorker();
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::packaged_task<size_t()>> queue_;
+  bool shutting_down_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace File_Namespace
@@ -54,6 +54,11 @@ GlobalFileMgr::GlobalFileMgr(const int deviceId,
       1;  // DS changes triggered by individual FileMgr per table project (release 2.1.0)
   dbConvert_ = false;
   init();
+  if (g_enable_page_scrubber) {
+    page_scrubber_ =
+        std::make_unique<PageScrubber>(this, g_page_scrubber_bytes_per_second);
+    page_scrubber_->start();
+  }
 }
 
 void GlobalFileMgr::init() {
@@ -73,6 +78,14 @@ void GlobalFileMgr::init() {
   }
 }
 
+std::shared_ptr<FileReaderPool> GlobalFileMgr::getReaderPool(const size_t num_threads) {
+  std::lock_guard<std::mutex> reader_pool_lock(reader_pool_mutex_);
+  if (!reader_pool_) {
+    reader_pool_ = std::make_shared<FileReaderPool>(num_threads);
+  }
+  return reader_pool_;
+}
+
 void GlobalFileMgr::checkpoint() {
   mapd_unique_lock<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
   for (auto fileMgrsIt = allFileMgrs_.begin(); fileMgrsIt != allFileMgrs_.end();
@@ -234,4 +247,43 @@ size_t GlobalFileMgr::getTableEpoch(const int db_id, const int tb_id) {
   return fm->epoch_;
 }
 
+void GlobalFileMgr::setTablePageCompression(const int db_id,
+                                            const int tb_id,
+                                            const PageCompression compression) {
+  auto fm = dynamic_cast<FileMgr*>(getFileMgr(db_id, tb_id));
+  CHECK(fm);
+  fm->setPageCompression(compression);
+}
+
+std::vector<std::pair<int, int>> GlobalFileMgr::getOwnedFileMgrKeys() {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  std::vector<std::pair<int, int>> file_mgr_keys;
+  for (const auto& file_mgr : ownedFileMgrs_) {
+    file_mgr_keys.push_back(file_mgr.first);
+  }
+  return file_mgr_keys;
+}
+
+std::vector<ChunkKey> GlobalFileMgr::getChunkKeys(const int db_id, const int tb_id) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  if (auto it = ownedFileMgrs_.find(std::make_pair(db_id, tb_id));
+      it != ownedFileMgrs_.end()) {
+    return it->second->getChunkKeys();
+  }
+  return {};
+}
+
+bool GlobalFileMgr::verifyPage(const ChunkKey& key,
+                               const size_t pageNum,
+                               std::vector<int8_t>& stored,
+                               PageVerification& verification) {
+  // Keeps the table from being dropped, and its files from being closed, meanwhile
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  if (auto it = ownedFileMgrs_.find(std::make_pair(key[0], key[1]));
+      it != ownedFileMgrs_.end()) {
+    return it->second->verifyPage(key, pageNum, stored, verification);
+  }
+  return false;
+}
+
 }  // namespace File_Namespace
@@ -28,13 +28,18 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <utility>
+#include <vector>
 #include "../Shared/mapd_shared_mutex.h"
 
 #include "../AbstractBuffer.h"
 #include "../AbstractBufferMgr.h"
 #include "FileMgr.h"
+#include "FileReaderPool.h"
+#include "PageScrubber.h"
 
 using namespace Data_Namespace;
 
@@ -138,6 +143,12 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  /**
+   * @brief Returns the reader pool shared by the FileMgrs of all tables, created with
+   * num_threads threads on the first call.
+   */
+  std::shared_ptr<FileReaderPool> getReaderPool(const size_t num_threads);
+
   size_t getNumChunks() override;
 
  private:
@@ -162,6 +173,22 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
   void removeTableRelatedDS(const int db_id, const int tb_id) override;
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  // Compression of the data pages of the chunks created from now on in the table
+  void setTablePageCompression(const int db_id,
+                               const int tb_id,
+                               const PageCompression compression);
+
+  // Keys of the tables whose FileMgr has been opened by this GlobalFileMgr
+  std::vector<std::pair<int, int>> getOwnedFileMgrKeys();
+  std::vector<ChunkKey> getChunkKeys(const int db_id, const int tb_id);
+  // See FileMgr::verifyPage, only the tables with an opened FileMgr are verified
+  bool verifyPage(const ChunkKey& key,
+                  const size_t pageNum,
+                  std::vector<int8_t>& stored,
+                  PageVerification& verification);
+
+  // Null unless --enable-page-scrubber is set
+  const PageScrubber* getPageScrubber() const { return page_scrubber_.get(); }
 
  private:
   std::string basePath_;       /// The OS file system path containing the files.
@@ -171,6 +198,8 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
                * using --start-epoch option at start up to rollback this table's updates.
                */
   size_t defaultPageSize_;  /// default page size, used to set FileMgr defaultPageSize_
+  std::mutex reader_pool_mutex_;
+  std::shared_ptr<FileReaderPool> reader_pool_;
   // bool isDirty_;               /// true if metadata changed since last writeState()
 
   int mapd_db_version_;  /// DB version for DataMgr DS and corresponding file buffer
@@ -186,6 +215,9 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
   std::map<std::pair<int, int>, AbstractBufferMgr*> allFileMgrs_;
 
   mapd_shared_mutex fileMgrs_mutex_;
+
+  // Last, it stops before the FileMgrs are destroyed
+  std::unique_ptr<PageScrubber> page_scrubber_;
 };
 
 }  // namespace File_Namespace
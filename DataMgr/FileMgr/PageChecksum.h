@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PageChecksum.h
+ * @brief   Checksums of the data pages of the chunks.
+ *
+ * The data pages of the chunks created with page checksums have a checksum area between
+ * the page header and the page data. It holds the number of bytes at the start of the
+ * page data covered by the checksum and their CRC32C. Appends extend the checksum of the
+ * last page, other writes compute it again. For compressed pages the checksum covers the
+ * compressed page word and the bytes stored after it.
+ *
+ * Reads verify the checksums of the pages they read. A checksum covering bytes past the
+ * end of the chunk, which happens if appends after the last checkpoint were rolled back,
+ * can't be verified and is reported as unchecked rather than corrupt.
+ *
+ * Every chunk records in its metadata page whether its pages have checksums, the
+ * --enable-page-checksums flag only applies to the chunks created while it's set.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "DataMgr/FileMgr/Page.h"
+
+namespace File_Namespace {
+
+struct PageChecksum {
+  uint32_t numBytes;
+  uint32_t crc;
+};
+
+constexpr size_t PAGE_CHECKSUM_SIZE{sizeof(PageChecksum)};
+
+enum class PageCheck { UNCHECKED, VERIFIED, CORRUPT };
+
+// Outcome of the verification of the current version of a data page
+struct PageVerification {
+  PageCheck check;
+  Page page;
+  size_t bytesRead;
+};
+
+}  // namespace File_Namespace
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PageCompression.h
+ * @brief   Compression of the data pages of the chunks of a table.
+ *
+ * The pages of a compressed chunk keep their size and their place in the data files,
+ * so the pages holding a range of the chunk are found as for uncompressed chunks. The
+ * data area of a page starts with a 32-bit word holding the number of bytes stored after
+ * it, followed by a blosc frame of the data of the page or, if it doesn't compress, by
+ * the data itself (flagged by the top bit of the word). Reads only transfer the stored
+ * bytes of the pages.
+ *
+ * Every chunk records its compression in its metadata page, the compression of a table
+ * (PAGE_COMPRESSION option of CREATE TABLE) only applies to the chunks it creates.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace File_Namespace {
+
+enum class PageCompression { NONE = 0, BLOSCLZ = 1, LZ4 = 2, ZSTD = 3 };
+
+// Size of the word in front of the stored bytes of compressed pages
+constexpr size_t COMPRESSED_PAGE_PREFIX_SIZE{sizeof(uint32_t)};
+// Flags the pages whose data didn't compress and is stored as is
+constexpr uint32_t RAW_COMPRESSED_PAGE_FLAG{uint32_t(1) << 31};
+
+inline PageCompression page_compression_from_string(const std::string& name) {
+  if (name.empty() || name == "NONE") {
+    return PageCompression::NONE;
+  }
+  if (name == "BLOSCLZ") {
+    return PageCompression::BLOSCLZ;
+  }
+  if (name == "LZ4") {
+    return PageCompression::LZ4;
+  }
+  if (name == "ZSTD") {
+    return PageCompression::ZSTD;
+  }
+  throw std::runtime_error("PAGE_COMPRESSION must be NONE, BLOSCLZ, LZ4 or ZSTD.");
+}
+
+inline std::string to_string(const PageCompression compression) {
+  switch (compression) {
+    case PageCompression::NONE:
+      return "NONE";
+    case PageCompression::BLOSCLZ:
+      return "BLOSCLZ";
+    case PageCompression::LZ4:
+      return "LZ4";
+    case PageCompression::ZSTD:
+      return "ZSTD";
+  }
+  return "";
+}
+
+// Name of the compressor in blosc
+inline const char* blosc_compressor_name(const PageCompression compression) {
+  switch (compression) {
+    case PageCompression::LZ4:
+      return "lz4";
+    case PageCompression::ZSTD:
+      return "zstd";
+    default:
+      return "blosclz";
+  }
+}
+
+// Favors the speed of the writes, reads are as fast at every level
+inline int blosc_compression_level(const PageCompression compression) {
+  return compression == PageCompression::ZSTD ? 3 : 5;
+}
+
+}  // namespace File_Namespace
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/FileMgr/PageScrubber.h"
+
+#include <vector>
+
+#include "DataMgr/FileMgr/GlobalFileMgr.h"
+
+bool g_enable_page_scrubber{false};
+size_t g_page_scrubber_bytes_per_second{size_t(16) << 20};
+
+namespace File_Namespace {
+
+namespace {
+
+constexpr std::chrono::minutes kStartDelay{1};
+constexpr std::chrono::hours kMinPassInterval{1};
+constexpr size_t kMaxCorruptPageDescriptions{100};
+
+}  // namespace
+
+PageScrubber::PageScrubber(GlobalFileMgr* gfm, const size_t bytes_per_second)
+    : gfm_(gfm), bytes_per_second_(bytes_per_second), stop_(false) {
+  CHECK(gfm_);
+}
+
+PageScrubber::~PageScrubber() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PageScrubber::start() {
+  CHECK(!thread_.joinable());
+  thread_ = std::thread([this] { run(); });
+}
+
+PageScrubber::Stats PageScrubber::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void PageScrubber::run() {
+  // Leaves the server some time to open the tables
+  auto next_pass = std::chrono::steady_clock::now() + kStartDelay;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (cv_.wait_until(lock, next_pass, [this] { return stop_; })) {
+        return;
+      }
+    }
+    next_pass = std::chrono::steady_clock::now() + kMinPassInterval;
+    scrubPass();
+  }
+}
+
+void PageScrubber::scrubPass() {
+  const auto pass_start = std::chrono::steady_clock::now();
+  size_t pass_bytes = 0;
+  std::vector<int8_t> stored;
+  for (const auto& table_key : gfm_->getOwnedFileMgrKeys()) {
+    for (const auto& chunk_key : gfm_->getChunkKeys(table_key.first, table_key.second)) {
+      PageVerification verification;
+      // The chunk may be deleted, or truncated, between two pages
+      for (size_t page_num = 0;
+           gfm_->verifyPage(chunk_key, page_num, stored, verification);
+           ++page_num) {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stats_.bytes_read += verification.bytesRead;
+          switch (verification.check) {
+            case PageCheck::VERIFIED:
+              ++stats_.verified_pages;
+              break;
+            case PageCheck::UNCHECKED:
+              ++stats_.unchecked_pages;
+              break;
+            case PageCheck::CORRUPT: {
+              ++stats_.corrupt_pages;
+              const auto description =
+                  "page " + std::to_string(page_num) + " of chunk " +
+                  showChunk(chunk_key) + " (page " +
+                  std::to_string(verification.page.pageNum) + " in file " +
+                  std::to_string(verification.page.fileId) + ")";
+              LOG(ERROR) << "Checksum mismatch in " << description;
+              if (stats_.corrupt_page_descriptions.size() <
+                  kMaxCorruptPageDescriptions) {
+                stats_.corrupt_page_descriptions.insert(description);
+              }
+              break;
+            }
+          }
+        }
+        pass_bytes += verification.bytesRead;
+        if (!throttle(pass_start, pass_bytes)) {
+          return;
+        }
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.passes;
+}
+
+bool PageScrubber::throttle(const std::chrono::steady_clock::time_point pass_start,
+                            const size_t pass_bytes) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (bytes_per_second_ == 0) {
+    return !stop_;
+  }
+  const auto pass_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(pass_bytes) / bytes_per_second_));
+  return !cv_.wait_until(lock, pass_start + pass_time, [this] { return stop_; });
+}
+
+}  // namespace File_Namespace
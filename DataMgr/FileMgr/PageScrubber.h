@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PageScrubber.h
+ * @brief   Verifies the checksums of the data pages of the tables in the background.
+ *
+ * A background thread walks the chunks of the tables opened by the GlobalFileMgr and
+ * verifies the checksum of every data page, so that corrupt pages are found before a
+ * query reads them. The thread reads at most g_page_scrubber_bytes_per_second, to leave
+ * the disks to the queries. The first pass starts a minute after the GlobalFileMgr, the
+ * next ones at most once an hour.
+ *
+ * Corrupt pages are logged and counted, the pages of chunks without checksums or written
+ * since the last checkpoint of their table are counted as unchecked.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+extern bool g_enable_page_scrubber;
+extern size_t g_page_scrubber_bytes_per_second;
+
+namespace File_Namespace {
+
+class GlobalFileMgr;
+
+class PageScrubber {
+ public:
+  // Counts of the pages verified since the scrubber started, every pass counts them again
+  struct Stats {
+    size_t passes{0};
+    size_t verified_pages{0};
+    size_t unchecked_pages{0};
+    size_t corrupt_pages{0};
+    size_t bytes_read{0};
+    // Capped, a corrupt page found by several passes appears once
+    std::set<std::string> corrupt_page_descriptions;
+  };
+
+  // Reads at most bytes_per_second, no limit if 0
+  PageScrubber(GlobalFileMgr* gfm, const size_t bytes_per_second);
+
+  ~PageScrubber();
+
+  PageScrubber(const PageScrubber&) = delete;
+  PageScrubber& operator=(const PageScrubber&) = delete;
+
+  // Starts the background thread
+  void start();
+
+  // Verifies all the pages of the tables once in the calling thread
+  void scrubPass();
+
+  Stats getStats() const;
+
+ private:
+  void run();
+
+  // Returns false if the scrubber has been stopped while waiting
+  bool throttle(const std::chrono::steady_clock::time_point pass_start,
+                const size_t pass_bytes);
+
+  GlobalFileMgr* gfm_;
+  const size_t bytes_per_second_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_;
+  Stats stats_;
+
+  std::thread thread_;
+};
+
+}  // namespace File_Namespace
@@ -92,6 +92,7 @@ class FixedLengthEncoder : public Encoder {
       dataMin = std::min(dataMin, data);
       dataMax = std::max(dataMax, data);
     }
+    updateValueFilter(val, is_null);
   }
 
   // Only called from the executor for synthesized meta-information.
@@ -103,6 +104,7 @@ class FixedLengthEncoder : public Encoder {
       dataMin = std::min(dataMin, data);
       dataMax = std::max(dataMax, data);
     }
+    updateValueFilter(static_cast<T>(val), is_null);
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
@@ -187,13 +189,15 @@ class FixedLengthEncoder : public Encoder {
                         " encoded: " + std::to_string(encoded_data);
     } else {
       T data = unencoded_data;
-      if (data == std::numeric_limits<V>::min()) {
+      const bool is_null = data == std::numeric_limits<V>::min();
+      if (is_null) {
         has_nulls = true;
       } else {
         decimal_overflow_validator_.validate(data);
         dataMin = std::min(dataMin, data);
         dataMax = std::max(dataMax, data);
       }
+      updateValueFilter(data, is_null);
     }
     return encoded_data;
   }
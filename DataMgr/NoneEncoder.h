@@ -99,6 +99,7 @@ class NoneEncoder : public Encoder {
       dataMin = std::min(dataMin, data);
       dataMax = std::max(dataMax, data);
     }
+    updateValueFilter(val, is_null);
   }
 
   // Only called from the executor for synthesized meta-information.
@@ -110,6 +111,7 @@ class NoneEncoder : public Encoder {
       dataMin = std::min(dataMin, data);
       dataMax = std::max(dataMax, data);
     }
+    updateValueFilter(static_cast<T>(val), is_null);
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
@@ -185,13 +187,15 @@ class NoneEncoder : public Encoder {
 
  private:
   T validateDataAndUpdateStats(const T& unencoded_data) {
-    if (unencoded_data == none_encoded_null_value<T>()) {
+    const bool is_null = unencoded_data == none_encoded_null_value<T>();
+    if (is_null) {
       has_nulls = true;
     } else {
       decimal_overflow_validator_.validate(unencoded_data);
       dataMin = std::min(dataMin, unencoded_data);
       dataMax = std::max(dataMax, unencoded_data);
     }
+    updateValueFilter(unencoded_data, is_null);
     return unencoded_data;
   }
 };  // class NoneEncoder
@@ -0,0 +1,304 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUN_LENGTH_ENCODER_H
+#define RUN_LENGTH_ENCODER_H
+#include "Logger/Logger.h"
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "AbstractBuffer.h"
+#include "Encoder.h"
+
+#include <Shared/DatumFetchers.h>
+#include <Shared/EncodedChunkLayout.h>
+
+/**
+ * Run-length encoder for boolean, integer, decimal and time columns. The chunk buffer
+ * holds a RunLengthChunkHeader followed by RunLengthEntry<T> runs, see
+ * EncodedChunkLayout.h. Appends extend the last run of the chunk when the first appended
+ * value continues it. Once a chunk of at least kRunLengthMinRowsForPlain rows has runs
+ * taking more space than one T per row, it is rewritten to store one T per row and
+ * takes the following appends that way.
+ */
+template <typename T>
+class RunLengthEncoder : public Encoder {
+ public:
+  using Run = RunLengthEntry<T>;
+
+  RunLengthEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : Encoder(buffer)
+      , dataMin(std::numeric_limits<T>::max())
+      , dataMax(std::numeric_limits<T>::min())
+      , has_nulls(false) {}
+
+  std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
+                                            const size_t num_elems_to_append,
+                                            const SQLTypeInfo& ti,
+                                            const bool replicating = false,
+                                            const int64_t offset = -1) override {
+    if (offset != -1) {
+      throw std::runtime_error(
+          "In-place updates are not supported on run-length encoded columns.");
+    }
+    T* unencoded_data = reinterpret_cast<T*>(src_data);
+    RunLengthChunkHeader header{0, 0};
+    if (buffer_->size() == 0) {
+      buffer_->append(reinterpret_cast<int8_t*>(&header), sizeof(RunLengthChunkHeader));
+    } else {
+      buffer_->read(
+          reinterpret_cast<int8_t*>(&header), sizeof(RunLengthChunkHeader), 0);
+    }
+    if (header.num_rows + num_elems_to_append >
+        static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+      throw std::runtime_error("Run-length encoded chunks hold at most " +
+                               std::to_string(std::numeric_limits<int32_t>::max()) +
+                               " rows.");
+    }
+
+    if (header.num_runs == kRunLengthPlainChunk) {
+      std::vector<T> values(num_elems_to_append);
+      for (size_t i = 0; i < num_elems_to_append; ++i) {
+        values[i] = encodeDataAndUpdateStats(unencoded_data[replicating ? 0 : i]);
+      }
+      if (!values.empty()) {
+        buffer_->append(reinterpret_cast<int8_t*>(values.data()),
+                        values.size() * sizeof(T));
+      }
+    } else {
+      header.num_runs += appendRuns(unencoded_data,
+                                    num_elems_to_append,
+                                    replicating,
+                                    header.num_runs,
+                                    header.num_rows);
+    }
+    header.num_rows += num_elems_to_append;
+    if (header.num_runs != kRunLengthPlainChunk &&
+        header.num_rows >= kRunLengthMinRowsForPlain &&
+        header.num_runs * sizeof(Run) > header.num_rows * sizeof(T)) {
+      convertToPlain(header);
+    }
+    buffer_->write(reinterpret_cast<int8_t*>(&header), sizeof(RunLengthChunkHeader), 0);
+    num_elems_ += num_elems_to_append;
+    if (!replicating) {
+      src_data += num_elems_to_append * sizeof(T);
+    }
+
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    getMetadata(chunk_metadata);
+    return chunk_metadata;
+  }
+
+  void getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) override {
+    Encoder::getMetadata(chunkMetadata);  // call on parent class
+    chunkMetadata->fillChunkStats(dataMin, dataMax, has_nulls);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>(ti, 0, 0, ChunkStats{});
+    chunk_metadata->fillChunkStats(dataMin, dataMax, has_nulls);
+    return chunk_metadata;
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    for (size_t i = 0; i < num_elements; ++i) {
+      encodeDataAndUpdateStats(unencoded_data[i]);
+    }
+  }
+
+  void updateStats(const std::vector<std::string>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  void updateStats(const std::vector<ArrayDatum>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void reduceStats(const Encoder& that) override {
+    const auto that_typed = static_cast<const RunLengthEncoder<T>&>(that);
+    if (that_typed.has_nulls) {
+      has_nulls = true;
+    }
+    dataMin = std::min(dataMin, that_typed.dataMin);
+    dataMax = std::max(dataMax, that_typed.dataMax);
+  }
+
+  void copyMetadata(const Encoder* copyFromEncoder) override {
+    num_elems_ = copyFromEncoder->getNumElems();
+    auto castedEncoder = reinterpret_cast<const RunLengthEncoder<T>*>(copyFromEncoder);
+    dataMin = castedEncoder->dataMin;
+    dataMax = castedEncoder->dataMax;
+    has_nulls = castedEncoder->has_nulls;
+  }
+
+  void writeMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fwrite((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&dataMin, sizeof(T), 1, f);
+    fwrite((int8_t*)&dataMax, sizeof(T), 1, f);
+    fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
+  }
+
+  void readMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fread((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fread((int8_t*)&dataMin, 1, sizeof(T), f);
+    fread((int8_t*)&dataMax, 1, sizeof(T), f);
+    fread((int8_t*)&has_nulls, 1, sizeof(bool), f);
+  }
+
+  bool resetChunkStats(const ChunkStats& stats) override {
+    const auto new_min = DatumFetcher::getDatumVal<T>(stats.min);
+    const auto new_max = DatumFetcher::getDatumVal<T>(stats.max);
+
+    if (dataMin == new_min && dataMax == new_max && has_nulls == stats.has_nulls) {
+      return false;
+    }
+
+    dataMin = new_min;
+    dataMax = new_max;
+    has_nulls = stats.has_nulls;
+    return true;
+  }
+
+  T dataMin;
+  T dataMax;
+  bool has_nulls;
+
+ private:
+  static size_t runOffset(const size_t run_idx) {
+    return sizeof(RunLengthChunkHeader) + run_idx * sizeof(Run);
+  }
+
+  // Appends the values as runs after the num_stored_runs runs holding the first
+  // num_stored_rows rows of the chunk, returns the number of runs added.
+  size_t appendRuns(const T* unencoded_data,
+                    const size_t num_elems_to_append,
+                    const bool replicating,
+                    const size_t num_stored_runs,
+                    const int64_t num_stored_rows) {
+    // Seed the current run with the last stored one so that appends can extend it.
+    Run current{0, 0};
+    bool have_current{false};
+    bool current_is_stored{false};
+    if (num_stored_runs > 0) {
+      buffer_->read(reinterpret_cast<int8_t*>(&current),
+                    sizeof(Run),
+                    runOffset(num_stored_runs - 1));
+      have_current = true;
+      current_is_stored = true;
+    }
+    const auto stored_last_run_end = current.run_end;
+
+    std::vector<Run> new_runs;
+    auto flush_current = [&]() {
+      if (!current_is_stored) {
+        new_runs.push_back(current);
+      } else if (current.run_end != stored_last_run_end) {
+        buffer_->write(reinterpret_cast<int8_t*>(&current),
+                       sizeof(Run),
+                       runOffset(num_stored_runs - 1));
+      }
+    };
+    for (size_t i = 0; i < num_elems_to_append; ++i) {
+      size_t ri = replicating ? 0 : i;
+      const auto value = encodeDataAndUpdateStats(unencoded_data[ri]);
+      const auto row_end = static_cast<int32_t>(num_stored_rows + i + 1);
+      if (have_current && current.value == value) {
+        current.run_end = row_end;
+        continue;
+      }
+      if (have_current) {
+        flush_current();
+      }
+      current = {value, row_end};
+      have_current = true;
+      current_is_stored = false;
+    }
+    if (have_current) {
+      flush_current();
+    }
+    if (!new_runs.empty()) {
+      buffer_->append(reinterpret_cast<int8_t*>(new_runs.data()),
+                      new_runs.size() * sizeof(Run));
+    }
+    return new_runs.size();
+  }
+
+  // Rewrites the runs of the chunk as one value per row.
+  void convertToPlain(RunLengthChunkHeader& header) {
+    std::vector<Run> runs(header.num_runs);
+    buffer_->read(reinterpret_cast<int8_t*>(runs.data()),
+                  runs.size() * sizeof(Run),
+                  sizeof(RunLengthChunkHeader));
+    std::vector<T> values;
+    values.reserve(header.num_rows);
+    for (const auto& run : runs) {
+      values.insert(values.end(), run.run_end - values.size(), run.value);
+    }
+    CHECK_EQ(values.size(), static_cast<size_t>(header.num_rows));
+    buffer_->write(reinterpret_cast<int8_t*>(values.data()),
+                   values.size() * sizeof(T),
+                   sizeof(RunLengthChunkHeader));
+    // Writes never shrink the buffer, drop the runs past the plain values so that the
+    // following appends land right after them.
+    buffer_->setSize(sizeof(RunLengthChunkHeader) + values.size() * sizeof(T));
+    header.num_runs = kRunLengthPlainChunk;
+  }
+
+  T encodeDataAndUpdateStats(const T& unencoded_data) {
+    if (unencoded_data == inline_int_null_value<T>()) {
+      has_nulls = true;
+    } else {
+      decimal_overflow_validator_.validate(unencoded_data);
+      dataMin = std::min(dataMin, unencoded_data);
+      dataMax = std::max(dataMax, unencoded_data);
+    }
+    return unencoded_data;
+  }
+};  // RunLengthEncoder
+
+#endif  // RUN_LENGTH_ENCODER_H
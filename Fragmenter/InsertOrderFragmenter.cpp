@@ -30,6 +30,7 @@
 #include "DataMgr/DataMgr.h"
 #include "LockMgr/LockMgr.h"
 #include "Logger/Logger.h"
+#include "Shared/EncodedChunkLayout.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/thread_count.h"
 
@@ -107,6 +108,34 @@ int compute_device_for_fragment(const int table_id,
   }
 }
 
+bool is_encoded_chunk(const SQLTypeInfo& ti) {
+  return ti.get_compression() == kENCODING_RL || ti.get_compression() == kENCODING_DIFF;
+}
+
+/**
+ * Rows which always fit in a RL or DIFF encoded chunk of max_chunk_size bytes. Both
+ * encodings start the chunk with a header. A run-length encoded chunk keeps its runs,
+ * which can take more than one value per row, for its first kRunLengthMinRowsForPlain
+ * rows, and takes at most one value per row past them.
+ */
+size_t get_max_encoded_chunk_rows(const SQLTypeInfo& ti, const size_t max_chunk_size) {
+  if (ti.get_compression() == kENCODING_RL) {
+    CHECK_GT(max_chunk_size, sizeof(RunLengthChunkHeader));
+    // No run is larger than the ones of BIGINT columns.
+    const size_t max_run_size = sizeof(RunLengthEntry<int64_t>);
+    const size_t max_runs_bytes =
+        sizeof(RunLengthChunkHeader) + kRunLengthMinRowsForPlain * max_run_size;
+    if (max_chunk_size <= max_runs_bytes) {
+      return (max_chunk_size - sizeof(RunLengthChunkHeader)) / max_run_size;
+    }
+    return std::min((max_chunk_size - max_runs_bytes) / ti.get_size(),
+                    static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+  }
+  CHECK_EQ(ti.get_compression(), kENCODING_DIFF);
+  CHECK_GT(max_chunk_size, sizeof(FrameOfReferenceChunkHeader));
+  return (max_chunk_size - sizeof(FrameOfReferenceChunkHeader)) / ti.get_size();
+}
+
 }  // namespace
 
 void InsertOrderFragmenter::getChunkMetadata() {
@@ -175,6 +204,11 @@ void InsertOrderFragmenter::getChunkMetadata() {
     }
     CHECK_GE(size, 0);
     maxFixedColSize = std::max(maxFixedColSize, static_cast<size_t>(size));
+    const auto& col_type = colIt->second.getColumnDesc()->columnType;
+    if (is_encoded_chunk(col_type)) {
+      maxFragmentRows_ =
+          std::min(maxFragmentRows_, get_max_encoded_chunk_rows(col_type, maxChunkSize_));
+    }
   }
 
   // this is maximum number of rows assuming everything is fixed length
@@ -454,6 +488,9 @@ void InsertOrderFragmenter::replicateData(const InsertData& insertDataStruct) {
           varLenColInfo_[columnId] = 0;
           numRowsCanBeInserted = chunk.getNumElemsForBytesInsertData(
               dataCopy, numRowsToInsert, 0, maxChunkSize_, true);
+        } else if (is_encoded_chunk(colDesc->columnType)) {
+          numRowsCanBeInserted =
+              get_max_encoded_chunk_rows(colDesc->columnType, maxChunkSize_);
         } else {
           numRowsCanBeInserted = maxChunkSize_ / size;
         }
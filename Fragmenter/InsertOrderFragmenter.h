@@ -238,6 +238,12 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   auto vacuum_varlen_rows(const FragmentInfo& fragment,
                           const std::shared_ptr<Chunk_NS::Chunk>& chunk,
                           const std::vector<uint64_t>& frag_offsets);
+  void vacuum_encoded_rows(const FragmentInfo& fragment,
+                           const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                           const std::vector<uint64_t>& frag_offsets,
+                           int8_t& has_null,
+                           int64_t& min,
+                           int64_t& max);
 };
 
 }  // namespace Fragmenter_Namespace
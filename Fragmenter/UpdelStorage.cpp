@@ -49,6 +49,18 @@ inline bool is_integral(const SQLTypeInfo& t) {
   return t.is_integer() || t.is_boolean() || t.is_time() || t.is_timeinterval();
 }
 
+inline bool is_row_encoded(const SQLTypeInfo& ti) {
+  return ti.get_compression() == kENCODING_RL || ti.get_compression() == kENCODING_DIFF;
+}
+
+// Run-length and DIFF encoded chunks can't be rewritten in place row by row.
+inline void check_in_place_update_supported(const ColumnDescriptor* cd) {
+  if (is_row_encoded(cd->columnType)) {
+    throw std::runtime_error("Column " + cd->columnName +
+                             " is RL or DIFF encoded and cannot be updated in place.");
+  }
+}
+
 bool FragmentInfo::unconditionalVacuum_{false};
 
 void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catalog,
@@ -577,6 +589,7 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
                                          const SQLTypeInfo& rhs_type,
                                          const Data_Namespace::MemoryLevel memory_level,
                                          UpdelRoll& updel_roll) {
+  check_in_place_update_supported(cd);
   updel_roll.catalog = catalog;
   updel_roll.logicalTableId = catalog->getLogicalTableId(td->tableId);
   updel_roll.memoryLevel = memory_level;
@@ -949,6 +962,9 @@ void InsertOrderFragmenter::updateColumnMetadata(const ColumnDescriptor* cd,
              !(lhs_type.is_string() && kENCODING_DICT != lhs_type.get_compression())) {
     update_stats(min_int64t_per_chunk, max_int64t_per_chunk, has_null_per_chunk);
   }
+  // The value filter only learns the new min and max, not the other updated values, so
+  // it could rule out values the chunk now holds
+  encoder->clearValueFilter();
   buffer->getEncoder()->getMetadata(chunkMetadata[cd->columnId]);
 }
 
@@ -1156,6 +1172,72 @@ auto InsertOrderFragmenter::vacuum_varlen_rows(
   return nbytes_var_data_to_keep;
 }
 
+// RL and DIFF encoded chunks don't have a fixed size per row to move the kept rows
+// around. Their kept rows are decoded and appended again to the emptied chunk instead.
+void InsertOrderFragmenter::vacuum_encoded_rows(
+    const FragmentInfo& fragment,
+    const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+    const std::vector<uint64_t>& frag_offsets,
+    int8_t& has_null,
+    int64_t& min,
+    int64_t& max) {
+  const auto& col_type = chunk->getColumnDesc()->columnType;
+  auto data_buffer = chunk->getBuffer();
+  auto encoder = data_buffer->getEncoder();
+  const size_t element_size = col_type.get_logical_size();
+  const auto nrows_in_fragment = fragment.getPhysicalNumTuples();
+  const auto nrows_to_keep = nrows_in_fragment - frag_offsets.size();
+
+  auto chunk_metadata = std::make_shared<ChunkMetadata>();
+  encoder->getMetadata(chunk_metadata);
+  auto chunk_iter = chunk->begin_iterator(chunk_metadata);
+  std::vector<int8_t> kept_rows(nrows_to_keep * element_size);
+  size_t irow_to_fill = 0;
+  size_t irow_to_vacuum = 0;
+  for (size_t irow = 0; irow < nrows_in_fragment; ++irow) {
+    if (irow_to_vacuum < frag_offsets.size() && frag_offsets[irow_to_vacuum] == irow) {
+      ++irow_to_vacuum;
+      continue;
+    }
+    VarlenDatum vd;
+    bool is_end;
+    ChunkIter_get_nth(&chunk_iter, irow, true, &vd, &is_end);
+    CHECK(!is_end);
+    CHECK_EQ(vd.length, element_size);
+    std::memcpy(kept_rows.data() + irow_to_fill * element_size, vd.pointer, element_size);
+    ++irow_to_fill;
+    if (vd.is_null) {
+      has_null = has_null || !col_type.get_notnull();
+      continue;
+    }
+    int64_t v;
+    switch (element_size) {
+      case 1:
+        v = *reinterpret_cast<const int8_t*>(vd.pointer);
+        break;
+      case 2:
+        v = *reinterpret_cast<const int16_t*>(vd.pointer);
+        break;
+      case 4:
+        v = *reinterpret_cast<const int32_t*>(vd.pointer);
+        break;
+      default:
+        v = *reinterpret_cast<const int64_t*>(vd.pointer);
+        break;
+    }
+    set_minmax(min, max, v);
+  }
+  CHECK_EQ(irow_to_fill, nrows_to_keep);
+
+  data_buffer->setSize(0);
+  encoder->setNumElems(0);
+  if (nrows_to_keep) {
+    auto src = kept_rows.data();
+    encoder->appendData(src, nrows_to_keep, col_type);
+  }
+  data_buffer->setUpdated();
+}
+
 void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalog,
                                         const TableDescriptor* td,
                                         const int fragment_id,
@@ -1249,8 +1331,26 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
       set_chunk_metadata(catalog, fragment, chunk, nrows_to_keep, updel_roll);
     };
 
+    auto encoded_vacuum = [=,
+                           &has_null_per_thread,
+                           &min_int64t_per_thread,
+                           &max_int64t_per_thread,
+                           &updel_roll,
+                           &frag_offsets,
+                           &fragment] {
+      vacuum_encoded_rows(fragment,
+                          chunk,
+                          frag_offsets,
+                          has_null_per_thread[ci],
+                          min_int64t_per_thread[ci],
+                          max_int64t_per_thread[ci]);
+      set_chunk_metadata(catalog, fragment, chunk, nrows_to_keep, updel_roll);
+    };
+
     if (is_varlen) {
       threads.emplace_back(std::async(std::launch::async, varlen_vacuum));
+    } else if (is_row_encoded(col_type)) {
+      threads.emplace_back(std::async(std::launch::async, encoded_vacuum));
     } else {
       threads.emplace_back(std::async(std::launch::async, fixlen_vacuum));
     }
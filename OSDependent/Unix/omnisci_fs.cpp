@@ -69,4 +69,14 @@ void close(const int fd) {
   ::close(fd);
 }
 
+void release_pages(void* addr, const size_t length) {
+  const auto page_size = static_cast<uintptr_t>(get_page_size());
+  const auto begin =
+      (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+  const auto end = (reinterpret_cast<uintptr_t>(addr) + length) & ~(page_size - 1);
+  if (begin < end) {
+    CHECK_EQ(0, madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED));
+  }
+}
+
 }  // namespace omnisci
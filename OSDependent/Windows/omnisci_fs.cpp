@@ -75,4 +75,15 @@ int get_page_size() {
   return 4096;  // TODO: reasonable guess for now
 }
 
+void release_pages(void* addr, const size_t length) {
+  const auto page_size = static_cast<uintptr_t>(get_page_size());
+  const auto begin =
+      (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+  const auto end = (reinterpret_cast<uintptr_t>(addr) + length) & ~(page_size - 1);
+  if (begin < end) {
+    // Best effort, only succeeds for memory allocated with VirtualAlloc
+    VirtualAlloc(reinterpret_cast<void*>(begin), end - begin, MEM_RESET, PAGE_READWRITE);
+  }
+}
+
 }  // namespace omnisci
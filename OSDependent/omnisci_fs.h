@@ -36,4 +36,8 @@ void close(const int fd);
 
 int get_page_size();
 
+// Gives the physical memory of the whole pages within [addr, addr + length) back to the
+// OS while keeping them mapped. Their content is lost.
+void release_pages(void* addr, const size_t length);
+
 }  // namespace omnisci
@@ -45,6 +45,7 @@
 #include "Catalog/Catalog.h"
 #include "Catalog/DataframeTableDescriptor.h"
 #include "Catalog/SharedDictionaryValidator.h"
+#include "DataMgr/FileMgr/PageCompression.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Fragmenter/SortedOrderFragmenter.h"
 #include "Fragmenter/TargetValueConvertersFactories.h"
@@ -2122,6 +2123,19 @@ decltype(auto) get_sort_column_def(TableDescriptor& td,
   });
 }
 
+decltype(auto) get_page_compression_def(TableDescriptor& td,
+                                        const NameValueAssign* p,
+                                        const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<StringLiteral>(p, [&td](const auto compression_uc) {
+    // Throws if the compression isn't supported
+    const auto compression =
+        File_Namespace::page_compression_from_string(compression_uc);
+    td.pageCompression = compression == File_Namespace::PageCompression::NONE
+                             ? ""
+                             : File_Namespace::to_string(compression);
+  });
+}
+
 static const std::map<const std::string, const TableDefFuncPtr> tableDefFuncMap = {
     {"fragment_size"s, get_frag_size_def},
     {"max_chunk_size"s, get_max_chunk_size_def},
@@ -2131,6 +2145,7 @@ static const std::map<const std::string, const TableDefFuncPtr> tableDefFuncMap
     {"shard_count"s, get_shard_count_def},
     {"vacuum"s, get_vacuum_def},
     {"sort_column"s, get_sort_column_def},
+    {"page_compression"s, get_page_compression_def},
     {"storage_type"s, get_storage_type}};
 
 void get_table_definitions(TableDescriptor& td,
@@ -2141,7 +2156,8 @@ void get_table_definitions(TableDescriptor& td,
     throw std::runtime_error(
         "Invalid CREATE TABLE option " + *p->get_name() +
         ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, MAX_ROWS, "
-        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, or STORAGE_TYPE.");
+        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, PAGE_COMPRESSION, or "
+        "STORAGE_TYPE.");
   }
   return it->second(td, p.get(), columns);
 }
@@ -2154,8 +2170,8 @@ void get_table_definitions_for_ctas(TableDescriptor& td,
     throw std::runtime_error(
         "Invalid CREATE TABLE AS option " + *p->get_name() +
         ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, MAX_ROWS, "
-        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, STORAGE_TYPE or "
-        "USE_SHARED_DICTIONARIES.");
+        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, PAGE_COMPRESSION, STORAGE_TYPE "
+        "or USE_SHARED_DICTIONARIES.");
   }
   return it->second(td, p.get(), columns);
 }
@@ -2963,6 +2979,10 @@ void InsertIntoTableAsSelectStmt::populateData(QueryStateProxy query_state_proxy
     }
     leafs_connector_->checkpoint(*session, td->tableId);
   }
+
+  // invalidate cached hashtable
+  InsertTriggeredCacheInvalidator::invalidateCachesByTable(catalog.getCurrentDB().dbId,
+                                                           td->tableId);
 }
 
 void InsertIntoTableAsSelectStmt::execute(const Catalog_Namespace::SessionInfo& session) {
@@ -3145,10 +3165,12 @@ void DropTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
 
   auto table_data_write_lock =
       lockmgr::TableDataLockMgr::getWriteLockForTable(catalog, *table);
+  const auto table_id = td->tableId;
   catalog.dropTable(td);
 
   // invalidate cached hashtable
-  DeleteTriggeredCacheInvalidator::invalidateCaches();
+  DeleteTriggeredCacheInvalidator::invalidateCachesByTable(catalog.getCurrentDB().dbId,
+                                                           table_id);
 }
 
 void TruncateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
@@ -3185,10 +3207,12 @@ void TruncateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   }
   auto table_data_write_lock =
       lockmgr::TableDataLockMgr::getWriteLockForTable(catalog, *table);
+  const auto table_id = td->tableId;
   catalog.truncateTable(td);
 
   // invalidate cached hashtable
-  DeleteTriggeredCacheInvalidator::invalidateCaches();
+  DeleteTriggeredCacheInvalidator::invalidateCachesByTable(catalog.getCurrentDB().dbId,
+                                                           table_id);
 }
 
 void check_alter_table_privilege(const Catalog_Namespace::SessionInfo& session,
@@ -3530,7 +3554,8 @@ void DropColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   }
 
   // invalidate cached hashtable
-  DeleteTriggeredCacheInvalidator::invalidateCaches();
+  DeleteTriggeredCacheInvalidator::invalidateCachesByTable(catalog.getCurrentDB().dbId,
+                                                           td->tableId);
 }
 
 void RenameColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
@@ -3918,6 +3943,10 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
       });
       total_time += ms;
 
+      // invalidate cached hashtable
+      InsertTriggeredCacheInvalidator::invalidateCachesByTable(
+          catalog.getCurrentDB().dbId, td->tableId);
+
       // results
       if (load_truncated || rows_rejected > copy_params.max_reject) {
         LOG(ERROR) << "COPY exited early due to reject records count during multi file "
@@ -22,6 +22,11 @@ class CacheInvalidator {
  public:
   static void invalidateCaches() { internalInvalidateCache<CACHE_HOLDING_TYPES...>(); }
 
+  // Only drops the entries derived from the given table.
+  static void invalidateCachesByTable(const int db_id, const int table_id) {
+    (CACHE_HOLDING_TYPES::yieldCacheInvalidator(db_id, table_id)(), ...);
+  }
+
  private:
   CacheInvalidator() = delete;
   ~CacheInvalidator() = delete;
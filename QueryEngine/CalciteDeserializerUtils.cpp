@@ -37,6 +37,8 @@ SQLTypeInfo get_agg_type(const SQLAgg agg_kind, const Analyzer::Expr* arg_expr)
       return SQLTypeInfo(kDOUBLE, false);
     case kAPPROX_COUNT_DISTINCT:
       return SQLTypeInfo(kBIGINT, false);
+    case kAPPROX_PERCENTILE:
+      return SQLTypeInfo(kDOUBLE, false);
     case kSINGLE_VALUE:
       if (arg_expr->get_type_info().is_varlen()) {
         throw std::runtime_error("SINGLE_VALUE not supported on '" +
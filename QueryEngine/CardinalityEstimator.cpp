@@ -98,7 +98,8 @@ RelAlgExecutionUnit create_ndv_execution_unit(const RelAlgExecutionUnit& ra_exe_
           0,
           false,
           ra_exe_unit.union_all,
-          ra_exe_unit.query_state};
+          ra_exe_unit.query_state,
+          ra_exe_unit.full_join_matched_rows};
 }
 
 RelAlgExecutionUnit create_count_all_execution_unit(
@@ -116,7 +117,8 @@ RelAlgExecutionUnit create_count_all_execution_unit(
           0,
           false,
           ra_exe_unit.union_all,
-          ra_exe_unit.query_state};
+          ra_exe_unit.query_state,
+          ra_exe_unit.full_join_matched_rows};
 }
 
 ResultSetPtr reduce_estimator_results(
@@ -0,0 +1,215 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ChunkPrefetcher.h"
+
+#include <map>
+
+#include "Catalog/Catalog.h"
+#include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
+#include "QueryEngine/ExecutionKernel.h"
+#include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+
+bool g_enable_chunk_prefetch{true};
+size_t g_chunk_prefetch_look_ahead_bytes{size_t(1) << 30};
+
+std::unique_ptr<ChunkPrefetcher> ChunkPrefetcher::create(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+    const std::set<std::pair<int, int>>& columns_to_fetch,
+    const Catalog_Namespace::Catalog& cat) {
+  // A single kernel has nothing to overlap its reads with
+  if (!g_enable_chunk_prefetch || kernels.size() < 2) {
+    return nullptr;
+  }
+  std::map<int, const TableFragments*> all_tables_fragments;
+  QueryFragmentDescriptor::computeAllTablesFragments(
+      all_tables_fragments, ra_exe_unit, query_infos);
+  auto& data_mgr = cat.getDataMgr();
+  const int db_id = cat.getCurrentDB().dbId;
+  std::vector<PrefetchChunk> chunks;
+  std::set<ChunkKey> seen_keys;
+  for (size_t kernel_idx = 0; kernel_idx < kernels.size(); ++kernel_idx) {
+    for (const auto& table_frags : kernels[kernel_idx]->getFragmentsList()) {
+      const int table_id = table_frags.table_id;
+      const auto fragments_it = all_tables_fragments.find(table_id);
+      if (table_id < 0 || fragments_it == all_tables_fragments.end()) {
+        continue;
+      }
+      const auto fragments = fragments_it->second;
+      for (const auto frag_id : table_frags.fragment_ids) {
+        CHECK_LT(frag_id, fragments->size());
+        const auto& fragment = (*fragments)[frag_id];
+        if (fragment.isEmptyPhysicalFragment()) {
+          continue;
+        }
+        for (const auto& col_desc : ra_exe_unit.input_col_descs) {
+          const int col_id = col_desc->getColId();
+          if (col_desc->getScanDesc().getTableId() != table_id ||
+              col_desc->getScanDesc().getSourceType() != InputSourceType::TABLE ||
+              !columns_to_fetch.count(std::make_pair(table_id, col_id))) {
+            continue;
+          }
+          const auto cd = cat.getMetadataForColumn(table_id, col_id);
+          if (!cd || cd->isVirtualCol || cd->columnType.is_varlen()) {
+            continue;
+          }
+          const auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
+          if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
+            continue;
+          }
+          ChunkKey chunk_key{
+              db_id, fragment.physicalTableId, col_id, fragment.fragmentId};
+          if (!seen_keys.insert(chunk_key).second ||
+              data_mgr.isBufferOnDevice(chunk_key, Data_Namespace::CPU_LEVEL, 0)) {
+            continue;
+          }
+          chunks.push_back({chunk_key,
+                            chunk_meta_it->second->numBytes,
+                            kernel_idx,
+                            ChunkState::Pending,
+                            false,
+                            nullptr});
+        }
+      }
+    }
+  }
+  if (chunks.empty()) {
+    return nullptr;
+  }
+  VLOG(1) << "Prefetching " << chunks.size() << " chunks for " << kernels.size()
+          << " kernels";
+  return std::unique_ptr<ChunkPrefetcher>(
+      new ChunkPrefetcher(&data_mgr, std::move(chunks), kernels.size()));
+}
+
+ChunkPrefetcher::ChunkPrefetcher(Data_Namespace::DataMgr* data_mgr,
+                                 std::vector<PrefetchChunk> chunks,
+                                 const size_t kernel_count)
+    : data_mgr_(data_mgr)
+    , chunks_(std::move(chunks))
+    , kernel_chunks_begin_(kernel_count + 1, 0)
+    , next_chunk_idx_(0)
+    , outstanding_bytes_(0)
+    , stop_(false) {
+  for (const auto& chunk : chunks_) {
+    CHECK_LT(chunk.kernel_idx, kernel_count);
+    ++kernel_chunks_begin_[chunk.kernel_idx + 1];
+  }
+  for (size_t i = 1; i <= kernel_count; ++i) {
+    kernel_chunks_begin_[i] += kernel_chunks_begin_[i - 1];
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+ChunkPrefetcher::~ChunkPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+  // The kernels which didn't start, e.g. after an interrupt, leave their chunks pinned
+  for (auto& chunk : chunks_) {
+    if (chunk.buffer) {
+      chunk.buffer->unPin();
+      chunk.buffer = nullptr;
+    }
+  }
+}
+
+void ChunkPrefetcher::onKernelStart(const size_t kernel_idx) {
+  CHECK_LT(kernel_idx + 1, kernel_chunks_begin_.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = kernel_chunks_begin_[kernel_idx];
+         i < kernel_chunks_begin_[kernel_idx + 1];
+         ++i) {
+      auto& chunk = chunks_[i];
+      chunk.kernel_started = true;
+      if (chunk.state == ChunkState::Loading || chunk.state == ChunkState::Loaded) {
+        CHECK_GE(outstanding_bytes_, chunk.num_bytes);
+        outstanding_bytes_ -= chunk.num_bytes;
+        ++stats_.hits;
+        // The pin of a chunk still loading is released by run()
+        if (chunk.buffer) {
+          chunk.buffer->unPin();
+          chunk.buffer = nullptr;
+        }
+      } else {
+        // The kernel reads it itself
+        chunk.state = ChunkState::Skipped;
+        ++stats_.misses;
+      }
+    }
+  }
+  cv_.notify_one();
+}
+
+ChunkPrefetcher::Stats ChunkPrefetcher::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void ChunkPrefetcher::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_ && next_chunk_idx_ < chunks_.size()) {
+    auto& chunk = chunks_[next_chunk_idx_];
+    if (chunk.state != ChunkState::Pending) {
+      ++next_chunk_idx_;
+      continue;
+    }
+    // Always allow one chunk in flight, even if it's larger than the look-ahead
+    if (outstanding_bytes_ &&
+        outstanding_bytes_ + chunk.num_bytes > g_chunk_prefetch_look_ahead_bytes) {
+      cv_.wait(lock);
+      continue;
+    }
+    chunk.state = ChunkState::Loading;
+    outstanding_bytes_ += chunk.num_bytes;
+    ++next_chunk_idx_;
+    lock.unlock();
+    Data_Namespace::AbstractBuffer* buffer{nullptr};
+    try {
+      buffer = data_mgr_->getChunkBuffer(
+          chunk.key, Data_Namespace::CPU_LEVEL, 0, chunk.num_bytes);
+      CHECK(buffer);
+    } catch (const std::exception& e) {
+      // Most likely the CPU buffer pool is full, leave the rest to the kernels
+      VLOG(1) << "Stopping chunk prefetch: " << e.what();
+      lock.lock();
+      if (chunk.kernel_started) {
+        --stats_.hits;
+        ++stats_.misses;
+      } else {
+        outstanding_bytes_ -= chunk.num_bytes;
+      }
+      chunk.state = ChunkState::Skipped;
+      break;
+    }
+    lock.lock();
+    chunk.state = ChunkState::Loaded;
+    ++stats_.prefetched_chunks;
+    // getChunkBuffer pinned the buffer, the pin is kept until the kernel starts
+    if (chunk.kernel_started) {
+      buffer->unPin();
+    } else {
+      chunk.buffer = buffer;
+    }
+  }
+}
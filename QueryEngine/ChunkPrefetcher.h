@@ -0,0 +1,123 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkPrefetcher.h
+ * @brief   Loads the chunks the execution kernels of a query are going to scan into the
+ *          CPU buffer pool ahead of them.
+ *
+ * Once the kernels of a query step are created, the chunks of their fragments which
+ * aren't in the CPU buffer pool yet are listed in dispatch order. Every chunk belongs to
+ * the first kernel which needs it. A background thread loads them one after the other,
+ * so that the reads for later kernels overlap with the execution of the earlier ones.
+ * The prefetcher never gets further ahead of the kernels than
+ * g_chunk_prefetch_look_ahead_bytes: the bytes of a chunk count against the look-ahead
+ * from the time its load starts until its kernel starts. The loaded chunks stay pinned
+ * until then too, so that the buffer pool doesn't evict them before their kernels fetch
+ * them.
+ *
+ * A kernel which starts before its chunks have been loaded reads them itself and the
+ * prefetcher skips them. The chunks found loaded, or being loaded, by their kernels are
+ * the hits of the prefetcher, the others are its misses.
+ *
+ * Only fixed width columns of physical tables are prefetched.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "DataMgr/DataMgr.h"
+
+extern bool g_enable_chunk_prefetch;
+extern size_t g_chunk_prefetch_look_ahead_bytes;
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+class ExecutionKernel;
+struct InputTableInfo;
+struct RelAlgExecutionUnit;
+
+class ChunkPrefetcher {
+ public:
+  struct Stats {
+    size_t prefetched_chunks{0};
+    size_t hits{0};
+    size_t misses{0};
+  };
+
+  // Returns null if prefetching is disabled or there's nothing to prefetch for the
+  // kernels, i.e. all their chunks are already in the CPU buffer pool.
+  static std::unique_ptr<ChunkPrefetcher> create(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& query_infos,
+      const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+      const std::set<std::pair<int, int>>& columns_to_fetch,
+      const Catalog_Namespace::Catalog& cat);
+
+  ~ChunkPrefetcher();
+
+  ChunkPrefetcher(const ChunkPrefetcher&) = delete;
+  ChunkPrefetcher& operator=(const ChunkPrefetcher&) = delete;
+
+  // Called right before the kernel at kernel_idx in the dispatch order fetches its
+  // chunks, releases the pins of the ones prefetched for it.
+  void onKernelStart(const size_t kernel_idx);
+
+  Stats getStats() const;
+
+ private:
+  enum class ChunkState { Pending, Loading, Loaded, Skipped };
+
+  struct PrefetchChunk {
+    ChunkKey key;
+    size_t num_bytes;
+    size_t kernel_idx;
+    ChunkState state;
+    bool kernel_started;
+    // Pinned buffer of a Loaded chunk until its kernel starts
+    Data_Namespace::AbstractBuffer* buffer;
+  };
+
+  ChunkPrefetcher(Data_Namespace::DataMgr* data_mgr,
+                  std::vector<PrefetchChunk> chunks,
+                  const size_t kernel_count);
+
+  void run();
+
+  Data_Namespace::DataMgr* data_mgr_;
+  // In dispatch order, the chunks of kernel i start at kernel_chunks_begin_[i]
+  std::vector<PrefetchChunk> chunks_;
+  std::vector<size_t> kernel_chunks_begin_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t next_chunk_idx_;
+  // Bytes of the chunks loaded, or being loaded, whose kernels haven't started yet
+  size_t outstanding_bytes_;
+  bool stop_;
+  Stats stats_;
+
+  std::thread thread_;
+};
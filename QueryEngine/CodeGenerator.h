@@ -21,6 +21,8 @@
 #include "../Analyzer/Analyzer.h"
 #include "Execute.h"
 
+class PersistentObjectCache;
+
 // Code generation utility to be used for queries and scalar expressions.
 class CodeGenerator {
  public:
@@ -70,10 +72,13 @@ class CodeGenerator {
       const std::vector<llvm::Function*>& roots,
       const std::vector<llvm::Function*>& leaves);
 
+  // If object_cache holds object code for the module, IR optimization and machine code
+  // generation are skipped and the cached code is loaded instead.
   static ExecutionEngineWrapper generateNativeCPUCode(
       llvm::Function* func,
       const std::unordered_set<llvm::Function*>& live_funcs,
-      const CompilationOptions& co);
+      const CompilationOptions& co,
+      PersistentObjectCache* object_cache = nullptr);
 
   static std::string generatePTX(const std::string& cuda_llir,
                                  llvm::TargetMachine* nvptx_target_machine,
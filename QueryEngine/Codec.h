@@ -53,16 +53,34 @@ class FixedWidthUnsigned : public Decoder {
   const size_t byte_width_;
 };
 
+// Decodes DIFF (frame-of-reference) encoded chunks, the baseline is read from the
+// chunk header at runtime. Deltas equal to null_val are decoded to ret_null_val.
 class DiffFixedWidthInt : public Decoder {
  public:
-  DiffFixedWidthInt(const size_t byte_width, const int64_t baseline);
+  DiffFixedWidthInt(const size_t byte_width,
+                    const int64_t null_val,
+                    const int64_t ret_null_val);
+  llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
+                                   llvm::Value* pos,
+                                   llvm::Module* module) const override;
+
+ private:
+  const size_t byte_width_;
+  const int64_t null_val_;
+  const int64_t ret_null_val_;
+};
+
+// Decodes run-length encoded chunks of byte_width wide values, searching the run ends
+// from an interpolated guess. Plain chunks are read like FIXED encoded ones.
+class RunLengthInt : public Decoder {
+ public:
+  RunLengthInt(const size_t byte_width);
   llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
                                    llvm::Value* pos,
                                    llvm::Module* module) const override;
 
  private:
   const size_t byte_width_;
-  const int64_t baseline_;
 };
 
 class FixedWidthReal : public Decoder {
@@ -116,6 +116,11 @@ JoinColumn ColumnFetcher::makeJoinColumn(
     std::vector<std::shared_ptr<void>>& malloc_owner,
     ColumnCacheMap& column_cache) {
   CHECK(!fragments.empty());
+  const auto compression = hash_col.get_type_info().get_compression();
+  if (compression == kENCODING_RL || compression == kENCODING_DIFF) {
+    throw ColumnarConversionNotSupported(
+        "Hash join columns cannot be RL or DIFF encoded");
+  }
 
   size_t col_chunks_buff_sz = sizeof(struct JoinChunk) * fragments.size();
   // TODO: needs an allocator owner
@@ -94,6 +94,11 @@ ColumnarResults::ColumnarResults(std::shared_ptr<RowSetMemoryOwner> row_set_mem_
   if (is_varlen) {
     throw ColumnarConversionNotSupported();
   }
+  if (target_type.get_compression() == kENCODING_RL ||
+      target_type.get_compression() == kENCODING_DIFF) {
+    throw ColumnarConversionNotSupported(
+        "Columnar conversion not supported for RL or DIFF encoded columns");
+  }
   const auto buf_size = num_rows * target_type.get_size();
   column_buffers_[0] = reinterpret_cast<int8_t*>(row_set_mem_owner->allocate(buf_size));
   memcpy(((void*)column_buffers_[0]), one_col_buffer, buf_size);
@@ -29,6 +29,8 @@ class ColumnarConversionNotSupported : public std::runtime_error {
   ColumnarConversionNotSupported()
       : std::runtime_error(
             "Columnar conversion not supported for variable length types") {}
+  ColumnarConversionNotSupported(const std::string& reason)
+      : std::runtime_error(reason) {}
 };
 
 /**
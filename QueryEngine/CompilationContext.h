@@ -22,6 +22,8 @@
 
 #include <memory>
 
+#include "Logger/Logger.h"
+
 class CompilationContext {
  public:
   virtual ~CompilationContext() {}
@@ -63,6 +65,12 @@ class CpuCompilationContext : public CompilationContext {
   CpuCompilationContext(ExecutionEngineWrapper&& execution_engine)
       : execution_engine_(std::move(execution_engine)) {}
 
+  // For code generated outside of the global LLVM context, the context the module of
+  // the engine lives in.
+  CpuCompilationContext(ExecutionEngineWrapper&& execution_engine,
+                        std::unique_ptr<llvm::LLVMContext> context)
+      : context_(std::move(context)), execution_engine_(std::move(execution_engine)) {}
+
   void setFunctionPointer(llvm::Function* function) {
     func_ = execution_engine_->getPointerToFunction(function);
     CHECK(func_);
@@ -72,5 +80,7 @@ class CpuCompilationContext : public CompilationContext {
 
  private:
   void* func_{nullptr};
+  // Declared before the engine, which must be destroyed first.
+  std::unique_ptr<llvm::LLVMContext> context_;
   ExecutionEngineWrapper execution_engine_;
 };
@@ -27,6 +27,7 @@
 
 #include "Descriptors/CountDistinctDescriptor.h"
 #include "HyperLogLog.h"
+#include "HyperLogLogSketch.h"
 
 #include <bitset>
 #include <set>
@@ -93,6 +94,9 @@ inline int64_t count_distinct_set_size(
     }
     return bitmap_set_size(set_vals, count_distinct_desc.bitmapSizeBytes());
   }
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::HllSketch) {
+    return reinterpret_cast<const HllSketch*>(set_handle)->cardinality();
+  }
   CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
   return reinterpret_cast<std::set<int64_t>*>(set_handle)->size();
 }
@@ -141,6 +145,11 @@ inline void count_distinct_set_union(
                                       : old_count_distinct_desc.bitmapPaddedSizeBytes();
       bitmap_set_union(new_set, old_set, bitmap_byte_sz);
     }
+  } else if (new_count_distinct_desc.impl_type_ == CountDistinctImplType::HllSketch) {
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::HllSketch);
+    auto old_sketch = reinterpret_cast<HllSketch*>(old_set_handle);
+    auto new_sketch = reinterpret_cast<const HllSketch*>(new_set_handle);
+    old_sketch->merge(*new_sketch);
   } else {
     CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
     auto old_set = reinterpret_cast<std::set<int64_t>*>(old_set_handle);
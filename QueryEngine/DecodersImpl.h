@@ -25,6 +25,7 @@
 #define QUERYENGINE_DECODERSIMPL_H
 
 #include <cstdint>
+#include "../Shared/EncodedChunkLayout.h"
 #include "../Shared/funcannotations.h"
 
 extern "C" DEVICE ALWAYS_INLINE int64_t
@@ -93,12 +94,44 @@ SUFFIX(fixed_width_unsigned_decode_noinline)(const int8_t* byte_stream,
   return SUFFIX(fixed_width_unsigned_decode)(byte_stream, byte_width, pos);
 }
 
+// DIFF encoded chunks start with the frame of reference, see EncodedChunkLayout.h.
 extern "C" DEVICE ALWAYS_INLINE int64_t
 SUFFIX(diff_fixed_width_int_decode)(const int8_t* byte_stream,
                                     const int32_t byte_width,
-                                    const int64_t baseline,
+                                    const int64_t null_val,
+                                    const int64_t ret_null_val,
                                     const int64_t pos) {
-  return SUFFIX(fixed_width_int_decode)(byte_stream, byte_width, pos) + baseline;
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  return for_decode_at(byte_stream, byte_width, null_val, ret_null_val, pos);
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(diff_fixed_width_int_decode_noinline)(const int8_t* byte_stream,
+                                             const int32_t byte_width,
+                                             const int64_t null_val,
+                                             const int64_t ret_null_val,
+                                             const int64_t pos) {
+  return SUFFIX(diff_fixed_width_int_decode)(
+      byte_stream, byte_width, null_val, ret_null_val, pos);
+}
+
+extern "C" DEVICE ALWAYS_INLINE int64_t
+SUFFIX(run_length_int_decode)(const int8_t* byte_stream,
+                              const int32_t byte_width,
+                              const int64_t pos) {
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0 && pos < rle_chunk_header(byte_stream)->num_rows);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  return rle_decode_at(byte_stream, byte_width, pos);
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(run_length_int_decode_noinline)(const int8_t* byte_stream,
+                                       const int32_t byte_width,
+                                       const int64_t pos) {
+  return SUFFIX(run_length_int_decode)(byte_stream, byte_width, pos);
 }
 
 extern "C" DEVICE ALWAYS_INLINE float SUFFIX(
@@ -38,7 +38,9 @@ inline size_t bitmap_bits_to_bytes(const size_t bitmap_sz) {
   return bitmap_byte_sz;
 }
 
-enum class CountDistinctImplType { Invalid, Bitmap, StdSet };
+// HllSketch is a pointer to a sparse-to-dense HllSketch, used by approximate count
+// distinct in CPU group by queries.
+enum class CountDistinctImplType { Invalid, Bitmap, StdSet, HllSketch };
 
 struct CountDistinctDescriptor {
   CountDistinctImplType impl_type_;
@@ -100,6 +100,7 @@ void QueryFragmentDescriptor::buildFragmentKernelMap(
                               device_count,
                               num_bytes_for_row,
                               device_type,
+                              enable_inner_join_fragment_skipping,
                               executor);
   }
 }
@@ -114,6 +115,7 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
     const ChunkMetadataVector& deleted_chunk_metadata_vec,
     const std::optional<size_t> table_desc_offset,
     const ExecutorDeviceType& device_type,
+    const bool enable_inner_join_fragment_skipping,
     Executor* executor) {
   auto get_fragment_tuple_count =
       [&deleted_chunk_metadata_vec](const auto& fragment) -> std::optional<size_t> {
@@ -145,11 +147,20 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
     }
 
     const auto& fragment = (*fragments)[i];
-    const auto skip_frag = executor->skipFragment(
-        table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
+    const auto skip_frag = executor->skipFragment(table_desc,
+                                                  fragment,
+                                                  ra_exe_unit.simple_quals,
+                                                  frag_offsets,
+                                                  i,
+                                                  ra_exe_unit.quals);
     if (skip_frag.first) {
       continue;
     }
+    if (enable_inner_join_fragment_skipping && skip_frag.second < 0 &&
+        executor->joinKeysExclude(table_desc, ra_exe_unit, fragment)) {
+      ++join_key_skipped_fragments_;
+      continue;
+    }
     rowid_lookup_key_ = std::max(rowid_lookup_key_, skip_frag.second);
     const int chosen_device_count =
         device_type == ExecutorDeviceType::CPU ? 1 : device_count;
@@ -244,6 +255,7 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMapForUnion(
                                    {},
                                    j,
                                    device_type,
+                                   /*enable_inner_join_fragment_skipping=*/false,
                                    executor);
 
     std::vector<int> table_ids =
@@ -267,6 +279,7 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
     const int device_count,
     const size_t num_bytes_for_row,
     const ExecutorDeviceType& device_type,
+    const bool enable_inner_join_fragment_skipping,
     Executor* executor) {
   const auto& outer_table_desc = ra_exe_unit.input_descs.front();
   const int outer_table_id = outer_table_desc.getTableId();
@@ -300,6 +313,7 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
                                  deleted_chunk_metadata_vec,
                                  std::nullopt,
                                  device_type,
+                                 enable_inner_join_fragment_skipping,
                                  executor);
 }
 
@@ -339,7 +353,8 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
                                             fragment,
                                             ra_exe_unit.simple_quals,
                                             frag_offsets,
-                                            outer_frag_id);
+                                            outer_frag_id,
+                                            ra_exe_unit.quals);
     if (enable_inner_join_fragment_skipping &&
         (skip_frag == std::pair<bool, int64_t>(false, -1))) {
       skip_frag = executor->skipFragmentInnerJoins(
@@ -348,6 +363,11 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
     if (skip_frag.first) {
       continue;
     }
+    if (enable_inner_join_fragment_skipping && skip_frag.second < 0 &&
+        executor->joinKeysExclude(outer_table_desc, ra_exe_unit, fragment)) {
+      ++join_key_skipped_fragments_;
+      continue;
+    }
     const int device_id =
         fragment.shard == -1
             ? fragment.deviceIds[static_cast<int>(Data_Namespace::GPU_LEVEL)]
@@ -142,10 +142,15 @@ class QueryFragmentDescriptor {
     return rowid_lookup_key_ < 0 && !execution_kernels_per_device_.empty();
   }
 
+  // Outer fragments skipped because their join column has none of the keys of the hash
+  // table of an inner join.
+  size_t getJoinKeySkippedFragmentCount() const { return join_key_skipped_fragments_; }
+
  protected:
   std::vector<size_t> allowed_outer_fragment_indices_;
   size_t outer_fragments_size_ = 0;
   int64_t rowid_lookup_key_ = -1;
+  size_t join_key_skipped_fragments_ = 0;
 
   std::map<int, const TableFragments*> selected_tables_fragments_;
 
@@ -167,6 +172,7 @@ class QueryFragmentDescriptor {
                                  const int device_count,
                                  const size_t num_bytes_for_row,
                                  const ExecutorDeviceType& device_type,
+                                 const bool enable_inner_join_fragment_skipping,
                                  Executor* executor);
 
   void buildMultifragKernelMap(const RelAlgExecutionUnit& ra_exe_unit,
@@ -187,6 +193,7 @@ class QueryFragmentDescriptor {
       const ChunkMetadataVector& deleted_chunk_metadata_vec,
       const std::optional<size_t> table_desc_offset,
       const ExecutorDeviceType& device_type,
+      const bool enable_inner_join_fragment_skipping,
       Executor* executor);
 
   bool terminateDispatchMaybe(size_t& tuple_count,
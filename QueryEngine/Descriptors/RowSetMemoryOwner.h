@@ -28,6 +28,8 @@
 #include "DataMgr/Allocators/ArenaAllocator.h"
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
+#include "QueryEngine/HyperLogLogSketch.h"
+#include "QueryEngine/TDigest.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 
 class ResultSet;
@@ -70,6 +72,16 @@ class RowSetMemoryOwner : boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
+  void addCountDistinctSketch(HllSketch* count_distinct_sketch) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    count_distinct_sketches_.push_back(count_distinct_sketch);
+  }
+
+  void addTDigest(TDigest* tdigest) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    tdigests_.push_back(tdigest);
+  }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
@@ -147,6 +159,12 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
+    for (auto count_distinct_sketch : count_distinct_sketches_) {
+      delete count_distinct_sketch;
+    }
+    for (auto tdigest : tdigests_) {
+      delete tdigest;
+    }
     for (auto group_by_buffer : group_by_buffers_) {
       free(group_by_buffer);
     }
@@ -178,6 +196,8 @@ class RowSetMemoryOwner : boost::noncopyable {
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<HllSketch*> count_distinct_sketches_;
+  std::vector<TDigest*> tdigests_;
   std::vector<int64_t*> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
@@ -17,6 +17,7 @@
 #include "Execute.h"
 
 #include "AggregateUtils.h"
+#include "ChunkPrefetcher.h"
 #include "CodeGenerator.h"
 #include "ColumnFetcher.h"
 #include "Descriptors/QueryCompilationDescriptor.h"
@@ -44,6 +45,7 @@
 
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/ChunkValueFilter.h"
 #include "Parser/ParserNode.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/TypedDataAccessors.h"
@@ -81,6 +83,8 @@ bool g_null_div_by_zero{false};
 unsigned g_trivial_loop_join_threshold{1000};
 bool g_from_table_reordering{true};
 bool g_inner_join_fragment_skipping{true};
+bool g_enable_morsel_scheduling{false};
+size_t g_morsel_size_rows{size_t(1) << 21};
 extern bool g_enable_smem_group_by;
 extern std::unique_ptr<llvm::Module> udf_gpu_module;
 extern std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -123,6 +127,7 @@ bool g_is_test_env{false};  // operating under a unit test environment. Currentl
                             // limits the allocation for the output buffer arena
 
 extern bool g_cache_string_hash;
+extern bool g_enable_chunk_value_filters;
 
 int const Executor::max_gpu_count;
 
@@ -147,6 +152,13 @@ Executor::Executor(const ExecutorId executor_id,
     , temporary_tables_(nullptr)
     , input_table_info_cache_(this) {}
 
+Executor::~Executor() {
+  // Background code generation installs its result in this executor's code cache.
+  for (auto& task : async_codegen_tasks_) {
+    task.wait();
+  }
+}
+
 std::shared_ptr<Executor> Executor::getExecutor(
     const ExecutorId executor_id,
     const std::string& debug_dir,
@@ -169,6 +181,27 @@ std::shared_ptr<Executor> Executor::getExecutor(
   return executor;
 }
 
+size_t Executor::waitForAsyncCodegen() {
+  std::vector<std::shared_ptr<Executor>> executors;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(executors_cache_mutex_);
+    for (const auto& executor : executors_) {
+      executors.push_back(executor.second);
+    }
+  }
+  for (const auto& executor : executors) {
+    std::list<std::future<void>> tasks;
+    {
+      std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
+      tasks.swap(executor->async_codegen_tasks_);
+    }
+    for (auto& task : tasks) {
+      task.wait();
+    }
+  }
+  return async_codegen_installs_;
+}
+
 void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
   switch (memory_level) {
     case Data_Namespace::MemoryLevel::CPU_LEVEL:
@@ -1166,6 +1199,14 @@ std::string join_type_to_string(const JoinType type) {
       return "INNER";
     case JoinType::LEFT:
       return "LEFT";
+    case JoinType::RIGHT:
+      return "RIGHT";
+    case JoinType::FULL:
+      return "FULL";
+    case JoinType::SEMI:
+      return "SEMI";
+    case JoinType::ANTI:
+      return "ANTI";
     case JoinType::INVALID:
       return "INVALID";
   }
@@ -1303,7 +1344,8 @@ RelAlgExecutionUnit replace_scan_limit(const RelAlgExecutionUnit& ra_exe_unit_in
           new_scan_limit,
           ra_exe_unit_in.use_bump_allocator,
           ra_exe_unit_in.union_all,
-          ra_exe_unit_in.query_state};
+          ra_exe_unit_in.query_state,
+          ra_exe_unit_in.full_join_matched_rows};
 }
 
 }  // namespace
@@ -1345,6 +1387,9 @@ ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
     if (result) {
       result->setKernelQueueTime(kernel_queue_time_ms_);
       result->addCompilationQueueTime(compilation_queue_time_ms_);
+      result->setKernelSchedulingStats(kernel_idle_time_ms_, morsel_kernels_);
+      result->setChunkPrefetchStats(prefetched_chunks_, prefetch_hits_, prefetch_misses_);
+      result->setJoinKeySkippedFragments(join_key_skipped_fragments_);
     }
     return result;
   } catch (const CompilationRetryNewScanLimit& e) {
@@ -1364,6 +1409,9 @@ ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
     if (result) {
       result->setKernelQueueTime(kernel_queue_time_ms_);
       result->addCompilationQueueTime(compilation_queue_time_ms_);
+      result->setKernelSchedulingStats(kernel_idle_time_ms_, morsel_kernels_);
+      result->setChunkPrefetchStats(prefetched_chunks_, prefetch_hits_, prefetch_misses_);
+      result->setJoinKeySkippedFragments(join_key_skipped_fragments_);
     }
     return result;
   }
@@ -1453,6 +1501,12 @@ ResultSetPtr Executor::executeWorkUnitImpl(
 
       const auto context_count =
           get_context_count(device_type, available_cpus, available_gpus.size());
+      if (!render_info &&
+          BaselineHashPartitions::canPreaggregate(
+              ra_exe_unit, *query_mem_desc_owned, query_comp_desc_owned->getDeviceType())) {
+        shared_context.setBaselinePartitions(
+            std::make_unique<BaselineHashPartitions>(cpu_threads()));
+      }
       try {
         auto kernels = createKernels(shared_context,
                                      ra_exe_unit,
@@ -1467,6 +1521,22 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                      render_info,
                                      available_gpus,
                                      available_cpus);
+        const auto chunk_prefetcher = ChunkPrefetcher::create(
+            ra_exe_unit, query_infos, kernels, plan_state_->columns_to_fetch_, cat);
+        shared_context.setChunkPrefetcher(chunk_prefetcher.get());
+        ScopeGuard collect_prefetch_stats = [this, &shared_context, &chunk_prefetcher] {
+          shared_context.setChunkPrefetcher(nullptr);
+          if (!chunk_prefetcher) {
+            return;
+          }
+          const auto stats = chunk_prefetcher->getStats();
+          prefetched_chunks_ += stats.prefetched_chunks;
+          prefetch_hits_ += stats.hits;
+          prefetch_misses_ += stats.misses;
+          VLOG(1) << "Prefetched " << stats.prefetched_chunks
+                  << " chunks ahead of the kernels, hit rate " << stats.hits << "/"
+                  << stats.hits + stats.misses;
+        };
         if (g_use_tbb_pool) {
 #ifdef HAVE_TBB
           VLOG(1) << "Using TBB thread pool for kernel dispatch.";
@@ -1481,6 +1551,10 @@ ResultSetPtr Executor::executeWorkUnitImpl(
           launchKernels<threadpool::FuturesThreadPool<void>>(shared_context,
                                                              std::move(kernels));
         }
+        if (const auto baseline_partitions = shared_context.getBaselinePartitions()) {
+          shared_context.addDeviceResults(
+              baseline_partitions->finalize(row_set_mem_owner, this), {});
+        }
       } catch (QueryExecutionError& e) {
         if (eo.with_dynamic_watchdog && interrupted_.load() &&
             e.getErrorCode() == ERR_OUT_OF_TIME) {
@@ -1665,6 +1739,19 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
     const auto agg_info = get_target_info(target_expr, g_bigint_count);
     CHECK(agg_info.is_agg);
     target_infos.push_back(agg_info);
+    if (is_approx_percentile_target(agg_info)) {
+      // An empty digest rather than a null handle, so the slot can still be reduced.
+      const auto executor = query_mem_desc.getExecutor();
+      CHECK(executor);
+      auto row_set_mem_owner = executor->getRowSetMemoryOwner();
+      CHECK(row_set_mem_owner);
+      const auto agg_expr = static_cast<const Analyzer::AggExpr*>(target_expr);
+      CHECK(agg_expr->get_arg1());
+      auto tdigest = new TDigest(agg_expr->get_arg1()->get_constval().doubleval);
+      row_set_mem_owner->addTDigest(tdigest);
+      entry.push_back(reinterpret_cast<int64_t>(tdigest));
+      continue;
+    }
     if (g_cluster) {
       const auto executor = query_mem_desc.getExecutor();
       CHECK(executor);
@@ -1686,6 +1773,12 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
         continue;
       }
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::HllSketch) {
+        auto count_distinct_sketch = new HllSketch(count_distinct_desc.bitmap_sz_bits);
+        row_set_mem_owner->addCountDistinctSketch(count_distinct_sketch);
+        entry.push_back(reinterpret_cast<int64_t>(count_distinct_sketch));
+        continue;
+      }
     }
     const bool float_argument_input = takes_float_argument(agg_info);
     if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
@@ -1934,6 +2027,37 @@ bool has_lazy_fetched_columns(const std::vector<ColumnLazyFetchInfo>& fetched_co
   return false;
 }
 
+// Morsels cut a large outer fragment into row ranges, so that CPU threads which run out
+// of fragments can keep helping with the big ones. Grouped queries only qualify when
+// their output buffer is small next to the morsel, otherwise initializing and reducing
+// one buffer per morsel costs more than the parallelism buys.
+bool can_split_into_morsels(const RelAlgExecutionUnit& ra_exe_unit,
+                            const ExecutorDeviceType device_type,
+                            const ExecutionOptions& eo,
+                            const QueryMemoryDescriptor& query_mem_desc,
+                            const RenderInfo* render_info,
+                            const bool has_window_function) {
+  if (!g_enable_morsel_scheduling || !g_morsel_size_rows ||
+      device_type != ExecutorDeviceType::CPU ||
+      eo.executor_type != ExecutorType::Native) {
+    return false;
+  }
+  if (ra_exe_unit.union_all || ra_exe_unit.estimator || ra_exe_unit.use_bump_allocator ||
+      render_info || has_window_function) {
+    return false;
+  }
+  switch (query_mem_desc.getQueryDescriptionType()) {
+    case QueryDescriptionType::NonGroupedAggregate:
+    case QueryDescriptionType::Projection:
+      return true;
+    case QueryDescriptionType::GroupByPerfectHash:
+    case QueryDescriptionType::GroupByBaselineHash:
+      return query_mem_desc.getEntryCount() <= g_morsel_size_rows / 8;
+    default:
+      return false;
+  }
+}
+
 }  // namespace
 
 std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
@@ -1978,6 +2102,7 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                              use_multifrag_kernel,
                                              g_inner_join_fragment_skipping,
                                              this);
+  join_key_skipped_fragments_ = fragment_descriptor.getJoinKeySkippedFragmentCount();
   if (eo.with_watchdog && fragment_descriptor.shouldCheckWorkUnitWatchdog()) {
     checkWorkUnitWatchdog(ra_exe_unit, table_infos, *catalog_, device_type, device_count);
   }
@@ -2031,6 +2156,13 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
       }
     }
 
+    const bool split_into_morsels =
+        can_split_into_morsels(ra_exe_unit,
+                               device_type,
+                               eo,
+                               query_mem_desc,
+                               render_info,
+                               window_project_node_context_owned_ != nullptr);
     size_t frag_list_idx{0};
     auto fragment_per_kernel_dispatch = [&ra_exe_unit,
                                          &execution_kernels,
@@ -2040,6 +2172,8 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                          &device_type,
                                          &query_comp_desc,
                                          &query_mem_desc,
+                                         &table_infos,
+                                         split_into_morsels,
                                          render_info](const int device_id,
                                                       const FragmentsList& frag_list,
                                                       const int64_t rowid_lookup_key) {
@@ -2048,19 +2182,45 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
       }
       CHECK_GE(device_id, 0);
 
-      execution_kernels.emplace_back(
-          std::make_unique<ExecutionKernel>(ra_exe_unit,
-                                            device_type,
-                                            device_id,
-                                            eo,
-                                            column_fetcher,
-                                            query_comp_desc,
-                                            query_mem_desc,
-                                            frag_list,
-                                            ExecutorDispatchMode::KernelPerFragment,
-                                            render_info,
-                                            rowid_lookup_key));
+      auto make_kernel = [&]() {
+        return std::make_unique<ExecutionKernel>(ra_exe_unit,
+                                                 device_type,
+                                                 device_id,
+                                                 eo,
+                                                 column_fetcher,
+                                                 query_comp_desc,
+                                                 query_mem_desc,
+                                                 frag_list,
+                                                 ExecutorDispatchMode::KernelPerFragment,
+                                                 render_info,
+                                                 rowid_lookup_key);
+      };
       ++frag_list_idx;
+
+      // A kernel can only resume the scan of its outer fragment if it runs a single
+      // fragment combination, i.e. every inner table is covered by one fragment.
+      const auto& outer_frag_ids = frag_list.front().fragment_ids;
+      const bool single_combination =
+          std::all_of(frag_list.begin(), frag_list.end(), [](const auto& table_frags) {
+            return table_frags.fragment_ids.size() == 1;
+          });
+      if (split_into_morsels && rowid_lookup_key < 0 && single_combination &&
+          frag_list.front().table_id == table_infos.front().table_id) {
+        const auto& fragments = table_infos.front().info.fragments;
+        CHECK_LT(outer_frag_ids.front(), fragments.size());
+        const size_t num_tuples = fragments[outer_frag_ids.front()].getNumTuples();
+        if (num_tuples > g_morsel_size_rows) {
+          for (size_t start_row = 0; start_row < num_tuples;
+               start_row += g_morsel_size_rows) {
+            auto kernel = make_kernel();
+            const size_t end_row = std::min(start_row + g_morsel_size_rows, num_tuples);
+            kernel->setOuterRowRange(start_row, end_row);
+            execution_kernels.emplace_back(std::move(kernel));
+          }
+          return;
+        }
+      }
+      execution_kernels.emplace_back(make_kernel());
     };
 
     fragment_descriptor.assignFragsToKernelDispatch(fragment_per_kernel_dispatch,
@@ -2079,15 +2239,78 @@ void Executor::launchKernels(SharedKernelContext& shared_context,
 
   THREAD_POOL thread_pool;
   VLOG(1) << "Launching " << kernels.size() << " kernels for query.";
-  for (auto& kernel : kernels) {
+  // Queries dispatched with a thread budget run their kernels on a bounded set of
+  // workers too, so that concurrent queries don't oversubscribe the CPUs.
+  if ((g_enable_morsel_scheduling || g_query_cpu_thread_budget) && !kernels.empty() &&
+      std::all_of(kernels.begin(), kernels.end(), [](const auto& kernel) {
+        return kernel->getDeviceType() == ExecutorDeviceType::CPU;
+      })) {
+    // Each worker keeps taking the next unclaimed kernel, so a thread which finishes its
+    // share early steals the remaining morsels instead of idling until the join.
+    const size_t worker_count = std::min(static_cast<size_t>(cpu_threads()),
+                                         kernels.size());
+    std::atomic<size_t> next_kernel_idx{0};
+    std::atomic<int64_t> busy_time_us{0};
+    morsel_kernels_ +=
+        std::count_if(kernels.begin(), kernels.end(), [](const auto& kernel) {
+          return kernel->isMorsel();
+        });
+    const auto launch_begin = timer_start();
+    for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+      thread_pool.spawn(
+          [this,
+           &shared_context,
+           &kernels,
+           &next_kernel_idx,
+           &busy_time_us,
+           parent_thread_id = logger::thread_id()](const size_t) {
+            DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+            for (size_t kernel_idx = next_kernel_idx++; kernel_idx < kernels.size();
+                 kernel_idx = next_kernel_idx++) {
+              const auto kernel_begin = timer_start();
+              try {
+                CHECK(kernels[kernel_idx]);
+                if (auto chunk_prefetcher = shared_context.getChunkPrefetcher()) {
+                  chunk_prefetcher->onKernelStart(kernel_idx);
+                }
+                kernels[kernel_idx]->run(this, shared_context);
+              } catch (...) {
+                // Don't let the other workers start new kernels for a failed query.
+                next_kernel_idx = kernels.size();
+                throw;
+              }
+              busy_time_us += timer_stop<std::chrono::steady_clock::time_point,
+                                         std::chrono::microseconds>(kernel_begin);
+            }
+          },
+          worker_idx);
+    }
+    thread_pool.join();
+    // Time the workers spent waiting for the last kernels to finish, summed over them.
+    const auto wall_time_us =
+        timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+            launch_begin);
+    const int64_t idle_time_us =
+        std::max(int64_t(0),
+                 static_cast<int64_t>(wall_time_us * worker_count) -
+                     static_cast<int64_t>(busy_time_us));
+    kernel_idle_time_ms_ += idle_time_us / 1000;
+    VLOG(1) << "Ran " << kernels.size() << " kernels on " << worker_count
+            << " workers, idle time " << idle_time_us / 1000 << " ms";
+    return;
+  }
+  for (size_t kernel_idx = 0; kernel_idx < kernels.size(); ++kernel_idx) {
     thread_pool.spawn(
-        [this, &shared_context, parent_thread_id = logger::thread_id()](
+        [this, &shared_context, kernel_idx, parent_thread_id = logger::thread_id()](
             ExecutionKernel* kernel) {
           CHECK(kernel);
           DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+          if (auto chunk_prefetcher = shared_context.getChunkPrefetcher()) {
+            chunk_prefetcher->onKernelStart(kernel_idx);
+          }
           kernel->run(this, shared_context);
         },
-        kernel.get());
+        kernels[kernel_idx].get());
   }
   thread_pool.join();
 }
@@ -2775,9 +2998,10 @@ int32_t Executor::executePlanWithoutGroupBy(
       for (int i = 0; i < num_iterations; i++) {
         int64_t val1;
         const bool float_argument_input = takes_float_argument(agg_info);
-        if (is_distinct_target(agg_info)) {
+        if (is_distinct_target(agg_info) || is_approx_percentile_target(agg_info)) {
           CHECK(agg_info.agg_kind == kCOUNT ||
-                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+                agg_info.agg_kind == kAPPROX_PERCENTILE);
           val1 = out_vec[out_vec_idx][0];
           error_code = 0;
         } else {
@@ -2862,7 +3086,8 @@ int32_t Executor::executePlanWithGroupBy(
     const int64_t scan_limit,
     const uint32_t start_rowid,
     const uint32_t num_tables,
-    RenderInfo* render_info) {
+    RenderInfo* render_info,
+    BaselineHashPartitions* baseline_partitions) {
   auto timer = DEBUG_TIMER(__func__);
   INJECT_TIMER(executePlanWithGroupBy);
   CHECK(!results);
@@ -2930,18 +3155,32 @@ int32_t Executor::executePlanWithGroupBy(
     auto cpu_generated_code = std::dynamic_pointer_cast<CpuCompilationContext>(
         compilation_result.generated_code);
     CHECK(cpu_generated_code);
-    query_exe_context->launchCpuCode(
-        ra_exe_unit_copy,
-        cpu_generated_code.get(),
-        hoist_literals,
-        hoist_buf,
-        col_buffers,
-        num_rows,
-        frag_offsets,
-        ra_exe_unit_copy.union_all ? ra_exe_unit_copy.scan_limit : scan_limit,
-        &error_code,
-        num_tables,
-        join_hash_table_ptrs);
+    const auto launch_cpu_code = [&] {
+      query_exe_context->launchCpuCode(
+          ra_exe_unit_copy,
+          cpu_generated_code.get(),
+          hoist_literals,
+          hoist_buf,
+          col_buffers,
+          num_rows,
+          frag_offsets,
+          ra_exe_unit_copy.union_all ? ra_exe_unit_copy.scan_limit : scan_limit,
+          &error_code,
+          num_tables,
+          join_hash_table_ptrs);
+    };
+    launch_cpu_code();
+    // The pre-aggregation buffer ran out of slots at row -error_code of the fragment:
+    // flush its groups to the partitions and resume the scan from that row.
+    while (baseline_partitions && !render_allocator_map_ptr && error_code < 0) {
+      CHECK_EQ(num_rows.size(), size_t(1));
+      const auto buffer_rows = query_exe_context->query_buffers_->getResultSet(0);
+      CHECK(buffer_rows);
+      baseline_partitions->flush(*buffer_rows->getStorage());
+      buffer_rows->initializeStorage();
+      error_code = -error_code;
+      launch_cpu_code();
+    }
   } else {
     try {
       auto gpu_generated_code = std::dynamic_pointer_cast<GpuCompilationContext>(
@@ -2990,6 +3229,12 @@ int32_t Executor::executePlanWithGroupBy(
     results = query_exe_context->getRowSet(ra_exe_unit_copy,
                                            query_exe_context->query_mem_desc_);
     CHECK(results);
+    if (baseline_partitions && device_type == ExecutorDeviceType::CPU && !error_code) {
+      // The groups are returned by the partitions once all the kernels are done.
+      baseline_partitions->flush(*results->getStorage());
+      results.reset();
+      return 0;
+    }
     VLOG(2) << "results->rowCount()=" << results->rowCount();
     results->holdLiterals(hoist_buf);
   }
@@ -3032,11 +3277,18 @@ void Executor::nukeOldState(const bool allow_lazy_fetch,
                             const RelAlgExecutionUnit* ra_exe_unit) {
   kernel_queue_time_ms_ = 0;
   compilation_queue_time_ms_ = 0;
+  kernel_idle_time_ms_ = 0;
+  morsel_kernels_ = 0;
+  prefetched_chunks_ = 0;
+  prefetch_hits_ = 0;
+  prefetch_misses_ = 0;
+  join_key_skipped_fragments_ = 0;
   const bool contains_left_deep_outer_join =
       ra_exe_unit && std::find_if(ra_exe_unit->join_quals.begin(),
                                   ra_exe_unit->join_quals.end(),
                                   [](const JoinCondition& join_condition) {
-                                    return join_condition.type == JoinType::LEFT;
+                                    return join_condition.type == JoinType::LEFT ||
+                                           join_condition.type == JoinType::FULL;
                                   }) != ra_exe_unit->join_quals.end();
   cgen_state_.reset(new CgenState(query_infos.size(), contains_left_deep_outer_join));
   plan_state_.reset(new PlanState(allow_lazy_fetch && !contains_left_deep_outer_join,
@@ -3265,15 +3517,148 @@ std::tuple<bool, int64_t, int64_t> get_hpt_overflow_underflow_safe_scaled_values
   return std::make_tuple(true, upscaled_chunk_min, upscaled_chunk_max);
 }
 
+bool same_column(const Analyzer::ColumnVar* lhs, const Analyzer::ColumnVar* rhs) {
+  return lhs->get_table_id() == rhs->get_table_id() &&
+         lhs->get_column_id() == rhs->get_column_id() &&
+         lhs->get_rte_idx() == rhs->get_rte_idx();
+}
+
+// Matches `col IN (constants)` and disjunctions of equalities between the same column
+// and constants, which is what short IN lists get expanded to. Returns the column and
+// adds the constants to the given vector, or returns nullptr if the qual is neither.
+const Analyzer::ColumnVar* get_in_values_column(
+    const Analyzer::Expr* qual,
+    std::vector<const Analyzer::Constant*>& constants) {
+  if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual)) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(in_values->get_arg());
+    if (!col_var || dynamic_cast<const Analyzer::Var*>(col_var)) {
+      return nullptr;
+    }
+    for (const auto& value : in_values->get_value_list()) {
+      const auto constant = dynamic_cast<const Analyzer::Constant*>(value.get());
+      if (!constant) {
+        return nullptr;
+      }
+      constants.push_back(constant);
+    }
+    return col_var;
+  }
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+  if (!bin_oper) {
+    return nullptr;
+  }
+  if (bin_oper->get_optype() == kOR) {
+    const auto lhs_col = get_in_values_column(bin_oper->get_left_operand(), constants);
+    const auto rhs_col = get_in_values_column(bin_oper->get_right_operand(), constants);
+    return lhs_col && rhs_col && same_column(lhs_col, rhs_col) ? lhs_col : nullptr;
+  }
+  if (bin_oper->get_optype() != kEQ || bin_oper->get_qualifier() != kONE) {
+    return nullptr;
+  }
+  auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_left_operand());
+  auto constant = dynamic_cast<const Analyzer::Constant*>(bin_oper->get_right_operand());
+  if (!col_var) {
+    col_var = dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_right_operand());
+    constant = dynamic_cast<const Analyzer::Constant*>(bin_oper->get_left_operand());
+  }
+  if (!col_var || dynamic_cast<const Analyzer::Var*>(col_var) || !constant) {
+    return nullptr;
+  }
+  constants.push_back(constant);
+  return col_var;
+}
+
+// Returns the value a constant compared to the column is stored as: the dictionary id
+// for dictionary encoded strings, the integer value otherwise. Returns std::nullopt if
+// the constant doesn't map to the stored values one to one.
+std::optional<int64_t> get_value_filter_key(const Analyzer::ColumnVar* col_var,
+                                            const Analyzer::Constant* constant,
+                                            const Catalog_Namespace::Catalog& cat) {
+  if (constant->get_is_null()) {
+    return std::nullopt;
+  }
+  const auto& col_ti = col_var->get_type_info();
+  const auto& constant_ti = constant->get_type_info();
+  const auto& datum = constant->get_constval();
+  if (col_ti.is_string()) {
+    if (col_ti.get_compression() != kENCODING_DICT || !constant_ti.is_string() ||
+        !datum.stringval) {
+      return std::nullopt;
+    }
+    const auto dd = cat.getMetadataForDict(col_ti.get_comp_param(), true);
+    if (!dd || !dd->stringDict) {
+      return std::nullopt;
+    }
+    // A string missing from the dictionary isn't stored in any chunk, its invalid id
+    // isn't in any filter either.
+    return dd->stringDict->getIdOfString(*datum.stringval);
+  }
+  if (constant_ti.get_type() != col_ti.get_type() ||
+      constant_ti.get_dimension() != col_ti.get_dimension()) {
+    return std::nullopt;
+  }
+  switch (col_ti.get_type()) {
+    case kBOOLEAN:
+      return datum.boolval;
+    case kTINYINT:
+      return datum.tinyintval;
+    case kSMALLINT:
+      return datum.smallintval;
+    case kINT:
+      return datum.intval;
+    case kBIGINT:
+    case kTIME:
+    case kTIMESTAMP:
+      return datum.bigintval;
+    default:
+      return std::nullopt;
+  }
+}
+
 }  // namespace
 
+bool Executor::valueFilterExcludes(
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const Analyzer::ColumnVar* col_var,
+    const std::vector<const Analyzer::Constant*>& constants) const {
+  if (!g_enable_chunk_value_filters || constants.empty()) {
+    return false;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+  if (chunk_meta_it == chunk_metadata_map.end()) {
+    return false;
+  }
+  const auto value_filter = chunk_meta_it->second->chunkStats.value_filter;
+  if (!value_filter) {
+    return false;
+  }
+  CHECK(catalog_);
+  for (const auto constant : constants) {
+    const auto key = get_value_filter_key(col_var, constant, *catalog_);
+    if (!key || value_filter->mayContain(*key)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::pair<bool, int64_t> Executor::skipFragment(
     const InputDescriptor& table_desc,
     const Fragmenter_Namespace::FragmentInfo& fragment,
     const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals,
     const std::vector<uint64_t>& frag_offsets,
-    const size_t frag_idx) {
+    const size_t frag_idx,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& quals) {
   const int table_id = table_desc.getTableId();
+  for (const auto& qual : quals) {
+    std::vector<const Analyzer::Constant*> constants;
+    const auto col_var = get_in_values_column(qual.get(), constants);
+    if (col_var && col_var->get_table_id() == table_id && !col_var->get_rte_idx() &&
+        valueFilterExcludes(fragment, col_var, constants)) {
+      return {true, -1};
+    }
+  }
   for (const auto& simple_qual : simple_quals) {
     const auto comp_expr =
         std::dynamic_pointer_cast<const Analyzer::BinOper>(simple_qual);
@@ -3303,6 +3688,11 @@ std::pair<bool, int64_t> Executor::skipFragment(
       // is this possible?
       return {false, -1};
     }
+    if (comp_expr->get_optype() == kEQ && lhs == lhs_col &&
+        lhs_col->get_table_id() == table_id &&
+        valueFilterExcludes(fragment, lhs_col, {rhs_const})) {
+      return {true, -1};
+    }
     if (!lhs->get_type_info().is_integer() && !lhs->get_type_info().is_time()) {
       continue;
     }
@@ -3454,6 +3844,64 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+bool Executor::joinKeysExclude(const InputDescriptor& table_desc,
+                               const RelAlgExecutionUnit& ra_exe_unit,
+                               const Fragmenter_Namespace::FragmentInfo& fragment) const {
+  // The hash tables are built while compiling the query, before the fragments are
+  // dispatched.
+  if (!plan_state_) {
+    return false;
+  }
+  const auto& join_info = plan_state_->join_info_;
+  CHECK_EQ(join_info.equi_join_tautologies_.size(), join_info.join_hash_tables_.size());
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  for (const auto& inner_join : ra_exe_unit.join_quals) {
+    // An outer row without a match doesn't survive a semi join either.
+    if (inner_join.type != JoinType::INNER && inner_join.type != JoinType::SEMI) {
+      continue;
+    }
+    for (const auto& qual : inner_join.quals) {
+      for (size_t i = 0; i < join_info.equi_join_tautologies_.size(); ++i) {
+        if (join_info.equi_join_tautologies_[i].get() != qual.get()) {
+          continue;
+        }
+        // A row needs a key of every component of a composite key to have a match.
+        for (const auto& summary :
+             join_info.join_hash_tables_[i]->getInnerKeySummaries()) {
+          if (summary.outer_col->get_table_id() != table_desc.getTableId() ||
+              summary.outer_col->get_rte_idx()) {
+            continue;
+          }
+          if (summary.min_key > summary.max_key) {
+            return true;
+          }
+          const auto chunk_meta_it =
+              chunk_metadata_map.find(summary.outer_col->get_column_id());
+          if (chunk_meta_it == chunk_metadata_map.end()) {
+            continue;
+          }
+          const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+          const auto& chunk_type = summary.outer_col->get_type_info();
+          if (extract_max_stat(chunk_stats, chunk_type) < summary.min_key ||
+              extract_min_stat(chunk_stats, chunk_type) > summary.max_key) {
+            return true;
+          }
+          if (g_enable_chunk_value_filters && chunk_stats.value_filter &&
+              !summary.keys.empty() &&
+              std::none_of(summary.keys.begin(),
+                           summary.keys.end(),
+                           [&chunk_stats](const int64_t key) {
+                             return chunk_stats.value_filter->mayContain(key);
+                           })) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
 AggregatedColRange Executor::computeColRangesCache(
     const std::unordered_set<PhysicalInput>& phys_inputs) {
   AggregatedColRange agg_col_range_cache;
@@ -3626,6 +4074,7 @@ void* Executor::gpu_active_modules_[max_gpu_count];
 std::atomic<bool> Executor::interrupted_{false};
 
 std::mutex Executor::compilation_mutex_;
+std::atomic<size_t> Executor::async_codegen_installs_{0};
 std::mutex Executor::kernel_mutex_;
 
 mapd_shared_mutex Executor::recycler_mutex_;
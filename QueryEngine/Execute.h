@@ -64,7 +64,9 @@
 #include <cstdlib>
 #include <deque>
 #include <functional>
+#include <future>
 #include <limits>
+#include <list>
 #include <map>
 #include <mutex>
 #include <stack>
@@ -289,6 +291,7 @@ class UpdateLogForFragment : public RowDataProvider {
 using LLVMValueVector = std::vector<llvm::Value*>;
 
 class QueryCompilationDescriptor;
+class PersistentObjectCache;
 
 std::ostream& operator<<(std::ostream&, FetchResult const&);
 
@@ -309,6 +312,8 @@ class Executor {
            const std::string& debug_dir,
            const std::string& debug_file);
 
+  ~Executor();
+
   static std::shared_ptr<Executor> getExecutor(
       const ExecutorId id,
       const std::string& debug_dir = "",
@@ -324,6 +329,10 @@ class Executor {
 
   static void clearMemory(const Data_Namespace::MemoryLevel memory_level);
 
+  // Waits for the optimized CPU code generated in the background by all executors, see
+  // g_enable_async_jit. Returns how many code cache entries it has replaced so far.
+  static size_t waitForAsyncCodegen();
+
   static size_t getArenaBlockSize();
 
   StringDictionaryProxy* getStringDictionaryProxy(
@@ -601,7 +610,8 @@ class Executor {
                                  const int64_t limit,
                                  const uint32_t start_rowid,
                                  const uint32_t num_tables,
-                                 RenderInfo* render_info);
+                                 RenderInfo* render_info,
+                                 BaselineHashPartitions* baseline_partitions);
   int32_t executePlanWithoutGroupBy(
       const RelAlgExecutionUnit& ra_exe_unit,
       const CompilationResult&,
@@ -718,6 +728,12 @@ class Executor {
                         const QueryMemoryDescriptor& query_mem_desc,
                         const CompilationOptions& co,
                         const ExecutionOptions& eo);
+  llvm::Value* codegenFullJoinMatchedRows(const RelAlgExecutionUnit& ra_exe_unit,
+                                          const CompilationOptions& co);
+  void codegenFullJoinMatches(const RelAlgExecutionUnit& ra_exe_unit,
+                              const CompilationOptions& co);
+  llvm::Value* codegenFullJoinUnmatched(const RelAlgExecutionUnit& ra_exe_unit,
+                                        const CompilationOptions& co);
   bool compileBody(const RelAlgExecutionUnit& ra_exe_unit,
                    GroupByAndAggregate& group_by_and_aggregate,
                    const QueryMemoryDescriptor& query_mem_desc,
@@ -753,6 +769,19 @@ class Executor {
       llvm::Function*,
       const std::unordered_set<llvm::Function*>&,
       const CompilationOptions&);
+  bool scheduleOptimizedCodegenCPU(const CodeCacheKey& key,
+                                   llvm::Function* query_func,
+                                   llvm::Function* multifrag_query_func,
+                                   const std::unordered_set<llvm::Function*>& live_funcs,
+                                   const CompilationOptions& co,
+                                   std::shared_ptr<PersistentObjectCache> object_cache);
+  void optimizedCodegenCPUInBackground(const CodeCacheKey& key,
+                                       const std::string& module_bitcode,
+                                       const std::string& query_func_name,
+                                       const std::string& multifrag_query_func_name,
+                                       const std::vector<std::string>& live_func_names,
+                                       const CompilationOptions& co,
+                                       PersistentObjectCache* object_cache);
   std::shared_ptr<CompilationContext> optimizeAndCodegenGPU(
       llvm::Function*,
       llvm::Function*,
@@ -791,7 +820,20 @@ class Executor {
       const Fragmenter_Namespace::FragmentInfo& frag_info,
       const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals,
       const std::vector<uint64_t>& frag_offsets,
-      const size_t frag_idx);
+      const size_t frag_idx,
+      const std::list<std::shared_ptr<Analyzer::Expr>>& quals = {});
+
+  // Returns true if the value filter of the column in the given fragment rules out every
+  // one of the constants, i.e. no row of the fragment can be equal to any of them.
+  bool valueFilterExcludes(const Fragmenter_Namespace::FragmentInfo& fragment,
+                           const Analyzer::ColumnVar* col_var,
+                           const std::vector<const Analyzer::Constant*>& constants) const;
+
+  // Returns true if the join column of the fragment has none of the keys of the hash
+  // table of one of the inner joins, i.e. no row of the fragment can have a match.
+  bool joinKeysExclude(const InputDescriptor& table_desc,
+                       const RelAlgExecutionUnit& ra_exe_unit,
+                       const Fragmenter_Namespace::FragmentInfo& fragment) const;
 
   std::pair<bool, int64_t> skipFragmentInnerJoins(
       const InputDescriptor& table_desc,
@@ -891,6 +933,10 @@ class Executor {
 
   CodeCache cpu_code_cache_;
   CodeCache gpu_code_cache_;
+  // Optimized CPU code being generated in the background, see g_enable_async_jit.
+  // Guarded by compilation_mutex_.
+  std::list<std::future<void>> async_codegen_tasks_;
+  static std::atomic<size_t> async_codegen_installs_;
 
   static const size_t baseline_threshold{
       1000000};  // if a perfect hash needs more entries, use baseline
@@ -908,6 +954,16 @@ class Executor {
 
   int64_t kernel_queue_time_ms_ = 0;
   int64_t compilation_queue_time_ms_ = 0;
+  // Time the bounded kernel workers spent without a kernel to run, summed over workers,
+  // and the kernels which ran a morsel of a fragment.
+  int64_t kernel_idle_time_ms_ = 0;
+  size_t morsel_kernels_ = 0;
+  // Chunks loaded ahead of the kernels, and how many of them the kernels found loaded.
+  size_t prefetched_chunks_ = 0;
+  size_t prefetch_hits_ = 0;
+  size_t prefetch_misses_ = 0;
+  // Outer fragments skipped because they have none of the keys of an inner join.
+  size_t join_key_skipped_fragments_ = 0;
 
   // Singleton instance used for an execution unit which is a project with window
   // functions.
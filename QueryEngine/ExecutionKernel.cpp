@@ -176,6 +176,16 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
     if (fetch_result.num_rows.empty()) {
       return;
     }
+    if (outer_row_range_) {
+      CHECK(chosen_device_type == ExecutorDeviceType::CPU);
+      CHECK_EQ(fetch_result.num_rows.size(), size_t(1));
+      auto& outer_num_rows = fetch_result.num_rows.front().front();
+      outer_num_rows =
+          std::min(outer_num_rows, static_cast<int64_t>(outer_row_range_->second));
+      if (outer_num_rows <= static_cast<int64_t>(outer_row_range_->first)) {
+        return;
+      }
+    }
     if (eo.with_dynamic_watchdog &&
         !shared_context.dynamic_watchdog_set.test_and_set(std::memory_order_acquire)) {
       CHECK_GT(eo.dynamic_watchdog_time_limit, 0u);
@@ -233,6 +243,10 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
                                                            frag_row_count.end(),
                                                            total_num_input_rows);
                   });
+    if (outer_row_range_) {
+      // The rows before the morsel are skipped, no output space is needed for them.
+      total_num_input_rows -= outer_row_range_->first;
+    }
     VLOG(2) << "total_num_input_rows=" << total_num_input_rows;
     // TODO(adb): we may want to take this early out for all queries, but we are most
     // likely to see this query pattern on the kernel per fragment path (e.g. with HAVING
@@ -269,11 +283,18 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
   CHECK(query_exe_context);
   int32_t err{0};
   uint32_t start_rowid{0};
-  if (rowid_lookup_key >= 0) {
+  if (outer_row_range_) {
+    CHECK_LT(rowid_lookup_key, 0);
+    // The generated code resumes the scan of the outer fragment from this row.
+    start_rowid = outer_row_range_->first;
+  } else if (rowid_lookup_key >= 0) {
     if (!frag_list.empty()) {
       const auto& all_frag_row_offsets = shared_context.getFragOffsets();
       start_rowid = rowid_lookup_key -
                     all_frag_row_offsets[frag_list.begin()->fragment_ids.front()];
+      // Only the looked up row is scanned.
+      auto& outer_num_rows = fetch_result.num_rows.front().front();
+      outer_num_rows = std::min(outer_num_rows, static_cast<int64_t>(start_rowid) + 1);
     }
   }
 
@@ -314,7 +335,8 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
                                            ra_exe_unit_.scan_limit,
                                            start_rowid,
                                            ra_exe_unit_.input_descs.size(),
-                                           do_render ? render_info_ : nullptr);
+                                           do_render ? render_info_ : nullptr,
+                                           shared_context.getBaselinePartitions());
   }
   if (device_results_) {
     std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
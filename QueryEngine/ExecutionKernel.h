@@ -16,10 +16,14 @@
 
 #pragma once
 
+#include <optional>
+
 #include "Logger/Logger.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
 
+class ChunkPrefetcher;
+
 class SharedKernelContext {
  public:
   SharedKernelContext(const std::vector<InputTableInfo>& query_infos)
@@ -36,6 +40,22 @@ class SharedKernelContext {
 
   std::atomic_flag dynamic_watchdog_set = ATOMIC_FLAG_INIT;
 
+  void setChunkPrefetcher(ChunkPrefetcher* chunk_prefetcher) {
+    chunk_prefetcher_ = chunk_prefetcher;
+  }
+
+  ChunkPrefetcher* getChunkPrefetcher() const { return chunk_prefetcher_; }
+
+  // Set when the kernels pre-aggregate a baseline hash group by and flush their groups
+  // to shared partitions instead of returning them.
+  void setBaselinePartitions(std::unique_ptr<BaselineHashPartitions> baseline_partitions) {
+    baseline_partitions_ = std::move(baseline_partitions);
+  }
+
+  BaselineHashPartitions* getBaselinePartitions() const {
+    return baseline_partitions_.get();
+  }
+
  private:
   std::mutex reduce_mutex_;
   std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
@@ -43,6 +63,8 @@ class SharedKernelContext {
   std::vector<uint64_t> all_frag_row_offsets_;
   std::mutex all_frag_row_offsets_mutex_;
   const std::vector<InputTableInfo>& query_infos_;
+  ChunkPrefetcher* chunk_prefetcher_{nullptr};
+  std::unique_ptr<BaselineHashPartitions> baseline_partitions_;
 };
 
 class ExecutionKernel {
@@ -72,6 +94,20 @@ class ExecutionKernel {
 
   void run(Executor* executor, SharedKernelContext& shared_context);
 
+  ExecutorDeviceType getDeviceType() const { return chosen_device_type; }
+
+  const FragmentsList& getFragmentsList() const { return frag_list; }
+
+  // Restricts the kernel to rows [start_row, end_row) of its outer fragment, which lets
+  // a large fragment be processed as several morsels. Only valid on CPU, for kernels
+  // which run a single fragment combination.
+  void setOuterRowRange(const size_t start_row, const size_t end_row) {
+    CHECK_LT(start_row, end_row);
+    outer_row_range_ = std::make_pair(start_row, end_row);
+  }
+
+  bool isMorsel() const { return outer_row_range_.has_value(); }
+
  private:
   const RelAlgExecutionUnit& ra_exe_unit_;
   const ExecutorDeviceType chosen_device_type;
@@ -84,6 +120,7 @@ class ExecutionKernel {
   const ExecutorDispatchMode kernel_dispatch_mode;
   RenderInfo* render_info_;
   const int64_t rowid_lookup_key;
+  std::optional<std::pair<size_t, size_t>> outer_row_range_;
 
   ResultSetPtr device_results_;
 
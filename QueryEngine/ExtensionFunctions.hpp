@@ -11,6 +11,8 @@
 #include <cmath>
 #include <cstdlib>
 
+#include "HyperLogLogRank.h"
+#include "MurmurHash.h"
 #include "OmniSciTypes.h"
 
 /* Example extension functions:
@@ -1099,5 +1101,43 @@ EXTENSION_NOINLINE bool is_point_size_in_merc_view(const double lon,
            lat + latdiff < min_lat || lat - latdiff > max_lat);
 }
 
+/* HyperLogLog sketches stored as rows, for rollups which merge pre-aggregated sketches
+ * instead of scanning the raw rows again. hll_register() and hll_rank() return the
+ * register a key updates and the rank it sets there in a sketch of 2^precision
+ * registers, hashing the key like APPROX_COUNT_DISTINCT does. The sketch of a set of keys
+ * is the largest rank per register, and the sketches of several sets are merged the same
+ * way. hll_estimate() takes the sum of 2^-rank over the registers of a sketch and their
+ * count, and estimates its number of distinct keys like APPROX_COUNT_DISTINCT with the
+ * same precision. The precision must be a literal between 4 and 16, queries with other
+ * precisions are rejected when they're translated. For example:
+ *
+ * CREATE TABLE daily_users AS SELECT d, hll_register(user_id, 12) AS reg,
+ *   MAX(hll_rank(user_id, 12)) AS rnk FROM events GROUP BY d, reg;
+ * SELECT m, hll_estimate(SUM(POWER(2, -rnk)), COUNT(*), 12) FROM (SELECT
+ *   DATE_TRUNC(MONTH, d) AS m, reg, MAX(rnk) AS rnk FROM daily_users GROUP BY m, reg)
+ *   GROUP BY m;
+ */
+
+EXTENSION_NOINLINE
+int32_t hll_register(const int64_t key, const int32_t precision) {
+  const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+  return hash >> (64 - precision);
+}
+
+EXTENSION_NOINLINE
+int32_t hll_rank(const int64_t key, const int32_t precision) {
+  const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+  return get_rank(hash << precision, 64 - precision);
+}
+
+EXTENSION_NOINLINE
+int64_t hll_estimate(const double rank_sum,
+                     const int64_t register_count,
+                     const int32_t precision) {
+  // The registers missing from the sketch are zero and each add 2^0 to the sum.
+  const int64_t zeros = (int64_t(1) << precision) - register_count;
+  return hll_size_from_harmonic_sum(precision, zeros, rank_sum + zeros);
+}
+
 #include "ExtensionFunctionsArray.hpp"
 #include "ExtensionFunctionsGeo.hpp"
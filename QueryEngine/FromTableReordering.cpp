@@ -153,7 +153,8 @@ SchedulingDependencyTracking build_dependency_tracking(
   // edges prevent start_it from pointing to a table with a
   // left join dependency on another table.
   for (size_t level_idx = 0; level_idx < left_deep_join_quals.size(); ++level_idx) {
-    if (left_deep_join_quals[level_idx].type == JoinType::LEFT) {
+    if (left_deep_join_quals[level_idx].type == JoinType::LEFT ||
+        left_deep_join_quals[level_idx].type == JoinType::FULL) {
       dependency_tracking.addEdge(level_idx, level_idx + 1);
     }
   }
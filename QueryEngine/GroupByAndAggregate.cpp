@@ -23,6 +23,7 @@
 #include "ExpressionRange.h"
 #include "ExpressionRewrite.h"
 #include "GpuInitGroups.h"
+#include "HyperLogLogSketch.h"
 #include "InPlaceSort.h"
 #include "LLVMFunctionAttributesUtil.h"
 #include "MaxwellCodegenPatch.h"
@@ -37,6 +38,7 @@
 #include "QueryTemplateGenerator.h"
 #include "RuntimeFunctions.h"
 #include "StreamingTopN.h"
+#include "TDigest.h"
 #include "TopKSort.h"
 #include "WindowContext.h"
 
@@ -48,7 +50,9 @@
 bool g_cluster{false};
 bool g_bigint_count{false};
 int g_hll_precision_bits{11};
+bool g_enable_sparse_hll{true};
 extern size_t g_leaf_count;
+extern size_t g_baseline_preaggregation_entry_count;
 
 namespace {
 
@@ -102,6 +106,15 @@ bool has_count_distinct(const RelAlgExecutionUnit& ra_exe_unit) {
   return false;
 }
 
+bool has_approx_percentile(const RelAlgExecutionUnit& ra_exe_unit) {
+  for (const auto& target_expr : ra_exe_unit.target_exprs) {
+    if (is_approx_percentile_target(get_target_info(target_expr, g_bigint_count))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool is_column_range_too_big_for_perfect_hash(const ColRangeInfo& col_range_info,
                                               const int64_t max_entry_count) {
   try {
@@ -395,6 +408,14 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
       break;
     }
   }
+  if (!render_info && g_baseline_preaggregation_entry_count &&
+      BaselineHashPartitions::canPreaggregate(
+          ra_exe_unit_, *query_mem_desc, device_type_)) {
+    // The kernels flush their groups to shared partitions whenever they run out of
+    // slots, a small buffer is enough.
+    query_mem_desc->setEntryCount(std::min(query_mem_desc->getEntryCount(),
+                                           g_baseline_preaggregation_entry_count));
+  }
   return query_mem_desc;
 }
 
@@ -445,6 +466,9 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
             130000000))) {
     throw WatchdogException("Query would use too much memory");
   }
+  // The t-digests behind APPROX_PERCENTILE are only allocated for row-wise buffers.
+  const bool output_columnar =
+      output_columnar_hint && !has_approx_percentile(ra_exe_unit_);
   try {
     return QueryMemoryDescriptor::init(executor_,
                                        ra_exe_unit_,
@@ -460,7 +484,7 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
                                        render_info,
                                        count_distinct_descriptors,
                                        must_use_baseline_sort,
-                                       output_columnar_hint,
+                                       output_columnar,
                                        /*streaming_top_n_hint=*/true);
   } catch (const StreamingTopNOOM& e) {
     LOG(WARNING) << e.what() << " Disabling Streaming Top N.";
@@ -478,7 +502,7 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
                                        render_info,
                                        count_distinct_descriptors,
                                        must_use_baseline_sort,
-                                       output_columnar_hint,
+                                       output_columnar,
                                        /*streaming_top_n_hint=*/false);
   }
 }
@@ -606,7 +630,7 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kINT);
           CHECK_GE(error_rate->get_constval().intval, 1);
@@ -642,6 +666,14 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           !(arg_ti.is_array() || arg_ti.is_geometry())) {
         count_distinct_impl_type = CountDistinctImplType::Bitmap;
       }
+      // Most groups of a large group by see few distinct values, a sketch which starts
+      // out sparse saves allocating the whole register array for each of them.
+      if (g_enable_sparse_hll && agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
+          count_distinct_impl_type == CountDistinctImplType::Bitmap &&
+          device_type_ == ExecutorDeviceType::CPU &&
+          !ra_exe_unit_.groupby_exprs.empty() && ra_exe_unit_.groupby_exprs.front()) {
+        count_distinct_impl_type = CountDistinctImplType::HllSketch;
+      }
 
       if (g_enable_watchdog && !(arg_range_info.isEmpty()) &&
           count_distinct_impl_type == CountDistinctImplType::StdSet) {
@@ -1499,7 +1531,8 @@ llvm::Value* GroupByAndAggregate::codegenWindowRowPointer(
   AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
   const auto window_func_context =
       WindowProjectNodeContext::getActiveWindowFunctionContext(executor_);
-  if (window_func_context && window_function_is_aggregate(window_func->getKind())) {
+  if (window_func_context && window_function_is_aggregate(window_func->getKind()) &&
+      !window_function_is_framed_aggregate(window_func)) {
     const int32_t row_size_quad = query_mem_desc.didOutputColumnar()
                                       ? 0
                                       : query_mem_desc.getRowSize() / sizeof(int64_t);
@@ -1697,6 +1730,12 @@ extern "C" void agg_count_distinct(int64_t* agg, const int64_t val) {
   reinterpret_cast<std::set<int64_t>*>(*agg)->insert(val);
 }
 
+extern "C" void agg_approximate_count_distinct_sketch(int64_t* agg,
+                                                     const int64_t key,
+                                                     const uint32_t b) {
+  reinterpret_cast<HllSketch*>(*agg)->update(key);
+}
+
 extern "C" void agg_count_distinct_skip_val(int64_t* agg,
                                             const int64_t val,
                                             const int64_t skip_val) {
@@ -1705,6 +1744,18 @@ extern "C" void agg_count_distinct_skip_val(int64_t* agg,
   }
 }
 
+extern "C" void agg_approx_percentile(int64_t* agg, const double val) {
+  reinterpret_cast<TDigest*>(*agg)->add(val);
+}
+
+extern "C" void agg_approx_percentile_skip_val(int64_t* agg,
+                                               const double val,
+                                               const double skip_val) {
+  if (val != skip_val) {
+    agg_approx_percentile(agg, val);
+  }
+}
+
 void GroupByAndAggregate::codegenCountDistinct(
     const size_t target_idx,
     const Analyzer::Expr* target_expr,
@@ -1723,8 +1774,15 @@ void GroupByAndAggregate::codegenCountDistinct(
       query_mem_desc.getCountDistinctDescriptor(target_idx);
   CHECK(count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid);
   if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-    CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     agg_args.push_back(LL_INT(int32_t(count_distinct_descriptor.bitmap_sz_bits)));
+    if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::HllSketch) {
+      CHECK(device_type == ExecutorDeviceType::CPU);
+      executor_->cgen_state_->emitExternalCall("agg_approximate_count_distinct_sketch",
+                                               llvm::Type::getVoidTy(LL_CONTEXT),
+                                               agg_args);
+      return;
+    }
+    CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     if (device_type == ExecutorDeviceType::GPU) {
       const auto base_dev_addr = getAdditionalLiteral(-1);
       const auto base_host_addr = getAdditionalLiteral(-2);
@@ -1774,6 +1832,27 @@ void GroupByAndAggregate::codegenCountDistinct(
   }
 }
 
+void GroupByAndAggregate::codegenApproxPercentile(
+    const size_t target_idx,
+    const Analyzer::Expr* target_expr,
+    std::vector<llvm::Value*>& agg_args,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const ExecutorDeviceType device_type) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  if (device_type == ExecutorDeviceType::GPU) {
+    throw QueryMustRunOnCpu();
+  }
+  const auto agg_info = get_target_info(target_expr, g_bigint_count);
+  CHECK(agg_info.agg_arg_type.get_type() == kDOUBLE);
+  std::string agg_fname{"agg_approx_percentile"};
+  if (agg_info.skip_null_val) {
+    agg_fname += "_skip_val";
+    agg_args.push_back(executor_->cgen_state_->inlineFpNull(agg_info.agg_arg_type));
+  }
+  executor_->cgen_state_->emitExternalCall(
+      agg_fname, llvm::Type::getVoidTy(LL_CONTEXT), agg_args);
+}
+
 llvm::Value* GroupByAndAggregate::getAdditionalLiteral(const int32_t off) {
   CHECK_LT(off, 0);
   const auto lit_buff_lv = get_arg_by_name(ROW_FUNC, "literals");
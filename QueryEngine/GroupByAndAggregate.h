@@ -272,6 +272,12 @@ class GroupByAndAggregate {
                             const QueryMemoryDescriptor&,
                             const ExecutorDeviceType);
 
+  void codegenApproxPercentile(const size_t target_idx,
+                               const Analyzer::Expr* target_expr,
+                               std::vector<llvm::Value*>& agg_args,
+                               const QueryMemoryDescriptor&,
+                               const ExecutorDeviceType);
+
   llvm::Value* getAdditionalLiteral(const int32_t off);
 
   std::vector<llvm::Value*> codegenAggArg(const Analyzer::Expr* target_expr,
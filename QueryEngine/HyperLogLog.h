@@ -26,34 +26,10 @@
 #define QUERYENGINE_HYPERLOGLOG_H
 
 #include "Descriptors/CountDistinctDescriptor.h"
+#include "HyperLogLogRank.h"
 
 #include <cmath>
 
-inline double get_alpha(const size_t m) {
-  switch (m) {
-    case 16:
-      return 0.673;
-    case 32:
-      return 0.697;
-    case 64:
-      return 0.709;
-    default:
-      break;
-  }
-  double alpha = 0.7213 / (1 + 1.079 / m);
-  return alpha;
-}
-
-inline double get_beta(const uint32_t zeros) {
-  // Using polynomial regression terms found in LogLog-Beta paper and Redis
-  double zl = log(zeros + 1);
-  double beta = -0.370393911 * zeros + 0.070471823 * zl + 0.17393686 * pow(zl, 2) +
-                0.16339839 * pow(zl, 3) + -0.09237745 * pow(zl, 4) +
-                0.03738027 * pow(zl, 5) + -0.005384159 * pow(zl, 6) +
-                0.00042419 * pow(zl, 7);
-  return beta;
-}
-
 template <typename T>
 inline double get_harmonic_mean_denominator(T* M, uint32_t m) {
   double accumulator = 0.0;
@@ -64,17 +40,6 @@ inline double get_harmonic_mean_denominator(T* M, uint32_t m) {
   return accumulator;
 }
 
-template <typename T>
-inline double get_beta_adjusted_estimate(const size_t m, const uint32_t z, T* M) {
-  return (get_alpha(m) * m * (m - z) *
-          (1 / (get_beta(z) + get_harmonic_mean_denominator(M, m))));
-}
-
-template <typename T>
-inline double get_alpha_adjusted_estimate(const size_t m, T* M) {
-  return (get_alpha(m) * m * m) * (1 / get_harmonic_mean_denominator(M, m));
-};
-
 template <typename T>
 inline uint32_t count_zeros(T* M, size_t m) {
   uint32_t zeros = 0;
@@ -91,18 +56,8 @@ inline size_t hll_size(const T* M, const size_t bitmap_sz_bits) {
   size_t m = 1 << bitmap_sz_bits;
 
   uint32_t zeros = count_zeros(M, m);
-  double estimate = get_alpha_adjusted_estimate(m, M);
-  if (estimate <= 2.5 * m) {
-    if (zeros != 0) {
-      estimate = m * log(static_cast<double>(m) / zeros);
-    }
-  } else {
-    if (bitmap_sz_bits == 14) {  // Apply LogLog-Beta adjustment only when p=14
-      estimate = get_beta_adjusted_estimate(m, zeros, M);
-    }
-  }
-  // No correction for large estimates since we're using 64-bit hashes.
-  return estimate;
+  return hll_size_from_harmonic_sum(
+      bitmap_sz_bits, zeros, get_harmonic_mean_denominator(M, m));
 }
 
 template <class T1, class T2>
@@ -19,6 +19,13 @@
 
 #include "../Shared/funcannotations.h"
 
+#ifndef __CUDACC__
+#include <algorithm>
+#endif
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
 #ifdef __CUDACC__
 inline __device__ int32_t get_rank(uint64_t x, uint32_t b) {
   return min(b, static_cast<uint32_t>(x ? __clzll(x) : 64)) + 1;
@@ -29,4 +36,51 @@ FORCE_INLINE uint8_t get_rank(uint64_t x, uint32_t b) {
 }
 #endif
 
+DEVICE inline double get_alpha(const size_t m) {
+  switch (m) {
+    case 16:
+      return 0.673;
+    case 32:
+      return 0.697;
+    case 64:
+      return 0.709;
+    default:
+      break;
+  }
+  double alpha = 0.7213 / (1 + 1.079 / m);
+  return alpha;
+}
+
+DEVICE inline double get_beta(const uint32_t zeros) {
+  // Using polynomial regression terms found in LogLog-Beta paper and Redis
+  double zl = log(zeros + 1.);
+  double beta = -0.370393911 * zeros + 0.070471823 * zl + 0.17393686 * pow(zl, 2) +
+                0.16339839 * pow(zl, 3) + -0.09237745 * pow(zl, 4) +
+                0.03738027 * pow(zl, 5) + -0.005384159 * pow(zl, 6) +
+                0.00042419 * pow(zl, 7);
+  return beta;
+}
+
+// Estimate of the number of distinct values from the 2^bitmap_sz_bits registers of a
+// HyperLogLog sketch, given how many of them are zero and the sum of 2^-register over all
+// of them.
+DEVICE inline double hll_size_from_harmonic_sum(const size_t bitmap_sz_bits,
+                                                const uint32_t zeros,
+                                                const double harmonic_sum) {
+  size_t m = 1 << bitmap_sz_bits;
+
+  double estimate = (get_alpha(m) * m * m) * (1 / harmonic_sum);
+  if (estimate <= 2.5 * m) {
+    if (zeros != 0) {
+      estimate = m * log(static_cast<double>(m) / zeros);
+    }
+  } else {
+    if (bitmap_sz_bits == 14) {  // Apply LogLog-Beta adjustment only when p=14
+      estimate = (get_alpha(m) * m * (m - zeros) * (1 / (get_beta(zeros) + harmonic_sum)));
+    }
+  }
+  // No correction for large estimates since we're using 64-bit hashes.
+  return estimate;
+}
+
 #endif  // QUERYENGINE_HYPERLOGLOGRT_H
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    HyperLogLogSketch.h
+ * @brief   HyperLogLog++ sketch with a sparse representation, used by
+ *          APPROX_COUNT_DISTINCT in CPU group by queries.
+ *
+ * A sketch starts out as a sorted list of (index, rank) pairs at a precision of
+ * kSparsePrecision bits, which is both much smaller than the dense register array for
+ * groups with few distinct values and exact enough for linear counting. Once the list
+ * would take more memory than the registers, the sketch switches to the same dense
+ * registers agg_approximate_count_distinct maintains, so its estimates match the dense
+ * implementation from then on.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/HyperLogLog.h"
+#include "QueryEngine/HyperLogLogRank.h"
+#include "QueryEngine/MurmurHash.h"
+
+class HllSketch {
+ public:
+  static constexpr uint32_t kSparsePrecision{25};
+
+  HllSketch(const uint32_t precision) : precision_(precision) {
+    CHECK_GE(precision_, 4u);
+    CHECK_LE(precision_, kSparsePrecision);
+  }
+
+  void update(const int64_t key) {
+    const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+    if (!registers_.empty()) {
+      updateRegister(hash >> (64 - precision_),
+                     get_rank(hash << precision_, 64 - precision_));
+      return;
+    }
+    temp_.push_back(encode(hash >> (64 - kSparsePrecision),
+                           get_rank(hash << kSparsePrecision, 64 - kSparsePrecision)));
+    if (temp_.size() >= tempCapacity()) {
+      mergeTemp();
+    }
+  }
+
+  void merge(const HllSketch& that) {
+    CHECK_EQ(precision_, that.precision_);
+    if (!that.isSparse()) {
+      toDense();
+      for (size_t i = 0; i < registers_.size(); ++i) {
+        registers_[i] = std::max(registers_[i], that.registers_[i]);
+      }
+      return;
+    }
+    const auto that_entries = that.temp_.empty() ? that.sparse_ : that.mergeTempEntries();
+    if (isSparse()) {
+      temp_.insert(temp_.end(), that_entries.begin(), that_entries.end());
+      mergeTemp();
+    } else {
+      for (const auto entry : that_entries) {
+        updateRegister(denseIndex(entry), denseRank(entry));
+      }
+    }
+  }
+
+  // Estimates the number of distinct keys. Leaves the sketch as is, the pending entries
+  // are merged into a copy, so that the sketch can be read concurrently.
+  size_t cardinality() const {
+    if (!isSparse()) {
+      return hll_size(registers_.data(), precision_);
+    }
+    if (temp_.empty()) {
+      return sparseCardinality(sparse_.size());
+    }
+    const auto entries = mergeTempEntries();
+    if (exceedsDense(entries)) {
+      const auto registers = denseRegisters(entries);
+      return hll_size(registers.data(), precision_);
+    }
+    return sparseCardinality(entries.size());
+  }
+
+  bool isSparse() const { return registers_.empty(); }
+
+ private:
+  // An entry is a sparse index in the upper bits and its rank in the lower 6 bits, so
+  // sorting the entries groups them by index and puts the largest rank last.
+  static uint32_t encode(const uint32_t sparse_index, const uint8_t rank) {
+    return (sparse_index << 6) | rank;
+  }
+
+  uint32_t denseIndex(const uint32_t entry) const {
+    return (entry >> 6) >> (kSparsePrecision - precision_);
+  }
+
+  // Rank the hash has at the dense precision: the sparse index bits below the dense index
+  // come first in the hash, only if they are all zero the stored rank is needed.
+  uint8_t denseRank(const uint32_t entry) const {
+    const uint32_t extra_bits = kSparsePrecision - precision_;
+    const uint32_t extra_index = (entry >> 6) & ((uint32_t(1) << extra_bits) - 1);
+    if (extra_index) {
+      return extra_bits - (31 - __builtin_clz(extra_index));
+    }
+    return extra_bits + (entry & 63);
+  }
+
+  void updateRegister(const uint32_t index, const uint8_t rank) {
+    registers_[index] = std::max(registers_[index], rank);
+  }
+
+  // Linear counting over the sparse indices, HyperLogLog++ section 5.3.
+  static size_t sparseCardinality(const size_t entry_count) {
+    const double m = static_cast<double>(uint64_t(1) << kSparsePrecision);
+    return m * log(m / (m - entry_count));
+  }
+
+  bool exceedsDense(const std::vector<uint32_t>& entries) const {
+    return entries.size() * sizeof(uint32_t) > (size_t(1) << precision_);
+  }
+
+  std::vector<uint8_t> denseRegisters(const std::vector<uint32_t>& entries) const {
+    std::vector<uint8_t> registers(size_t(1) << precision_, 0);
+    for (const auto entry : entries) {
+      auto& value = registers[denseIndex(entry)];
+      value = std::max(value, denseRank(entry));
+    }
+    return registers;
+  }
+
+  size_t tempCapacity() const {
+    return std::max(size_t(16), (size_t(1) << precision_) / 16);
+  }
+
+  // The sparse list with the pending entries sorted in, keeping the largest rank per
+  // index.
+  std::vector<uint32_t> mergeTempEntries() const {
+    std::vector<uint32_t> temp(temp_);
+    std::sort(temp.begin(), temp.end());
+    std::vector<uint32_t> merged;
+    merged.reserve(sparse_.size() + temp.size());
+    std::merge(sparse_.begin(), sparse_.end(), temp.begin(), temp.end(),
+               std::back_inserter(merged));
+    std::vector<uint32_t> entries;
+    entries.reserve(merged.size());
+    for (const auto entry : merged) {
+      if (!entries.empty() && (entries.back() >> 6) == (entry >> 6)) {
+        entries.back() = entry;
+      } else {
+        entries.push_back(entry);
+      }
+    }
+    return entries;
+  }
+
+  // Sorts the pending entries into the sparse list and switches to the dense registers
+  // once the list outgrows them.
+  void mergeTemp() {
+    if (temp_.empty()) {
+      return;
+    }
+    sparse_ = mergeTempEntries();
+    temp_.clear();
+    if (exceedsDense(sparse_)) {
+      convertToDense();
+    }
+  }
+
+  void toDense() {
+    mergeTemp();
+    if (isSparse()) {
+      convertToDense();
+    }
+  }
+
+  void convertToDense() {
+    CHECK(temp_.empty());
+    registers_ = denseRegisters(sparse_);
+    std::vector<uint32_t>().swap(sparse_);
+    std::vector<uint32_t>().swap(temp_);
+  }
+
+  uint32_t precision_;
+  std::vector<uint32_t> sparse_;
+  std::vector<uint32_t> temp_;
+  std::vector<uint8_t> registers_;
+};
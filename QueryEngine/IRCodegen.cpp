@@ -270,14 +270,19 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
        level_idx < ra_exe_unit.join_quals.size();
        ++level_idx) {
     const auto& current_level_join_conditions = ra_exe_unit.join_quals[level_idx];
+    // The probe pass of a FULL join runs as a LEFT join, the inner rows it matches are
+    // marked by codegenJoinLoops.
+    const auto join_loop_type = current_level_join_conditions.type == JoinType::FULL
+                                    ? JoinType::LEFT
+                                    : current_level_join_conditions.type;
+    const bool is_outer_join = join_loop_type == JoinType::LEFT;
     std::vector<std::string> fail_reasons;
     const auto build_cur_level_hash_table = [&]() {
       if (current_level_join_conditions.quals.size() > 1) {
         const auto first_qual = *current_level_join_conditions.quals.begin();
         auto qual_bin_oper =
             std::dynamic_pointer_cast<const Analyzer::BinOper>(first_qual);
-        if (qual_bin_oper && qual_bin_oper->is_overlaps_oper() &&
-            current_level_join_conditions.type == JoinType::LEFT) {
+        if (qual_bin_oper && qual_bin_oper->is_overlaps_oper() && is_outer_join) {
           JoinCondition join_condition{{first_qual}, current_level_join_conditions.type};
 
           return buildCurrentLevelHashTable(
@@ -325,11 +330,48 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
           }
           return left_join_cond;
         };
+    if (join_loop_type == JoinType::SEMI || join_loop_type == JoinType::ANTI) {
+      // Semi and anti joins only probe for the existence of the key: a single lookup per
+      // outer row, without iterating over the matching inner rows. Their inner side is
+      // an intermediate result, there is no deleted column to check.
+      if (!current_level_hash_table) {
+        throw std::runtime_error("Hash semi join failed, reason(s): " +
+                                 boost::algorithm::join(fail_reasons, " | "));
+      }
+      join_loops.emplace_back(
+          /*kind=*/JoinLoopKind::Singleton,
+          /*type=*/join_loop_type,
+          /*iteration_domain_codegen=*/
+          [this, current_hash_table_idx, level_idx, current_level_hash_table, &co](
+              const std::vector<llvm::Value*>& prev_iters) {
+            addJoinLoopIterator(prev_iters, level_idx);
+            JoinLoopDomain domain{{0}};
+            if (current_level_hash_table->getHashType() ==
+                JoinHashTable::HashType::OneToOne) {
+              domain.slot_lookup_result =
+                  current_level_hash_table->codegenSlot(co, current_hash_table_idx);
+            } else {
+              const auto matching_set = current_level_hash_table->codegenMatchingSet(
+                  co, current_hash_table_idx);
+              domain.slot_lookup_result = cgen_state_->ir_builder_.CreateSelect(
+                  cgen_state_->ir_builder_.CreateICmpSGT(matching_set.count,
+                                                         cgen_state_->llInt(int64_t(0))),
+                  cgen_state_->llInt(int64_t(0)),
+                  cgen_state_->llInt(int64_t(-1)));
+            }
+            return domain;
+          },
+          /*outer_condition_match=*/nullptr,
+          /*found_outer_matches=*/nullptr,
+          /*is_deleted=*/nullptr);
+      ++current_hash_table_idx;
+      continue;
+    }
     if (current_level_hash_table) {
       if (current_level_hash_table->getHashType() == JoinHashTable::HashType::OneToOne) {
         join_loops.emplace_back(
             /*kind=*/JoinLoopKind::Singleton,
-            /*type=*/current_level_join_conditions.type,
+            /*type=*/join_loop_type,
             /*iteration_domain_codegen=*/
             [this, current_hash_table_idx, level_idx, current_level_hash_table, &co](
                 const std::vector<llvm::Value*>& prev_iters) {
@@ -340,14 +382,14 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
               return domain;
             },
             /*outer_condition_match=*/nullptr,
-            /*found_outer_matches=*/current_level_join_conditions.type == JoinType::LEFT
+            /*found_outer_matches=*/is_outer_join
                 ? std::function<void(llvm::Value*)>(found_outer_join_matches_cb)
                 : nullptr,
             /*is_deleted=*/is_deleted_cb);
       } else {
         join_loops.emplace_back(
             /*kind=*/JoinLoopKind::Set,
-            /*type=*/current_level_join_conditions.type,
+            /*type=*/join_loop_type,
             /*iteration_domain_codegen=*/
             [this, current_hash_table_idx, level_idx, current_level_hash_table, &co](
                 const std::vector<llvm::Value*>& prev_iters) {
@@ -360,11 +402,11 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
               return domain;
             },
             /*outer_condition_match=*/
-            current_level_join_conditions.type == JoinType::LEFT
+            is_outer_join
                 ? std::function<llvm::Value*(const std::vector<llvm::Value*>&)>(
                       outer_join_condition_multi_quals_cb)
                 : nullptr,
-            /*found_outer_matches=*/current_level_join_conditions.type == JoinType::LEFT
+            /*found_outer_matches=*/is_outer_join
                 ? std::function<void(llvm::Value*)>(found_outer_join_matches_cb)
                 : nullptr,
             /*is_deleted=*/is_deleted_cb);
@@ -400,7 +442,7 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
           };
       join_loops.emplace_back(
           /*kind=*/JoinLoopKind::UpperBound,
-          /*type=*/current_level_join_conditions.type,
+          /*type=*/join_loop_type,
           /*iteration_domain_codegen=*/
           [this, level_idx](const std::vector<llvm::Value*>& prev_iters) {
             addJoinLoopIterator(prev_iters, level_idx);
@@ -413,12 +455,12 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
             return domain;
           },
           /*outer_condition_match=*/
-          current_level_join_conditions.type == JoinType::LEFT
+          is_outer_join
               ? std::function<llvm::Value*(const std::vector<llvm::Value*>&)>(
                     outer_join_condition_cb)
               : nullptr,
           /*found_outer_matches=*/
-          current_level_join_conditions.type == JoinType::LEFT
+          is_outer_join
               ? std::function<void(llvm::Value*)>(found_outer_join_matches_cb)
               : nullptr,
           /*is_deleted=*/is_deleted_cb);
@@ -681,6 +723,9 @@ void Executor::codegenJoinLoops(const std::vector<JoinLoop>& join_loops,
         const auto loop_body_bb = llvm::BasicBlock::Create(
             builder.getContext(), "loop_body", builder.GetInsertBlock()->getParent());
         builder.SetInsertPoint(loop_body_bb);
+        if (ra_exe_unit.full_join_matched_rows) {
+          codegenFullJoinMatches(ra_exe_unit, co);
+        }
         const bool can_return_error =
             compileBody(ra_exe_unit, group_by_and_aggregate, query_mem_desc, co);
         if (can_return_error || cgen_state_->needs_error_check_ ||
@@ -699,6 +744,72 @@ void Executor::codegenJoinLoops(const std::vector<JoinLoop>& join_loops,
   cgen_state_->ir_builder_.CreateBr(loops_entry_bb);
 }
 
+// The address of the matched rows bitmap of a FULL join. It is a literal like any other,
+// hoisted out of the code when the literals are, so that the code of the next execution
+// of the query, with another bitmap, is found in the code cache.
+llvm::Value* Executor::codegenFullJoinMatchedRows(const RelAlgExecutionUnit& ra_exe_unit,
+                                                  const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_.get());
+  CHECK(ra_exe_unit.full_join_matched_rows);
+  Datum d;
+  d.bigintval =
+      reinterpret_cast<int64_t>(ra_exe_unit.full_join_matched_rows->bitmap.data());
+  const auto matched_rows = makeExpr<Analyzer::Constant>(kBIGINT, false, d);
+  CodeGenerator code_generator(this);
+  const auto matched_rows_lvs =
+      code_generator.codegen(matched_rows.get(), kENCODING_NONE, -1, co);
+  CHECK_EQ(size_t(1), matched_rows_lvs.size());
+  return matched_rows_lvs.front();
+}
+
+void Executor::codegenFullJoinMatches(const RelAlgExecutionUnit& ra_exe_unit,
+                                      const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_.get());
+  const auto matched_rows = codegenFullJoinMatchedRows(ra_exe_unit, co);
+  for (size_t level_idx = 0; level_idx < ra_exe_unit.join_quals.size(); ++level_idx) {
+    if (ra_exe_unit.join_quals[level_idx].type != JoinType::FULL) {
+      continue;
+    }
+    CHECK_LT(level_idx, cgen_state_->outer_join_match_found_per_level_.size());
+    const auto match_found = cgen_state_->outer_join_match_found_per_level_[level_idx];
+    CHECK(match_found);
+    const auto row_id_it = cgen_state_->scan_idx_to_hash_pos_.find(level_idx + 1);
+    CHECK(row_id_it != cgen_state_->scan_idx_to_hash_pos_.end());
+    const auto row_id = row_id_it->second;
+    // The iterator of a one to many hash join points into the matching set.
+    if (row_id->getType()->isPointerTy()) {
+      cgen_state_->emitCall(
+          "full_join_mark_matched_set_row",
+          {matched_rows, row_id, cgen_state_->castToTypeIn(match_found, 8)});
+    } else {
+      cgen_state_->emitCall("full_join_mark_matched_row",
+                            {matched_rows,
+                             cgen_state_->ir_builder_.CreateSelect(
+                                 match_found, row_id, cgen_state_->llInt(int64_t(-1)))});
+    }
+  }
+}
+
+llvm::Value* Executor::codegenFullJoinUnmatched(const RelAlgExecutionUnit& ra_exe_unit,
+                                                const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_.get());
+  CHECK(ra_exe_unit.full_join_matched_rows);
+  CHECK(ra_exe_unit.join_quals.empty());
+  CHECK_EQ(size_t(1), ra_exe_unit.input_descs.size());
+  // The position of a row in the inner table during the probe pass is its rowid.
+  const auto table_id = ra_exe_unit.input_descs.front().getTableId();
+  const auto rowid_cd = catalog_->getMetadataForColumn(table_id, "rowid");
+  CHECK(rowid_cd);
+  Analyzer::ColumnVar rowid(rowid_cd->columnType, table_id, rowid_cd->columnId, 0);
+  CodeGenerator code_generator(this);
+  const auto row_id = code_generator.codegen(&rowid, true, co).front();
+  const auto matched = cgen_state_->emitCall(
+      "full_join_row_matched",
+      {codegenFullJoinMatchedRows(ra_exe_unit, co),
+       cgen_state_->castToTypeIn(row_id, 64)});
+  return cgen_state_->ir_builder_.CreateICmpEQ(matched, cgen_state_->llInt(int8_t(0)));
+}
+
 Executor::GroupColLLVMValue Executor::groupByColumnCodegen(
     Analyzer::Expr* group_by_col,
     const size_t col_width,
@@ -17,6 +17,7 @@
 #include "BaselineJoinHashTable.h"
 
 #include <future>
+#include <unordered_set>
 
 #include "DataMgr/Allocators/CudaAllocator.h"
 #include "QueryEngine/CodeGenerator.h"
@@ -25,11 +26,47 @@
 #include "QueryEngine/ExpressionRewrite.h"
 #include "QueryEngine/JoinHashTable/HashJoinKeyHandlers.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableGpuUtils.h"
+#include "Shared/scope.h"
+
+bool g_enable_partitioned_hash_join_build{true};
+size_t g_hash_join_build_partition_bytes{256 * 1024};
+
+namespace {
+
+// Below this many partitions, scattering the rows costs more than the cache misses it
+// saves. Above the maximum, the scatter itself misses the TLB.
+constexpr size_t kMinBuildPartitionCount{8};
+constexpr size_t kMaxBuildPartitionCount{1024};
+
+// Number of partitions to split the CPU build of a baseline hash table into, such that
+// each partition covers at most g_hash_join_build_partition_bytes of its keys. Returns 1
+// if the table should be built directly: when it's small enough to mostly stay in cache,
+// or when the keys need a dictionary translation, which partitioning would do twice.
+size_t get_build_partition_count(const size_t keys_size_bytes,
+                                 const std::vector<const void*>& sd_inner_proxy_per_key) {
+  if (!g_enable_partitioned_hash_join_build || g_hash_join_build_partition_bytes == 0) {
+    return 1;
+  }
+  if (std::any_of(sd_inner_proxy_per_key.begin(),
+                  sd_inner_proxy_per_key.end(),
+                  [](const void* sd_inner_proxy) { return sd_inner_proxy; })) {
+    return 1;
+  }
+  const size_t partition_count =
+      (keys_size_bytes + g_hash_join_build_partition_bytes - 1) /
+      g_hash_join_build_partition_bytes;
+  if (partition_count < kMinBuildPartitionCount) {
+    return 1;
+  }
+  return std::min(partition_count, kMaxBuildPartitionCount);
+}
+
+}  // namespace
 
-std::vector<std::pair<BaselineJoinHashTable::HashTableCacheKey,
-                      BaselineJoinHashTable::HashTableCacheValue>>
+HashTableCache<BaselineJoinHashTable::HashTableCacheKey,
+               BaselineJoinHashTable::HashTableCacheValue,
+               BaselineJoinHashTable::HashTableCacheKeyHash>
     BaselineJoinHashTable::hash_table_cache_;
-std::mutex BaselineJoinHashTable::hash_table_cache_mutex_;
 
 //! Make hash table from an in-flight SQL query's parse tree etc.
 std::shared_ptr<BaselineJoinHashTable> BaselineJoinHashTable::getInstance(
@@ -346,6 +383,85 @@ void BaselineJoinHashTable::reify() {
                        JoinHashTableInterface::HashType::OneToMany);
     reifyWithLayout(JoinHashTableInterface::HashType::OneToMany);
   }
+  computeInnerKeySummaries();
+}
+
+void BaselineJoinHashTable::computeInnerKeySummaries() {
+  if (isBitwiseEq() || shardCount()) {
+    return;
+  }
+  const auto key_component_count = getKeyComponentCount();
+  std::vector<JoinKeySummary> summaries;
+  for (const auto& inner_outer_pair : inner_outer_pairs_) {
+    summaries.push_back({get_join_key_summary_column(inner_outer_pair.first,
+                                                     inner_outer_pair.second),
+                         std::numeric_limits<int64_t>::max(),
+                         std::numeric_limits<int64_t>::min(),
+                         {}});
+  }
+  const auto key_component_width = getKeyComponentWidth();
+  const auto entry_size =
+      (key_component_count +
+       (layout_ == JoinHashTableInterface::HashType::OneToOne ? 1 : 0)) *
+      key_component_width;
+  // Both layouts start with the keys of the entries, entry_size bytes apart.
+  const auto keys_size = entry_count_ * entry_size;
+  const int8_t* keys{nullptr};
+  std::vector<int8_t> gpu_keys;
+  if (cpu_hash_table_buff_) {
+    CHECK_LE(keys_size, cpu_hash_table_buff_->size());
+    keys = cpu_hash_table_buff_->data();
+  } else {
+#ifdef HAVE_CUDA
+    // Every device holds the same table, read the keys back from the first one.
+    if (memory_level_ != Data_Namespace::GPU_LEVEL || gpu_hash_table_buff_.empty() ||
+        !gpu_hash_table_buff_.front()) {
+      return;
+    }
+    gpu_keys.resize(keys_size);
+    copy_from_gpu(
+        &catalog_->getDataMgr(),
+        gpu_keys.data(),
+        reinterpret_cast<CUdeviceptr>(gpu_hash_table_buff_.front()->getMemoryPtr()),
+        keys_size,
+        0);
+    keys = gpu_keys.data();
+#else
+    return;
+#endif
+  }
+  const auto key_component = [key_component_width](const int8_t* entry,
+                                                   const size_t idx) -> int64_t {
+    return key_component_width == 4 ? reinterpret_cast<const int32_t*>(entry)[idx]
+                                    : reinterpret_cast<const int64_t*>(entry)[idx];
+  };
+  const int64_t empty_key = key_component_width == 4 ? EMPTY_KEY_32 : EMPTY_KEY_64;
+  std::vector<std::unordered_set<int64_t>> distinct_keys(key_component_count);
+  for (size_t i = 0; i < entry_count_; ++i) {
+    const auto entry = keys + i * entry_size;
+    if (key_component(entry, 0) == empty_key) {
+      continue;
+    }
+    for (size_t j = 0; j < key_component_count; ++j) {
+      const auto key = key_component(entry, j);
+      summaries[j].min_key = std::min(summaries[j].min_key, key);
+      summaries[j].max_key = std::max(summaries[j].max_key, key);
+      if (distinct_keys[j].size() <= JoinKeySummary::kMaxKeys) {
+        distinct_keys[j].insert(key);
+      }
+    }
+  }
+  for (size_t j = 0; j < key_component_count; ++j) {
+    auto& summary = summaries[j];
+    if (!summary.outer_col) {
+      continue;
+    }
+    if (distinct_keys[j].size() <= JoinKeySummary::kMaxKeys) {
+      summary.keys.assign(distinct_keys[j].begin(), distinct_keys[j].end());
+      std::sort(summary.keys.begin(), summary.keys.end());
+    }
+    inner_key_summaries_.push_back(std::move(summary));
+  }
 }
 
 void BaselineJoinHashTable::reifyWithLayout(
@@ -393,13 +509,14 @@ void BaselineJoinHashTable::reifyWithLayout(
         shard_count
             ? only_shards_for_device(query_info.fragments, device_id, device_count_)
             : query_info.fragments;
-    init_threads.push_back(std::async(std::launch::async,
-                                      &BaselineJoinHashTable::reifyForDevice,
-                                      this,
-                                      columns_per_device[device_id],
-                                      layout,
-                                      device_id,
-                                      logger::thread_id()));
+    init_threads.push_back(std::async(
+        std::launch::async,
+        with_cpu_thread_budget(&BaselineJoinHashTable::reifyForDevice),
+        this,
+        columns_per_device[device_id],
+        layout,
+        device_id,
+        logger::thread_id()));
   }
   for (auto& init_thread : init_threads) {
     init_thread.wait();
@@ -638,6 +755,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(
   if (cpu_hash_table_buff_) {
     return 0;
   }
+  const auto build_clock_begin = timer_start();
   const auto key_component_width = getKeyComponentWidth();
   const auto key_component_count = getKeyComponentCount();
   const auto entry_size =
@@ -705,71 +823,134 @@ int BaselineJoinHashTable::initHashTableOnCpu(
   for (auto& child : init_cpu_buff_threads) {
     child.get();
   }
-  std::vector<std::future<int>> fill_cpu_buff_threads;
-  for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-    fill_cpu_buff_threads.emplace_back(std::async(
-        std::launch::async,
-        [this,
-         &composite_key_info,
-         &join_columns,
-         &join_column_types,
-         key_component_count,
-         key_component_width,
-         layout,
-         thread_idx,
-         thread_count] {
-          switch (key_component_width) {
-            case 4: {
-              const auto key_handler =
-                  GenericKeyHandler(key_component_count,
-                                    true,
-                                    &join_columns[0],
-                                    &join_column_types[0],
-                                    &composite_key_info.sd_inner_proxy_per_key[0],
-                                    &composite_key_info.sd_outer_proxy_per_key[0]);
-              return fill_baseline_hash_join_buff_32(
-                  &(*cpu_hash_table_buff_)[0],
-                  entry_count_,
-                  -1,
-                  key_component_count,
-                  layout == JoinHashTableInterface::HashType::OneToOne,
-                  &key_handler,
-                  join_columns[0].num_elems,
-                  thread_idx,
-                  thread_count);
-              break;
-            }
-            case 8: {
-              const auto key_handler =
-                  GenericKeyHandler(key_component_count,
-                                    true,
-                                    &join_columns[0],
-                                    &join_column_types[0],
-                                    &composite_key_info.sd_inner_proxy_per_key[0],
-                                    &composite_key_info.sd_outer_proxy_per_key[0]);
-              return fill_baseline_hash_join_buff_64(
-                  &(*cpu_hash_table_buff_)[0],
-                  entry_count_,
-                  -1,
-                  key_component_count,
-                  layout == JoinHashTableInterface::HashType::OneToOne,
-                  &key_handler,
-                  join_columns[0].num_elems,
-                  thread_idx,
-                  thread_count);
-              break;
-            }
-            default:
-              CHECK(false);
-          }
-          return -1;
-        }));
+  auto partition_count = get_build_partition_count(
+      entry_count_ * entry_size, composite_key_info.sd_inner_proxy_per_key);
+  // The rows are scattered into a buffer of the CPU buffer pool, so that it counts
+  // towards the CPU memory limit. Build directly if the pool can't hold it.
+  auto& data_mgr = catalog_->getDataMgr();
+  Data_Namespace::AbstractBuffer* records_buffer{nullptr};
+  ScopeGuard free_records_buffer = [&data_mgr, &records_buffer] {
+    if (records_buffer) {
+      data_mgr.free(records_buffer);
+    }
+  };
+  const auto records_size = get_partitioned_build_records_size(
+      join_columns[0].num_elems, key_component_count, key_component_width);
+  if (partition_count > 1) {
+    try {
+      records_buffer = data_mgr.alloc(Data_Namespace::CPU_LEVEL, 0, records_size);
+    } catch (const OutOfMemory& e) {
+      VLOG(1) << "Building the CPU Join Hash Table directly: " << e.what();
+      partition_count = 1;
+    }
   }
   int err = 0;
-  for (auto& child : fill_cpu_buff_threads) {
-    int partial_err = child.get();
-    if (partial_err) {
-      err = partial_err;
+  if (partition_count > 1) {
+    VLOG(1) << "Building the CPU Join Hash Table in " << partition_count
+            << " partitions";
+    const auto key_handler =
+        GenericKeyHandler(key_component_count,
+                          true,
+                          &join_columns[0],
+                          &join_column_types[0],
+                          &composite_key_info.sd_inner_proxy_per_key[0],
+                          &composite_key_info.sd_outer_proxy_per_key[0]);
+    switch (key_component_width) {
+      case 4:
+        err = fill_baseline_hash_join_buff_partitioned_32(
+            &(*cpu_hash_table_buff_)[0],
+            entry_count_,
+            -1,
+            key_component_count,
+            layout == JoinHashTableInterface::HashType::OneToOne,
+            &key_handler,
+            partition_count,
+            records_buffer->getMemoryPtr(),
+            records_size,
+            thread_count);
+        break;
+      case 8:
+        err = fill_baseline_hash_join_buff_partitioned_64(
+            &(*cpu_hash_table_buff_)[0],
+            entry_count_,
+            -1,
+            key_component_count,
+            layout == JoinHashTableInterface::HashType::OneToOne,
+            &key_handler,
+            partition_count,
+            records_buffer->getMemoryPtr(),
+            records_size,
+            thread_count);
+        break;
+      default:
+        CHECK(false);
+    }
+  } else {
+    std::vector<std::future<int>> fill_cpu_buff_threads;
+    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      fill_cpu_buff_threads.emplace_back(std::async(
+          std::launch::async,
+          [this,
+           &composite_key_info,
+           &join_columns,
+           &join_column_types,
+           key_component_count,
+           key_component_width,
+           layout,
+           thread_idx,
+           thread_count] {
+            switch (key_component_width) {
+              case 4: {
+                const auto key_handler =
+                    GenericKeyHandler(key_component_count,
+                                      true,
+                                      &join_columns[0],
+                                      &join_column_types[0],
+                                      &composite_key_info.sd_inner_proxy_per_key[0],
+                                      &composite_key_info.sd_outer_proxy_per_key[0]);
+                return fill_baseline_hash_join_buff_32(
+                    &(*cpu_hash_table_buff_)[0],
+                    entry_count_,
+                    -1,
+                    key_component_count,
+                    layout == JoinHashTableInterface::HashType::OneToOne,
+                    &key_handler,
+                    join_columns[0].num_elems,
+                    thread_idx,
+                    thread_count);
+                break;
+              }
+              case 8: {
+                const auto key_handler =
+                    GenericKeyHandler(key_component_count,
+                                      true,
+                                      &join_columns[0],
+                                      &join_column_types[0],
+                                      &composite_key_info.sd_inner_proxy_per_key[0],
+                                      &composite_key_info.sd_outer_proxy_per_key[0]);
+                return fill_baseline_hash_join_buff_64(
+                    &(*cpu_hash_table_buff_)[0],
+                    entry_count_,
+                    -1,
+                    key_component_count,
+                    layout == JoinHashTableInterface::HashType::OneToOne,
+                    &key_handler,
+                    join_columns[0].num_elems,
+                    thread_idx,
+                    thread_count);
+                break;
+              }
+              default:
+                CHECK(false);
+            }
+            return -1;
+          }));
+    }
+    for (auto& child : fill_cpu_buff_threads) {
+      int partial_err = child.get();
+      if (partial_err) {
+        err = partial_err;
+      }
     }
   }
   if (err) {
@@ -818,7 +999,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(
     }
   }
   if (!err && getInnerTableId() > 0) {
-    putHashTableOnCpuToCache(cache_key);
+    putHashTableOnCpuToCache(cache_key, timer_stop(build_clock_begin));
   }
   return err;
 }
@@ -1231,58 +1412,47 @@ void BaselineJoinHashTable::checkHashJoinReplicationConstraint(const int table_i
   }
 }
 
-const BaselineJoinHashTable::HashTableCacheValue*
+std::optional<BaselineJoinHashTable::HashTableCacheValue>
 BaselineJoinHashTable::findHashTableOnCpuInCache(const HashTableCacheKey& key) {
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      return &kv.second;
-    }
-  }
-  return nullptr;
+  return hash_table_cache_.peek(key);
 }
 
 void BaselineJoinHashTable::initHashTableOnCpuFromCache(const HashTableCacheKey& key) {
   auto timer = DEBUG_TIMER(__func__);
   VLOG(1) << "Checking CPU hash table cache.";
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  if (hash_table_cache_.size() == 0) {
-    VLOG(1) << "CPU hash table cache was empty.";
-  }
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      VLOG(1) << "Found a suitable hash table in the cache.";
-      cpu_hash_table_buff_ = kv.second.buffer;
-      layout_ = kv.second.type;
-      entry_count_ = kv.second.entry_count;
-      emitted_keys_count_ = kv.second.emitted_keys_count;
-      break;
-    } else {
-      VLOG(1) << hash_table_cache_.size()
-              << " hash tables found in cache. None were suitable for this query.";
-    }
+  const auto cached_hash_table = hash_table_cache_.get(key);
+  if (!cached_hash_table) {
+    VLOG(1) << hash_table_cache_.size()
+            << " hash tables found in cache. None were suitable for this query.";
+    return;
   }
+  VLOG(1) << "Found a suitable hash table in the cache.";
+  cpu_hash_table_buff_ = cached_hash_table->buffer;
+  layout_ = cached_hash_table->type;
+  entry_count_ = cached_hash_table->entry_count;
+  emitted_keys_count_ = cached_hash_table->emitted_keys_count;
 }
 
-void BaselineJoinHashTable::putHashTableOnCpuToCache(const HashTableCacheKey& key) {
+void BaselineJoinHashTable::putHashTableOnCpuToCache(const HashTableCacheKey& key,
+                                                     const int64_t build_time_ms) {
+  std::vector<std::pair<int, int>> table_keys;
   for (auto chunk_key : key.chunk_keys) {
     CHECK_GE(chunk_key.size(), size_t(2));
     if (chunk_key[1] < 0) {
       return;
     }
+    table_keys.emplace_back(chunk_key[0], chunk_key[1]);
   }
 
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
   VLOG(1) << "Storing hash table in cache.";
-  for (const auto& kv : hash_table_cache_) {
-    if (std::get<0>(kv) == key) {
-      return;
-    }
-  }
-  hash_table_cache_.emplace_back(
+  CHECK(cpu_hash_table_buff_);
+  hash_table_cache_.put(
       key,
       HashTableCacheValue{
-          cpu_hash_table_buff_, layout_, entry_count_, emitted_keys_count_});
+          cpu_hash_table_buff_, layout_, entry_count_, emitted_keys_count_},
+      cpu_hash_table_buff_->size(),
+      build_time_ms,
+      std::move(table_keys));
 }
 
 std::pair<std::optional<size_t>, size_t>
@@ -1296,11 +1466,10 @@ BaselineJoinHashTable::getApproximateTupleCountFromCache(
     }
   }
 
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      return std::make_pair(kv.second.entry_count / 2, kv.second.emitted_keys_count);
-    }
+  const auto cached_hash_table = hash_table_cache_.peek(key);
+  if (cached_hash_table) {
+    return std::make_pair(cached_hash_table->entry_count / 2,
+                          cached_hash_table->emitted_keys_count);
   }
   return std::make_pair(std::nullopt, 0);
 }
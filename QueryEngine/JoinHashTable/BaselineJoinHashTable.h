@@ -19,9 +19,11 @@
 #ifdef HAVE_CUDA
 #include <cuda.h>
 #endif
+#include <boost/functional/hash.hpp>
 #include <cstdint>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <unordered_set>
 #include <vector>
@@ -32,6 +34,7 @@
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/InputMetadata.h"
 #include "QueryEngine/JoinHashTable/HashJoinRuntime.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 class Executor;
@@ -93,32 +96,35 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   size_t payloadBufferOff() const noexcept override;
 
+  const std::vector<JoinKeySummary>& getInnerKeySummaries() const noexcept override {
+    return inner_key_summaries_;
+  }
+
   static auto yieldCacheInvalidator() -> std::function<void()> {
     VLOG(1) << "Invalidate " << hash_table_cache_.size() << " cached baseline hashtable.";
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-      hash_table_cache_.clear();
+    return []() -> void { hash_table_cache_.clear(); };
+  }
+
+  static auto yieldCacheInvalidator(const int db_id, const int table_id)
+      -> std::function<void()> {
+    return [db_id, table_id]() -> void {
+      const auto removed = hash_table_cache_.invalidateTable(db_id, table_id);
+      VLOG(1) << "Invalidated " << removed << " cached baseline hashtables of table "
+              << table_id;
     };
   }
 
-  static const std::shared_ptr<std::vector<int8_t>>& getCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    CHECK(!hash_table_cache_.empty());
-    CHECK_LT(idx, hash_table_cache_.size());
-    return hash_table_cache_.at(idx).second.buffer;
+  static std::shared_ptr<std::vector<int8_t>> getCachedHashTable(size_t idx) {
+    return hash_table_cache_.getValueAt(idx).buffer;
   }
 
   static size_t getEntryCntCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    CHECK(!hash_table_cache_.empty());
-    CHECK_LT(idx, hash_table_cache_.size());
-    return hash_table_cache_.at(idx).second.entry_count;
+    return hash_table_cache_.getValueAt(idx).entry_count;
   }
 
-  static uint64_t getNumberOfCachedHashTables() {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    return hash_table_cache_.size();
-  }
+  static uint64_t getNumberOfCachedHashTables() { return hash_table_cache_.size(); }
+
+  static HashTableCacheStats getCacheStats() { return hash_table_cache_.getStats(); }
 
   virtual ~BaselineJoinHashTable();
 
@@ -241,15 +247,29 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
     }
   };
 
+  // Threshold excluded, equal keys must hash the same and thresholds compare with a
+  // tolerance.
+  struct HashTableCacheKeyHash {
+    size_t operator()(const HashTableCacheKey& key) const {
+      size_t seed{0};
+      boost::hash_combine(seed, key.num_elements);
+      boost::hash_combine(seed, key.chunk_keys);
+      boost::hash_combine(seed, static_cast<int>(key.optype));
+      return seed;
+    }
+  };
+
   void initHashTableOnCpuFromCache(const HashTableCacheKey&);
 
-  void putHashTableOnCpuToCache(const HashTableCacheKey&);
+  void putHashTableOnCpuToCache(const HashTableCacheKey&, const int64_t build_time_ms);
 
   std::pair<std::optional<size_t>, size_t> getApproximateTupleCountFromCache(
       const HashTableCacheKey&) const;
 
   bool isBitwiseEq() const;
 
+  void computeInnerKeySummaries();
+
   void freeHashBufferMemory();
   void freeHashBufferGpuMemory();
   void freeHashBufferCpuMemory();
@@ -274,6 +294,7 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_buff_;
 #endif
   std::vector<InnerOuter> inner_outer_pairs_;
+  std::vector<JoinKeySummary> inner_key_summaries_;
   const Catalog_Namespace::Catalog* catalog_;
   const int device_count_;
 #ifdef HAVE_CUDA
@@ -288,10 +309,10 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
     const size_t emitted_keys_count;
   };
 
-  const HashTableCacheValue* findHashTableOnCpuInCache(const HashTableCacheKey&);
+  std::optional<HashTableCacheValue> findHashTableOnCpuInCache(const HashTableCacheKey&);
 
-  static std::vector<std::pair<HashTableCacheKey, HashTableCacheValue>> hash_table_cache_;
-  static std::mutex hash_table_cache_mutex_;
+  static HashTableCache<HashTableCacheKey, HashTableCacheValue, HashTableCacheKeyHash>
+      hash_table_cache_;
 
   static const int ERR_FAILED_TO_FETCH_COLUMN{-3};
   static const int ERR_FAILED_TO_JOIN_ON_VIRTUAL_COLUMN{-4};
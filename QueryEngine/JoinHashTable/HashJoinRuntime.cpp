@@ -34,6 +34,7 @@
 #include "StringDictionary/StringDictionary.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 
+#include <atomic>
 #include <future>
 #endif
 
@@ -439,17 +440,18 @@ T* get_matching_baseline_hash_slot_at(int8_t* hash_buff,
 
 #endif  // __CUDACC__
 
+// Writes the key and the value to the first slot matching the key or empty, starting
+// from slot h.
 template <typename T>
-DEVICE int write_baseline_hash_slot(const int32_t val,
-                                    int8_t* hash_buff,
-                                    const int64_t entry_count,
-                                    const T* key,
-                                    const size_t key_component_count,
-                                    const bool with_val_slot,
-                                    const int32_t invalid_slot_val,
-                                    const size_t key_size_in_bytes,
-                                    const size_t hash_entry_size) {
-  const uint32_t h = MurmurHash1Impl(key, key_size_in_bytes, 0) % entry_count;
+DEVICE int write_baseline_hash_slot_from(const uint32_t h,
+                                         const int32_t val,
+                                         int8_t* hash_buff,
+                                         const int64_t entry_count,
+                                         const T* key,
+                                         const size_t key_component_count,
+                                         const bool with_val_slot,
+                                         const int32_t invalid_slot_val,
+                                         const size_t hash_entry_size) {
   T* matching_group = get_matching_baseline_hash_slot_at(
       hash_buff, h, key, key_component_count, hash_entry_size);
   if (!matching_group) {
@@ -475,6 +477,28 @@ DEVICE int write_baseline_hash_slot(const int32_t val,
   return 0;
 }
 
+template <typename T>
+DEVICE int write_baseline_hash_slot(const int32_t val,
+                                    int8_t* hash_buff,
+                                    const int64_t entry_count,
+                                    const T* key,
+                                    const size_t key_component_count,
+                                    const bool with_val_slot,
+                                    const int32_t invalid_slot_val,
+                                    const size_t key_size_in_bytes,
+                                    const size_t hash_entry_size) {
+  const uint32_t h = MurmurHash1Impl(key, key_size_in_bytes, 0) % entry_count;
+  return write_baseline_hash_slot_from(h,
+                                       val,
+                                       hash_buff,
+                                       entry_count,
+                                       key,
+                                       key_component_count,
+                                       with_val_slot,
+                                       invalid_slot_val,
+                                       hash_entry_size);
+}
+
 template <typename T, typename FILL_HANDLER>
 DEVICE int SUFFIX(fill_baseline_hash_join_buff)(int8_t* hash_buff,
                                                 const int64_t entry_count,
@@ -1724,6 +1748,195 @@ int overlaps_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                                cpu_thread_count);
 }
 
+namespace {
+
+/**
+ * Radix partitioned build of a baseline hash table. The rows are first scattered into
+ * partition_count partitions by the hash table slot their key maps to, each partition
+ * covering a contiguous range of slots, then the threads insert one whole partition at a
+ * time. The part of the table a thread writes to stays in its cache, instead of every
+ * insertion missing it as when the rows are inserted in scan order. Linear probing can
+ * spill past the end of a partition into the next one, so the slots are still written
+ * with atomics. The rows are scattered into records_buff, which the caller allocates
+ * from the CPU buffer pool, see get_partitioned_build_records_size().
+ */
+template <typename T>
+int fill_baseline_hash_join_buff_partitioned(int8_t* hash_buff,
+                                             const int64_t entry_count,
+                                             const int32_t invalid_slot_val,
+                                             const size_t key_component_count,
+                                             const bool with_val_slot,
+                                             const GenericKeyHandler* key_handler,
+                                             const size_t partition_count,
+                                             int8_t* records_buff,
+                                             const size_t records_buff_size,
+                                             const int32_t cpu_thread_count) {
+  CHECK_GT(entry_count, int64_t(0));
+  CHECK_GT(partition_count, size_t(0));
+  CHECK_GT(cpu_thread_count, 0);
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  const size_t hash_entry_size =
+      (key_component_count + (with_val_slot ? 1 : 0)) * sizeof(T);
+  // A partitioned row is stored as its row id, its hash slot and its key.
+  const size_t record_size = 2 + key_component_count;
+  const auto get_partition = [entry_count, partition_count](const uint32_t h) {
+    return static_cast<size_t>(h) * partition_count / entry_count;
+  };
+  // Calls f(row id, hash slot, key) for the rows of the slice of the given thread which
+  // make it into the hash table.
+  const auto for_each_row = [key_handler,
+                             key_size_in_bytes,
+                             entry_count,
+                             cpu_thread_count](const int32_t cpu_thread_idx, auto f) {
+    T key_scratch_buff[g_maximum_conditions_to_coalesce];
+    JoinColumnTuple cols(key_handler->get_number_of_columns(),
+                         key_handler->get_join_columns(),
+                         key_handler->get_join_column_type_infos());
+    for (auto& it : cols.slice(cpu_thread_idx, cpu_thread_count)) {
+      (*key_handler)(
+          it.join_column_iterators,
+          key_scratch_buff,
+          [&f, key_size_in_bytes, entry_count](
+              const int64_t row_id, const T* key, const size_t) {
+            const uint32_t h = MurmurHash1Impl(key, key_size_in_bytes, 0) % entry_count;
+            f(row_id, h, key);
+            return 0;
+          });
+    }
+  };
+
+  // Count the rows of every partition per thread, then turn the counts into the offsets
+  // the threads scatter their rows at, partition by partition.
+  std::vector<std::vector<size_t>> offsets(cpu_thread_count,
+                                           std::vector<size_t>(partition_count, 0));
+  std::vector<std::future<void>> count_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    count_threads.push_back(std::async(std::launch::async, [&, cpu_thread_idx] {
+      auto& counts = offsets[cpu_thread_idx];
+      for_each_row(cpu_thread_idx, [&](const int64_t, const uint32_t h, const T*) {
+        ++counts[get_partition(h)];
+      });
+    }));
+  }
+  for (auto& child : count_threads) {
+    child.get();
+  }
+  std::vector<size_t> partition_offsets(partition_count + 1);
+  size_t row_count{0};
+  for (size_t partition = 0; partition < partition_count; ++partition) {
+    partition_offsets[partition] = row_count;
+    for (auto& thread_offsets : offsets) {
+      const auto count = thread_offsets[partition];
+      thread_offsets[partition] = row_count;
+      row_count += count;
+    }
+  }
+  partition_offsets[partition_count] = row_count;
+
+  CHECK_LE(row_count * record_size * sizeof(T), records_buff_size);
+  auto records = reinterpret_cast<T*>(records_buff);
+  std::vector<std::future<void>> scatter_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    scatter_threads.push_back(std::async(std::launch::async, [&, cpu_thread_idx] {
+      auto& positions = offsets[cpu_thread_idx];
+      for_each_row(cpu_thread_idx,
+                   [&](const int64_t row_id, const uint32_t h, const T* key) {
+                     const auto record =
+                         &records[positions[get_partition(h)]++ * record_size];
+                     record[0] = row_id;
+                     record[1] = h;
+                     memcpy(record + 2, key, key_size_in_bytes);
+                   });
+    }));
+  }
+  for (auto& child : scatter_threads) {
+    child.get();
+  }
+
+  std::atomic<size_t> next_partition{0};
+  std::vector<std::future<int>> fill_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    fill_threads.push_back(std::async(std::launch::async, [&] {
+      for (size_t partition = next_partition++; partition < partition_count;
+           partition = next_partition++) {
+        for (size_t i = partition_offsets[partition];
+             i < partition_offsets[partition + 1];
+             ++i) {
+          const auto record = &records[i * record_size];
+          const auto err =
+              write_baseline_hash_slot_from<T>(static_cast<uint32_t>(record[1]),
+                                               static_cast<int32_t>(record[0]),
+                                               hash_buff,
+                                               entry_count,
+                                               record + 2,
+                                               key_component_count,
+                                               with_val_slot,
+                                               invalid_slot_val,
+                                               hash_entry_size);
+          if (err) {
+            return err;
+          }
+        }
+      }
+      return 0;
+    }));
+  }
+  int err = 0;
+  for (auto& child : fill_threads) {
+    const int partial_err = child.get();
+    if (partial_err) {
+      err = partial_err;
+    }
+  }
+  return err;
+}
+
+}  // namespace
+
+int fill_baseline_hash_join_buff_partitioned_32(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                int8_t* records_buff,
+                                                const size_t records_buff_size,
+                                                const int32_t cpu_thread_count) {
+  return fill_baseline_hash_join_buff_partitioned<int32_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           records_buff,
+                                                           records_buff_size,
+                                                           cpu_thread_count);
+}
+
+int fill_baseline_hash_join_buff_partitioned_64(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                int8_t* records_buff,
+                                                const size_t records_buff_size,
+                                                const int32_t cpu_thread_count) {
+  return fill_baseline_hash_join_buff_partitioned<int64_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           records_buff,
+                                                           records_buff_size,
+                                                           cpu_thread_count);
+}
+
 template <typename T>
 void fill_one_to_many_baseline_hash_table(
     int32_t* buff,
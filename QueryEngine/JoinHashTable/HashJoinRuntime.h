@@ -297,6 +297,35 @@ int overlaps_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                              const int32_t cpu_thread_idx,
                                              const int32_t cpu_thread_count);
 
+// Size of the buffer the partitioned build scatters num_elems inner rows into.
+inline size_t get_partitioned_build_records_size(const size_t num_elems,
+                                                 const size_t key_component_count,
+                                                 const size_t key_component_width) {
+  return num_elems * (2 + key_component_count) * key_component_width;
+}
+
+int fill_baseline_hash_join_buff_partitioned_32(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                int8_t* records_buff,
+                                                const size_t records_buff_size,
+                                                const int32_t cpu_thread_count);
+
+int fill_baseline_hash_join_buff_partitioned_64(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                int8_t* records_buff,
+                                                const size_t records_buff_size,
+                                                const int32_t cpu_thread_count);
+
 void fill_baseline_hash_join_buff_on_device_32(int8_t* hash_buff,
                                                const int64_t entry_count,
                                                const int32_t invalid_slot_val,
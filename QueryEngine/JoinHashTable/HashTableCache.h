@@ -0,0 +1,267 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    HashTableCache.h
+ * @brief   Cache of the join hash tables built on CPU, shared by all queries.
+ *
+ * Entries are spread over kShardCount shards by the hash of their key, each with its own
+ * lock, so concurrent lookups for different tables don't serialize. The total size of
+ * the cached tables is kept below g_hash_table_cache_max_bytes: when an insertion goes
+ * over the budget, entries are evicted from the least recently used end of the shards.
+ * Among the few least recently used entries of a shard the one which was the cheapest to
+ * build per byte goes first, a large table which took long to build survives a burst of
+ * small ones. Every entry records the tables it has been built from, so that changes to
+ * a table only drop the hash tables built on it.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Logger/Logger.h"
+
+extern size_t g_hash_table_cache_max_bytes;
+
+struct HashTableCacheStats {
+  size_t entry_count{0};
+  size_t size_bytes{0};
+  size_t max_size_bytes{0};
+  size_t hits{0};
+  size_t misses{0};
+  size_t evictions{0};
+  size_t invalidations{0};
+};
+
+template <typename K, typename V, typename KeyHash>
+class HashTableCache {
+ public:
+  // (database id, table id) of a table a cached hash table has been built from
+  using TableKey = std::pair<int, int>;
+
+  static constexpr size_t kShardCount{16};
+  // Number of least recently used entries of a shard considered for eviction.
+  static constexpr size_t kEvictionCandidates{4};
+
+  HashTableCache() : size_bytes_(0), next_seq_(0), eviction_shard_(0) {}
+
+  std::optional<V> get(const K& key) {
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      ++misses_;
+      return std::nullopt;
+    }
+    ++hits_;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->value;
+  }
+
+  // Looks up the key without updating the statistics or the recency of the entry.
+  std::optional<V> peek(const K& key) const {
+    const auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      return std::nullopt;
+    }
+    return it->second->value;
+  }
+
+  // Inserts the value unless the key is already cached. build_cost is the time it took
+  // to build the hash table, in milliseconds. Returns false if the value is larger than
+  // the whole budget of the cache and hasn't been inserted.
+  bool put(const K& key,
+           const V& value,
+           const size_t size_bytes,
+           const int64_t build_cost,
+           std::vector<TableKey> table_keys) {
+    if (size_bytes > g_hash_table_cache_max_bytes) {
+      VLOG(1) << "Not caching a hash table of " << size_bytes
+              << " bytes, larger than the cache budget.";
+      return false;
+    }
+    const double build_cost_per_byte =
+        static_cast<double>(std::max(build_cost, int64_t(1))) /
+        std::max(size_bytes, size_t(1));
+    {
+      auto& shard = getShard(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (shard.index.count(key)) {
+        return true;
+      }
+      shard.entries.push_front(Entry{key,
+                                     value,
+                                     size_bytes,
+                                     build_cost_per_byte,
+                                     next_seq_++,
+                                     std::move(table_keys)});
+      shard.index.emplace(key, shard.entries.begin());
+      size_bytes_ += size_bytes;
+    }
+    evictOverBudget();
+    return true;
+  }
+
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (const auto& entry : shard.entries) {
+        size_bytes_ -= entry.size_bytes;
+      }
+      shard.index.clear();
+      shard.entries.clear();
+    }
+  }
+
+  // Drops the hash tables built from the given table. Returns the number of entries
+  // removed.
+  size_t invalidateTable(const int db_id, const int table_id) {
+    const TableKey table_key{db_id, table_id};
+    size_t removed{0};
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+        const auto& table_keys = it->table_keys;
+        if (std::find(table_keys.begin(), table_keys.end(), table_key) ==
+            table_keys.end()) {
+          ++it;
+          continue;
+        }
+        size_bytes_ -= it->size_bytes;
+        shard.index.erase(it->key);
+        it = shard.entries.erase(it);
+        ++removed;
+      }
+    }
+    invalidations_ += removed;
+    return removed;
+  }
+
+  size_t size() const {
+    size_t entry_count{0};
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      entry_count += shard.entries.size();
+    }
+    return entry_count;
+  }
+
+  // Returns the idx-th oldest value in the cache, for tests.
+  V getValueAt(const size_t idx) const {
+    std::vector<size_t> seqs;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (const auto& entry : shard.entries) {
+        seqs.push_back(entry.seq);
+      }
+    }
+    CHECK_LT(idx, seqs.size());
+    std::nth_element(seqs.begin(), seqs.begin() + idx, seqs.end());
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (const auto& entry : shard.entries) {
+        if (entry.seq == seqs[idx]) {
+          return entry.value;
+        }
+      }
+    }
+    UNREACHABLE();
+    return V{};
+  }
+
+  HashTableCacheStats getStats() const {
+    HashTableCacheStats stats;
+    stats.entry_count = size();
+    stats.size_bytes = size_bytes_;
+    stats.max_size_bytes = g_hash_table_cache_max_bytes;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.invalidations = invalidations_;
+    return stats;
+  }
+
+ private:
+  struct Entry {
+    K key;
+    V value;
+    size_t size_bytes;
+    double build_cost_per_byte;
+    size_t seq;
+    std::vector<TableKey> table_keys;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<K, typename std::list<Entry>::iterator, KeyHash> index;
+  };
+
+  Shard& getShard(const K& key) { return shards_[KeyHash()(key) % kShardCount]; }
+
+  const Shard& getShard(const K& key) const {
+    return shards_[KeyHash()(key) % kShardCount];
+  }
+
+  // Evicts entries, one shard at a time in round robin order, until the cache fits in
+  // its budget again.
+  void evictOverBudget() {
+    size_t empty_shards{0};
+    while (size_bytes_ > g_hash_table_cache_max_bytes && empty_shards < kShardCount) {
+      auto& shard = shards_[eviction_shard_++ % kShardCount];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (shard.entries.empty()) {
+        ++empty_shards;
+        continue;
+      }
+      empty_shards = 0;
+      // Cheapest to rebuild per byte among the least recently used entries
+      auto victim = std::prev(shard.entries.end());
+      auto candidate = victim;
+      for (size_t i = 1; i < kEvictionCandidates && candidate != shard.entries.begin();
+           ++i) {
+        --candidate;
+        if (candidate->build_cost_per_byte < victim->build_cost_per_byte) {
+          victim = candidate;
+        }
+      }
+      VLOG(1) << "Evicting a cached hash table of " << victim->size_bytes << " bytes.";
+      size_bytes_ -= victim->size_bytes;
+      shard.index.erase(victim->key);
+      shard.entries.erase(victim);
+      ++evictions_;
+    }
+  }
+
+  Shard shards_[kShardCount];
+  std::atomic<size_t> size_bytes_;
+  std::atomic<size_t> next_seq_;
+  std::atomic<size_t> eviction_shard_;
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+  std::atomic<size_t> evictions_{0};
+  std::atomic<size_t> invalidations_{0};
+};
@@ -256,10 +256,12 @@ size_t get_hash_entry_count(const ExpressionRange& col_range, const bool is_bw_e
 
 }  // namespace
 
-std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
-                      std::shared_ptr<std::vector<int32_t>>>>
+size_t g_hash_table_cache_max_bytes{size_t(4) << 30};
+
+HashTableCache<JoinHashTable::JoinHashTableCacheKey,
+               std::shared_ptr<std::vector<int32_t>>,
+               JoinHashTable::JoinHashTableCacheKeyHash>
     JoinHashTable::join_hash_table_cache_;
-std::mutex JoinHashTable::join_hash_table_cache_mutex_;
 
 size_t get_shard_count(const Analyzer::BinOper* join_condition,
                        const Executor* executor) {
@@ -520,9 +522,10 @@ void JoinHashTable::reify() {
               : query_info.fragments;
       init_threads.push_back(
           std::async(std::launch::async,
-                     hash_type_ == JoinHashTableInterface::HashType::OneToOne
-                         ? &JoinHashTable::reifyOneToOneForDevice
-                         : &JoinHashTable::reifyOneToManyForDevice,
+                     with_cpu_thread_budget(
+                         hash_type_ == JoinHashTableInterface::HashType::OneToOne
+                             ? &JoinHashTable::reifyOneToOneForDevice
+                             : &JoinHashTable::reifyOneToManyForDevice),
                      this,
                      fragments,
                      device_id,
@@ -559,6 +562,74 @@ void JoinHashTable::reify() {
       init_thread.get();
     }
   }
+  if (!shard_count) {
+    computeInnerKeySummary(cols.second);
+  }
+}
+
+void JoinHashTable::computeInnerKeySummary(const Analyzer::Expr* outer_col_expr) {
+  if (isBitwiseEq()) {
+    return;
+  }
+  auto outer_col = get_join_key_summary_column(col_var_.get(), outer_col_expr);
+  if (!outer_col) {
+    return;
+  }
+  JoinKeySummary summary{outer_col, 0, -1, {}};
+  if (col_range_.getIntMin() > col_range_.getIntMax()) {
+    inner_key_summaries_.push_back(summary);
+    return;
+  }
+  const auto& inner_ti = col_var_->get_type_info();
+  // Both layouts start with one slot per key, -1 for the keys without a match.
+  const int32_t* slots{nullptr};
+  size_t entry_count{0};
+  std::vector<int32_t> gpu_slots;
+  if (cpu_hash_table_buff_) {
+    slots = cpu_hash_table_buff_->data();
+    entry_count = std::min(hash_entry_count_, cpu_hash_table_buff_->size());
+  } else {
+#ifdef HAVE_CUDA
+    // Every device holds the same table, read the slots back from the first one.
+    if (memory_level_ != Data_Namespace::GPU_LEVEL || gpu_hash_table_buff_.empty() ||
+        !gpu_hash_table_buff_.front()) {
+      return;
+    }
+    gpu_slots.resize(hash_entry_count_);
+    copy_from_gpu(&executor_->getCatalog()->getDataMgr(),
+                  gpu_slots.data(),
+                  reinterpret_cast<CUdeviceptr>(
+                      gpu_hash_table_buff_.front()->getMemoryPtr()),
+                  gpu_slots.size() * sizeof(int32_t),
+                  0);
+    slots = gpu_slots.data();
+    entry_count = gpu_slots.size();
+#else
+    return;
+#endif
+  }
+  const auto hash_entry_info =
+      get_bucketized_hash_entry_info(inner_ti, col_range_, isBitwiseEq());
+  const auto bucket = hash_entry_info.bucket_normalization;
+  bool empty{true};
+  for (size_t i = 0; i < entry_count; ++i) {
+    if (slots[i] == -1) {
+      continue;
+    }
+    const int64_t key = col_range_.getIntMin() + static_cast<int64_t>(i) * bucket;
+    if (empty) {
+      summary.min_key = key;
+      empty = false;
+    }
+    summary.max_key = key + bucket - 1;
+    if (bucket == 1 && summary.keys.size() <= JoinKeySummary::kMaxKeys) {
+      summary.keys.push_back(key);
+    }
+  }
+  if (summary.keys.size() > JoinKeySummary::kMaxKeys) {
+    summary.keys.clear();
+  }
+  inner_key_summaries_.push_back(summary);
 }
 
 JoinHashTable::~JoinHashTable() {
@@ -962,13 +1033,15 @@ void JoinHashTable::initOneToOneHashTable(
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
     CHECK(!chunk_key.empty());
     initHashTableOnCpuFromCache(chunk_key, join_column.num_elems, cols);
+    const auto build_clock_begin = timer_start();
     {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
       initOneToOneHashTableOnCpu(
           join_column, cols, hash_entry_info, hash_join_invalid_val);
     }
     if (inner_col->get_table_id() > 0) {
-      putHashTableOnCpuToCache(chunk_key, join_column.num_elems, cols);
+      putHashTableOnCpuToCache(
+          chunk_key, join_column.num_elems, cols, timer_stop(build_clock_begin));
     }
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
@@ -1096,13 +1169,15 @@ void JoinHashTable::initOneToManyHashTable(
   const int32_t hash_join_invalid_val{-1};
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
     initHashTableOnCpuFromCache(chunk_key, join_column.num_elems, cols);
+    const auto build_clock_begin = timer_start();
     {
       std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
       initOneToManyHashTableOnCpu(
           join_column, cols, hash_entry_info, hash_join_invalid_val);
     }
     if (inner_col->get_table_id() > 0) {
-      putHashTableOnCpuToCache(chunk_key, join_column.num_elems, cols);
+      putHashTableOnCpuToCache(
+          chunk_key, join_column.num_elems, cols, timer_stop(build_clock_begin));
     }
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
@@ -1198,20 +1273,18 @@ void JoinHashTable::initHashTableOnCpuFromCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      cpu_hash_table_buff_ = kv.second;
-      break;
-    }
+  const auto cached_hash_table = join_hash_table_cache_.get(cache_key);
+  if (cached_hash_table) {
+    std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+    cpu_hash_table_buff_ = *cached_hash_table;
   }
 }
 
 void JoinHashTable::putHashTableOnCpuToCache(
     const ChunkKey& chunk_key,
     const size_t num_elements,
-    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols) {
+    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+    const int64_t build_time_ms) {
   CHECK_GE(chunk_key.size(), size_t(2));
   if (chunk_key[1] < 0) {
     // Do not cache hash tables over intermediate results
@@ -1224,13 +1297,26 @@ void JoinHashTable::putHashTableOnCpuToCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      return;
-    }
-  }
-  join_hash_table_cache_.emplace_back(cache_key, cpu_hash_table_buff_);
+  std::shared_ptr<std::vector<int32_t>> hash_table;
+  {
+    std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+    hash_table = cpu_hash_table_buff_;
+  }
+  CHECK(hash_table);
+  std::vector<std::pair<int, int>> table_keys{{chunk_key[0], chunk_key[1]}};
+  // The values of the inner column have been translated to the ids of the dictionary of
+  // the outer column, which changes with the outer table
+  const auto& inner_ti = cols.first->get_type_info();
+  if (inner_ti.is_string() && outer_col &&
+      inner_ti.get_comp_param() != outer_col->get_comp_param() &&
+      outer_col->get_table_id() > 0 && outer_col->get_table_id() != chunk_key[1]) {
+    table_keys.emplace_back(chunk_key[0], outer_col->get_table_id());
+  }
+  join_hash_table_cache_.put(cache_key,
+                             hash_table,
+                             hash_table->size() * sizeof(int32_t),
+                             build_time_ms,
+                             std::move(table_keys));
 }
 
 llvm::Value* JoinHashTable::codegenHashTableLoad(const size_t table_idx) {
@@ -33,9 +33,11 @@
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/ExpressionRange.h"
 #include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 #include <llvm/IR/Value.h>
+#include <boost/functional/hash.hpp>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -43,6 +45,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
 
 class Executor;
@@ -100,6 +103,10 @@ class JoinHashTable : public JoinHashTableInterface {
 
   size_t payloadBufferOff() const noexcept override;
 
+  const std::vector<JoinKeySummary>& getInnerKeySummaries() const noexcept override {
+    return inner_key_summaries_;
+  }
+
   static HashJoinMatchingSet codegenMatchingSet(
       const std::vector<llvm::Value*>& hash_join_idx_args_in,
       const bool is_sharded,
@@ -114,24 +121,25 @@ class JoinHashTable : public JoinHashTableInterface {
   static auto yieldCacheInvalidator() -> std::function<void()> {
     VLOG(1) << "Invalidate " << join_hash_table_cache_.size()
             << " cached baseline hashtable.";
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-      join_hash_table_cache_.clear();
-    };
+    return []() -> void { join_hash_table_cache_.clear(); };
   }
 
-  static const std::shared_ptr<std::vector<int32_t>>& getCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-    CHECK(!join_hash_table_cache_.empty());
-    CHECK_LT(idx, join_hash_table_cache_.size());
-    return join_hash_table_cache_.at(idx).second;
+  static auto yieldCacheInvalidator(const int db_id, const int table_id)
+      -> std::function<void()> {
+    return [db_id, table_id]() -> void {
+      const auto removed = join_hash_table_cache_.invalidateTable(db_id, table_id);
+      VLOG(1) << "Invalidated " << removed << " cached hashtables of table " << table_id;
+    };
   }
 
-  static uint64_t getNumberOfCachedHashTables() {
-    std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-    return join_hash_table_cache_.size();
+  static std::shared_ptr<std::vector<int32_t>> getCachedHashTable(size_t idx) {
+    return join_hash_table_cache_.getValueAt(idx);
   }
 
+  static uint64_t getNumberOfCachedHashTables() { return join_hash_table_cache_.size(); }
+
+  static HashTableCacheStats getCacheStats() { return join_hash_table_cache_.getStats(); }
+
   virtual ~JoinHashTable();
 
  private:
@@ -192,7 +200,8 @@ class JoinHashTable : public JoinHashTableInterface {
   void putHashTableOnCpuToCache(
       const ChunkKey& chunk_key,
       const size_t num_elements,
-      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols);
+      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+      const int64_t build_time_ms);
   void initOneToOneHashTableOnCpu(
       const JoinColumn& join_column,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
@@ -217,6 +226,8 @@ class JoinHashTable : public JoinHashTableInterface {
 
   bool isBitwiseEq() const;
 
+  void computeInnerKeySummary(const Analyzer::Expr* outer_col_expr);
+
   void freeHashBufferMemory();
   void freeHashBufferGpuMemory();
   void freeHashBufferCpuMemory();
@@ -242,6 +253,7 @@ class JoinHashTable : public JoinHashTableInterface {
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_err_buff_;
 #endif
   ExpressionRange col_range_;
+  std::vector<JoinKeySummary> inner_key_summaries_;
   Executor* executor_;
   ColumnCacheMap& column_cache_;
   const int device_count_;
@@ -261,10 +273,24 @@ class JoinHashTable : public JoinHashTableInterface {
     }
   };
 
-  static std::vector<
-      std::pair<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>>
+  struct JoinHashTableCacheKeyHash {
+    size_t operator()(const JoinHashTableCacheKey& key) const {
+      size_t seed{0};
+      boost::hash_combine(seed, key.inner_col.get_table_id());
+      boost::hash_combine(seed, key.inner_col.get_column_id());
+      boost::hash_combine(seed, key.outer_col.get_table_id());
+      boost::hash_combine(seed, key.outer_col.get_column_id());
+      boost::hash_combine(seed, key.num_elements);
+      boost::hash_combine(seed, key.chunk_key);
+      boost::hash_combine(seed, static_cast<int>(key.optype));
+      return seed;
+    }
+  };
+
+  static HashTableCache<JoinHashTableCacheKey,
+                        std::shared_ptr<std::vector<int32_t>>,
+                        JoinHashTableCacheKeyHash>
       join_hash_table_cache_;
-  static std::mutex join_hash_table_cache_mutex_;
 };
 
 // TODO(alex): Functions below need to be moved to a separate translation unit, they don't
@@ -67,6 +67,27 @@ JoinColumn JoinHashTableInterface::fetchJoinColumn(
   }
 }
 
+std::shared_ptr<Analyzer::ColumnVar> get_join_key_summary_column(
+    const Analyzer::ColumnVar* inner_col,
+    const Analyzer::Expr* outer_expr) {
+  const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(outer_expr);
+  if (!outer_col) {
+    return nullptr;
+  }
+  // Strings have been translated to the dictionary of the outer column if needed.
+  const auto& inner_ti = inner_col->get_type_info();
+  const auto& outer_ti = outer_col->get_type_info();
+  if (inner_ti.is_string()) {
+    if (!outer_ti.is_string() || outer_ti.get_compression() != kENCODING_DICT) {
+      return nullptr;
+    }
+  } else if (inner_ti.get_type() != outer_ti.get_type() ||
+             inner_ti.get_dimension() != outer_ti.get_dimension()) {
+    return nullptr;
+  }
+  return std::dynamic_pointer_cast<Analyzer::ColumnVar>(outer_col->deep_copy());
+}
+
 namespace {
 
 template <typename T>
@@ -80,8 +80,28 @@ struct DecodedJoinHashBufferEntry {
 
 using DecodedJoinHashBufferSet = std::set<DecodedJoinHashBufferEntry>;
 
+//! Keys held by the hash table of an equijoin for one of its key components, the outer
+//! fragments whose join column has none of them can't produce any match.
+struct JoinKeySummary {
+  // Outer side of the key component.
+  std::shared_ptr<Analyzer::ColumnVar> outer_col;
+  // Range of the keys, min_key > max_key if the hash table is empty.
+  int64_t min_key;
+  int64_t max_key;
+  // Sorted keys, only collected if there are at most kMaxKeys of them.
+  std::vector<int64_t> keys;
+
+  static constexpr size_t kMaxKeys{1024};
+};
+
 using InnerOuter = std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>;
 
+//! Outer column of a key component whose hash table keys compare to its stored values
+//! as they are, nullptr if there is none.
+std::shared_ptr<Analyzer::ColumnVar> get_join_key_summary_column(
+    const Analyzer::ColumnVar* inner_col,
+    const Analyzer::Expr* outer_expr);
+
 class DeviceAllocator;
 
 class JoinHashTableInterface {
@@ -137,6 +157,13 @@ class JoinHashTableInterface {
 
   virtual size_t payloadBufferOff() const noexcept = 0;
 
+  //! Keys of the hash table in terms of the outer column values, one summary per key
+  //! component known. A match needs a key of every one of them.
+  virtual const std::vector<JoinKeySummary>& getInnerKeySummaries() const noexcept {
+    static const std::vector<JoinKeySummary> no_summaries;
+    return no_summaries;
+  }
+
   JoinColumn fetchJoinColumn(
       const Analyzer::ColumnVar* hash_col,
       const std::vector<Fragmenter_Namespace::FragmentInfo>& fragment_info,
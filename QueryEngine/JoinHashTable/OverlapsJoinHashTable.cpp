@@ -222,13 +222,14 @@ void OverlapsJoinHashTable::reifyWithLayout(
         shard_count
             ? only_shards_for_device(query_info.fragments, device_id, device_count_)
             : query_info.fragments;
-    init_threads.push_back(std::async(std::launch::async,
-                                      &OverlapsJoinHashTable::reifyForDevice,
-                                      this,
-                                      columns_per_device[device_id],
-                                      layout,
-                                      device_id,
-                                      logger::thread_id()));
+    init_threads.push_back(std::async(
+        std::launch::async,
+        with_cpu_thread_budget(&OverlapsJoinHashTable::reifyForDevice),
+        this,
+        columns_per_device[device_id],
+        layout,
+        device_id,
+        logger::thread_id()));
   }
   for (auto& init_thread : init_threads) {
     init_thread.wait();
@@ -527,6 +528,7 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
     }
     return 0;
   }
+  const auto build_clock_begin = timer_start();
   CHECK(layoutRequiresAdditionalBuffers(layout));
   const auto key_component_width = getKeyComponentWidth();
   const auto key_component_count = join_bucket_info[0].bucket_sizes_for_dimension.size();
@@ -676,7 +678,7 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
       CHECK(false);
   }
   if (!err && getInnerTableId() > 0) {
-    putHashTableOnCpuToCache(cache_key);
+    putHashTableOnCpuToCache(cache_key, timer_stop(build_clock_begin));
   }
   return err;
 }
@@ -59,6 +59,25 @@ class OverlapsJoinHashTable : public BaselineJoinHashTable {
     };
   }
 
+  static auto yieldCacheInvalidator(const int db_id, const int table_id)
+      -> std::function<void()> {
+    return [db_id, table_id]() -> void {
+      std::lock_guard<std::mutex> guard(auto_tuner_cache_mutex_);
+      for (auto it = auto_tuner_cache_.begin(); it != auto_tuner_cache_.end();) {
+        const auto& chunk_keys = it->first.chunk_keys;
+        if (std::any_of(chunk_keys.begin(),
+                        chunk_keys.end(),
+                        [db_id, table_id](const ChunkKey& chunk_key) {
+                          return chunk_key[0] == db_id && chunk_key[1] == table_id;
+                        })) {
+          it = auto_tuner_cache_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    };
+  }
+
  protected:
   void reifyWithLayout(const JoinHashTableInterface::HashType layout) override;
 
@@ -189,6 +189,15 @@ llvm::BasicBlock* JoinLoop::codegen(
             prev_comparison_result = ll_bool(true, context);
             break;
           }
+          case JoinType::SEMI: {
+            // The slot only tells whether the key exists, the body runs at most once.
+            prev_comparison_result = match_found;
+            break;
+          }
+          case JoinType::ANTI: {
+            prev_comparison_result = builder.CreateNot(match_found);
+            break;
+          }
           default:
             CHECK(false);
         }
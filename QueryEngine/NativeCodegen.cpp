@@ -20,6 +20,7 @@
 #include "GpuSharedMemoryUtils.h"
 #include "LLVMFunctionAttributesUtil.h"
 #include "OutputBufferInitialization.h"
+#include "PersistentCodeCache.h"
 #include "QueryTemplateGenerator.h"
 
 #include "OSDependent/omnisci_path.h"
@@ -68,6 +69,7 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/Support/raw_ostream.h>
 
 float g_fraction_code_cache_to_evict = 0.2;
+bool g_enable_async_jit{false};
 
 std::unique_ptr<llvm::Module> udf_gpu_module;
 std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -258,12 +260,16 @@ std::string assemblyForCPU(ExecutionEngineWrapper& execution_engine,
 ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
     llvm::Function* func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    PersistentObjectCache* object_cache) {
   auto module = func->getParent();
+  const bool use_cached_object = object_cache && object_cache->hasCachedObject();
   // run optimizations
 #ifndef WITH_JIT_DEBUG
-  llvm::legacy::PassManager pass_manager;
-  optimize_ir(func, module, pass_manager, live_funcs, co);
+  if (!use_cached_object) {
+    llvm::legacy::PassManager pass_manager;
+    optimize_ir(func, module, pass_manager, live_funcs, co);
+  }
 #endif  // WITH_JIT_DEBUG
 
   auto init_err = llvm::InitializeNativeTarget();
@@ -287,9 +293,18 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
 
   ExecutionEngineWrapper execution_engine(eb.create(), co);
   CHECK(execution_engine.get());
-  LOG(ASM) << assemblyForCPU(execution_engine, module);
+  if (!use_cached_object) {
+    LOG(ASM) << assemblyForCPU(execution_engine, module);
+  }
 
+  if (object_cache) {
+    execution_engine->setObjectCache(object_cache);
+  }
   execution_engine->finalizeObject();
+  if (object_cache) {
+    // The cache is only consulted while the module is compiled.
+    execution_engine->setObjectCache(nullptr);
+  }
 
   return execution_engine;
 }
@@ -344,8 +359,30 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
 #endif
   }
 
-  auto execution_engine =
-      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+  // Query shapes compiled before a restart are picked up from the on-disk cache. Code
+  // linking UDFs is keyed on their names only, so it is never persisted.
+  std::shared_ptr<PersistentObjectCache> object_cache;
+  auto persistent_code_cache = PersistentCodeCache::instance();
+  if (persistent_code_cache && !udf_cpu_module && !rt_udf_cpu_module) {
+    object_cache = std::make_shared<PersistentObjectCache>(*persistent_code_cache, key);
+    VLOG(1) << "JIT code disk cache "
+            << (object_cache->hasCachedObject() ? "hit" : "miss")
+            << ", hits: " << persistent_code_cache->getHits()
+            << ", misses: " << persistent_code_cache->getMisses();
+  }
+  auto compile_co = co;
+  if (g_enable_async_jit && co.opt_level != ExecutorOptLevel::ReductionJIT &&
+      !(object_cache && object_cache->hasCachedObject()) &&
+      scheduleOptimizedCodegenCPU(
+          key, query_func, multifrag_query_func, live_funcs, co, object_cache)) {
+    // Run the first execution of this query shape on code generated without machine
+    // code optimizations, like the reduction JIT does. The optimized code replaces it
+    // in the cache once ready, and is the one persisted.
+    compile_co.opt_level = ExecutorOptLevel::ReductionJIT;
+    object_cache = nullptr;
+  }
+  auto execution_engine = CodeGenerator::generateNativeCPUCode(
+      query_func, live_funcs, compile_co, object_cache.get());
   auto cpu_compilation_context =
       std::make_shared<CpuCompilationContext>(std::move(execution_engine));
   cpu_compilation_context->setFunctionPointer(multifrag_query_func);
@@ -353,6 +390,96 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
   return cpu_compilation_context;
 }
 
+bool Executor::scheduleOptimizedCodegenCPU(
+    const CodeCacheKey& key,
+    llvm::Function* query_func,
+    llvm::Function* multifrag_query_func,
+    const std::unordered_set<llvm::Function*>& live_funcs,
+    const CompilationOptions& co,
+    std::shared_ptr<PersistentObjectCache> object_cache) {
+  async_codegen_tasks_.remove_if([](const std::future<void>& task) {
+    return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  });
+  if (async_codegen_tasks_.size() >= static_cast<size_t>(cpu_threads())) {
+    return false;
+  }
+  // The global LLVM context can only be used with compilation_mutex_ held, hand a
+  // serialized copy of the module to the background task instead.
+  std::string module_bitcode;
+  {
+    llvm::raw_string_ostream os(module_bitcode);
+#if LLVM_VERSION_MAJOR >= 7
+    llvm::WriteBitcodeToFile(*query_func->getParent(), os);
+#else
+    llvm::WriteBitcodeToFile(query_func->getParent(), os);
+#endif
+  }
+  std::vector<std::string> live_func_names;
+  for (const auto live_func : live_funcs) {
+    live_func_names.push_back(live_func->getName().str());
+  }
+  async_codegen_tasks_.push_back(
+      std::async(std::launch::async,
+                 [this,
+                  key,
+                  module_bitcode = std::move(module_bitcode),
+                  query_func_name = query_func->getName().str(),
+                  multifrag_query_func_name = multifrag_query_func->getName().str(),
+                  live_func_names = std::move(live_func_names),
+                  co,
+                  object_cache] {
+                   try {
+                     optimizedCodegenCPUInBackground(key,
+                                                     module_bitcode,
+                                                     query_func_name,
+                                                     multifrag_query_func_name,
+                                                     live_func_names,
+                                                     co,
+                                                     object_cache.get());
+                   } catch (const std::exception& e) {
+                     LOG(WARNING) << "Background code generation failed: " << e.what();
+                   }
+                 }));
+  return true;
+}
+
+void Executor::optimizedCodegenCPUInBackground(
+    const CodeCacheKey& key,
+    const std::string& module_bitcode,
+    const std::string& query_func_name,
+    const std::string& multifrag_query_func_name,
+    const std::vector<std::string>& live_func_names,
+    const CompilationOptions& co,
+    PersistentObjectCache* object_cache) {
+  auto timer = DEBUG_TIMER(__func__);
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto owner = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(module_bitcode, "async_codegen_module"), *context);
+  CHECK(!owner.takeError());
+  auto module = owner.get().release();
+  auto query_func = module->getFunction(query_func_name);
+  auto multifrag_query_func = module->getFunction(multifrag_query_func_name);
+  CHECK(query_func);
+  CHECK(multifrag_query_func);
+  std::unordered_set<llvm::Function*> live_funcs;
+  for (const auto& live_func_name : live_func_names) {
+    const auto live_func = module->getFunction(live_func_name);
+    CHECK(live_func);
+    live_funcs.insert(live_func);
+  }
+
+  auto execution_engine =
+      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co, object_cache);
+  auto cpu_compilation_context = std::make_shared<CpuCompilationContext>(
+      std::move(execution_engine), std::move(context));
+  cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+
+  std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
+  addCodeToCache(key, cpu_compilation_context, module, cpu_code_cache_);
+  ++async_codegen_installs_;
+  VLOG(1) << "Installed background generated code for " << multifrag_query_func_name;
+}
+
 void CodeGenerator::link_udf_module(const std::unique_ptr<llvm::Module>& udf_module,
                                     llvm::Module& module,
                                     CgenState* cgen_state,
@@ -1047,6 +1174,7 @@ bool CodeGenerator::alwaysCloneRuntimeFunction(const llvm::Function* func) {
          func->getName() == "fixed_width_int_decode" ||
          func->getName() == "fixed_width_unsigned_decode" ||
          func->getName() == "diff_fixed_width_int_decode" ||
+         func->getName() == "run_length_int_decode" ||
          func->getName() == "fixed_width_double_decode" ||
          func->getName() == "fixed_width_float_decode" ||
          func->getName() == "fixed_width_small_date_decode" ||
@@ -1345,6 +1473,9 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.emplace_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_PERCENTILE:
+        result.emplace_back("agg_approx_percentile");
+        break;
       default:
         CHECK(false);
     }
@@ -2148,6 +2279,7 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       const auto& count_distinct_descriptor =
           query_mem_desc->getCountDistinctDescriptor(i);
       if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+          count_distinct_descriptor.impl_type_ == CountDistinctImplType::HllSketch ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals)) {
         throw QueryMustRunOnCpu();
@@ -2538,6 +2670,10 @@ bool Executor::compileBody(const RelAlgExecutionUnit& ra_exe_unit,
   }
   llvm::Value* filter_lv = cgen_state_->llBool(true);
   CodeGenerator code_generator(this);
+  if (ra_exe_unit.full_join_matched_rows && ra_exe_unit.join_quals.empty()) {
+    // Second pass of a FULL join, over its inner table
+    filter_lv = codegenFullJoinUnmatched(ra_exe_unit, co);
+  }
   for (auto expr : primary_quals) {
     // Generate the filter for primary quals
     auto cond = code_generator.toBool(code_generator.codegen(expr, true, co).front());
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PersistentCodeCache.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/Host.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+#include "Logger/Logger.h"
+#include "MapDRelease.h"
+
+std::string g_jit_code_disk_cache_path{""};
+size_t g_jit_code_disk_cache_max_size{size_t(1) << 30};  // 1GB
+
+namespace {
+
+const std::string kEntryMagic{"OMNISCI_JIT_OBJ1"};
+const std::string kEntryExtension{".jitobj"};
+
+// Identifies the toolchain and the machine the object code was generated for; any
+// difference must turn into a cache miss.
+std::string get_code_fingerprint() {
+  std::string fingerprint = std::string("llvm:") + LLVM_VERSION_STRING +
+                            ";release:" + MAPD_RELEASE +
+                            ";triple:" + llvm::sys::getProcessTriple() +
+                            ";cpu:" + llvm::sys::getHostCPUName().str() + ";features:";
+  llvm::StringMap<bool> cpu_features;
+  if (llvm::sys::getHostCPUFeatures(cpu_features)) {
+    std::vector<std::string> features;
+    for (const auto& feature : cpu_features) {
+      features.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+    }
+    std::sort(features.begin(), features.end());
+    for (const auto& feature : features) {
+      fingerprint += feature + ",";
+    }
+  }
+  return fingerprint;
+}
+
+bool is_cache_entry(const boost::filesystem::directory_entry& entry) {
+  return boost::filesystem::is_regular_file(entry.status()) &&
+         entry.path().extension().string() == kEntryExtension;
+}
+
+}  // namespace
+
+PersistentCodeCache::PersistentCodeCache(const std::string& path,
+                                         const size_t max_size_bytes)
+    : path_(path)
+    , max_size_bytes_(max_size_bytes)
+    , size_bytes_(0)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0) {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(path_, ec);
+  if (ec || !boost::filesystem::is_directory(path_)) {
+    throw std::runtime_error("Could not create JIT code cache directory " + path_ +
+                             (ec ? ": " + ec.message() : ""));
+  }
+  for (const auto& entry : boost::filesystem::directory_iterator(path_)) {
+    if (is_cache_entry(entry)) {
+      size_bytes_ += boost::filesystem::file_size(entry.path());
+    }
+  }
+  LOG(INFO) << "JIT code disk cache at " << path_ << " holds " << size_bytes_
+            << " bytes, limit " << max_size_bytes_ << " bytes";
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentCodeCache::get(const CodeCacheKey& key) {
+  const auto serialized_key = serializeKey(key);
+  const auto entry_path = getEntryPath(serialized_key);
+  std::ifstream entry_file(entry_path, std::ios::binary);
+  if (!entry_file) {
+    ++misses_;
+    return nullptr;
+  }
+  std::string contents{std::istreambuf_iterator<char>(entry_file),
+                       std::istreambuf_iterator<char>()};
+  // An entry is the magic, the length of the serialized key, the key itself and the
+  // object code. Anything else is a partial write or a hash collision.
+  const size_t header_size = kEntryMagic.size() + sizeof(uint64_t);
+  uint64_t key_size{0};
+  if (contents.size() >= header_size) {
+    memcpy(&key_size, contents.data() + kEntryMagic.size(), sizeof(uint64_t));
+  }
+  if (contents.size() < header_size ||
+      contents.compare(0, kEntryMagic.size(), kEntryMagic) ||
+      contents.size() <= header_size + key_size ||
+      contents.compare(header_size, key_size, serialized_key)) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  boost::system::error_code ec;
+  boost::filesystem::last_write_time(entry_path, time(nullptr), ec);
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(contents).substr(header_size + key_size), entry_path);
+}
+
+void PersistentCodeCache::put(const CodeCacheKey& key, llvm::MemoryBufferRef object) {
+  const auto serialized_key = serializeKey(key);
+  const auto entry_path = getEntryPath(serialized_key);
+  std::ostringstream tmp_path;
+  tmp_path << entry_path << ".tmp." << getpid() << "."
+           << std::hash<std::thread::id>()(std::this_thread::get_id());
+  const uint64_t key_size = serialized_key.size();
+  const size_t entry_size = kEntryMagic.size() + sizeof(uint64_t) + key_size +
+                            object.getBufferSize();
+  {
+    std::ofstream tmp_file(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    tmp_file.write(kEntryMagic.data(), kEntryMagic.size());
+    tmp_file.write(reinterpret_cast<const char*>(&key_size), sizeof(uint64_t));
+    tmp_file.write(serialized_key.data(), serialized_key.size());
+    tmp_file.write(object.getBufferStart(), object.getBufferSize());
+    if (!tmp_file) {
+      LOG(WARNING) << "Could not write JIT code cache entry " << tmp_path.str();
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp_path.str(), ec);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  auto old_size = boost::filesystem::file_size(entry_path, ec);
+  if (ec) {
+    old_size = 0;
+  }
+  // Publish the entry atomically, concurrent readers see either nothing or all of it.
+  boost::filesystem::rename(tmp_path.str(), entry_path, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not publish JIT code cache entry " << entry_path << ": "
+                 << ec.message();
+    boost::filesystem::remove(tmp_path.str(), ec);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(size_mutex_);
+    size_bytes_ += entry_size;
+    size_bytes_ -= std::min(size_bytes_, static_cast<size_t>(old_size));
+  }
+  evictIfNeeded();
+}
+
+size_t PersistentCodeCache::getSizeBytes() const {
+  std::lock_guard<std::mutex> lock(size_mutex_);
+  return size_bytes_;
+}
+
+PersistentCodeCache* PersistentCodeCache::instance() {
+  static std::unique_ptr<PersistentCodeCache> cache = []() {
+    std::unique_ptr<PersistentCodeCache> cache;
+    if (g_jit_code_disk_cache_path.empty()) {
+      return cache;
+    }
+    try {
+      cache = std::make_unique<PersistentCodeCache>(g_jit_code_disk_cache_path,
+                                                    g_jit_code_disk_cache_max_size);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Disabling the JIT code disk cache: " << e.what();
+    }
+    return cache;
+  }();
+  return cache.get();
+}
+
+std::string PersistentCodeCache::getEntryPath(const std::string& serialized_key) const {
+  std::ostringstream file_name;
+  file_name << std::hex << std::setw(16) << std::setfill('0')
+            << std::hash<std::string>()(serialized_key) << kEntryExtension;
+  return (boost::filesystem::path(path_) / file_name.str()).string();
+}
+
+void PersistentCodeCache::evictIfNeeded() {
+  std::lock_guard<std::mutex> lock(size_mutex_);
+  if (size_bytes_ <= max_size_bytes_) {
+    return;
+  }
+  std::vector<std::pair<time_t, boost::filesystem::path>> entries;
+  for (const auto& entry : boost::filesystem::directory_iterator(path_)) {
+    if (is_cache_entry(entry)) {
+      entries.emplace_back(boost::filesystem::last_write_time(entry.path()),
+                           entry.path());
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+  for (const auto& entry : entries) {
+    if (size_bytes_ <= max_size_bytes_) {
+      break;
+    }
+    boost::system::error_code ec;
+    const auto entry_size = boost::filesystem::file_size(entry.second, ec);
+    if (ec || !boost::filesystem::remove(entry.second, ec)) {
+      continue;
+    }
+    size_bytes_ -= std::min(size_bytes_, static_cast<size_t>(entry_size));
+    ++evictions_;
+  }
+}
+
+std::string PersistentCodeCache::serializeKey(const CodeCacheKey& key) {
+  static const std::string fingerprint = get_code_fingerprint();
+  std::string serialized_key = fingerprint + "\n";
+  for (const auto& key_part : key) {
+    serialized_key += std::to_string(key_part.size()) + "\n" + key_part;
+  }
+  return serialized_key;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                                 llvm::MemoryBufferRef object) {
+  if (!cached_object_) {
+    cache_.put(key_, object);
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentObjectCache::getObject(
+    const llvm::Module* module) {
+  if (!cached_object_) {
+    return nullptr;
+  }
+  return llvm::MemoryBuffer::getMemBufferCopy(cached_object_->getBuffer(),
+                                              cached_object_->getBufferIdentifier());
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PersistentCodeCache.h
+ * @brief   On-disk cache of the CPU object code generated for queries, which lets a
+ *          restarted server skip IR optimization and machine code generation for query
+ *          shapes it has already compiled.
+ *
+ * Entries are keyed on the in-memory CodeCacheKey (the serialized IR of the query
+ * functions) plus a fingerprint of the LLVM version, the host CPU and the server
+ * release. The full key is stored in every entry and compared on load, so a hash
+ * collision is a miss rather than a wrong kernel.
+ */
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "QueryEngine/CodeCache.h"
+
+extern std::string g_jit_code_disk_cache_path;
+extern size_t g_jit_code_disk_cache_max_size;
+
+class PersistentCodeCache {
+ public:
+  PersistentCodeCache(const std::string& path, const size_t max_size_bytes);
+
+  // Returns the cached object code for the key, or nullptr on a miss.
+  std::unique_ptr<llvm::MemoryBuffer> get(const CodeCacheKey& key);
+
+  void put(const CodeCacheKey& key, llvm::MemoryBufferRef object);
+
+  size_t getHits() const { return hits_; }
+  size_t getMisses() const { return misses_; }
+  size_t getEvictions() const { return evictions_; }
+  size_t getSizeBytes() const;
+
+  // Returns the process wide cache configured by g_jit_code_disk_cache_path, or nullptr
+  // if the on-disk cache is disabled.
+  static PersistentCodeCache* instance();
+
+ private:
+  std::string getEntryPath(const std::string& serialized_key) const;
+  void evictIfNeeded();
+
+  static std::string serializeKey(const CodeCacheKey& key);
+
+  const std::string path_;
+  const size_t max_size_bytes_;
+  mutable std::mutex size_mutex_;
+  size_t size_bytes_;
+  std::atomic<size_t> hits_;
+  std::atomic<size_t> misses_;
+  std::atomic<size_t> evictions_;
+};
+
+/**
+ * Adapter handed to MCJIT for a single module: it either serves the object code loaded
+ * from the persistent cache, or stores the freshly generated object code in it.
+ */
+class PersistentObjectCache : public llvm::ObjectCache {
+ public:
+  PersistentObjectCache(PersistentCodeCache& cache, const CodeCacheKey& key)
+      : cache_(cache), key_(key), cached_object_(cache.get(key)) {}
+
+  bool hasCachedObject() const { return cached_object_ != nullptr; }
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+ private:
+  PersistentCodeCache& cache_;
+  const CodeCacheKey key_;
+  std::unique_ptr<llvm::MemoryBuffer> cached_object_;
+};
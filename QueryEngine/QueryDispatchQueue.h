@@ -16,21 +16,48 @@
 
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <future>
+#include <list>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
+#include <unordered_map>
+
+#include "Logger/Logger.h"
+#include "Shared/thread_count.h"
 
 /**
  * QueryDispatchQueue maintains a list of pending queries and dispatches those queries as
- * Executors become available
+ * Executors become available.
+ *
+ * Pending queries with a higher priority are dispatched first. A pending query gains one
+ * priority level for every priority aging interval it waits, so that a steady stream of
+ * higher priority queries delays the lower priority ones without starving them. Among
+ * queries with the same priority, the one whose owner (a user or a session) has the
+ * fewest queries running goes first, so that a single client can't starve the others;
+ * ties go to the oldest query. Every running query gets a CPU thread budget, an even
+ * share of cpu_threads() between the queries running, which caps the parallelism of its
+ * kernels. The budgets are rebalanced whenever a query starts or finishes, so that they
+ * don't add up to more than cpu_threads() while there are at most that many queries.
  */
 class QueryDispatchQueue {
  public:
   using Task = std::packaged_task<void(size_t)>;
 
-  QueryDispatchQueue(const size_t parallel_executors_max) {
+  using Clock = std::function<std::chrono::steady_clock::time_point()>;
+
+  static constexpr std::chrono::milliseconds kDefaultPriorityAgingInterval{10000};
+
+  // The clock the waiting time of pending queries is measured with can be replaced by
+  // tests.
+  QueryDispatchQueue(const size_t parallel_executors_max,
+                     const std::chrono::milliseconds priority_aging_interval =
+                         kDefaultPriorityAgingInterval,
+                     Clock clock = std::chrono::steady_clock::now)
+      : priority_aging_interval_(priority_aging_interval), clock_(std::move(clock)) {
     workers_.resize(parallel_executors_max);
     for (size_t i = 0; i < workers_.size(); i++) {
       // worker IDs are 1-indexed, leaving Executor 0 for non-dispatch queue worker tasks
@@ -43,7 +70,10 @@ class QueryDispatchQueue {
    * expected to maintain a copy of the shared_ptr which will be used to access results
    * once the task runs.
    */
-  void submit(std::shared_ptr<Task> task, const bool is_update_delete) {
+  void submit(std::shared_ptr<Task> task,
+              const bool is_update_delete,
+              const int priority = 0,
+              const std::string& owner = "") {
     if (workers_.size() == 1 && is_update_delete) {
       std::lock_guard<decltype(update_delete_mutex_)> update_delete_lock(
           update_delete_mutex_);
@@ -59,7 +89,8 @@ class QueryDispatchQueue {
     std::unique_lock<decltype(queue_mutex_)> lock(queue_mutex_);
 
     LOG(INFO) << "Dispatching query with " << queue_.size() << " queries in the queue.";
-    queue_.push(task);
+    queue_.push_back(
+        PendingTask{task, priority, owner, clock_()});
     lock.unlock();
     cv_.notify_all();
   }
@@ -76,6 +107,61 @@ class QueryDispatchQueue {
   }
 
  private:
+  struct PendingTask {
+    std::shared_ptr<Task> task;
+    int priority;
+    std::string owner;
+    std::chrono::steady_clock::time_point submit_time;
+  };
+
+  // Priority of the task, raised by the time it has been waiting
+  int64_t agedPriority(const PendingTask& pending_task,
+                       const std::chrono::steady_clock::time_point now) const {
+    return pending_task.priority + (now - pending_task.submit_time) /
+                                       std::max(priority_aging_interval_,
+                                                std::chrono::milliseconds(1));
+  }
+
+  // Must be called with the queue lock held. The queue is in submission order, so the
+  // first best candidate is also the oldest one.
+  std::list<PendingTask>::iterator nextTask() {
+    const auto now = clock_();
+    auto best = queue_.begin();
+    auto best_priority = agedPriority(*best, now);
+    for (auto it = std::next(queue_.begin()); it != queue_.end(); ++it) {
+      const auto priority = agedPriority(*it, now);
+      if (priority != best_priority) {
+        if (priority > best_priority) {
+          best = it;
+          best_priority = priority;
+        }
+        continue;
+      }
+      if (runningCount(it->owner) < runningCount(best->owner)) {
+        best = it;
+      }
+    }
+    return best;
+  }
+
+  size_t runningCount(const std::string& owner) const {
+    const auto it = running_per_owner_.find(owner);
+    return it == running_per_owner_.end() ? 0 : it->second;
+  }
+
+  // Must be called with the queue lock held. Splits cpu_threads() evenly between the
+  // running queries.
+  void rebalanceThreadBudgets() {
+    if (running_budgets_.empty()) {
+      return;
+    }
+    const unsigned thread_budget =
+        std::max(cpu_threads() / static_cast<int>(running_budgets_.size()), 1);
+    for (const auto& budget : running_budgets_) {
+      budget->store(thread_budget);
+    }
+  }
+
   void worker(const size_t worker_idx) {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     while (true) {
@@ -86,19 +172,35 @@ class QueryDispatchQueue {
       }
 
       if (!queue_.empty()) {
-        auto task = queue_.front();
-        queue_.pop();
+        const auto next_task = nextTask();
+        const auto task = next_task->task;
+        const auto owner = next_task->owner;
+        queue_.erase(next_task);
+        ++running_per_owner_[owner];
+        const auto thread_budget = std::make_shared<CpuThreadBudget>(0);
+        const auto running_budget =
+            running_budgets_.insert(running_budgets_.end(), thread_budget);
+        rebalanceThreadBudgets();
 
-        LOG(INFO) << "Worker " << worker_idx
-                  << " running query and returning control. There are now "
-                  << queue_.size() << " queries in the queue.";
+        LOG(INFO) << "Worker " << worker_idx << " running query with a budget of "
+                  << thread_budget->load()
+                  << " threads and returning control. There are now " << queue_.size()
+                  << " queries in the queue.";
         // allow other threads to pick up tasks
         lock.unlock();
         CHECK(task);
-        (*task)(worker_idx);
+        {
+          ScopedCpuThreadBudget budget(thread_budget);
+          (*task)(worker_idx);
+        }
 
         // wait for signal
         lock.lock();
+        running_budgets_.erase(running_budget);
+        rebalanceThreadBudgets();
+        if (!--running_per_owner_[owner]) {
+          running_per_owner_.erase(owner);
+        }
       }
     }
   }
@@ -109,6 +211,11 @@ class QueryDispatchQueue {
   std::mutex update_delete_mutex_;
 
   bool threads_should_exit_{false};
-  std::queue<std::shared_ptr<Task>> queue_;
+  const std::chrono::milliseconds priority_aging_interval_;
+  const Clock clock_;
+  std::list<PendingTask> queue_;
+  // Thread budgets of the running queries
+  std::list<std::shared_ptr<CpuThreadBudget>> running_budgets_;
+  std::unordered_map<std::string, size_t> running_per_owner_;
   std::vector<std::thread> workers_;
 };
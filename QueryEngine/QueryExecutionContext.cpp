@@ -614,9 +614,7 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
     flatened_frag_offsets.insert(
         flatened_frag_offsets.end(), offsets.begin(), offsets.end());
   }
-  int64_t rowid_lookup_num_rows{*error_code ? *error_code + 1 : 0};
-  auto num_rows_ptr =
-      rowid_lookup_num_rows ? &rowid_lookup_num_rows : &flatened_num_rows[0];
+  auto num_rows_ptr = &flatened_num_rows[0];
   int32_t total_matched_init{0};
 
   std::vector<int64_t> cmpt_val_buff;
@@ -717,10 +715,6 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
     return {};
   }
 
-  if (rowid_lookup_num_rows && *error_code < 0) {
-    *error_code = 0;
-  }
-
   if (query_mem_desc_.useStreamingTopN()) {
     query_buffers_->applyStreamingTopNOffsetCpu(query_mem_desc_, ra_exe_unit);
   }
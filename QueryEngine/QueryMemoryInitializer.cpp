@@ -26,6 +26,10 @@
 
 #include <Shared/checked_alloc.h>
 
+// Maximum size of a baseline group by buffer on CPU, zero for no limit. Larger buffers
+// fail the kernel as if the host had run out of memory.
+size_t g_max_cpu_group_by_buffer_bytes{0};
+
 namespace {
 
 inline void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_desc) {
@@ -191,6 +195,7 @@ QueryMemoryInitializer::QueryMemoryInitializer(
 
   if (render_allocator_map || !query_mem_desc.isGroupBy()) {
     allocateCountDistinctBuffers(query_mem_desc, false, executor);
+    allocateTDigests(query_mem_desc, false, executor);
     if (render_info && render_info->useCudaBuffers()) {
       return;
     }
@@ -249,6 +254,12 @@ QueryMemoryInitializer::QueryMemoryInitializer(
   const auto actual_group_buffer_size =
       group_buffer_size + index_buffer_qw * sizeof(int64_t);
   CHECK_GE(actual_group_buffer_size, group_buffer_size);
+  if (device_type == ExecutorDeviceType::CPU && g_max_cpu_group_by_buffer_bytes &&
+      actual_group_buffer_size > g_max_cpu_group_by_buffer_bytes &&
+      query_mem_desc.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash) {
+    throw OutOfHostMemory(actual_group_buffer_size);
+  }
 
   for (size_t i = 0; i < group_buffers_count; i += step) {
     auto group_by_buffer = alloc_group_by_buffer(
@@ -409,6 +420,7 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
   const size_t col_base_off{query_mem_desc.getColOffInBytes(0)};
 
   auto agg_bitmap_size = allocateCountDistinctBuffers(query_mem_desc, true, executor);
+  auto tdigest_quantiles = allocateTDigests(query_mem_desc, true, executor);
   auto buffer_ptr = reinterpret_cast<int8_t*>(groups_buffer);
 
   const auto query_mem_desc_fixedup =
@@ -424,7 +436,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                          &buffer_ptr[col_base_off],
                          bin,
                          init_vals,
-                         agg_bitmap_size);
+                         agg_bitmap_size,
+                         tdigest_quantiles);
       }
     }
     return;
@@ -437,7 +450,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                      &buffer_ptr[col_base_off],
                      bin,
                      init_vals,
-                     agg_bitmap_size);
+                     agg_bitmap_size,
+                     tdigest_quantiles);
   }
 }
 
@@ -518,18 +532,25 @@ void QueryMemoryInitializer::initColumnarGroups(
   }
 }
 
-void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query_mem_desc,
-                                              int8_t* row_ptr,
-                                              const size_t bin,
-                                              const std::vector<int64_t>& init_vals,
-                                              const std::vector<int64_t>& bitmap_sizes) {
+void QueryMemoryInitializer::initColumnPerRow(
+    const QueryMemoryDescriptor& query_mem_desc,
+    int8_t* row_ptr,
+    const size_t bin,
+    const std::vector<int64_t>& init_vals,
+    const std::vector<int64_t>& bitmap_sizes,
+    const std::vector<std::optional<double>>& tdigest_quantiles) {
   int8_t* col_ptr = row_ptr;
   size_t init_vec_idx = 0;
   for (size_t col_idx = 0; col_idx < query_mem_desc.getSlotCount();
        col_ptr += query_mem_desc.getNextColOffInBytes(col_ptr, bin, col_idx++)) {
     const int64_t bm_sz{bitmap_sizes[col_idx]};
     int64_t init_val{0};
-    if (!bm_sz || !query_mem_desc.isGroupBy()) {
+    if (query_mem_desc.isGroupBy() && tdigest_quantiles[col_idx]) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
+               sizeof(int64_t));
+      init_val = allocateTDigest(*tdigest_quantiles[col_idx]);
+      ++init_vec_idx;
+    } else if (!bm_sz || !query_mem_desc.isGroupBy()) {
       if (query_mem_desc.getPaddedSlotWidthBytes(col_idx) > 0) {
         CHECK_LT(init_vec_idx, init_vals.size());
         init_val = init_vals[init_vec_idx++];
@@ -537,8 +558,13 @@ void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query
     } else {
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      if (bm_sz > 0) {
+        init_val = allocateCountDistinctBitmap(bm_sz);
+      } else if (bm_sz == -1) {
+        init_val = allocateCountDistinctSet();
+      } else {
+        init_val = allocateCountDistinctSketch(-bm_sz - 1);
+      }
       ++init_vec_idx;
     }
     switch (query_mem_desc.getPaddedSlotWidthBytes(col_idx)) {
@@ -626,6 +652,14 @@ std::vector<int64_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
         } else {
           init_agg_vals_[agg_col_idx] = allocateCountDistinctBitmap(bitmap_byte_sz);
         }
+      } else if (count_distinct_desc.impl_type_ == CountDistinctImplType::HllSketch) {
+        // Sketches are tagged with their negated precision, offset to not clash with -1.
+        if (deferred) {
+          agg_bitmap_size[agg_col_idx] = -count_distinct_desc.bitmap_sz_bits - 1;
+        } else {
+          init_agg_vals_[agg_col_idx] =
+              allocateCountDistinctSketch(count_distinct_desc.bitmap_sz_bits);
+        }
       } else {
         CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
         if (deferred) {
@@ -659,6 +693,52 @@ int64_t QueryMemoryInitializer::allocateCountDistinctSet() {
   return reinterpret_cast<int64_t>(count_distinct_set);
 }
 
+int64_t QueryMemoryInitializer::allocateCountDistinctSketch(const int64_t precision) {
+  auto count_distinct_sketch = new HllSketch(precision);
+  row_set_mem_owner_->addCountDistinctSketch(count_distinct_sketch);
+  return reinterpret_cast<int64_t>(count_distinct_sketch);
+}
+
+// Like allocateCountDistinctBuffers, deferred is true for group by queries and
+// initColumnPerRow allocates a digest for each group slot with a quantile set
+std::vector<std::optional<double>> QueryMemoryInitializer::allocateTDigests(
+    const QueryMemoryDescriptor& query_mem_desc,
+    const bool deferred,
+    const Executor* executor) {
+  const size_t agg_col_count{query_mem_desc.getSlotCount()};
+  std::vector<std::optional<double>> tdigest_quantiles(deferred ? agg_col_count : 0);
+
+  for (size_t target_idx = 0; target_idx < executor->plan_state_->target_exprs_.size();
+       ++target_idx) {
+    const auto target_expr = executor->plan_state_->target_exprs_[target_idx];
+    const auto agg_info = get_target_info(target_expr, g_bigint_count);
+    if (!is_approx_percentile_target(agg_info)) {
+      continue;
+    }
+    CHECK(!query_mem_desc.didOutputColumnar());
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    CHECK(agg_expr && agg_expr->get_arg1());
+    const double quantile = agg_expr->get_arg1()->get_constval().doubleval;
+    const auto agg_col_idx = query_mem_desc.getSlotIndexForSingleSlotCol(target_idx);
+    CHECK_LT(static_cast<size_t>(agg_col_idx), agg_col_count);
+    CHECK_EQ(static_cast<size_t>(query_mem_desc.getLogicalSlotWidthBytes(agg_col_idx)),
+             sizeof(int64_t));
+    if (deferred) {
+      tdigest_quantiles[agg_col_idx] = quantile;
+    } else {
+      init_agg_vals_[agg_col_idx] = allocateTDigest(quantile);
+    }
+  }
+
+  return tdigest_quantiles;
+}
+
+int64_t QueryMemoryInitializer::allocateTDigest(const double quantile) {
+  auto tdigest = new TDigest(quantile);
+  row_set_mem_owner_->addTDigest(tdigest);
+  return reinterpret_cast<int64_t>(tdigest);
+}
+
 #ifdef HAVE_CUDA
 GpuGroupByBuffers QueryMemoryInitializer::prepareTopNHeapsDevBuffer(
     const QueryMemoryDescriptor& query_mem_desc,
@@ -25,6 +25,7 @@
 #include "Rendering/RenderAllocator.h"
 
 #include <memory>
+#include <optional>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -151,7 +152,8 @@ class QueryMemoryInitializer {
                         int8_t* row_ptr,
                         const size_t bin,
                         const std::vector<int64_t>& init_vals,
-                        const std::vector<int64_t>& bitmap_sizes);
+                        const std::vector<int64_t>& bitmap_sizes,
+                        const std::vector<std::optional<double>>& tdigest_quantiles);
 
   void allocateCountDistinctGpuMem(const QueryMemoryDescriptor& query_mem_desc);
 
@@ -164,6 +166,15 @@ class QueryMemoryInitializer {
 
   int64_t allocateCountDistinctSet();
 
+  int64_t allocateCountDistinctSketch(const int64_t precision);
+
+  std::vector<std::optional<double>> allocateTDigests(
+      const QueryMemoryDescriptor& query_mem_desc,
+      const bool deferred,
+      const Executor* executor);
+
+  int64_t allocateTDigest(const double quantile);
+
 #ifdef HAVE_CUDA
   GpuGroupByBuffers prepareTopNHeapsDevBuffer(const QueryMemoryDescriptor& query_mem_desc,
                                               const CUdeviceptr init_agg_vals_dev_ptr,
@@ -52,7 +52,9 @@ void RexSubQuery::setExecutionResult(
     const std::shared_ptr<const ExecutionResult> result) {
   auto row_set = result->getRows();
   CHECK(row_set);
-  CHECK_EQ(size_t(1), row_set->colCount());
+  // Only the IN sub-queries of RelAlgExecutor::addSemiJoinLevels() return more than one
+  // column, the type is that of the first one.
+  CHECK_LE(size_t(1), row_set->colCount());
   *(type_.get()) = row_set->getColType(0);
   (*(result_.get())) = result;
 }
@@ -1006,9 +1008,13 @@ std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr)
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 && (operands.size() != 2 || (agg != kAPPROX_COUNT_DISTINCT &&
+                                                        agg != kAPPROX_PERCENTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
+  if (agg == kAPPROX_PERCENTILE && operands.size() != 2) {
+    throw QueryNotSupported("APPROX_PERCENTILE requires a column and a quantile");
+  }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
 }
 
@@ -1044,6 +1050,12 @@ JoinType to_join_type(const std::string& join_type_name) {
   if (join_type_name == "left") {
     return JoinType::LEFT;
   }
+  if (join_type_name == "right") {
+    return JoinType::RIGHT;
+  }
+  if (join_type_name == "full") {
+    return JoinType::FULL;
+  }
   throw QueryNotSupported("Join type (" + join_type_name + ") not supported");
 }
 
@@ -1195,6 +1207,83 @@ void bind_inputs(const std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept
   }
 }
 
+// Moves the references to the output of a RIGHT join to the positions they have once
+// its inputs are swapped.
+class RexSwapJoinOutputVisitor : public RexVisitor<void*> {
+ public:
+  RexSwapJoinOutputVisitor(const std::unordered_set<const RelAlgNode*>& join_outputs,
+                           const size_t lhs_size,
+                           const size_t rhs_size)
+      : join_outputs_(join_outputs), lhs_size_(lhs_size), rhs_size_(rhs_size) {}
+
+  void* visitInput(const RexInput* rex_input) const override {
+    if (join_outputs_.count(rex_input->getSourceNode())) {
+      const auto idx = rex_input->getIndex();
+      CHECK_LT(idx, lhs_size_ + rhs_size_);
+      rex_input->setIndex(idx < lhs_size_ ? idx + rhs_size_ : idx - lhs_size_);
+    }
+    return nullptr;
+  }
+
+ private:
+  const std::unordered_set<const RelAlgNode*>& join_outputs_;
+  const size_t lhs_size_;
+  const size_t rhs_size_;
+};
+
+// Executes RIGHT joins as LEFT joins with swapped inputs. The nodes which reference the
+// output of the join (or of the filters on top of it) by position are remapped, the
+// other consumers reference the inputs of the join directly.
+void rewrite_right_joins(const std::vector<std::shared_ptr<RelAlgNode>>& nodes) {
+  for (auto node_it = nodes.begin(); node_it != nodes.end(); ++node_it) {
+    auto join_node = std::dynamic_pointer_cast<RelJoin>(*node_it);
+    if (!join_node || join_node->getJoinType() != JoinType::RIGHT) {
+      continue;
+    }
+    if (dynamic_cast<const RelJoin*>(join_node->getInput(0))) {
+      throw QueryNotSupported(
+          "RIGHT join with a join on its left side isn't supported, rewrite it as a LEFT "
+          "join");
+    }
+    std::unordered_set<const RelAlgNode*> join_outputs{join_node.get()};
+    for (auto consumer_it = std::next(node_it); consumer_it != nodes.end();
+         ++consumer_it) {
+      const auto consumer = consumer_it->get();
+      for (size_t i = 0; i < consumer->inputCount(); ++i) {
+        if (!join_outputs.count(consumer->getInput(i))) {
+          continue;
+        }
+        if (dynamic_cast<const RelFilter*>(consumer)) {
+          join_outputs.insert(consumer);
+        } else if (!dynamic_cast<const RelProject*>(consumer) &&
+                   !dynamic_cast<const RelJoin*>(consumer)) {
+          throw QueryNotSupported("RIGHT join consumed by a " + consumer->toString() +
+                                  " isn't supported");
+        }
+      }
+    }
+    if (join_outputs.count(nodes.back().get())) {
+      throw QueryNotSupported("RIGHT join without a projection isn't supported");
+    }
+    RexSwapJoinOutputVisitor swap_outputs(
+        join_outputs, join_node->getInput(0)->size(), join_node->getInput(1)->size());
+    for (auto consumer_it = std::next(node_it); consumer_it != nodes.end();
+         ++consumer_it) {
+      const auto consumer = consumer_it->get();
+      if (const auto filter = dynamic_cast<const RelFilter*>(consumer)) {
+        swap_outputs.visit(filter->getCondition());
+      } else if (const auto project = dynamic_cast<const RelProject*>(consumer)) {
+        for (size_t i = 0; i < project->size(); ++i) {
+          swap_outputs.visit(project->getProjectAt(i));
+        }
+      } else if (const auto join = dynamic_cast<const RelJoin*>(consumer)) {
+        swap_outputs.visit(join->getCondition());
+      }
+    }
+    join_node->swapInputsToLeftJoin();
+  }
+}
+
 void handleQueryHint(const std::vector<std::shared_ptr<RelAlgNode>>& nodes,
                      RelAlgDagBuilder* dag_builder) noexcept {
   QueryHint query_hints;
@@ -1597,6 +1686,22 @@ bool is_window_function_operator(const RexScalar* rex) {
 
 }  // namespace
 
+// The rows of a FULL join come from two executions, see RelAlgExecutor::executeFullJoin,
+// an aggregate on top of it can't be coalesced with its projection.
+bool is_on_full_join(const RelAlgNode* node) {
+  CHECK_EQ(size_t(1), node->inputCount());
+  for (auto input = node->getInput(0); input;) {
+    if (const auto join = dynamic_cast<const RelJoin*>(input)) {
+      return join->getJoinType() == JoinType::FULL;
+    }
+    if (!dynamic_cast<const RelFilter*>(input)) {
+      return false;
+    }
+    input = input->getInput(0);
+  }
+  return false;
+}
+
 void coalesce_nodes(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
                     const std::vector<const RelAlgNode*>& left_deep_joins) {
   enum class CoalesceState { Initial, Filter, FirstProject, Aggregate };
@@ -1642,7 +1747,8 @@ void coalesce_nodes(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
         break;
       }
       case CoalesceState::FirstProject: {
-        if (std::dynamic_pointer_cast<const RelAggregate>(ra_node)) {
+        if (std::dynamic_pointer_cast<const RelAggregate>(ra_node) &&
+            !is_on_full_join(nodes[crt_pattern.front()].get())) {
           crt_pattern.push_back(size_t(nodeIt));
           crt_state = CoalesceState::Aggregate;
           nodeIt.advance(RANodeIterator::AdvancingMode::DUChain);
@@ -2613,6 +2719,7 @@ void RelAlgDagBuilder::build(const rapidjson::Value& query_ast,
   }
   CHECK(!nodes_.empty());
   bind_inputs(nodes_);
+  rewrite_right_joins(nodes_);
 
   if (render_info_) {
     // Alter the RA for render. Do this before any flattening/optimizations are done to
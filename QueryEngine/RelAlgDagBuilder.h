@@ -1136,6 +1136,14 @@ class RelJoin : public RelAlgNode {
 
   JoinType getJoinType() const { return join_type_; }
 
+  // Turns a RIGHT join into the equivalent LEFT join. The condition references the inputs
+  // by node, it stays valid; the callers remap the positional references to the output.
+  void swapInputsToLeftJoin() {
+    CHECK(join_type_ == JoinType::RIGHT);
+    std::swap(inputs_[0], inputs_[1]);
+    join_type_ = JoinType::LEFT;
+  }
+
   const RexScalar* getCondition() const { return condition_.get(); }
 
   const RexScalar* getAndReleaseCondition() const { return condition_.release(); }
@@ -1185,7 +1193,7 @@ class RelJoin : public RelAlgNode {
 
  private:
   mutable std::unique_ptr<const RexScalar> condition_;
-  const JoinType join_type_;
+  JoinType join_type_;
   bool hint_applied_;
   std::unique_ptr<Hints> hints_;
 };
@@ -1241,6 +1249,9 @@ class RelLeftDeepInnerJoin : public RelAlgNode {
 
   const RexScalar* getOuterCondition(const size_t nesting_level) const;
 
+  // LEFT or FULL for the levels with an outer condition, INNER otherwise.
+  JoinType getOuterJoinType(const size_t nesting_level) const;
+
   std::string toString() const override;
 
   size_t size() const override;
@@ -1252,6 +1263,7 @@ class RelLeftDeepInnerJoin : public RelAlgNode {
  private:
   std::unique_ptr<const RexScalar> condition_;
   std::vector<std::unique_ptr<const RexScalar>> outer_conditions_per_level_;
+  std::vector<JoinType> outer_join_types_per_level_;
   const std::shared_ptr<RelFilter> original_filter_;
   const std::vector<std::shared_ptr<const RelJoin>> original_joins_;
 };
@@ -59,6 +59,16 @@ struct JoinCondition {
 
 using JoinQualsPerNestingLevel = std::vector<JoinCondition>;
 
+// Rows of the inner table of a FULL join matched by the probe pass, one bit per row
+// indexed by the position of the row in the table. The probe pass runs as a LEFT join
+// which also sets the bits of the inner rows it matches, then a second pass over the
+// inner table emits the rows whose bit isn't set.
+struct FullJoinMatchedRows {
+  FullJoinMatchedRows(const size_t row_count) : bitmap((row_count + 31) / 32, 0) {}
+
+  std::vector<uint32_t> bitmap;
+};
+
 struct RelAlgExecutionUnit {
   std::vector<InputDescriptor> input_descs;
   std::list<std::shared_ptr<const InputColDescriptor>> input_col_descs;
@@ -74,6 +84,10 @@ struct RelAlgExecutionUnit {
   // empty if not a UNION, true if UNION ALL, false if regular UNION
   const std::optional<bool> union_all;
   std::shared_ptr<const query_state::QueryState> query_state;
+  // Only set for the two passes of a FULL join: the probe pass has the FULL join
+  // qualifiers and marks the matched rows, the pass over the inner table has no joins
+  // and only keeps the unmatched rows.
+  std::shared_ptr<FullJoinMatchedRows> full_join_matched_rows;
 };
 
 std::ostream& operator<<(std::ostream& os, const RelAlgExecutionUnit& ra_exe_unit);
@@ -19,6 +19,7 @@
 #include "QueryEngine/CalciteDeserializerUtils.h"
 #include "QueryEngine/CardinalityEstimator.h"
 #include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/DeepCopyVisitor.h"
 #include "QueryEngine/EquiJoinCondition.h"
 #include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/ExpressionRewrite.h"
@@ -29,8 +30,10 @@
 #include "QueryEngine/RelAlgDagBuilder.h"
 #include "QueryEngine/RelAlgTranslator.h"
 #include "QueryEngine/RexVisitor.h"
+#include "QueryEngine/SpillManager.h"
 #include "QueryEngine/TableFunctions/TableFunctionsFactory.h"
 #include "QueryEngine/WindowContext.h"
+#include "Shared/EncodedChunkLayout.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/measure.h"
 #include "Shared/misc.h"
@@ -47,6 +50,10 @@ bool g_skip_intermediate_count{true};
 extern bool g_enable_bump_allocator;
 bool g_enable_interop{false};
 bool g_enable_union{false};
+size_t g_hash_semi_join_threshold{100000};
+bool g_enable_group_by_spill{true};
+size_t g_group_by_spill_partition_count{8};
+bool g_enable_run_length_aggregates{true};
 
 namespace {
 
@@ -1366,14 +1373,15 @@ void RelAlgExecutor::executeUpdate(const RelAlgNode* node,
   CHECK(node);
   auto timer = DEBUG_TIMER(__func__);
 
-  UpdateTriggeredCacheInvalidator::invalidateCaches();
-
   auto co = co_in;
   co.hoist_literals = false;  // disable literal hoisting as it interferes with dict
                               // encoded string updates
 
   auto execute_update_for_node =
       [this, &co, &eo_in](const auto node, auto& work_unit, const bool is_aggregate) {
+        CHECK(node->getModifiedTableDescriptor());
+        UpdateTriggeredCacheInvalidator::invalidateCachesByTable(
+            cat_.getCurrentDB().dbId, node->getModifiedTableDescriptor()->tableId);
         UpdateTransactionParameters update_params(node->getModifiedTableDescriptor(),
                                                   node->getTargetColumns(),
                                                   node->getOutputMetainfo(),
@@ -1469,8 +1477,6 @@ void RelAlgExecutor::executeDelete(const RelAlgNode* node,
   CHECK(node);
   auto timer = DEBUG_TIMER(__func__);
 
-  DeleteTriggeredCacheInvalidator::invalidateCaches();
-
   auto execute_delete_for_node = [this, &co, &eo_in](const auto node,
                                                      auto& work_unit,
                                                      const bool is_aggregate) {
@@ -1480,6 +1486,8 @@ void RelAlgExecutor::executeDelete(const RelAlgNode* node,
       throw std::runtime_error(
           "DELETE only supported on tables with the vacuum attribute set to 'delayed'");
     }
+    DeleteTriggeredCacheInvalidator::invalidateCachesByTable(cat_.getCurrentDB().dbId,
+                                                             table_descriptor->tableId);
 
     const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
 
@@ -1593,6 +1601,13 @@ bool is_window_execution_unit(const RelAlgExecutionUnit& ra_exe_unit) {
                      });
 }
 
+bool has_full_join(const JoinQualsPerNestingLevel& join_quals) {
+  return std::any_of(
+      join_quals.begin(), join_quals.end(), [](const JoinCondition& join_condition) {
+        return join_condition.type == JoinType::FULL;
+      });
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeProject(
@@ -1751,6 +1766,20 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
   }
 }
 
+namespace {
+
+// The window function context reads the raw column buffers, which hold the runs or the
+// deltas instead of the values for these encodings.
+void check_window_column_encoding(const Analyzer::ColumnVar& col) {
+  const auto compression = col.get_type_info().get_compression();
+  if (compression == kENCODING_RL || compression == kENCODING_DIFF) {
+    throw ColumnarConversionNotSupported(
+        "Window function columns cannot be RL or DIFF encoded");
+  }
+}
+
+}  // namespace
+
 std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
     const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
@@ -1787,6 +1816,7 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
     if (!order_col) {
       throw std::runtime_error("Only order by columns supported for now");
     }
+    check_window_column_encoding(*order_col);
     const int8_t* column;
     size_t join_col_elem_count;
     std::tie(column, join_col_elem_count) =
@@ -1801,6 +1831,30 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
     CHECK_EQ(join_col_elem_count, elem_count);
     context->addOrderColumn(column, order_col.get(), chunks_owner);
   }
+  const auto& args = window_func->getArgs();
+  if (window_function_is_framed_aggregate(window_func) && !args.empty()) {
+    const auto arg_col =
+        std::dynamic_pointer_cast<const Analyzer::ColumnVar>(args.front());
+    if (!arg_col) {
+      throw std::runtime_error(
+          "Only column arguments supported for aggregates over a frame for now");
+    }
+    check_window_column_encoding(*arg_col);
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> arg_chunks_owner;
+    const int8_t* column;
+    size_t arg_col_elem_count;
+    std::tie(column, arg_col_elem_count) =
+        ColumnFetcher::getOneColumnFragment(executor_,
+                                            *arg_col,
+                                            query_infos.front().info.fragments.front(),
+                                            memory_level,
+                                            0,
+                                            nullptr,
+                                            arg_chunks_owner,
+                                            column_cache_map);
+    CHECK_EQ(arg_col_elem_count, elem_count);
+    context->setAggregateColumn(column, arg_chunks_owner);
+  }
   return context;
 }
 
@@ -2296,6 +2350,8 @@ ExecutionResult RelAlgExecutor::executeSimpleInsert(const Analyzer::Query& query
   } else {
     table_descriptor->fragmenter->insertData(insert_data);
   }
+  InsertTriggeredCacheInvalidator::invalidateCachesByTable(cat_.getCurrentDB().dbId,
+                                                           table_descriptor->tableId);
 
   auto rs = std::make_shared<ResultSet>(TargetInfoList{},
                                         ExecutorDeviceType::CPU,
@@ -2602,7 +2658,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
         get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
     const auto error_rate =
-        static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+        static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kINT);
       CHECK_GE(error_rate->get_constval().intval, 1);
@@ -2704,7 +2760,17 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     }
     return result;
   }
+  if (!work_unit.exe_unit.full_join_matched_rows &&
+      has_full_join(work_unit.exe_unit.join_quals)) {
+    return executeFullJoin(
+        work_unit, targets_meta, is_agg, co, eo, render_info, queue_time_ms);
+  }
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
+  if (const auto run_length_result = executeRunLengthAggregate(
+          work_unit.exe_unit, table_infos, targets_meta, eo, render_info)) {
+    body->setOutputMetainfo(targets_meta);
+    return *run_length_result;
+  }
 
   auto ra_exe_unit = decide_approx_count_distinct_implementation(
       work_unit.exe_unit, table_infos, executor_, co.device_type, target_exprs_owned_);
@@ -2760,6 +2826,18 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
                                          column_cache),
               targets_meta};
     } catch (const QueryExecutionError& e) {
+      if (e.getErrorCode() == Executor::ERR_OUT_OF_CPU_MEM) {
+        const auto partitioned_result = executeGroupByInPartitions(
+            {ra_exe_unit, work_unit.body, local_groups_buffer_entry_guess},
+            targets_meta,
+            co,
+            eo,
+            render_info,
+            queue_time_ms);
+        if (partitioned_result) {
+          return *partitioned_result;
+        }
+      }
       handlePersistentError(e.getErrorCode());
       return handleOutOfMemoryRetry(
           {ra_exe_unit, work_unit.body, local_groups_buffer_entry_guess},
@@ -2819,6 +2897,356 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
   return result;
 }
 
+namespace {
+
+// Rewrites an expression of a FULL join for the pass over its inner table, which becomes
+// the only input: the columns of the outer table are NULL for the unmatched rows.
+class FullJoinUnmatchedRowsRewriter : public DeepCopyVisitor {
+ protected:
+  RetType visitColumnVar(const Analyzer::ColumnVar* col_var) const override {
+    if (col_var->get_rte_idx() == 0) {
+      auto null_ti = col_var->get_type_info();
+      if (null_ti.is_array() || null_ti.is_geometry()) {
+        throw std::runtime_error(
+            "Array and geo columns of the left side of a FULL join not supported");
+      }
+      null_ti.set_notnull(false);
+      return makeExpr<Analyzer::Constant>(null_ti, true, Datum{});
+    }
+    CHECK_EQ(1, col_var->get_rte_idx());
+    return makeExpr<Analyzer::ColumnVar>(col_var->get_type_info(),
+                                         col_var->get_table_id(),
+                                         col_var->get_column_id(),
+                                         0);
+  }
+};
+
+}  // namespace
+
+namespace {
+
+// The run-length encoded column argument of a COUNT, SUM, MIN or MAX target, nullptr for
+// COUNT(*). Sets supported to false for any other target.
+const Analyzer::ColumnVar* get_run_length_agg_arg(const Analyzer::Expr* target_expr,
+                                                  bool& supported) {
+  supported = false;
+  const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+  if (!agg_expr || agg_expr->get_is_distinct()) {
+    return nullptr;
+  }
+  const auto agg_kind = agg_expr->get_aggtype();
+  if (agg_kind != kCOUNT && agg_kind != kSUM && agg_kind != kMIN && agg_kind != kMAX) {
+    return nullptr;
+  }
+  const auto arg = agg_expr->get_arg();
+  if (!arg) {
+    supported = agg_kind == kCOUNT;
+    return nullptr;
+  }
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(arg);
+  if (!col_var || dynamic_cast<const Analyzer::Var*>(arg) || col_var->get_rte_idx() > 0) {
+    return nullptr;
+  }
+  const auto& arg_ti = col_var->get_type_info();
+  if (arg_ti.get_compression() != kENCODING_RL) {
+    return nullptr;
+  }
+  if (agg_kind != kCOUNT && !arg_ti.is_integer() && !arg_ti.is_decimal() &&
+      !(agg_kind != kSUM && arg_ti.is_time())) {
+    return nullptr;
+  }
+  supported = true;
+  return col_var;
+}
+
+struct RunAggregates {
+  int64_t count{0};
+  int64_t sum{0};
+  int64_t min{std::numeric_limits<int64_t>::max()};
+  int64_t max{std::numeric_limits<int64_t>::min()};
+  bool sum_overflow{false};
+
+  void addRun(const int64_t value, const int64_t num_rows) {
+    count += num_rows;
+    int64_t run_sum;
+    if (__builtin_mul_overflow(value, num_rows, &run_sum) ||
+        __builtin_add_overflow(sum, run_sum, &sum)) {
+      sum_overflow = true;
+    }
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+};
+
+// Adds the non-null rows of a run-length encoded chunk, one run at a time.
+template <typename T>
+void aggregate_runs(const int8_t* chunk, RunAggregates& aggregates) {
+  const auto header = rle_chunk_header(chunk);
+  const auto null_val = inline_int_null_value<T>();
+  if (rle_chunk_is_plain(chunk)) {
+    const auto values = rle_chunk_plain_values<T>(chunk);
+    for (int64_t i = 0; i < header->num_rows; ++i) {
+      if (values[i] != null_val) {
+        aggregates.addRun(values[i], 1);
+      }
+    }
+    return;
+  }
+  const auto runs = rle_chunk_runs<T>(chunk);
+  int64_t run_start = 0;
+  for (int64_t i = 0; i < header->num_runs; ++i) {
+    if (runs[i].value != null_val) {
+      aggregates.addRun(runs[i].value, runs[i].run_end - run_start);
+    }
+    run_start = runs[i].run_end;
+  }
+}
+
+void aggregate_runs(const int8_t* chunk,
+                    const int32_t byte_width,
+                    RunAggregates& aggregates) {
+  switch (byte_width) {
+    case 1:
+      aggregate_runs<int8_t>(chunk, aggregates);
+      break;
+    case 2:
+      aggregate_runs<int16_t>(chunk, aggregates);
+      break;
+    case 4:
+      aggregate_runs<int32_t>(chunk, aggregates);
+      break;
+    default:
+      aggregate_runs<int64_t>(chunk, aggregates);
+      break;
+  }
+}
+
+}  // namespace
+
+std::optional<ExecutionResult> RelAlgExecutor::executeRunLengthAggregate(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& table_infos,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const ExecutionOptions& eo,
+    RenderInfo* render_info) {
+  if (!g_enable_run_length_aggregates || eo.just_explain || render_info ||
+      ra_exe_unit.input_descs.size() != 1 || table_infos.size() != 1 ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front() ||
+      !ra_exe_unit.simple_quals.empty() || !ra_exe_unit.quals.empty() ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.estimator ||
+      ra_exe_unit.union_all || ra_exe_unit.target_exprs.empty()) {
+    return std::nullopt;
+  }
+  const auto table_id = ra_exe_unit.input_descs.front().getTableId();
+  const auto td = cat_.getMetadataForTable(table_id);
+  if (!td || td->isView || td->storageType == StorageType::FOREIGN_TABLE ||
+      cat_.getDeletedColumnIfRowsDeleted(td)) {
+    return std::nullopt;
+  }
+  std::vector<const Analyzer::ColumnVar*> target_args;
+  bool has_run_length_arg{false};
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    bool supported;
+    target_args.push_back(get_run_length_agg_arg(target_expr, supported));
+    if (!supported) {
+      return std::nullopt;
+    }
+    has_run_length_arg = has_run_length_arg || target_args.back();
+  }
+  if (!has_run_length_arg) {
+    return std::nullopt;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+
+  std::unordered_map<int, const Analyzer::ColumnVar*> run_length_columns;
+  for (const auto col_var : target_args) {
+    if (col_var) {
+      run_length_columns.emplace(col_var->get_column_id(), col_var);
+    }
+  }
+  std::unordered_map<int, RunAggregates> aggregates_per_column;
+  int64_t num_rows{0};
+  ColumnCacheMap column_cache;
+  for (const auto& fragment : table_infos.front().info.fragments) {
+    num_rows += fragment.getNumTuples();
+    if (fragment.isEmptyPhysicalFragment()) {
+      continue;
+    }
+    for (const auto& [column_id, col_var] : run_length_columns) {
+      std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+      const auto chunk = ColumnFetcher::getOneColumnFragment(executor_,
+                                                             *col_var,
+                                                             fragment,
+                                                             Data_Namespace::CPU_LEVEL,
+                                                             0,
+                                                             nullptr,
+                                                             chunks_owner,
+                                                             column_cache)
+                             .first;
+      CHECK(chunk);
+      aggregate_runs(chunk,
+                     col_var->get_type_info().get_size(),
+                     aggregates_per_column[column_id]);
+    }
+  }
+  for (const auto& [column_id, aggregates] : aggregates_per_column) {
+    if (aggregates.sum_overflow) {
+      return std::nullopt;
+    }
+  }
+
+  QueryMemoryDescriptor query_mem_desc(
+      executor_, 1, QueryDescriptionType::Projection, /*is_table_function=*/false);
+  std::vector<TargetInfo> target_infos;
+  for (const auto& target_meta : targets_meta) {
+    const auto ti = get_logical_type_info(target_meta.get_type_info());
+    query_mem_desc.addColSlotInfo({std::make_tuple(ti.get_size(), 8)});
+    target_infos.emplace_back(
+        TargetInfo{false, kCOUNT, ti, SQLTypeInfo(kNULLT, false), false, false});
+  }
+  auto rs = std::make_shared<ResultSet>(target_infos,
+                                        ExecutorDeviceType::CPU,
+                                        query_mem_desc,
+                                        executor_->getRowSetMemoryOwner(),
+                                        executor_);
+  auto storage = rs->allocateStorage();
+  auto slot = reinterpret_cast<int64_t*>(storage->getUnderlyingBuffer());
+  for (size_t i = 0; i < ra_exe_unit.target_exprs.size(); ++i, ++slot) {
+    const auto agg_expr =
+        static_cast<const Analyzer::AggExpr*>(ra_exe_unit.target_exprs[i]);
+    const auto col_var = target_args[i];
+    if (!col_var) {
+      *slot = num_rows;
+      continue;
+    }
+    const auto& aggregates = aggregates_per_column[col_var->get_column_id()];
+    if (agg_expr->get_aggtype() == kCOUNT) {
+      *slot = aggregates.count;
+    } else if (!aggregates.count) {
+      *slot = inline_int_null_val(target_infos[i].sql_type);
+    } else if (agg_expr->get_aggtype() == kSUM) {
+      *slot = aggregates.sum;
+    } else {
+      *slot = agg_expr->get_aggtype() == kMIN ? aggregates.min : aggregates.max;
+    }
+  }
+  return ExecutionResult(rs, targets_meta);
+}
+
+/**
+ * Executes a FULL join in two passes. The probe pass runs it as a LEFT join and sets a
+ * bit for every row of the inner table it matches; the second pass scans the inner table
+ * alone and emits the rows whose bit isn't set, with NULL for the columns of the outer
+ * table. The WHERE clause is evaluated in both passes after the matching, so that inner
+ * rows only matched by filtered out rows don't show up as unmatched.
+ */
+ExecutionResult RelAlgExecutor::executeFullJoin(
+    const WorkUnit& work_unit,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const bool is_agg,
+    const CompilationOptions& co_in,
+    const ExecutionOptions& eo,
+    RenderInfo* render_info,
+    const int64_t queue_time_ms) {
+  const auto& exe_unit = work_unit.exe_unit;
+  if (exe_unit.join_quals.size() != 1 || exe_unit.input_descs.size() != 2 ||
+      exe_unit.input_descs[1].getSourceType() != InputSourceType::TABLE) {
+    throw std::runtime_error("FULL join is only supported between two tables");
+  }
+  if (is_agg || render_info || g_cluster) {
+    throw std::runtime_error("FULL join not supported in this context");
+  }
+  auto co = co_in;
+  co.device_type = ExecutorDeviceType::CPU;
+  co.allow_lazy_fetch = false;
+
+  const auto& inner_desc = exe_unit.input_descs[1];
+  const auto inner_table_infos = get_table_infos({inner_desc}, executor_);
+  CHECK_EQ(size_t(1), inner_table_infos.size());
+  size_t inner_row_count{0};
+  for (const auto& fragment : inner_table_infos.front().info.fragments) {
+    inner_row_count += fragment.getNumTuples();
+  }
+  auto matched_rows = std::make_shared<FullJoinMatchedRows>(inner_row_count);
+
+  // The sort and the limit apply to the rows of both passes, they're left to the caller.
+  const SortInfo no_sort{{}, SortAlgorithm::Default, 0, 0};
+  // Skipping outer fragments based on the filters would leave the inner rows they match
+  // unmarked.
+  auto probe_quals = exe_unit.quals;
+  probe_quals.insert(
+      probe_quals.end(), exe_unit.simple_quals.begin(), exe_unit.simple_quals.end());
+  WorkUnit probe_work_unit{{exe_unit.input_descs,
+                            exe_unit.input_col_descs,
+                            {},
+                            probe_quals,
+                            exe_unit.join_quals,
+                            exe_unit.groupby_exprs,
+                            exe_unit.target_exprs,
+                            exe_unit.estimator,
+                            no_sort,
+                            0,
+                            exe_unit.use_bump_allocator,
+                            exe_unit.union_all,
+                            exe_unit.query_state,
+                            matched_rows},
+                           work_unit.body,
+                           work_unit.max_groups_buffer_entry_guess,
+                           nullptr,
+                           {},
+                           {}};
+  auto result = executeWorkUnit(
+      probe_work_unit, targets_meta, is_agg, co, eo, nullptr, queue_time_ms);
+  if (eo.just_explain) {
+    return result;
+  }
+
+  std::list<std::shared_ptr<const InputColDescriptor>> unmatched_input_col_descs;
+  for (const auto& input_col_desc : exe_unit.input_col_descs) {
+    if (input_col_desc->getScanDesc().getNestLevel() == 1) {
+      unmatched_input_col_descs.push_back(std::make_shared<InputColDescriptor>(
+          input_col_desc->getColId(), inner_desc.getTableId(), 0));
+    }
+  }
+  FullJoinUnmatchedRowsRewriter rewriter;
+  std::vector<Analyzer::Expr*> unmatched_target_exprs;
+  for (const auto target_expr : exe_unit.target_exprs) {
+    target_exprs_owned_.push_back(rewriter.visit(target_expr));
+    unmatched_target_exprs.push_back(target_exprs_owned_.back().get());
+  }
+  std::list<std::shared_ptr<Analyzer::Expr>> unmatched_quals;
+  for (const auto& qual : probe_quals) {
+    unmatched_quals.push_back(rewriter.visit(qual.get()));
+  }
+  WorkUnit unmatched_work_unit{{{InputDescriptor(inner_desc.getTableId(), 0)},
+                                unmatched_input_col_descs,
+                                {},
+                                unmatched_quals,
+                                {},
+                                exe_unit.groupby_exprs,
+                                unmatched_target_exprs,
+                                nullptr,
+                                no_sort,
+                                0,
+                                false,
+                                exe_unit.union_all,
+                                exe_unit.query_state,
+                                matched_rows},
+                               work_unit.body,
+                               work_unit.max_groups_buffer_entry_guess,
+                               nullptr,
+                               {},
+                               {}};
+  const auto unmatched_result = executeWorkUnit(
+      unmatched_work_unit, targets_meta, is_agg, co, eo, nullptr, queue_time_ms);
+  if (result.getRows()->definitelyHasNoRows()) {
+    return unmatched_result;
+  }
+  result.getRows()->append(*unmatched_result.getRows());
+  return result;
+}
+
 std::optional<size_t> RelAlgExecutor::getFilteredCountAll(const WorkUnit& work_unit,
                                                           const bool is_agg,
                                                           const CompilationOptions& co,
@@ -3015,6 +3443,18 @@ ExecutionResult RelAlgExecutor::handleOutOfMemoryRetry(
                         "guess equal to "
                      << max_groups_buffer_entry_guess;
       } else {
+        if (e.getErrorCode() == Executor::ERR_OUT_OF_CPU_MEM) {
+          const auto partitioned_result = executeGroupByInPartitions(
+              {ra_exe_unit_in, work_unit.body, work_unit.max_groups_buffer_entry_guess},
+              targets_meta,
+              co_cpu,
+              eo,
+              nullptr,
+              queue_time_ms);
+          if (partitioned_result) {
+            return *partitioned_result;
+          }
+        }
         handlePersistentError(e.getErrorCode());
       }
       continue;
@@ -3025,6 +3465,275 @@ ExecutionResult RelAlgExecutor::handleOutOfMemoryRetry(
   return result;
 }
 
+namespace {
+
+// Returns true if the groups of the execution unit can be computed one partition of the
+// group keys at a time and concatenated: every target has to be a fixed size value which
+// doesn't point into a buffer owned by the pass which computed it.
+bool can_execute_group_by_in_partitions(const RelAlgExecutionUnit& ra_exe_unit) {
+  if (ra_exe_unit.groupby_exprs.empty() || !ra_exe_unit.groupby_exprs.front()) {
+    return false;
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto& ti = target_expr->get_type_info();
+    if (ti.is_varlen() || ti.is_array() || ti.is_geometry()) {
+      return false;
+    }
+    if (ti.is_string() && ti.get_compression() == kENCODING_DICT &&
+        ti.get_comp_param() == TRANSIENT_DICT_ID) {
+      return false;
+    }
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    if (agg_expr && (agg_expr->get_is_distinct() ||
+                     agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT ||
+                     agg_expr->get_aggtype() == kAPPROX_PERCENTILE)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns a filter which only keeps the rows whose group keys fall in the given
+// partition, or nullptr if none of the keys can be mapped to a partition. The keys which
+// can are combined modulo the partition count: integers, decimals and floating point
+// numbers cast to BIGINT and the dictionary ids of strings, nulls count as zero.
+std::shared_ptr<Analyzer::Expr> build_group_by_partition_qual(
+    const std::list<std::shared_ptr<Analyzer::Expr>>& groupby_exprs,
+    const size_t partition_count,
+    const size_t partition_idx) {
+  const SQLTypeInfo bigint_ti(kBIGINT, false);
+  const auto make_bigint = [](const int64_t val) {
+    Datum d;
+    d.bigintval = val;
+    return makeExpr<Analyzer::Constant>(kBIGINT, false, d);
+  };
+  const auto modulo = [&](const std::shared_ptr<Analyzer::Expr>& lhs) {
+    return makeExpr<Analyzer::BinOper>(
+        bigint_ti, false, kMODULO, kONE, lhs, make_bigint(partition_count));
+  };
+  std::shared_ptr<Analyzer::Expr> partition;
+  for (const auto& groupby_expr : groupby_exprs) {
+    const auto& ti = groupby_expr->get_type_info();
+    const auto uoper = std::dynamic_pointer_cast<Analyzer::UOper>(groupby_expr);
+    if (uoper && uoper->get_optype() == kUNNEST) {
+      continue;
+    }
+    std::shared_ptr<Analyzer::Expr> key;
+    if (ti.is_integer() || ti.is_decimal() || ti.is_fp()) {
+      key = groupby_expr->deep_copy();
+    } else if (ti.is_string() && ti.get_compression() == kENCODING_DICT) {
+      key = makeExpr<Analyzer::KeyForStringExpr>(groupby_expr->deep_copy());
+    } else {
+      continue;
+    }
+    key = key->add_cast(bigint_ti);
+    // The remainder of a negative key is negative, shift it into [0, partition_count)
+    std::shared_ptr<Analyzer::Expr> key_partition = modulo(makeExpr<Analyzer::BinOper>(
+        bigint_ti, false, kPLUS, kONE, modulo(key), make_bigint(partition_count)));
+    if (!ti.get_notnull()) {
+      std::list<
+          std::pair<std::shared_ptr<Analyzer::Expr>, std::shared_ptr<Analyzer::Expr>>>
+          when_null;
+      when_null.emplace_back(
+          makeExpr<Analyzer::UOper>(kBOOLEAN, kISNULL, groupby_expr->deep_copy()),
+          make_bigint(0));
+      key_partition =
+          makeExpr<Analyzer::CaseExpr>(bigint_ti, false, when_null, key_partition);
+    }
+    partition = partition ? modulo(makeExpr<Analyzer::BinOper>(
+                                bigint_ti, false, kPLUS, kONE, partition, key_partition))
+                          : key_partition;
+  }
+  if (!partition) {
+    return nullptr;
+  }
+  return makeExpr<Analyzer::BinOper>(SQLTypeInfo(kBOOLEAN, false),
+                                     false,
+                                     kEQ,
+                                     kONE,
+                                     partition,
+                                     make_bigint(partition_idx));
+}
+
+}  // namespace
+
+std::optional<ExecutionResult> RelAlgExecutor::executeGroupByInPartitions(
+    const WorkUnit& work_unit,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    RenderInfo* render_info,
+    const int64_t queue_time_ms) {
+  // Every partition count tried scans the whole input again, only a few are tried
+  constexpr size_t kMaxPartitionCountIncreases{2};
+  constexpr size_t kSpillBatchBytes{1 << 20};
+  const auto& ra_exe_unit_in = work_unit.exe_unit;
+  if (!g_enable_group_by_spill || g_group_by_spill_partition_count < 2 ||
+      render_info || eo.just_explain || eo.just_validate ||
+      !can_execute_group_by_in_partitions(ra_exe_unit_in) ||
+      !build_group_by_partition_qual(ra_exe_unit_in.groupby_exprs, 2, 0)) {
+    return std::nullopt;
+  }
+  const auto co_cpu = CompilationOptions::makeCpuOnly(co);
+  ExecutionOptions eo_partition{false,
+                                false,
+                                false,
+                                eo.allow_loop_joins,
+                                eo.with_watchdog,
+                                eo.jit_debug,
+                                false,
+                                eo.with_dynamic_watchdog,
+                                eo.dynamic_watchdog_time_limit,
+                                false,
+                                false,
+                                eo.gpu_input_mem_limit_percent,
+                                eo.allow_runtime_query_interrupt,
+                                eo.runtime_query_interrupt_frequency,
+                                eo.executor_type,
+                                eo.outer_fragment_indices};
+  const auto table_infos = get_table_infos(ra_exe_unit_in, executor_);
+  const auto query_row_set_mem_owner = executor_->row_set_mem_owner_;
+  ScopeGuard restore_row_set_mem_owner = [this, query_row_set_mem_owner] {
+    executor_->row_set_mem_owner_ = query_row_set_mem_owner;
+  };
+  const size_t groups_buffer_entry_guess =
+      work_unit.max_groups_buffer_entry_guess
+          ? work_unit.max_groups_buffer_entry_guess
+          : static_cast<size_t>(max_groups_buffer_entry_default_guess);
+  auto partition_count = g_group_by_spill_partition_count;
+  for (size_t attempt = 0; attempt <= kMaxPartitionCountIncreases;
+       ++attempt, partition_count *= 4) {
+    LOG(INFO) << "Group by ran out of host memory, executing it in " << partition_count
+              << " partitions of the group keys.";
+    auto spill_manager = std::make_unique<SpillManager>();
+    const auto spill_file = spill_manager->createFile();
+    std::optional<QueryMemoryDescriptor> spilled_query_mem_desc;
+    std::vector<TargetInfo> targets;
+    std::vector<int64_t> target_init_vals;
+    ResultSetPtr empty_rows;
+    bool out_of_memory{false};
+    for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+      auto partition_exe_unit = ra_exe_unit_in;
+      partition_exe_unit.use_bump_allocator = false;
+      partition_exe_unit.quals.push_back(build_group_by_partition_qual(
+          partition_exe_unit.groupby_exprs, partition_count, partition_idx));
+      const auto ra_exe_unit =
+          decide_approx_count_distinct_implementation(partition_exe_unit,
+                                                      table_infos,
+                                                      executor_,
+                                                      co_cpu.device_type,
+                                                      target_exprs_owned_);
+      // The buffers of the pass go away with its memory owner once its groups are spilled
+      executor_->row_set_mem_owner_ =
+          std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+      auto max_groups_buffer_entry_guess =
+          std::max((groups_buffer_entry_guess + partition_count - 1) / partition_count,
+                   size_t(1));
+      ResultSetPtr rows;
+      for (size_t iteration = 0; !rows; ++iteration) {
+        ColumnCacheMap column_cache;
+        try {
+          rows = executor_->executeWorkUnit(max_groups_buffer_entry_guess,
+                                            true,
+                                            table_infos,
+                                            ra_exe_unit,
+                                            co_cpu,
+                                            eo_partition,
+                                            cat_,
+                                            nullptr,
+                                            true,
+                                            column_cache);
+        } catch (const QueryExecutionError& e) {
+          if (e.getErrorCode() == Executor::ERR_OUT_OF_CPU_MEM) {
+            out_of_memory = true;
+            break;
+          }
+          if (e.getErrorCode() < 0 && iteration < 2) {
+            max_groups_buffer_entry_guess *= 2;
+            continue;
+          }
+          handlePersistentError(e.getErrorCode());
+          throw;
+        }
+      }
+      if (out_of_memory) {
+        break;
+      }
+      CHECK(rows);
+      const auto storage = rows->getStorage();
+      if (!storage) {
+        empty_rows = rows;
+        continue;
+      }
+      const auto& query_mem_desc = rows->getQueryMemDesc();
+      if (query_mem_desc.getQueryDescriptionType() !=
+              QueryDescriptionType::GroupByBaselineHash ||
+          query_mem_desc.didOutputColumnar() ||
+          rows->entryCount() != storage->getEntryCount()) {
+        LOG(INFO) << "Can't spill the groups of a "
+                  << query_mem_desc.queryDescTypeToString() << " group by.";
+        return std::nullopt;
+      }
+      if (!spilled_query_mem_desc) {
+        spilled_query_mem_desc = query_mem_desc;
+        targets = rows->getTargetInfos();
+        target_init_vals = rows->getTargetInitVals();
+      }
+      const auto row_bytes = get_row_bytes(query_mem_desc);
+      const auto buff = storage->getUnderlyingBuffer();
+      std::vector<int8_t> spill_buffer;
+      for (size_t entry_idx = 0; entry_idx < storage->getEntryCount(); ++entry_idx) {
+        if (rows->isRowAtEmpty(entry_idx)) {
+          continue;
+        }
+        const auto row_ptr = row_ptr_rowwise(buff, query_mem_desc, entry_idx);
+        spill_buffer.insert(spill_buffer.end(), row_ptr, row_ptr + row_bytes);
+        if (spill_buffer.size() >= kSpillBatchBytes) {
+          spill_manager->append(spill_file, spill_buffer.data(), spill_buffer.size());
+          spill_buffer.clear();
+        }
+      }
+      if (!spill_buffer.empty()) {
+        spill_manager->append(spill_file, spill_buffer.data(), spill_buffer.size());
+      }
+    }
+    if (out_of_memory) {
+      continue;
+    }
+    executor_->row_set_mem_owner_ = query_row_set_mem_owner;
+    if (!spilled_query_mem_desc) {
+      CHECK(empty_rows);
+      ExecutionResult result{empty_rows, targets_meta};
+      result.setQueueTime(queue_time_ms);
+      return result;
+    }
+    const auto spilled_bytes = spill_manager->getFileSize(spill_file);
+    const auto row_count = spilled_bytes / get_row_bytes(*spilled_query_mem_desc);
+    LOG(INFO) << "Spilled " << row_count << " groups, " << spilled_bytes
+              << " bytes, in " << partition_count << " partitions to "
+              << spill_manager->getPath();
+    auto query_mem_desc = *spilled_query_mem_desc;
+    query_mem_desc.setEntryCount(std::max(row_count, size_t(1)));
+    auto rows = std::make_shared<ResultSet>(targets,
+                                            ExecutorDeviceType::CPU,
+                                            query_mem_desc,
+                                            query_row_set_mem_owner,
+                                            executor_);
+    if (row_count) {
+      // The groups stay on disk, the result reads them a block at a time as they're
+      // fetched
+      rows->setSpilledRows(std::move(spill_manager), spill_file, target_init_vals);
+    } else {
+      rows->allocateStorage(target_init_vals);
+      rows->initializeStorage();
+    }
+    ExecutionResult result{rows, targets_meta};
+    result.setQueueTime(queue_time_ms);
+    return result;
+  }
+  throw std::runtime_error(getErrorMessageFromCode(Executor::ERR_OUT_OF_CPU_MEM));
+}
+
 void RelAlgExecutor::handlePersistentError(const int32_t error_code) {
   LOG(ERROR) << "Query execution failed with error "
              << getErrorMessageFromCode(error_code);
@@ -3190,7 +3899,7 @@ std::vector<JoinType> left_deep_join_types(const RelLeftDeepInnerJoin* left_deep
   for (size_t nesting_level = 1; nesting_level <= left_deep_join->inputCount() - 1;
        ++nesting_level) {
     if (left_deep_join->getOuterCondition(nesting_level)) {
-      join_types[nesting_level - 1] = JoinType::LEFT;
+      join_types[nesting_level - 1] = left_deep_join->getOuterJoinType(nesting_level);
     }
   }
   return join_types;
@@ -3249,8 +3958,159 @@ std::list<std::shared_ptr<Analyzer::Expr>> rewrite_quals(
   return rewritten_quals;
 }
 
+std::vector<const RexScalar*> rex_to_conjunctive_form(const RexScalar* qual_expr);
+
+std::shared_ptr<Analyzer::Expr> build_logical_expression(
+    const std::vector<std::shared_ptr<Analyzer::Expr>>& factors,
+    const SQLOps sql_op);
+
+// Returns the IN operator of an `IN (sub-query)` or a `NOT IN (sub-query)` conjunct, or
+// nullptr for any other conjunct.
+const RexOperator* get_in_subquery_oper(const RexScalar* conjunct, bool& is_not_in) {
+  auto oper = dynamic_cast<const RexOperator*>(conjunct);
+  is_not_in = oper && oper->getOperator() == kNOT && oper->size() == 1;
+  if (is_not_in) {
+    oper = dynamic_cast<const RexOperator*>(oper->getOperand(0));
+  }
+  if (!oper || oper->getOperator() != kIN || oper->size() < 2 ||
+      !dynamic_cast<const RexSubQuery*>(oper->getOperand(oper->size() - 1))) {
+    return nullptr;
+  }
+  return oper;
+}
+
+// Sub-query result columns a semi join can be built on: the join hash tables support
+// them and they are read back as plain integers by has_null_values().
+bool is_semi_join_key_type(const SQLTypeInfo& ti) {
+  if (ti.is_string()) {
+    return ti.get_compression() == kENCODING_DICT && ti.get_size() == 4;
+  }
+  return (ti.is_integer() || ti.is_time()) && ti.get_compression() == kENCODING_NONE;
+}
+
+bool has_null_values(ResultSet& rows) {
+  rows.moveToBegin();
+  while (true) {
+    const auto row = rows.getNextRow(false, false);
+    if (row.empty()) {
+      return false;
+    }
+    for (size_t i = 0; i < row.size(); ++i) {
+      const auto scalar_tv = boost::get<ScalarTargetValue>(&row[i]);
+      CHECK(scalar_tv);
+      const auto value = boost::get<int64_t>(scalar_tv);
+      CHECK(value);
+      if (*value == inline_int_null_val(rows.getColType(i))) {
+        return true;
+      }
+    }
+  }
+}
+
 }  // namespace
 
+bool RelAlgExecutor::addSemiJoinLevels(
+    const RelCompound* compound,
+    const RelAlgTranslator& translator,
+    std::vector<InputDescriptor>& input_descs,
+    std::list<std::shared_ptr<const InputColDescriptor>>& input_col_descs,
+    JoinQualsPerNestingLevel& join_quals,
+    std::shared_ptr<Analyzer::Expr>& remaining_filter) {
+  const auto filter_rex = compound->getFilterExpr();
+  if (!filter_rex) {
+    return false;
+  }
+  bool has_semi_join{false};
+  std::vector<std::shared_ptr<Analyzer::Expr>> filter_factors;
+  for (const auto conjunct : rex_to_conjunctive_form(filter_rex)) {
+    bool is_not_in{false};
+    const auto in_oper = get_in_subquery_oper(conjunct, is_not_in);
+    if (!in_oper) {
+      filter_factors.push_back(translator.translateScalarRex(conjunct));
+      continue;
+    }
+    const auto subquery =
+        static_cast<const RexSubQuery*>(in_oper->getOperand(in_oper->size() - 1));
+    const auto& rows = subquery->getExecutionResult()->getRows();
+    const size_t key_count = in_oper->size() - 1;
+    CHECK_EQ(key_count, rows->colCount());
+    const auto row_count = rows->rowCount();
+    // A single key IN sub-query keeps going through the IN list path for small results,
+    // there is no other way to run a multiple keys one.
+    bool use_semi_join = key_count > 1 || (g_hash_semi_join_threshold &&
+                                           row_count >= g_hash_semi_join_threshold);
+    std::vector<std::shared_ptr<Analyzer::Expr>> lhs_keys;
+    for (size_t i = 0; i < key_count && use_semi_join; ++i) {
+      lhs_keys.push_back(translator.translateScalarRex(in_oper->getOperand(i)));
+      const auto& lhs_ti = lhs_keys.back()->get_type_info();
+      const auto& rhs_ti = rows->getColType(i);
+      use_semi_join = is_semi_join_key_type(rhs_ti) &&
+                      lhs_ti.get_type() == rhs_ti.get_type() &&
+                      (!rhs_ti.is_string() ||
+                       (lhs_ti.get_compression() == kENCODING_DICT &&
+                        lhs_ti.get_comp_param() == rhs_ti.get_comp_param())) &&
+                      (!is_not_in || key_count == 1 || lhs_ti.get_notnull());
+    }
+    // NOT IN is never true if the sub-query returns a NULL.
+    if (use_semi_join && is_not_in && row_count) {
+      use_semi_join = !has_null_values(*rows);
+    }
+    if (!use_semi_join) {
+      filter_factors.push_back(translator.translateScalarRex(conjunct));
+      continue;
+    }
+    has_semi_join = true;
+    if (!row_count) {
+      // IN an empty set is false and NOT IN an empty set true, even for a NULL key.
+      if (!is_not_in) {
+        Datum false_datum;
+        false_datum.boolval = false;
+        filter_factors.push_back(
+            makeExpr<Analyzer::Constant>(kBOOLEAN, false, false_datum));
+      }
+      continue;
+    }
+    if (is_not_in && !lhs_keys.front()->get_type_info().get_notnull()) {
+      // A NULL key is never found in the hash table but NOT IN is NULL for it.
+      const auto is_null = makeExpr<Analyzer::UOper>(kBOOLEAN, kISNULL, lhs_keys.front());
+      filter_factors.push_back(makeExpr<Analyzer::UOper>(kBOOLEAN, kNOT, is_null));
+    }
+    const int table_id = -static_cast<int>(subquery->getId());
+    const int nest_level = input_descs.size();
+    if (!temporary_tables_.count(table_id)) {
+      addTemporaryTable(table_id, rows);
+    }
+    input_descs.emplace_back(table_id, nest_level);
+    std::vector<std::shared_ptr<Analyzer::Expr>> rhs_keys;
+    for (size_t i = 0; i < key_count; ++i) {
+      input_col_descs.push_back(
+          std::make_shared<const InputColDescriptor>(i, table_id, nest_level));
+      rhs_keys.push_back(makeExpr<Analyzer::ColumnVar>(
+          rows->getColType(i), table_id, static_cast<int>(i), nest_level));
+    }
+    const auto join_qual = std::make_shared<Analyzer::BinOper>(
+        SQLTypeInfo(kBOOLEAN, false),
+        false,
+        kEQ,
+        kONE,
+        key_count > 1 ? std::make_shared<Analyzer::ExpressionTuple>(lhs_keys)
+                      : lhs_keys.front(),
+        key_count > 1 ? std::make_shared<Analyzer::ExpressionTuple>(rhs_keys)
+                      : rhs_keys.front());
+    join_quals.push_back(
+        JoinCondition{{join_qual}, is_not_in ? JoinType::ANTI : JoinType::SEMI});
+    VLOG(1) << "Running " << (is_not_in ? "NOT IN" : "IN") << " sub-query with "
+            << row_count << " rows as a hash " << (is_not_in ? "anti" : "semi")
+            << " join.";
+  }
+  if (!has_semi_join) {
+    return false;
+  }
+  remaining_filter =
+      filter_factors.empty() ? nullptr : build_logical_expression(filter_factors, kAND);
+  return true;
+}
+
 RelAlgExecutor::WorkUnit RelAlgExecutor::createCompoundWorkUnit(
     const RelCompound* compound,
     const SortInfo& sort_info,
@@ -3261,7 +4121,7 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createCompoundWorkUnit(
   std::tie(input_descs, input_col_descs, std::ignore) =
       get_input_desc(compound, input_to_nest_level, {}, cat_);
   VLOG(3) << "input_descs=" << shared::printContainer(input_descs);
-  const auto query_infos = get_table_infos(input_descs, executor_);
+  auto query_infos = get_table_infos(input_descs, executor_);
   CHECK_EQ(size_t(1), compound->inputCount());
   const auto left_deep_join =
       dynamic_cast<const RelLeftDeepInnerJoin*>(compound->getInput(0));
@@ -3276,6 +4136,8 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createCompoundWorkUnit(
         left_deep_join, input_descs, input_to_nest_level, eo.just_explain);
     if (g_from_table_reordering &&
         std::find(join_types.begin(), join_types.end(), JoinType::LEFT) ==
+            join_types.end() &&
+        std::find(join_types.begin(), join_types.end(), JoinType::FULL) ==
             join_types.end()) {
       input_permutation = do_table_reordering(input_descs,
                                               input_col_descs,
@@ -3301,7 +4163,23 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createCompoundWorkUnit(
   const auto scalar_sources =
       translate_scalar_sources(compound, translator, eo.executor_type);
   const auto groupby_exprs = translate_groupby_exprs(compound, scalar_sources);
-  const auto quals_cf = translate_quals(compound, translator);
+  // The semi join levels come after the reordered inputs, they can only be the innermost
+  // ones.
+  std::shared_ptr<Analyzer::Expr> remaining_filter;
+  const bool has_semi_join = !eo.just_explain && addSemiJoinLevels(compound,
+                                                                   translator,
+                                                                   input_descs,
+                                                                   input_col_descs,
+                                                                   left_deep_join_quals,
+                                                                   remaining_filter);
+  if (has_semi_join) {
+    query_infos = get_table_infos(input_descs, executor_);
+  }
+  const auto quals_cf =
+      !has_semi_join
+          ? translate_quals(compound, translator)
+          : remaining_filter ? qual_to_conjunctive_form(fold_expr(remaining_filter.get()))
+                             : QualsConjunctiveForm{};
   const auto target_exprs = translate_targets(target_exprs_owned_,
                                               scalar_sources,
                                               groupby_exprs,
@@ -3473,8 +4351,9 @@ JoinQualsPerNestingLevel RelAlgExecutor::translateLeftDeepJoinFilter(
       result[rte_idx - 1].quals =
           makeJoinQuals(outer_condition, join_types, input_to_nest_level, just_explain);
       CHECK_LE(rte_idx, join_types.size());
-      CHECK(join_types[rte_idx - 1] == JoinType::LEFT);
-      result[rte_idx - 1].type = JoinType::LEFT;
+      CHECK(join_types[rte_idx - 1] == JoinType::LEFT ||
+            join_types[rte_idx - 1] == JoinType::FULL);
+      result[rte_idx - 1].type = join_types[rte_idx - 1];
       continue;
     }
     for (const auto& qual : join_condition_quals) {
@@ -36,6 +36,8 @@
 
 extern bool g_skip_intermediate_count;
 
+class RelAlgTranslator;
+
 enum class MergeType { Union, Reduce };
 
 struct FirstStepExecutionResult {
@@ -272,6 +274,24 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
       const int64_t queue_time_ms,
       const std::optional<size_t> previous_count = std::nullopt);
 
+  // Computes COUNT, SUM, MIN and MAX without a group by or a filter over run-length
+  // encoded columns of a single table from the runs of the chunks. Returns nothing if
+  // the execution unit doesn't have this shape or a sum overflows.
+  std::optional<ExecutionResult> executeRunLengthAggregate(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& table_infos,
+      const std::vector<TargetMetaInfo>& targets_meta,
+      const ExecutionOptions& eo,
+      RenderInfo* render_info);
+
+  ExecutionResult executeFullJoin(const WorkUnit& work_unit,
+                                  const std::vector<TargetMetaInfo>& targets_meta,
+                                  const bool is_agg,
+                                  const CompilationOptions& co_in,
+                                  const ExecutionOptions& eo,
+                                  RenderInfo* render_info,
+                                  const int64_t queue_time_ms);
+
   size_t getNDVEstimation(const WorkUnit& work_unit,
                           const int64_t range,
                           const bool is_agg,
@@ -304,6 +324,18 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                          const bool was_multifrag_kernel_launch,
                                          const int64_t queue_time_ms);
 
+  // Runs a group by which ran out of host memory on CPU once per partition of its group
+  // keys, spilling the groups of every pass to disk before moving on to the next one.
+  // The result reads the spilled groups back as they're fetched. Returns nothing if the
+  // group by can't be partitioned, the caller should report the original error then.
+  std::optional<ExecutionResult> executeGroupByInPartitions(
+      const WorkUnit& work_unit,
+      const std::vector<TargetMetaInfo>& targets_meta,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo,
+      RenderInfo* render_info,
+      const int64_t queue_time_ms);
+
   // Allows an out of memory error through if CPU retry is enabled. Otherwise, throws an
   // appropriate exception corresponding to the query error code.
   static void handlePersistentError(const int32_t error_code);
@@ -314,6 +346,18 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                   const SortInfo&,
                                   const ExecutionOptions& eo);
 
+  // Appends a semi join level, an anti join one for NOT IN, against the result of the
+  // sub-query to the inputs for each IN sub-query conjunct of the filter of the compound
+  // which qualifies. Returns false if there is none, otherwise sets remaining_filter to
+  // the translation of the other conjuncts and of the NULL checks NOT IN requires.
+  bool addSemiJoinLevels(
+      const RelCompound* compound,
+      const RelAlgTranslator& translator,
+      std::vector<InputDescriptor>& input_descs,
+      std::list<std::shared_ptr<const InputColDescriptor>>& input_col_descs,
+      JoinQualsPerNestingLevel& join_quals,
+      std::shared_ptr<Analyzer::Expr>& remaining_filter);
+
   WorkUnit createAggregateWorkUnit(const RelAggregate*,
                                    const SortInfo&,
                                    const bool just_explain);
@@ -217,6 +217,9 @@ bool is_agg_supported_for_type(const SQLAgg& agg_kind, const SQLTypeInfo& arg_ti
       !(arg_ti.is_number() || arg_ti.is_boolean() || arg_ti.is_time())) {
     return false;
   }
+  if (agg_kind == kAPPROX_PERCENTILE && !arg_ti.is_number()) {
+    return false;
+  }
 
   return true;
 }
@@ -230,30 +233,51 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, scalar_sources.size());
     CHECK_LE(rex->size(), 2u);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
           scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kINT ||
-          err_rate->get_constval().intval < 1 || err_rate->get_constval().intval > 100) {
+      if (!arg1 || arg1->get_type_info().get_type() != kINT ||
+          arg1->get_constval().intval < 1 || arg1->get_constval().intval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between "
             "1 and 100");
       }
     }
+    if (agg_kind == kAPPROX_PERCENTILE) {
+      CHECK_EQ(rex->size(), 2u);
+      const auto quantile = std::dynamic_pointer_cast<Analyzer::Constant>(
+          scalar_sources[rex->getOperand(1)]);
+      if (quantile && quantile->get_type_info().is_number() &&
+          !quantile->get_is_null()) {
+        arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
+            quantile->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, true)));
+      }
+      if (!arg1 || arg1->get_constval().doubleval < 0 ||
+          arg1->get_constval().doubleval > 1) {
+        throw std::runtime_error(
+            "APPROX_PERCENTILE's second parameter should be a numeric literal between 0 "
+            "and 1");
+      }
+    }
     const auto& arg_ti = arg_expr->get_type_info();
     if (!is_agg_supported_for_type(agg_kind, arg_ti)) {
       throw std::runtime_error("Aggregate on " + arg_ti.get_type_name() +
                                " is not supported yet.");
     }
+    if (agg_kind == kAPPROX_PERCENTILE && arg_ti.get_type() != kDOUBLE) {
+      // The digest is built on doubles, convert the other numeric types while loading.
+      arg_expr =
+          arg_expr->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, arg_ti.get_notnull()));
+    }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(
@@ -358,6 +382,16 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateScalarSubquery(
   return makeExpr<Analyzer::Constant>(ti, is_null_const, d);
 }
 
+// The inner columns of LEFT and FULL joins and the outer columns of FULL joins are NULL
+// for the rows without a match.
+bool RelAlgTranslator::isNullableInOuterJoin(const int rte_idx) const {
+  if (rte_idx > 0) {
+    return join_types_[rte_idx - 1] == JoinType::LEFT ||
+           join_types_[rte_idx - 1] == JoinType::FULL;
+  }
+  return !join_types_.empty() && join_types_.front() == JoinType::FULL;
+}
+
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateInput(
     const RexInput* rex_input) const {
   const auto source = rex_input->getSourceNode();
@@ -386,7 +420,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateInput(
       col_ti.set_size(8);
     }
     CHECK_LE(static_cast<size_t>(rte_idx), join_types_.size());
-    if (rte_idx > 0 && join_types_[rte_idx - 1] == JoinType::LEFT) {
+    if (isNullableInOuterJoin(rte_idx)) {
       col_ti.set_notnull(false);
     }
     return std::make_shared<Analyzer::ColumnVar>(
@@ -400,7 +434,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateInput(
 
   if (join_types_.size() > 0) {
     CHECK_LE(static_cast<size_t>(rte_idx), join_types_.size());
-    if (rte_idx > 0 && join_types_[rte_idx - 1] == JoinType::LEFT) {
+    if (isNullableInOuterJoin(rte_idx)) {
       col_ti.set_notnull(false);
     }
   }
@@ -536,7 +570,12 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateInOper(
   if (just_explain_) {
     throw std::runtime_error("EXPLAIN is not supported with sub-queries");
   }
-  CHECK(rex_operator->size() == 2);
+  if (rex_operator->size() != 2) {
+    // See RelAlgExecutor::addSemiJoinLevels() for the ones which can run.
+    throw std::runtime_error(
+        "Multiple columns IN sub-queries are only supported as hash semi joins, in a top "
+        "level conjunct of the filter.");
+  }
   const auto lhs = translateScalarRex(rex_operator->getOperand(0));
   const auto rhs = rex_operator->getOperand(1);
   const auto rex_subquery = dynamic_cast<const RexSubQuery*>(rhs);
@@ -1602,6 +1641,20 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateFunction(
       }
     }
   }
+  if (func_resolve(
+          rex_function->getName(), "hll_register"sv, "hll_rank"sv, "hll_estimate"sv)) {
+    // The precision sizes the sketch the registers and ranks index, the functions
+    // can't check it themselves
+    const auto precision =
+        std::dynamic_pointer_cast<Analyzer::Constant>(arg_expr_list.back());
+    if (!precision || precision->get_is_null() ||
+        precision->get_type_info().get_type() != kINT ||
+        precision->get_constval().intval < 4 || precision->get_constval().intval > 16) {
+      throw std::runtime_error(rex_function->getName() +
+                               "'s precision should be an INTEGER literal between 4 "
+                               "and 16");
+    }
+  }
   auto ret_ti = ext_arg_type_to_type_info(ext_func_sig.getRet());
   // By defualt, the extension function type will not allow nulls. If one of the arguments
   // is nullable, the extension function must also explicitly allow nulls.
@@ -1660,15 +1713,89 @@ bool supported_upper_bound(const RexWindowFunctionOperator* rex_window_function)
   }
 }
 
+double get_frame_offset(const Analyzer::Expr* offset_expr) {
+  const auto offset = dynamic_cast<const Analyzer::Constant*>(offset_expr);
+  if (!offset || offset->get_is_null()) {
+    throw std::runtime_error("Window frame offsets must be numeric literals");
+  }
+  const auto& offset_ti = offset->get_type_info();
+  const auto& datum = offset->get_constval();
+  double offset_val;
+  switch (offset_ti.get_type()) {
+    case kTINYINT: {
+      offset_val = datum.tinyintval;
+      break;
+    }
+    case kSMALLINT: {
+      offset_val = datum.smallintval;
+      break;
+    }
+    case kINT: {
+      offset_val = datum.intval;
+      break;
+    }
+    case kBIGINT: {
+      offset_val = datum.bigintval;
+      break;
+    }
+    case kNUMERIC:
+    case kDECIMAL: {
+      offset_val =
+          static_cast<double>(datum.bigintval) / exp_to_scale(offset_ti.get_scale());
+      break;
+    }
+    case kFLOAT: {
+      offset_val = datum.floatval;
+      break;
+    }
+    case kDOUBLE: {
+      offset_val = datum.doubleval;
+      break;
+    }
+    default: {
+      throw std::runtime_error("Window frame offsets must be numeric literals");
+    }
+  }
+  if (offset_val < 0) {
+    throw std::runtime_error("Window frame offsets must not be negative");
+  }
+  return offset_val;
+}
+
 }  // namespace
 
+Analyzer::WindowFrameBound RelAlgTranslator::translateWindowBound(
+    const RexWindowFunctionOperator::RexWindowBound& window_bound) const {
+  using BoundType = Analyzer::WindowFrameBound::Type;
+  if (window_bound.unbounded) {
+    return {window_bound.preceding ? BoundType::UnboundedPreceding
+                                   : BoundType::UnboundedFollowing,
+            0};
+  }
+  if (window_bound.is_current_row) {
+    return {BoundType::CurrentRow, 0};
+  }
+  CHECK(window_bound.offset);
+  const auto offset = translateScalarRex(window_bound.offset.get());
+  return {window_bound.preceding ? BoundType::Preceding : BoundType::Following,
+          get_frame_offset(offset.get())};
+}
+
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
     const RexWindowFunctionOperator* rex_window_function) const {
+  const auto kind = rex_window_function->getKind();
+  std::optional<Analyzer::WindowFrame> frame;
   if (!supported_lower_bound(rex_window_function->getLowerBound()) ||
       !supported_upper_bound(rex_window_function) ||
-      ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
-       rex_window_function->isRows())) {
-    throw std::runtime_error("Frame specification not supported");
+      ((kind == SqlWindowFunctionKind::ROW_NUMBER) != rex_window_function->isRows())) {
+    // Aggregates over any other frame are evaluated by the window context directly.
+    if (!window_function_is_aggregate(kind)) {
+      throw std::runtime_error("Frame specification not supported");
+    }
+    frame = Analyzer::WindowFrame{
+        rex_window_function->isRows(),
+        translateWindowBound(rex_window_function->getLowerBound()),
+        translateWindowBound(rex_window_function->getUpperBound())};
   }
   std::vector<std::shared_ptr<Analyzer::Expr>> args;
   for (size_t i = 0; i < rex_window_function->size(); ++i) {
@@ -1682,18 +1809,24 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
   for (const auto& order_key : rex_window_function->getOrderKeys()) {
     order_keys.push_back(translateScalarRex(order_key.get()));
   }
+  if (frame && !frame->is_rows && frame->hasOffset() &&
+      (order_keys.size() != 1 || !order_keys.front()->get_type_info().is_number())) {
+    throw std::runtime_error(
+        "RANGE frames with offsets require a single numeric order key");
+  }
   auto ti = rex_window_function->getType();
-  if (window_function_is_value(rex_window_function->getKind())) {
+  if (window_function_is_value(kind)) {
     CHECK_GE(args.size(), 1u);
     ti = args.front()->get_type_info();
   }
   return makeExpr<Analyzer::WindowFunction>(
       ti,
-      rex_window_function->getKind(),
+      kind,
       args,
       partition_keys,
       order_keys,
-      translate_collation(rex_window_function->getCollation()));
+      translate_collation(rex_window_function->getCollation()),
+      frame);
 }
 
 Analyzer::ExpressionPtrVector RelAlgTranslator::translateFunctionArgs(
@@ -142,6 +142,9 @@ class RelAlgTranslator {
   std::shared_ptr<Analyzer::Expr> translateWindowFunction(
       const RexWindowFunctionOperator*) const;
 
+  Analyzer::WindowFrameBound translateWindowBound(
+      const RexWindowFunctionOperator::RexWindowBound&) const;
+
   Analyzer::ExpressionPtrVector translateFunctionArgs(const RexFunctionOperator*) const;
 
   std::shared_ptr<Analyzer::Expr> translateUnaryGeoFunction(
@@ -193,6 +196,8 @@ class RelAlgTranslator {
                                                                    SQLTypeInfo&,
                                                                    bool) const;
 
+  bool isNullableInOuterJoin(const int rte_idx) const;
+
   const Catalog_Namespace::Catalog& cat_;
   std::shared_ptr<const query_state::QueryState> query_state_;
   const Executor* executor_;
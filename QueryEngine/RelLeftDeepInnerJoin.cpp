@@ -33,6 +33,7 @@ RelLeftDeepInnerJoin::RelLeftDeepInnerJoin(
   // Accumulate join conditions from the (explicit) joins themselves and
   // from the filter node at the root of the left-deep tree pattern.
   outer_conditions_per_level_.resize(original_joins.size());
+  outer_join_types_per_level_.resize(original_joins.size(), JoinType::INNER);
   for (size_t nesting_level = 0; nesting_level < original_joins.size(); ++nesting_level) {
     const auto& original_join = original_joins[nesting_level];
     const auto condition_true =
@@ -51,10 +52,12 @@ RelLeftDeepInnerJoin::RelLeftDeepInnerJoin(
           }
           break;
         }
-        case JoinType::LEFT: {
+        case JoinType::LEFT:
+        case JoinType::FULL: {
           if (original_join->getCondition()) {
             outer_conditions_per_level_[nesting_level].reset(
                 original_join->getAndReleaseCondition());
+            outer_join_types_per_level_[nesting_level] = original_join->getJoinType();
           }
           break;
         }
@@ -100,6 +103,12 @@ const RexScalar* RelLeftDeepInnerJoin::getOuterCondition(
       .get();
 }
 
+JoinType RelLeftDeepInnerJoin::getOuterJoinType(const size_t nesting_level) const {
+  CHECK_GE(nesting_level, size_t(1));
+  CHECK_LE(nesting_level, outer_join_types_per_level_.size());
+  return outer_join_types_per_level_[outer_join_types_per_level_.size() - nesting_level];
+}
+
 std::string RelLeftDeepInnerJoin::toString() const {
   std::string result =
       "(RelLeftDeepInnerJoin<" + std::to_string(reinterpret_cast<uint64_t>(this)) + ">(";
@@ -29,6 +29,7 @@
 #include "Execute.h"
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
+#include "OSDependent/omnisci_fs.h"
 #include "OutputBufferInitialization.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
@@ -36,20 +37,50 @@
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
 #include "Shared/threadpool.h"
+#include "SortedRunMerger.h"
+#include "SpillManager.h"
+#include "TDigest.h"
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <future>
 #include <numeric>
 
 extern bool g_use_tbb_pool;
 
+bool g_enable_external_sort{false};
+size_t g_external_sort_run_rows{1 << 24};
+size_t g_external_sort_max_concurrent_runs{4};
+size_t g_spilled_rows_block_bytes{1 << 24};
+bool g_enable_normalized_sort_keys{true};
+
+struct ResultSet::SpilledRows {
+  std::unique_ptr<SpillManager> spill_manager;
+  size_t file_id;
+  size_t row_bytes;
+  // The storage holds the rows from block_start on, block_rows at most
+  std::vector<int8_t> block;
+  size_t block_rows;
+  size_t block_start;
+};
+
+struct ResultSet::SortedRuns {
+  std::unique_ptr<SortedRunMerger> merger;
+  // A spilled record is the normalized key of a row followed by the row
+  size_t key_bytes;
+  size_t row_bytes;
+  // The storage holds the last merged row
+  std::vector<int8_t> row;
+};
+
 std::vector<int64_t> initialize_target_values_for_storage(
     const std::vector<TargetInfo>& targets) {
   std::vector<int64_t> target_init_vals;
   for (const auto& target_info : targets) {
     if (target_info.agg_kind == kCOUNT ||
-        target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+        target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_PERCENTILE) {
       target_init_vals.push_back(0);
       continue;
     }
@@ -298,6 +329,7 @@ void ResultSet::append(ResultSet& that) {
 }
 
 const ResultSetStorage* ResultSet::getStorage() const {
+  materializeRows();
   return storage_.get();
 }
 
@@ -336,6 +368,10 @@ size_t ResultSet::rowCount(const bool force_parallel) const {
   if (just_explain_) {
     return 1;
   }
+  if (spilled_rows_ || sorted_runs_) {
+    return get_truncated_row_count(
+        query_mem_desc_.getEntryCount(), getLimit(), drop_first_);
+  }
   if (!permutation_.empty()) {
     if (drop_first_ > permutation_.size()) {
       return 0;
@@ -431,6 +467,7 @@ bool ResultSet::definitelyHasNoRows() const {
 
 const QueryMemoryDescriptor& ResultSet::getQueryMemDesc() const {
   CHECK(storage_);
+  materializeRows();
   return storage_->query_mem_desc_;
 }
 
@@ -480,6 +517,24 @@ void ResultSet::addCompilationQueueTime(const int64_t compilation_queue_time) {
   timings_.compilation_queue_time += compilation_queue_time;
 }
 
+void ResultSet::setKernelSchedulingStats(const int64_t kernel_idle_time,
+                                         const size_t morsel_kernels) {
+  timings_.kernel_idle_time = kernel_idle_time;
+  timings_.morsel_kernels = morsel_kernels;
+}
+
+void ResultSet::setChunkPrefetchStats(const size_t prefetched_chunks,
+                                      const size_t prefetch_hits,
+                                      const size_t prefetch_misses) {
+  timings_.prefetched_chunks = prefetched_chunks;
+  timings_.prefetch_hits = prefetch_hits;
+  timings_.prefetch_misses = prefetch_misses;
+}
+
+void ResultSet::setJoinKeySkippedFragments(const size_t join_key_skipped_fragments) {
+  timings_.join_key_skipped_fragments = join_key_skipped_fragments;
+}
+
 int64_t ResultSet::getQueueTime() const {
   return timings_.executor_queue_time + timings_.kernel_queue_time +
          timings_.compilation_queue_time;
@@ -492,6 +547,9 @@ int64_t ResultSet::getRenderTime() const {
 void ResultSet::moveToBegin() const {
   crt_row_buff_idx_ = 0;
   fetched_so_far_ = 0;
+  if (sorted_runs_) {
+    sorted_runs_->merger->reset();
+  }
 }
 
 bool ResultSet::isTruncated() const {
@@ -525,6 +583,7 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
   if (!storage_) {
     return;
   }
+  materializeSpilledRows();
   CHECK_EQ(-1, cached_row_count_);
   CHECK(!targets_.empty());
 #ifdef HAVE_CUDA
@@ -545,8 +604,10 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     }
     return;
   }
-  // This check isn't strictly required, but allows the index buffer to be 32-bit.
-  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max()) {
+  // This check isn't strictly required, but allows the index buffer to be 32-bit. The
+  // external sort indexes the entries of every run from its first one.
+  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max() &&
+      !canUseExternalSort(order_entries, top_n)) {
     throw RowSortException("Sorting more than 4B elements not supported");
   }
 
@@ -565,12 +626,19 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     throw WatchdogException("Sorting the result would be too slow");
   }
 
+  if (canUseExternalSort(order_entries, top_n)) {
+    externalSort(order_entries);
+    return;
+  }
+
   permutation_ = initPermutationBuffer(0, 1);
 
   auto compare = createComparator(order_entries, use_heap);
 
   if (use_heap) {
     topPermutation(permutation_, top_n, compare);
+  } else if (canUseNormalizedKeySort(order_entries)) {
+    normalizedKeySort(permutation_);
   } else {
     sortPermutation(compare);
   }
@@ -613,6 +681,7 @@ std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start,
 }
 
 const std::vector<uint32_t>& ResultSet::getPermutationBuffer() const {
+  materializeRows();
   return permutation_;
 }
 
@@ -700,13 +769,12 @@ void ResultSet::ResultSetComparator<
 }
 
 template <typename BUFFER_ITERATOR_TYPE>
-std::vector<int64_t>
-ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeCountDistinctColumn(
-    const Analyzer::OrderEntry& order_entry) const {
+template <typename T, typename F>
+std::vector<T> ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeColumn(
+    const Analyzer::OrderEntry& order_entry,
+    const F& materialize_value) const {
   const size_t num_storage_entries = result_set_->query_mem_desc_.getEntryCount();
-  std::vector<int64_t> count_distinct_materialized_buffer(num_storage_entries);
-  const CountDistinctDescriptor count_distinct_descriptor =
-      result_set_->query_mem_desc_.getCountDistinctDescriptor(order_entry.tle_no - 1);
+  std::vector<T> materialized_buffer(num_storage_entries);
   const size_t num_non_empty_entries = result_set_->permutation_.size();
   const size_t worker_count = cpu_threads();
   // TODO(tlm): Allow use of tbb after we determine how to easily encapsulate the choice
@@ -719,11 +787,8 @@ ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeCountDistinctCo
        ++i, start_entry += stride) {
     const auto end_entry = std::min(start_entry + stride, num_non_empty_entries);
     thread_pool.spawn(
-        [this](const size_t start,
-               const size_t end,
-               const Analyzer::OrderEntry& order_entry,
-               const CountDistinctDescriptor& count_distinct_descriptor,
-               std::vector<int64_t>& count_distinct_materialized_buffer) {
+        [this, &order_entry, &materialize_value, &materialized_buffer](
+            const size_t start, const size_t end) {
           for (size_t i = start; i < end; ++i) {
             const uint32_t permuted_idx = result_set_->permutation_[i];
             const auto storage_lookup_result = result_set_->findStorage(permuted_idx);
@@ -731,18 +796,264 @@ ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeCountDistinctCo
             const auto off = storage_lookup_result.fixedup_entry_idx;
             const auto value = buffer_itr_.getColumnInternal(
                 storage->buff_, off, order_entry.tle_no - 1, storage_lookup_result);
-            count_distinct_materialized_buffer[permuted_idx] =
-                count_distinct_set_size(value.i1, count_distinct_descriptor);
+            materialized_buffer[permuted_idx] = materialize_value(value.i1);
           }
         },
         start_entry,
-        end_entry,
-        std::cref(order_entry),
-        std::cref(count_distinct_descriptor),
-        std::ref(count_distinct_materialized_buffer));
+        end_entry);
   }
   thread_pool.join();
-  return count_distinct_materialized_buffer;
+  return materialized_buffer;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::vector<int64_t>
+ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeCountDistinctColumn(
+    const Analyzer::OrderEntry& order_entry) const {
+  const CountDistinctDescriptor count_distinct_descriptor =
+      result_set_->query_mem_desc_.getCountDistinctDescriptor(order_entry.tle_no - 1);
+  return materializeColumn<int64_t>(
+      order_entry, [&count_distinct_descriptor](const int64_t set_handle) {
+        return count_distinct_set_size(set_handle, count_distinct_descriptor);
+      });
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::ResultSetComparator<
+    BUFFER_ITERATOR_TYPE>::materializeApproxPercentileColumns() {
+  for (const auto& order_entry : order_entries_) {
+    if (is_approx_percentile_target(result_set_->targets_[order_entry.tle_no - 1])) {
+      approx_percentile_materialized_buffers_.emplace_back(
+          materializeApproxPercentileColumn(order_entry));
+    }
+  }
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::vector<double>
+ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeApproxPercentileColumn(
+    const Analyzer::OrderEntry& order_entry) const {
+  return materializeColumn<double>(order_entry, [](const int64_t tdigest_handle) {
+    return approx_percentile_value(tdigest_handle);
+  });
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::isFloatArgumentInput(
+    const size_t target_idx) const {
+  const auto& agg_info = result_set_->targets_[target_idx];
+  bool float_argument_input = takes_float_argument(agg_info);
+  // Need to determine if the float value has been stored as float
+  // or if it has been compacted to a different (often larger 8 bytes)
+  // in distributed case the floats are actually 4 bytes
+  // TODO the above takes_float_argument() is widely used wonder if this problem
+  // exists elsewhere
+  if (get_compact_type(agg_info).get_type() == kFLOAT) {
+    const auto is_col_lazy = !result_set_->lazy_fetch_info_.empty() &&
+                             result_set_->lazy_fetch_info_[target_idx].is_lazily_fetched;
+    if (result_set_->query_mem_desc_.getPaddedSlotWidthBytes(target_idx) ==
+        sizeof(float)) {
+      float_argument_input =
+          result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
+    }
+  }
+  return float_argument_input;
+}
+
+namespace {
+
+// Maps a signed integer to an unsigned one, in the same order.
+inline uint64_t order_preserving_int(const int64_t val) {
+  return static_cast<uint64_t>(val) ^ (uint64_t(1) << 63);
+}
+
+// Maps a double to an unsigned integer, in the same order: negative numbers get all
+// their bits flipped, positive ones only the sign bit.
+inline uint64_t order_preserving_double(double val) {
+  if (val == 0) {
+    // -0.0 and 0.0 compare equal
+    val = 0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &val, sizeof(double));
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+inline void write_big_endian(const uint64_t val, int8_t* out) {
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    out[i] = static_cast<int8_t>(val >> (8 * (sizeof(uint64_t) - 1 - i)));
+  }
+}
+
+// Positions of the normalized keys of key_bytes each in keys, in the order memcmp sorts
+// the keys.
+std::vector<uint32_t> get_normalized_key_order(const std::vector<int8_t>& keys,
+                                               const size_t key_bytes) {
+  std::vector<uint32_t> positions(keys.size() / key_bytes);
+  std::iota(positions.begin(), positions.end(), 0);
+  const auto keys_ptr = keys.data();
+  std::sort(positions.begin(),
+            positions.end(),
+            [keys_ptr, key_bytes](const uint32_t lhs, const uint32_t rhs) {
+              return std::memcmp(keys_ptr + static_cast<size_t>(lhs) * key_bytes,
+                                 keys_ptr + static_cast<size_t>(rhs) * key_bytes,
+                                 key_bytes) < 0;
+            });
+  return positions;
+}
+
+}  // namespace
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::collectStringIds(
+    const std::vector<uint32_t>& permutation,
+    const size_t entry_offset,
+    StringIds& string_ids) const {
+  string_ids.resize(order_entries_.size());
+  size_t order_entry_idx{0};
+  for (const auto& order_entry : order_entries_) {
+    CHECK_GE(order_entry.tle_no, 1);
+    const size_t target_idx = order_entry.tle_no - 1;
+    const auto entry_ti = get_compact_type(result_set_->targets_[target_idx]);
+    auto& ids = string_ids[order_entry_idx++];
+    if (!entry_ti.is_string() || entry_ti.get_compression() != kENCODING_DICT) {
+      continue;
+    }
+    const bool float_argument_input = isFloatArgumentInput(target_idx);
+    for (const auto entry_idx : permutation) {
+      const auto storage_lookup_result =
+          result_set_->findStorage(entry_offset + entry_idx);
+      const auto val =
+          buffer_itr_.getColumnInternal(storage_lookup_result.storage_ptr->buff_,
+                                        storage_lookup_result.fixedup_entry_idx,
+                                        target_idx,
+                                        storage_lookup_result);
+      if (!isNull(entry_ti, val, float_argument_input)) {
+        ids.push_back(val.i1);
+      }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  }
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+typename ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::StringRanks
+ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::rankStrings(
+    const StringIds& string_ids) const {
+  StringRanks string_ranks(order_entries_.size());
+  size_t order_entry_idx{0};
+  for (const auto& order_entry : order_entries_) {
+    const auto& ids = string_ids[order_entry_idx];
+    auto& ranks = string_ranks[order_entry_idx++];
+    if (ids.empty()) {
+      continue;
+    }
+    const auto entry_ti = get_compact_type(result_set_->targets_[order_entry.tle_no - 1]);
+    const auto string_dict_proxy = result_set_->executor_->getStringDictionaryProxy(
+        entry_ti.get_comp_param(), result_set_->row_set_mem_owner_, false);
+    std::vector<std::pair<std::string, int64_t>> strings;
+    strings.reserve(ids.size());
+    for (const auto string_id : ids) {
+      strings.emplace_back(string_dict_proxy->getString(string_id), string_id);
+    }
+    std::sort(strings.begin(), strings.end());
+    uint64_t rank{0};
+    for (size_t i = 0; i < strings.size(); ++i) {
+      if (i && strings[i].first != strings[i - 1].first) {
+        ++rank;
+      }
+      ranks.emplace(strings[i].second, rank);
+    }
+  }
+  return string_ranks;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::vector<int8_t>
+ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeNormalizedKeys(
+    const std::vector<uint32_t>& permutation) const {
+  StringIds string_ids;
+  collectStringIds(permutation, 0, string_ids);
+  return materializeNormalizedKeys(permutation, 0, rankStrings(string_ids));
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::vector<int8_t>
+ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeNormalizedKeys(
+    const std::vector<uint32_t>& permutation,
+    const size_t entry_offset,
+    const StringRanks& string_ranks) const {
+  CHECK(!use_heap_);
+  CHECK_EQ(string_ranks.size(), order_entries_.size());
+  const auto key_bytes = getNormalizedKeyBytes();
+  std::vector<int8_t> keys(permutation.size() * key_bytes, 0);
+  const auto value_at = [this, entry_offset](const uint32_t entry_idx,
+                                             const size_t target_idx) {
+    const auto storage_lookup_result = result_set_->findStorage(entry_offset + entry_idx);
+    return buffer_itr_.getColumnInternal(storage_lookup_result.storage_ptr->buff_,
+                                         storage_lookup_result.fixedup_entry_idx,
+                                         target_idx,
+                                         storage_lookup_result);
+  };
+  constexpr size_t kMinEntriesPerWorker{16384};
+  const size_t worker_count =
+      std::min(static_cast<size_t>(cpu_threads()),
+               std::max((permutation.size() + kMinEntriesPerWorker - 1) /
+                            kMinEntriesPerWorker,
+                        size_t(1)));
+  const auto stride = (permutation.size() + worker_count - 1) / worker_count;
+  size_t key_off{0};
+  size_t order_entry_idx{0};
+  for (const auto& order_entry : order_entries_) {
+    CHECK_GE(order_entry.tle_no, 1);
+    const size_t target_idx = order_entry.tle_no - 1;
+    const auto entry_ti = get_compact_type(result_set_->targets_[target_idx]);
+    const bool float_argument_input = isFloatArgumentInput(target_idx);
+    const bool is_dict_string =
+        entry_ti.is_string() && entry_ti.get_compression() == kENCODING_DICT;
+    const auto& ranks = string_ranks[order_entry_idx++];
+    std::vector<std::future<void>> key_futures;
+    for (size_t start = 0; start < permutation.size(); start += stride) {
+      const auto end = std::min(start + stride, permutation.size());
+      key_futures.emplace_back(std::async(std::launch::async, [&, start, end, key_off] {
+        for (size_t i = start; i < end; ++i) {
+          const auto val = value_at(permutation[i], target_idx);
+          auto key_ptr = &keys[i * key_bytes + key_off];
+          const bool is_null = isNull(entry_ti, val, float_argument_input);
+          // The value bytes of nulls stay zero
+          key_ptr[0] = is_null == order_entry.nulls_first ? 0 : 1;
+          if (is_null) {
+            continue;
+          }
+          CHECK(val.isInt());
+          uint64_t normalized_val{0};
+          if (is_dict_string) {
+            const auto rank_it = ranks.find(val.i1);
+            CHECK(rank_it != ranks.end());
+            normalized_val = rank_it->second;
+          } else if (entry_ti.is_fp()) {
+            normalized_val = order_preserving_double(
+                float_argument_input
+                    ? *reinterpret_cast<const float*>(may_alias_ptr(&val.i1))
+                    : *reinterpret_cast<const double*>(may_alias_ptr(&val.i1)));
+          } else {
+            normalized_val = order_preserving_int(val.i1);
+          }
+          write_big_endian(order_entry.is_desc ? ~normalized_val : normalized_val,
+                           key_ptr + 1);
+        }
+      }));
+    }
+    for (auto& key_future : key_futures) {
+      key_future.wait();
+    }
+    for (auto& key_future : key_futures) {
+      key_future.get();
+    }
+    key_off += 9;
+  }
+  return keys;
 }
 
 template <typename BUFFER_ITERATOR_TYPE>
@@ -758,27 +1069,13 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
   const auto fixedup_lhs = lhs_storage_lookup_result.fixedup_entry_idx;
   const auto fixedup_rhs = rhs_storage_lookup_result.fixedup_entry_idx;
   size_t materialized_count_distinct_buffer_idx{0};
+  size_t materialized_approx_percentile_buffer_idx{0};
 
   for (const auto& order_entry : order_entries_) {
     CHECK_GE(order_entry.tle_no, 1);
     const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
     const auto entry_ti = get_compact_type(agg_info);
-    bool float_argument_input = takes_float_argument(agg_info);
-    // Need to determine if the float value has been stored as float
-    // or if it has been compacted to a different (often larger 8 bytes)
-    // in distributed case the floats are actually 4 bytes
-    // TODO the above takes_float_argument() is widely used wonder if this problem
-    // exists elsewhere
-    if (entry_ti.get_type() == kFLOAT) {
-      const auto is_col_lazy =
-          !result_set_->lazy_fetch_info_.empty() &&
-          result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
-      if (result_set_->query_mem_desc_.getPaddedSlotWidthBytes(order_entry.tle_no - 1) ==
-          sizeof(float)) {
-        float_argument_input =
-            result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
-      }
-    }
+    const bool float_argument_input = isFloatArgumentInput(order_entry.tle_no - 1);
 
     const bool use_desc_cmp = use_heap_ ? !order_entry.is_desc : order_entry.is_desc;
 
@@ -796,6 +1093,32 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
       return use_desc_cmp ? lhs_sz > rhs_sz : lhs_sz < rhs_sz;
     }
 
+    if (UNLIKELY(is_approx_percentile_target(agg_info))) {
+      CHECK_LT(materialized_approx_percentile_buffer_idx,
+               approx_percentile_materialized_buffers_.size());
+      const auto& approx_percentile_materialized_buffer =
+          approx_percentile_materialized_buffers_
+              [materialized_approx_percentile_buffer_idx];
+      const auto lhs_value = approx_percentile_materialized_buffer[lhs];
+      const auto rhs_value = approx_percentile_materialized_buffer[rhs];
+      ++materialized_approx_percentile_buffer_idx;
+      const bool lhs_is_null = lhs_value == NULL_DOUBLE;
+      const bool rhs_is_null = rhs_value == NULL_DOUBLE;
+      if (lhs_is_null && rhs_is_null) {
+        continue;
+      }
+      if (lhs_is_null) {
+        return use_heap_ ? !order_entry.nulls_first : order_entry.nulls_first;
+      }
+      if (rhs_is_null) {
+        return use_heap_ ? order_entry.nulls_first : !order_entry.nulls_first;
+      }
+      if (lhs_value == rhs_value) {
+        continue;
+      }
+      return use_desc_cmp ? lhs_value > rhs_value : lhs_value < rhs_value;
+    }
+
     const auto lhs_v = buffer_itr_.getColumnInternal(lhs_storage->buff_,
                                                      fixedup_lhs,
                                                      order_entry.tle_no - 1,
@@ -807,7 +1130,7 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
 
     if (UNLIKELY(isNull(entry_ti, lhs_v, float_argument_input) &&
                  isNull(entry_ti, rhs_v, float_argument_input))) {
-      return false;
+      continue;
     }
     if (UNLIKELY(isNull(entry_ti, lhs_v, float_argument_input) &&
                  !isNull(entry_ti, rhs_v, float_argument_input))) {
@@ -897,6 +1220,348 @@ void ResultSet::sortPermutation(
   std::sort(permutation_.begin(), permutation_.end(), compare);
 }
 
+bool ResultSet::canUseExternalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                                   const size_t top_n) const {
+  if (!g_enable_external_sort || top_n || !g_external_sort_run_rows ||
+      query_mem_desc_.getEntryCount() <= g_external_sort_run_rows) {
+    return false;
+  }
+  // The rows are spilled as laid out in the storage and decoded from the first storage
+  // once merged, which doesn't work for the targets decoded through their entry index
+  // or through the inputs of their own storage.
+  if (query_mem_desc_.didOutputColumnar() || separate_varlen_storage_valid_) {
+    return false;
+  }
+  if (!appended_storage_.empty() &&
+      std::any_of(lazy_fetch_info_.begin(),
+                  lazy_fetch_info_.end(),
+                  [](const ColumnLazyFetchInfo& col_lazy_fetch) {
+                    return col_lazy_fetch.is_lazily_fetched;
+                  })) {
+    return false;
+  }
+  // The runs are merged on the normalized keys of their rows
+  return canUseNormalizedKeySort(order_entries);
+}
+
+void ResultSet::externalSort(const std::list<Analyzer::OrderEntry>& order_entries) {
+  auto timer = DEBUG_TIMER(__func__);
+  // Bytes of every run read at a time by the merge
+  constexpr size_t kMergeBlockBytes{1 << 20};
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  const auto run_rows =
+      std::min(g_external_sort_run_rows,
+               static_cast<size_t>(std::numeric_limits<uint32_t>::max()));
+  const auto run_count = (entry_count + run_rows - 1) / run_rows;
+  createComparator(order_entries, false);
+  CHECK(row_wise_comparator_);
+  const auto& comparator = *row_wise_comparator_;
+  const auto key_bytes = comparator.getNormalizedKeyBytes();
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  for (const auto& storage : appended_storage_) {
+    CHECK_EQ(row_bytes, get_row_bytes(storage->query_mem_desc_));
+  }
+  const auto record_bytes = key_bytes + row_bytes;
+  auto merger =
+      std::make_unique<SortedRunMerger>(key_bytes, record_bytes, kMergeBlockBytes);
+
+  // Non empty entries of a run, indexed from the first entry of the run
+  const auto get_run_entries = [this, entry_count, run_rows](const size_t run_idx) {
+    const auto run_start = run_idx * run_rows;
+    const auto run_end = std::min(run_start + run_rows, entry_count);
+    std::vector<uint32_t> run_entries;
+    for (size_t entry_idx = run_start; entry_idx < run_end; ++entry_idx) {
+      const auto storage_lookup_result = findStorage(entry_idx);
+      const auto storage = storage_lookup_result.storage_ptr;
+      if (!storage->isEmptyEntry(storage_lookup_result.fixedup_entry_idx)) {
+        run_entries.push_back(entry_idx - run_start);
+      }
+    }
+    return run_entries;
+  };
+  const auto run_thread_count =
+      std::min({static_cast<size_t>(cpu_threads()),
+                run_count,
+                std::max(g_external_sort_max_concurrent_runs, size_t(1))});
+  const auto for_each_run = [run_count, run_thread_count](const auto& process_run) {
+    std::atomic<size_t> next_run_idx{0};
+    std::vector<std::future<void>> run_futures;
+    for (size_t i = 0; i < run_thread_count; ++i) {
+      run_futures.emplace_back(std::async(std::launch::async, [&] {
+        for (size_t run_idx = next_run_idx++; run_idx < run_count;
+             run_idx = next_run_idx++) {
+          process_run(run_idx);
+        }
+      }));
+    }
+    for (auto& run_future : run_futures) {
+      run_future.wait();
+    }
+    for (auto& run_future : run_futures) {
+      run_future.get();
+    }
+  };
+
+  // Dictionary encoded strings are ranked among all the rows, so that the normalized
+  // keys of different runs compare.
+  ResultSetComparator<RowWiseTargetAccessor>::StringIds string_ids(order_entries.size());
+  if (std::any_of(order_entries.begin(),
+                  order_entries.end(),
+                  [this](const Analyzer::OrderEntry& order_entry) {
+                    const auto ti = get_compact_type(targets_[order_entry.tle_no - 1]);
+                    return ti.is_string() && ti.get_compression() == kENCODING_DICT;
+                  })) {
+    std::mutex string_ids_mutex;
+    for_each_run([&](const size_t run_idx) {
+      ResultSetComparator<RowWiseTargetAccessor>::StringIds run_string_ids;
+      comparator.collectStringIds(
+          get_run_entries(run_idx), run_idx * run_rows, run_string_ids);
+      std::lock_guard<std::mutex> string_ids_lock(string_ids_mutex);
+      for (size_t i = 0; i < string_ids.size(); ++i) {
+        auto& ids = string_ids[i];
+        const auto ids_size = ids.size();
+        ids.insert(ids.end(), run_string_ids[i].begin(), run_string_ids[i].end());
+        std::inplace_merge(ids.begin(), ids.begin() + ids_size, ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      }
+    });
+  }
+  const auto string_ranks = comparator.rankStrings(string_ids);
+
+  // Run generation: the rows of a run are sorted on their normalized keys and spilled
+  // with them
+  for_each_run([&](const size_t run_idx) {
+    const auto run_start = run_idx * run_rows;
+    const auto run_entries = get_run_entries(run_idx);
+    const auto keys =
+        comparator.materializeNormalizedKeys(run_entries, run_start, string_ranks);
+    std::vector<int8_t> records(run_entries.size() * record_bytes);
+    auto record = records.data();
+    for (const auto position : get_normalized_key_order(keys, key_bytes)) {
+      std::memcpy(record, &keys[static_cast<size_t>(position) * key_bytes], key_bytes);
+      const auto storage_lookup_result = findStorage(run_start + run_entries[position]);
+      const auto storage = storage_lookup_result.storage_ptr;
+      std::memcpy(record + key_bytes,
+                  row_ptr_rowwise(storage->buff_,
+                                  storage->query_mem_desc_,
+                                  storage_lookup_result.fixedup_entry_idx),
+                  row_bytes);
+      record += record_bytes;
+    }
+    merger->addRun(records.data(), run_entries.size());
+  });
+  VLOG(1) << "Sorted " << merger->getRecordCount() << " rows in "
+          << merger->getRunCount() << " runs, spilled " << merger->getSpilledBytes()
+          << " bytes.";
+
+  // The rows only live in the runs from now on. The buffers provided by the memory owner
+  // of the query can't be freed before it goes away, but their pages can.
+  const auto target_init_vals = storage_->target_init_vals_;
+  const auto release_storage = [this](const ResultSetStorage& storage) {
+    const auto buff = storage.getUnderlyingBuffer();
+    if (storage.buff_is_provided_) {
+      omnisci::release_pages(buff,
+                             storage.query_mem_desc_.getBufferSizeBytes(device_type_));
+    } else {
+      free(buff);
+    }
+  };
+  release_storage(*storage_);
+  for (const auto& storage : appended_storage_) {
+    release_storage(*storage);
+  }
+  appended_storage_.clear();
+  row_wise_comparator_.reset();
+  query_mem_desc_.setEntryCount(merger->getRecordCount());
+
+  auto sorted_runs = std::make_unique<SortedRuns>();
+  sorted_runs->merger = std::move(merger);
+  sorted_runs->key_bytes = key_bytes;
+  sorted_runs->row_bytes = row_bytes;
+  auto row_query_mem_desc = query_mem_desc_;
+  row_query_mem_desc.setEntryCount(1);
+  sorted_runs->row.resize(row_query_mem_desc.getBufferSizeBytes(device_type_));
+  storage_.reset(
+      new ResultSetStorage(targets_, row_query_mem_desc, sorted_runs->row.data(), true));
+  storage_->target_init_vals_ = target_init_vals;
+  sorted_runs_ = std::move(sorted_runs);
+}
+
+std::vector<TargetValue> ResultSet::getNextMergedRow(
+    const bool translate_strings,
+    const bool decimal_to_double) const {
+  CHECK(sorted_runs_);
+  auto& sorted_runs = *sorted_runs_;
+  const int8_t* record{nullptr};
+  do {
+    if (keep_first_ && fetched_so_far_ >= drop_first_ + keep_first_) {
+      return {};
+    }
+    record = sorted_runs.merger->next();
+    if (!record) {
+      return {};
+    }
+    ++fetched_so_far_;
+  } while (drop_first_ && fetched_so_far_ <= drop_first_);
+
+  std::memcpy(
+      sorted_runs.row.data(), record + sorted_runs.key_bytes, sorted_runs.row_bytes);
+  auto row = getRowAt(0, translate_strings, decimal_to_double, false);
+  CHECK(!row.empty());
+  return row;
+}
+
+void ResultSet::materializeExternalSort() const {
+  if (!sorted_runs_) {
+    return;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  const auto row_count = query_mem_desc_.getEntryCount();
+  VLOG(1) << "Loading " << row_count << " externally sorted rows into host memory";
+  CHECK(row_set_mem_owner_);
+  auto buff =
+      row_set_mem_owner_->allocate(query_mem_desc_.getBufferSizeBytes(device_type_));
+  auto& merger = *sorted_runs_->merger;
+  merger.reset();
+  auto row_ptr = buff;
+  while (const auto record = merger.next()) {
+    std::memcpy(row_ptr, record + sorted_runs_->key_bytes, sorted_runs_->row_bytes);
+    row_ptr += sorted_runs_->row_bytes;
+  }
+  CHECK_EQ(row_count * sorted_runs_->row_bytes, static_cast<size_t>(row_ptr - buff));
+  const auto target_init_vals = storage_->target_init_vals_;
+  storage_.reset(new ResultSetStorage(targets_, query_mem_desc_, buff, true));
+  storage_->target_init_vals_ = target_init_vals;
+  sorted_runs_.reset();
+  // Every entry of the storage is a row, getNextRow carries on from the same row
+  crt_row_buff_idx_ = fetched_so_far_;
+}
+
+void ResultSet::setSpilledRows(std::unique_ptr<SpillManager> spill_manager,
+                               const size_t file_id,
+                               const std::vector<int64_t>& target_init_vals) {
+  CHECK(!storage_);
+  CHECK(!query_mem_desc_.didOutputColumnar());
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  const auto row_count = query_mem_desc_.getEntryCount();
+  CHECK_GT(row_count, size_t(0));
+  CHECK_EQ(row_count * row_bytes, spill_manager->getFileSize(file_id));
+  auto spilled_rows = std::make_unique<SpilledRows>();
+  spilled_rows->spill_manager = std::move(spill_manager);
+  spilled_rows->file_id = file_id;
+  spilled_rows->row_bytes = row_bytes;
+  spilled_rows->block_rows =
+      std::min(row_count, std::max(g_spilled_rows_block_bytes / row_bytes, size_t(1)));
+  spilled_rows->block_start = row_count;
+  auto block_query_mem_desc = query_mem_desc_;
+  block_query_mem_desc.setEntryCount(spilled_rows->block_rows);
+  spilled_rows->block.resize(block_query_mem_desc.getBufferSizeBytes(device_type_));
+  storage_.reset(new ResultSetStorage(
+      targets_, block_query_mem_desc, spilled_rows->block.data(), true));
+  storage_->target_init_vals_ = target_init_vals;
+  spilled_rows_ = std::move(spilled_rows);
+}
+
+std::vector<TargetValue> ResultSet::getNextSpilledRow(
+    const bool translate_strings,
+    const bool decimal_to_double) const {
+  CHECK(spilled_rows_);
+  auto& spilled_rows = *spilled_rows_;
+  const auto row_count = query_mem_desc_.getEntryCount();
+  // Every spilled row is a group, the dropped ones don't need to be read
+  fetched_so_far_ = std::max(fetched_so_far_, std::min(drop_first_, row_count));
+  if ((keep_first_ && fetched_so_far_ >= drop_first_ + keep_first_) ||
+      fetched_so_far_ >= row_count) {
+    return {};
+  }
+  const auto block_start =
+      fetched_so_far_ - fetched_so_far_ % spilled_rows.block_rows;
+  if (block_start != spilled_rows.block_start) {
+    const auto block_rows = std::min(spilled_rows.block_rows, row_count - block_start);
+    spilled_rows.spill_manager->read(spilled_rows.file_id,
+                                     block_start * spilled_rows.row_bytes,
+                                     spilled_rows.block.data(),
+                                     block_rows * spilled_rows.row_bytes);
+    spilled_rows.block_start = block_start;
+  }
+  const auto entry_idx = fetched_so_far_ - block_start;
+  ++fetched_so_far_;
+  auto row = getRowAt(entry_idx, translate_strings, decimal_to_double, false);
+  CHECK(!row.empty());
+  return row;
+}
+
+void ResultSet::materializeSpilledRows() const {
+  if (!spilled_rows_) {
+    return;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  const auto row_count = query_mem_desc_.getEntryCount();
+  VLOG(1) << "Loading " << row_count << " spilled rows into host memory";
+  CHECK(row_set_mem_owner_);
+  auto buff =
+      row_set_mem_owner_->allocate(query_mem_desc_.getBufferSizeBytes(device_type_));
+  spilled_rows_->spill_manager->read(
+      spilled_rows_->file_id, 0, buff, row_count * spilled_rows_->row_bytes);
+  const auto target_init_vals = storage_->target_init_vals_;
+  storage_.reset(new ResultSetStorage(targets_, query_mem_desc_, buff, true));
+  storage_->target_init_vals_ = target_init_vals;
+  spilled_rows_.reset();
+  // Every entry of the storage is a row, getNextRow carries on from the same row
+  crt_row_buff_idx_ = fetched_so_far_;
+}
+
+void ResultSet::materializeRows() const {
+  materializeSpilledRows();
+  materializeExternalSort();
+}
+
+bool ResultSet::canUseNormalizedKeySort(
+    const std::list<Analyzer::OrderEntry>& order_entries) const {
+  if (!g_enable_normalized_sort_keys) {
+    return false;
+  }
+  for (const auto& order_entry : order_entries) {
+    const auto& target = targets_[order_entry.tle_no - 1];
+    if (is_distinct_target(target) || is_approx_percentile_target(target) ||
+        (target.is_agg && target.agg_kind == kAVG)) {
+      return false;
+    }
+    const auto ti = get_compact_type(target);
+    if (ti.is_string()) {
+      if (ti.get_compression() != kENCODING_DICT || !executor_) {
+        return false;
+      }
+    } else if (!ti.is_integer() && !ti.is_decimal() && !ti.is_fp() &&
+               !ti.is_boolean() && !ti.is_time()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ResultSet::normalizedKeySort(std::vector<uint32_t>& permutation) const {
+  auto timer = DEBUG_TIMER(__func__);
+  size_t key_bytes{0};
+  std::vector<int8_t> keys;
+  if (query_mem_desc_.didOutputColumnar()) {
+    CHECK(column_wise_comparator_);
+    key_bytes = column_wise_comparator_->getNormalizedKeyBytes();
+    keys = column_wise_comparator_->materializeNormalizedKeys(permutation);
+  } else {
+    CHECK(row_wise_comparator_);
+    key_bytes = row_wise_comparator_->getNormalizedKeyBytes();
+    keys = row_wise_comparator_->materializeNormalizedKeys(permutation);
+  }
+  const auto positions = get_normalized_key_order(keys, key_bytes);
+  std::vector<uint32_t> sorted_permutation;
+  sorted_permutation.reserve(permutation.size());
+  for (const auto position : positions) {
+    sorted_permutation.push_back(permutation[position]);
+  }
+  permutation.swap(sorted_permutation);
+}
+
 void ResultSet::radixSortOnGpu(
     const std::list<Analyzer::OrderEntry>& order_entries) const {
   auto timer = DEBUG_TIMER(__func__);
@@ -1016,6 +1681,7 @@ bool use_parallel_algorithms(const ResultSet& rows) {
  * becomes equivalent to the row-wise columnarization.
  */
 bool ResultSet::isDirectColumnarConversionPossible() const {
+  materializeRows();
   if (!g_enable_direct_columnarization) {
     return false;
   } else if (query_mem_desc_.didOutputColumnar()) {
@@ -1068,7 +1734,8 @@ std::tuple<std::vector<bool>, size_t> ResultSet::getSingleSlotTargetBitmap() con
  *
  * The final goal is to remove the need for such selection, but at the moment for any
  * target that doesn't qualify for direct columnarization, we use the traditional
- * result set's iteration to handle it (e.g., count distinct, approximate count distinct)
+ * result set's iteration to handle it (e.g., count distinct, approximate count distinct,
+ * approximate percentile)
  */
 std::tuple<std::vector<bool>, size_t> ResultSet::getSupportedSingleSlotTargetBitmap()
     const {
@@ -1078,7 +1745,7 @@ std::tuple<std::vector<bool>, size_t> ResultSet::getSupportedSingleSlotTargetBit
   for (size_t target_idx = 0; target_idx < single_slot_targets.size(); target_idx++) {
     const auto& target = targets_[target_idx];
     if (single_slot_targets[target_idx] &&
-        (is_distinct_target(target) ||
+        (is_distinct_target(target) || is_approx_percentile_target(target) ||
          (target.is_agg && target.agg_kind == kSAMPLE && target.sql_type == kFLOAT))) {
       single_slot_targets[target_idx] = false;
       num_single_slot_targets--;
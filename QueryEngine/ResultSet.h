@@ -33,6 +33,8 @@
 #include <atomic>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <unordered_map>
 
 /*
  * Stores the underlying buffer and the meta-data for a result set. The buffer
@@ -218,6 +220,7 @@ class ResultSetStorage {
 
   friend class ResultSet;
   friend class ResultSetManager;
+  friend class BaselineHashPartitions;
 };
 
 namespace Analyzer {
@@ -229,6 +232,7 @@ struct OrderEntry;
 }  // namespace Analyzer
 
 class Executor;
+class SpillManager;
 
 struct ColumnLazyFetchInfo {
   const bool is_lazily_fetched;
@@ -430,19 +434,42 @@ class ResultSet {
   size_t getNDVEstimator() const;
 
   struct QueryExecutionTimings {
-    // all in ms
+    // times in ms
     int64_t executor_queue_time{0};
     int64_t render_time{0};
     int64_t compilation_queue_time{0};
     int64_t kernel_queue_time{0};
+    // time the kernel workers spent idle, and the kernels which ran a fragment morsel
+    int64_t kernel_idle_time{0};
+    size_t morsel_kernels{0};
+    // chunks loaded ahead of the kernels, and how many the kernels found loaded or not
+    size_t prefetched_chunks{0};
+    size_t prefetch_hits{0};
+    size_t prefetch_misses{0};
+    // outer fragments skipped because they have none of the keys of an inner join
+    size_t join_key_skipped_fragments{0};
   };
 
   void setQueueTime(const int64_t queue_time);
   void setKernelQueueTime(const int64_t kernel_queue_time);
   void addCompilationQueueTime(const int64_t compilation_queue_time);
+  void setKernelSchedulingStats(const int64_t kernel_idle_time,
+                                const size_t morsel_kernels);
+  void setChunkPrefetchStats(const size_t prefetched_chunks,
+                             const size_t prefetch_hits,
+                             const size_t prefetch_misses);
+  void setJoinKeySkippedFragments(const size_t join_key_skipped_fragments);
 
   int64_t getQueueTime() const;
   int64_t getRenderTime() const;
+  int64_t getKernelIdleTime() const { return timings_.kernel_idle_time; }
+  size_t getMorselKernels() const { return timings_.morsel_kernels; }
+  size_t getPrefetchedChunks() const { return timings_.prefetched_chunks; }
+  size_t getPrefetchHits() const { return timings_.prefetch_hits; }
+  size_t getPrefetchMisses() const { return timings_.prefetch_misses; }
+  size_t getJoinKeySkippedFragments() const {
+    return timings_.join_key_skipped_fragments;
+  }
 
   void moveToBegin() const;
 
@@ -469,6 +496,13 @@ class ResultSet {
 
   void initializeStorage() const;
 
+  // Backs the result with rows spilled to a file of the spill manager, as many as the
+  // entry count of the query memory descriptor. getNextRow loads them into the storage a
+  // block at a time, the first accessor which needs all of them loads them all.
+  void setSpilledRows(std::unique_ptr<SpillManager> spill_manager,
+                      const size_t file_id,
+                      const std::vector<int64_t>& target_init_vals);
+
   void holdChunks(const std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks) {
     chunks_ = chunks;
   }
@@ -484,7 +518,10 @@ class ResultSet {
   }
 
   const std::vector<uint32_t>& getPermutationBuffer() const;
-  const bool isPermutationBufferEmpty() const { return permutation_.empty(); };
+  const bool isPermutationBufferEmpty() const {
+    materializeRows();
+    return permutation_.empty();
+  };
 
   void serialize(TSerializedRows& serialized_rows) const;
 
@@ -596,6 +633,30 @@ class ResultSet {
 
   void radixSortOnCpu(const std::list<Analyzer::OrderEntry>& order_entries) const;
 
+  bool canUseExternalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                          const size_t top_n) const;
+
+  // Sorts runs of g_external_sort_run_rows entries of the storage on their normalized
+  // keys, at most g_external_sort_max_concurrent_runs at a time, and spills the rows of
+  // every run with their keys. The storage is released once all the runs are spilled,
+  // the runs are merged as getNextRow streams the rows from them.
+  void externalSort(const std::list<Analyzer::OrderEntry>& order_entries);
+
+  std::vector<TargetValue> getNextMergedRow(const bool translate_strings,
+                                            const bool decimal_to_double) const;
+
+  // Loads all the rows of the external sort, if any, into the storage in sort order.
+  void materializeExternalSort() const;
+
+  std::vector<TargetValue> getNextSpilledRow(const bool translate_strings,
+                                             const bool decimal_to_double) const;
+
+  // Loads all the spilled rows, if any, into the storage.
+  void materializeSpilledRows() const;
+
+  // Makes the rows and their order available to the accessors which aren't sequential.
+  void materializeRows() const;
+
   static bool isNull(const SQLTypeInfo& ti,
                      const InternalTargetValue& val,
                      const bool float_argument_input);
@@ -754,21 +815,67 @@ class ResultSet {
         , result_set_(result_set)
         , buffer_itr_(result_set) {
       materializeCountDistinctColumns();
+      materializeApproxPercentileColumns();
     }
 
     void materializeCountDistinctColumns();
+    void materializeApproxPercentileColumns();
 
+    // Computes materialize_value() of the handle the order entry holds for every entry
+    // of the permutation in parallel, the results are indexed by entry.
+    template <typename T, typename F>
+    std::vector<T> materializeColumn(const Analyzer::OrderEntry& order_entry,
+                                     const F& materialize_value) const;
     std::vector<int64_t> materializeCountDistinctColumn(
         const Analyzer::OrderEntry& order_entry) const;
+    std::vector<double> materializeApproxPercentileColumn(
+        const Analyzer::OrderEntry& order_entry) const;
 
     bool operator()(const uint32_t lhs, const uint32_t rhs) const;
 
+    // Whether the target is a float stored in a 4 bytes slot.
+    bool isFloatArgumentInput(const size_t target_idx) const;
+
+    // Number of bytes of a normalized key, a null flag and 8 value bytes per order entry.
+    size_t getNormalizedKeyBytes() const { return order_entries_.size() * 9; }
+
+    // Sorted distinct ids of the dictionary encoded strings of every order entry, empty
+    // for the other order entries.
+    using StringIds = std::vector<std::vector<int64_t>>;
+    // Rank of the string of every id per order entry, ids of equal strings get the same
+    // rank.
+    using StringRanks = std::vector<std::unordered_map<int64_t, uint64_t>>;
+
+    // Adds the string ids of the entries entry_offset + permutation[i] to string_ids.
+    void collectStringIds(const std::vector<uint32_t>& permutation,
+                          const size_t entry_offset,
+                          StringIds& string_ids) const;
+
+    StringRanks rankStrings(const StringIds& string_ids) const;
+
+    // Encodes the order entries of every entry of the permutation into a normalized key,
+    // such that memcmp orders the keys the way operator() orders the entries, except
+    // that rows which are both null on an order entry get ordered by the next ones.
+    // Dictionary encoded strings are encoded as the rank of their string among those
+    // of the permutation. The key of permutation[i] starts at
+    // i * getNormalizedKeyBytes().
+    std::vector<int8_t> materializeNormalizedKeys(
+        const std::vector<uint32_t>& permutation) const;
+
+    // Same for the entries entry_offset + permutation[i], with dictionary encoded
+    // strings ranked beforehand, so that keys of different calls compare.
+    std::vector<int8_t> materializeNormalizedKeys(
+        const std::vector<uint32_t>& permutation,
+        const size_t entry_offset,
+        const StringRanks& string_ranks) const;
+
     // TODO(adb): make order_entries_ a pointer
     const std::list<Analyzer::OrderEntry> order_entries_;
     const bool use_heap_;
     const ResultSet* result_set_;
     const BufferIteratorType buffer_itr_;
     std::vector<std::vector<int64_t>> count_distinct_materialized_buffers_;
+    std::vector<std::vector<double>> approx_percentile_materialized_buffers_;
   };
 
   std::function<bool(const uint32_t, const uint32_t)> createComparator(
@@ -798,6 +905,16 @@ class ResultSet {
 
   void sortPermutation(const std::function<bool(const uint32_t, const uint32_t)> compare);
 
+  // Order entries on integers, decimals, times, booleans, floating point numbers and
+  // dictionary encoded strings can be sorted through normalized keys.
+  bool canUseNormalizedKeySort(
+      const std::list<Analyzer::OrderEntry>& order_entries) const;
+
+  // Sorts the permutation on the normalized keys of the last comparator createComparator
+  // created, compared with memcmp, instead of decoding the order entries of both rows for
+  // every comparison.
+  void normalizedKeySort(std::vector<uint32_t>& permutation) const;
+
   std::vector<uint32_t> initPermutationBuffer(const size_t start, const size_t step);
 
   void parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
@@ -845,6 +962,10 @@ class ResultSet {
   size_t keep_first_;
   std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
   std::vector<uint32_t> permutation_;
+  struct SortedRuns;
+  mutable std::unique_ptr<SortedRuns> sorted_runs_;
+  struct SpilledRows;
+  mutable std::unique_ptr<SpilledRows> spilled_rows_;
 
   QueryExecutionTimings timings_;
   const Executor* executor_;  // TODO(alex): remove
@@ -921,9 +1042,64 @@ class ResultSetManager {
   void rewriteVarlenAggregates(ResultSet*);
 
  private:
+  ResultSet* reduceBaselinePartitioned(std::vector<ResultSet*>&);
+
+  void reduceTree(std::vector<ResultSet*>&, const ReductionCode&);
+
   std::shared_ptr<ResultSet> rs_;
 };
 
+// Shared destination of the pre-aggregation buffers of the CPU kernels of a row-wise
+// baseline hash group by. The kernels run with small buffers and flush their groups here
+// whenever they run out of slots, then resume the scan from the row which didn't fit, so
+// the memory of the group by grows with the number of groups instead of the number of
+// kernels times the number of groups. The key space is split in partitions by a hash of
+// the key, each with a hash table of its own which grows as groups get added. Kernels
+// flushing at the same time only wait on each other for the partitions they share.
+class BaselineHashPartitions {
+ public:
+  BaselineHashPartitions(const size_t partition_count);
+
+  ~BaselineHashPartitions();
+
+  // Whether the kernels of the execution unit can pre-aggregate into small buffers and
+  // flush them here when they run out of slots.
+  static bool canPreaggregate(const RelAlgExecutionUnit& ra_exe_unit,
+                              const QueryMemoryDescriptor& query_mem_desc,
+                              const ExecutorDeviceType device_type);
+
+  // Reduces the groups of a pre-aggregation buffer into the partitions, the buffer can be
+  // re-initialized and reused afterwards. Thread safe.
+  void flush(const ResultSetStorage& storage);
+
+  size_t getGroupCount() const;
+
+  // Moves the groups of all the partitions to the storage of a single result set. Returns
+  // nullptr if nothing has been flushed.
+  std::shared_ptr<ResultSet> finalize(std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                                      const Executor* executor);
+
+ private:
+  struct Partition;
+
+  void init(const ResultSetStorage& storage);
+
+  void initializeBuffer(int8_t* buff, const QueryMemoryDescriptor& query_mem_desc) const;
+
+  void reducePartition(Partition& partition, int8_t* rows, const size_t row_count);
+
+  void growPartition(Partition& partition);
+
+  const size_t partition_count_;
+  std::once_flag init_flag_;
+  std::vector<TargetInfo> targets_;
+  QueryMemoryDescriptor query_mem_desc_;
+  std::vector<int64_t> target_init_vals_;
+  std::unique_ptr<ReductionCode> reduction_code_;
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  std::atomic<size_t> flush_count_;
+};
+
 class RowSortException : public std::runtime_error {
  public:
   RowSortException(const std::string& cause) : std::runtime_error(cause) {}
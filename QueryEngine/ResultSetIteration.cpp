@@ -33,6 +33,7 @@
 #include "Shared/SqlTypesLayout.h"
 #include "Shared/likely.h"
 #include "Shared/sqltypes.h"
+#include "TDigest.h"
 #include "TypePunning.h"
 
 #include <memory>
@@ -315,6 +316,12 @@ std::vector<TargetValue> ResultSet::getNextRowUnlocked(
 
 std::vector<TargetValue> ResultSet::getNextRowImpl(const bool translate_strings,
                                                    const bool decimal_to_double) const {
+  if (sorted_runs_) {
+    return getNextMergedRow(translate_strings, decimal_to_double);
+  }
+  if (spilled_rows_) {
+    return getNextSpilledRow(translate_strings, decimal_to_double);
+  }
   size_t entry_buff_idx = 0;
   do {
     if (keep_first_ && fetched_so_far_ >= drop_first_ + keep_first_) {
@@ -751,6 +758,7 @@ size_t ResultSet::advanceCursorToNextEntry() const {
 }
 
 size_t ResultSet::entryCount() const {
+  materializeRows();
   return permutation_.empty() ? query_mem_desc_.getEntryCount() : permutation_.size();
 }
 
@@ -778,6 +786,17 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
   CHECK(type_info.is_integer() || type_info.is_decimal() || type_info.is_time() ||
         type_info.is_timeinterval() || type_info.is_boolean() || type_info.is_string() ||
         type_info.is_array());
+  if (type_info.get_compression() == kENCODING_RL) {
+    return run_length_int_decode_noinline(byte_stream, type_info.get_size(), pos);
+  }
+  if (type_info.get_compression() == kENCODING_DIFF) {
+    return diff_fixed_width_int_decode_noinline(
+        byte_stream,
+        type_info.get_comp_param() / 8,
+        inline_fixed_encoding_null_val(type_info),
+        inline_int_null_val(get_logical_type_info(type_info)),
+        pos);
+  }
   size_t type_bitwidth = get_bit_width(type_info);
   if (type_info.get_compression() == kENCODING_FIXED) {
     type_bitwidth = type_info.get_comp_param();
@@ -1840,6 +1859,9 @@ TargetValue ResultSet::makeTargetValue(const int8_t* ptr,
       }
     }
   }
+  if (is_approx_percentile_target(target_info)) {
+    return ScalarTargetValue(approx_percentile_value(ival));
+  }
   if (chosen_type.is_fp()) {
     switch (actual_compact_sz) {
       case 8: {
@@ -24,10 +24,12 @@
 
 #include "DynamicWatchdog.h"
 #include "Execute.h"
+#include "MurmurHash.h"
 #include "ResultSet.h"
 #include "ResultSetReductionInterpreter.h"
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
+#include "TDigest.h"
 #include "Shared/SqlTypesLayout.h"
 
 #include "Shared/likely.h"
@@ -40,6 +42,12 @@
 #include <numeric>
 
 extern bool g_enable_dynamic_watchdog;
+extern bool g_bigint_count;
+
+bool g_enable_partitioned_baseline_reduction{true};
+bool g_enable_tree_reduction{true};
+bool g_enable_baseline_preaggregation{false};
+size_t g_baseline_preaggregation_entry_count{1 << 16};
 
 namespace {
 
@@ -47,6 +55,34 @@ bool use_multithreaded_reduction(const size_t entry_count) {
   return entry_count > 100000;
 }
 
+// Runs func(task_idx) for every task index in [0, task_count) on its own thread.
+template <typename F>
+void run_in_parallel(const size_t task_count, F func) {
+  std::vector<std::future<void>> threads;
+  for (size_t task_idx = 0; task_idx < task_count; ++task_idx) {
+    threads.emplace_back(
+        std::async(std::launch::async, with_cpu_thread_budget(func), task_idx));
+  }
+  for (auto& thread : threads) {
+    thread.wait();
+  }
+  for (auto& thread : threads) {
+    thread.get();
+  }
+}
+
+std::pair<size_t, size_t> get_chunk_range(const size_t entry_count,
+                                          const size_t chunk_count,
+                                          const size_t chunk_idx) {
+  const auto chunk_entry_count = (entry_count + chunk_count - 1) / chunk_count;
+  const auto start = std::min(chunk_idx * chunk_entry_count, entry_count);
+  return {start, std::min(start + chunk_entry_count, entry_count)};
+}
+
+// Must differ from the seed of key_hash, otherwise the entries of a partition would only
+// hash to a fraction of the slots of its hash table.
+constexpr uint32_t kReductionPartitionSeed{0x9e3779b9};
+
 size_t get_row_qw_count(const QueryMemoryDescriptor& query_mem_desc) {
   const auto row_bytes = get_row_bytes(query_mem_desc);
   CHECK_EQ(size_t(0), row_bytes % 8);
@@ -1014,6 +1050,26 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
   for (const auto result_set : result_sets) {
     CHECK_EQ(executor, result_set->executor_);
   }
+  if (g_enable_partitioned_baseline_reduction && result_sets.size() > 1 &&
+      cpu_threads() > 1 &&
+      first_result.query_mem_desc_.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash &&
+      !first_result.query_mem_desc_.didOutputColumnar()) {
+    const auto total_entry_count =
+        std::accumulate(result_sets.begin(),
+                        result_sets.end(),
+                        size_t(0),
+                        [](const size_t init, const ResultSet* rs) {
+                          return init + rs->query_mem_desc_.getEntryCount();
+                        });
+    const bool has_varlen_buffers =
+        std::any_of(result_sets.begin(), result_sets.end(), [](const ResultSet* rs) {
+          return !rs->serialized_varlen_buffer_.empty();
+        });
+    if (use_multithreaded_reduction(total_entry_count) && !has_varlen_buffers) {
+      return reduceBaselinePartitioned(result_sets);
+    }
+  }
   if (first_result.query_mem_desc_.getQueryDescriptionType() ==
       QueryDescriptionType::GroupByBaselineHash) {
     const auto total_entry_count =
@@ -1065,6 +1121,13 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
                                       result_rs->getTargetInfos(),
                                       result_rs->getTargetInitVals());
   auto reduction_code = reduction_jit.codegen();
+  if (g_enable_tree_reduction && result_sets.size() > 2 && cpu_threads() > 1 &&
+      result == &first_result && serialized_varlen_buffer.empty() &&
+      use_multithreaded_reduction(first_result.query_mem_desc_.getEntryCount() *
+                                  (result_sets.size() - 1))) {
+    reduceTree(result_sets, reduction_code);
+    return result_rs;
+  }
   size_t ctr = 1;
   for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end();
        ++result_it) {
@@ -1078,6 +1141,444 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
   return result_rs;
 }
 
+// Reduces the storage of the result sets into the one of the first result set in
+// log2(n) rounds: in every round the pairs of partial results stride apart are merged
+// concurrently, each merge with its share of the CPU threads. No more pairs than the
+// thread budget of the query, read at the start of every round, are merged at once.
+// Only used when all the storages have the same layout, which is the case for all but
+// the baseline hash group by. The storages of the result sets other than the first one
+// are clobbered.
+void ResultSetManager::reduceTree(std::vector<ResultSet*>& result_sets,
+                                  const ReductionCode& reduction_code) {
+  for (size_t stride = 1; stride < result_sets.size(); stride *= 2) {
+    const size_t thread_count = cpu_threads();
+    const auto pair_count = (result_sets.size() + stride - 1) / (2 * stride);
+    const auto worker_count = std::min(pair_count, thread_count);
+    const unsigned pair_thread_count = std::max(thread_count / worker_count, size_t(1));
+    run_in_parallel(worker_count, [&](const size_t worker_idx) {
+      ScopedCpuThreadBudget thread_budget(pair_thread_count);
+      for (size_t pair_idx = worker_idx; pair_idx < pair_count;
+           pair_idx += worker_count) {
+        const auto this_idx = 2 * stride * pair_idx;
+        const auto that_idx = this_idx + stride;
+        CHECK_LT(that_idx, result_sets.size());
+        result_sets[this_idx]->storage_->reduce(
+            *result_sets[that_idx]->storage_, {}, reduction_code);
+      }
+    });
+  }
+}
+
+// Reduces rowwise baseline hash group by buffers in parallel: the key space is split in
+// cpu_threads() partitions by a hash of the key and every partition gets its own hash
+// table, sized after the number of entries of the inputs which belong to it. The
+// entries of every input are first scattered partition by partition to a scratch buffer,
+// then each partition reduces its part of the scratch buffer into its hash table, so no
+// two threads ever touch the same hash table. The output is the concatenation of the
+// partition hash tables, which is fine since reduced buffers are only iterated or
+// rehashed afterwards, never probed for a key. Unlike the serial reduction, the output
+// is sized after the non-empty entries of the inputs rather than their entry counts.
+// This speeds up the reduction but doesn't lower the memory of the group by: every
+// kernel still fills a buffer of its own, and the scratch buffer holds a copy of the
+// non-empty entries of one input at a time on top of the inputs and the output. See
+// BaselineHashPartitions for the pre-aggregation which does bound the memory.
+ResultSet* ResultSetManager::reduceBaselinePartitioned(
+    std::vector<ResultSet*>& result_sets) {
+  const auto& first_result = *result_sets.front()->storage_;
+  const auto& first_query_mem_desc = first_result.query_mem_desc_;
+  const auto key_bytes = get_key_bytes_rowwise(first_query_mem_desc);
+  const auto row_bytes = get_row_bytes(first_query_mem_desc);
+  const size_t partition_count = cpu_threads();
+  const size_t chunk_count = cpu_threads();
+  const auto get_partition = [key_bytes, partition_count](const int8_t* row_ptr) {
+    return MurmurHash1(row_ptr, key_bytes, kReductionPartitionSeed) % partition_count;
+  };
+
+  // histograms[i][chunk_idx * partition_count + partition_idx] is the number of non-empty
+  // entries of the given chunk of the i-th result set which belong to the partition.
+  std::vector<std::vector<size_t>> histograms(
+      result_sets.size(), std::vector<size_t>(chunk_count * partition_count, 0));
+  for (size_t i = 0; i < result_sets.size(); ++i) {
+    const auto& storage = *result_sets[i]->storage_;
+    auto& histogram = histograms[i];
+    run_in_parallel(chunk_count, [&](const size_t chunk_idx) {
+      const auto chunk_range = get_chunk_range(
+          storage.query_mem_desc_.getEntryCount(), chunk_count, chunk_idx);
+      auto chunk_histogram = &histogram[chunk_idx * partition_count];
+      for (size_t entry_idx = chunk_range.first; entry_idx < chunk_range.second;
+           ++entry_idx) {
+        check_watchdog(entry_idx);
+        if (storage.isEmptyEntry(entry_idx)) {
+          continue;
+        }
+        ++chunk_histogram[get_partition(
+            row_ptr_rowwise(storage.buff_, storage.query_mem_desc_, entry_idx))];
+      }
+    });
+  }
+
+  // A partition can't have more groups than entries belonging to it across the inputs.
+  // Keep the load factor of its hash table below 2/3 for the linear probing.
+  std::vector<size_t> partition_offsets(partition_count + 1, 0);
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    size_t partition_entry_count{0};
+    for (const auto& histogram : histograms) {
+      for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+        partition_entry_count += histogram[chunk_idx * partition_count + partition_idx];
+      }
+    }
+    partition_offsets[partition_idx + 1] = partition_offsets[partition_idx] +
+                                           partition_entry_count +
+                                           partition_entry_count / 2 + 1;
+  }
+  auto query_mem_desc = first_query_mem_desc;
+  query_mem_desc.setEntryCount(partition_offsets.back());
+  rs_.reset(new ResultSet(first_result.targets_,
+                          ExecutorDeviceType::CPU,
+                          query_mem_desc,
+                          result_sets.front()->row_set_mem_owner_,
+                          result_sets.front()->executor_));
+  auto result_storage = rs_->allocateStorage(first_result.target_init_vals_);
+  rs_->initializeStorage();
+  std::vector<QueryMemoryDescriptor> partition_query_mem_descs(partition_count,
+                                                               query_mem_desc);
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    partition_query_mem_descs[partition_idx].setEntryCount(
+        partition_offsets[partition_idx + 1] - partition_offsets[partition_idx]);
+  }
+
+  ResultSetReductionJIT reduction_jit(
+      rs_->getQueryMemDesc(), rs_->getTargetInfos(), rs_->getTargetInitVals());
+  const auto reduction_code = reduction_jit.codegen();
+  CHECK(reduction_code.ir_reduce_loop);
+  for (size_t i = 0; i < result_sets.size(); ++i) {
+    const auto& storage = *result_sets[i]->storage_;
+    const auto& histogram = histograms[i];
+    // Offsets of the chunks in the scratch buffer, partition major.
+    std::vector<size_t> scratch_offsets(chunk_count * partition_count);
+    std::vector<size_t> scratch_partition_offsets(partition_count + 1, 0);
+    size_t scratch_entry_count{0};
+    for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+      for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+        const auto histogram_idx = chunk_idx * partition_count + partition_idx;
+        scratch_offsets[histogram_idx] = scratch_entry_count;
+        scratch_entry_count += histogram[histogram_idx];
+      }
+      scratch_partition_offsets[partition_idx + 1] = scratch_entry_count;
+    }
+    if (!scratch_entry_count) {
+      continue;
+    }
+    std::vector<int64_t> scratch_buffer(scratch_entry_count * row_bytes /
+                                        sizeof(int64_t));
+    auto scratch_buff = reinterpret_cast<int8_t*>(scratch_buffer.data());
+    run_in_parallel(chunk_count, [&](const size_t chunk_idx) {
+      const auto chunk_range = get_chunk_range(
+          storage.query_mem_desc_.getEntryCount(), chunk_count, chunk_idx);
+      auto chunk_offsets = &scratch_offsets[chunk_idx * partition_count];
+      for (size_t entry_idx = chunk_range.first; entry_idx < chunk_range.second;
+           ++entry_idx) {
+        check_watchdog(entry_idx);
+        if (storage.isEmptyEntry(entry_idx)) {
+          continue;
+        }
+        const auto row_ptr =
+            row_ptr_rowwise(storage.buff_, storage.query_mem_desc_, entry_idx);
+        const auto scratch_idx = chunk_offsets[get_partition(row_ptr)]++;
+        memcpy(scratch_buff + scratch_idx * row_bytes, row_ptr, row_bytes);
+      }
+    });
+    auto scratch_query_mem_desc = storage.query_mem_desc_;
+    scratch_query_mem_desc.setEntryCount(scratch_entry_count);
+    run_in_parallel(partition_count, [&](const size_t partition_idx) {
+      const auto start_index = scratch_partition_offsets[partition_idx];
+      const auto end_index = scratch_partition_offsets[partition_idx + 1];
+      if (start_index == end_index) {
+        return;
+      }
+      run_reduction_code(reduction_code,
+                         result_storage->getUnderlyingBuffer() +
+                             partition_offsets[partition_idx] * row_bytes,
+                         scratch_buff,
+                         start_index,
+                         end_index,
+                         scratch_entry_count,
+                         &partition_query_mem_descs[partition_idx],
+                         &scratch_query_mem_desc,
+                         nullptr);
+    });
+  }
+  return rs_.get();
+}
+
+namespace {
+
+// Entry count of the hash table of a partition when it gets its first groups.
+constexpr size_t kMinPartitionEntryCount{1024};
+
+// Keeps the load factor of the partition hash tables below 2/3 for the linear probing.
+bool partition_needs_to_grow(const size_t group_count, const size_t entry_count) {
+  return 3 * (group_count + 1) > 2 * entry_count;
+}
+
+}  // namespace
+
+struct BaselineHashPartitions::Partition {
+  std::mutex mutex;
+  QueryMemoryDescriptor query_mem_desc;
+  std::vector<int64_t> buffer;
+  size_t group_count{0};
+};
+
+BaselineHashPartitions::BaselineHashPartitions(const size_t partition_count)
+    : partition_count_(std::max(partition_count, size_t(1))), flush_count_(0) {}
+
+BaselineHashPartitions::~BaselineHashPartitions() {}
+
+bool BaselineHashPartitions::canPreaggregate(const RelAlgExecutionUnit& ra_exe_unit,
+                                             const QueryMemoryDescriptor& query_mem_desc,
+                                             const ExecutorDeviceType device_type) {
+  if (!g_enable_baseline_preaggregation || device_type != ExecutorDeviceType::CPU ||
+      query_mem_desc.getQueryDescriptionType() !=
+          QueryDescriptionType::GroupByBaselineHash ||
+      query_mem_desc.didOutputColumnar()) {
+    return false;
+  }
+  // The scan resumes from the row which didn't fit, which must not have updated any
+  // group yet: every row of the input updates exactly one group.
+  if (ra_exe_unit.input_descs.size() != 1 || ra_exe_unit.union_all ||
+      ra_exe_unit.scan_limit || ra_exe_unit.use_bump_allocator) {
+    return false;
+  }
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    const auto uoper = dynamic_cast<const Analyzer::UOper*>(groupby_expr.get());
+    if (uoper && uoper->get_optype() == kUNNEST) {
+      return false;
+    }
+  }
+  // Re-initializing a buffer doesn't allocate the count distinct sets and t-digests of
+  // its entries again, and the groups must not point to the input buffers.
+  return std::none_of(ra_exe_unit.target_exprs.begin(),
+                      ra_exe_unit.target_exprs.end(),
+                      [](const Analyzer::Expr* target_expr) {
+                        const auto target_info =
+                            get_target_info(target_expr, g_bigint_count);
+                        return is_distinct_target(target_info) ||
+                               is_approx_percentile_target(target_info) ||
+                               target_info.sql_type.is_varlen();
+                      });
+}
+
+void BaselineHashPartitions::init(const ResultSetStorage& storage) {
+  targets_ = storage.targets_;
+  query_mem_desc_ = storage.query_mem_desc_;
+  target_init_vals_ = storage.target_init_vals_;
+  {
+    std::lock_guard<std::mutex> compilation_lock(Executor::compilation_mutex_);
+    ResultSetReductionJIT reduction_jit(query_mem_desc_, targets_, target_init_vals_);
+    reduction_code_ = std::make_unique<ReductionCode>(reduction_jit.codegen());
+  }
+  CHECK(reduction_code_->ir_reduce_loop);
+  for (size_t partition_idx = 0; partition_idx < partition_count_; ++partition_idx) {
+    partitions_.emplace_back(std::make_unique<Partition>());
+    partitions_.back()->query_mem_desc = query_mem_desc_;
+    partitions_.back()->query_mem_desc.setEntryCount(0);
+  }
+}
+
+void BaselineHashPartitions::flush(const ResultSetStorage& storage) {
+  std::call_once(init_flag_, [this, &storage] { init(storage); });
+  const auto& query_mem_desc = storage.query_mem_desc_;
+  CHECK(query_mem_desc.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!query_mem_desc.didOutputColumnar());
+  const auto key_bytes = get_key_bytes_rowwise(query_mem_desc);
+  const auto row_bytes = get_row_bytes(query_mem_desc);
+  CHECK_EQ(row_bytes, get_row_bytes(query_mem_desc_));
+  const auto get_partition = [this, key_bytes](const int8_t* row_ptr) {
+    return MurmurHash1(row_ptr, key_bytes, kReductionPartitionSeed) % partition_count_;
+  };
+
+  // Copy the groups of the buffer to a scratch buffer, partition by partition.
+  std::vector<size_t> partition_offsets(partition_count_ + 1, 0);
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+    check_watchdog(entry_idx);
+    if (storage.isEmptyEntry(entry_idx)) {
+      continue;
+    }
+    ++partition_offsets[get_partition(
+                            row_ptr_rowwise(storage.buff_, query_mem_desc, entry_idx)) +
+                        1];
+  }
+  std::partial_sum(
+      partition_offsets.begin(), partition_offsets.end(), partition_offsets.begin());
+  const auto row_count = partition_offsets.back();
+  if (!row_count) {
+    return;
+  }
+  std::vector<int64_t> scratch_buffer(row_count * row_bytes / sizeof(int64_t));
+  auto scratch_buff = reinterpret_cast<int8_t*>(scratch_buffer.data());
+  auto scratch_offsets = partition_offsets;
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+    if (storage.isEmptyEntry(entry_idx)) {
+      continue;
+    }
+    const auto row_ptr = row_ptr_rowwise(storage.buff_, query_mem_desc, entry_idx);
+    const auto scratch_idx = scratch_offsets[get_partition(row_ptr)]++;
+    memcpy(scratch_buff + scratch_idx * row_bytes, row_ptr, row_bytes);
+  }
+
+  // Start from a different partition on every flush, so that the kernels flushing at the
+  // same time don't all queue on the same partition.
+  const auto first_partition_idx = flush_count_++ % partition_count_;
+  for (size_t i = 0; i < partition_count_; ++i) {
+    const auto partition_idx = (first_partition_idx + i) % partition_count_;
+    const auto start_index = partition_offsets[partition_idx];
+    const auto end_index = partition_offsets[partition_idx + 1];
+    if (start_index == end_index) {
+      continue;
+    }
+    auto& partition = *partitions_[partition_idx];
+    std::lock_guard<std::mutex> partition_lock(partition.mutex);
+    reducePartition(
+        partition, scratch_buff + start_index * row_bytes, end_index - start_index);
+  }
+}
+
+// Inserts the groups new to the partition in its hash table, which copies their values
+// too, and moves the rows of the groups it already has to the front of the rows to
+// reduce them afterwards. Counting the new groups this way keeps the hash table sized
+// after the number of groups rather than the number of flushed rows.
+void BaselineHashPartitions::reducePartition(Partition& partition,
+                                             int8_t* rows,
+                                             const size_t row_count) {
+  const auto key_count = query_mem_desc_.getGroupbyColCount();
+  const auto key_width = query_mem_desc_.getEffectiveKeyWidth();
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  const auto rows_i64 = reinterpret_cast<const int64_t*>(rows);
+  size_t existing_row_count{0};
+  for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+    check_watchdog(row_idx);
+    if (partition_needs_to_grow(partition.group_count,
+                                partition.query_mem_desc.getEntryCount())) {
+      growPartition(partition);
+    }
+    const auto row_ptr = rows + row_idx * row_bytes;
+    const auto gvi = get_group_value_reduction(partition.buffer.data(),
+                                               partition.query_mem_desc.getEntryCount(),
+                                               reinterpret_cast<const int64_t*>(row_ptr),
+                                               key_count,
+                                               key_width,
+                                               partition.query_mem_desc,
+                                               rows_i64,
+                                               row_idx,
+                                               row_count,
+                                               row_bytes / sizeof(int64_t));
+    CHECK(gvi.first);
+    if (gvi.second) {
+      ++partition.group_count;
+      continue;
+    }
+    if (existing_row_count != row_idx) {
+      memcpy(rows + existing_row_count * row_bytes, row_ptr, row_bytes);
+    }
+    ++existing_row_count;
+  }
+  if (!existing_row_count) {
+    return;
+  }
+  auto rows_query_mem_desc = query_mem_desc_;
+  rows_query_mem_desc.setEntryCount(existing_row_count);
+  run_reduction_code(*reduction_code_,
+                     reinterpret_cast<int8_t*>(partition.buffer.data()),
+                     rows,
+                     0,
+                     existing_row_count,
+                     existing_row_count,
+                     &partition.query_mem_desc,
+                     &rows_query_mem_desc,
+                     nullptr);
+}
+
+void BaselineHashPartitions::growPartition(Partition& partition) {
+  const auto entry_count = partition.query_mem_desc.getEntryCount();
+  auto query_mem_desc = partition.query_mem_desc;
+  query_mem_desc.setEntryCount(std::max(2 * entry_count, kMinPartitionEntryCount));
+  std::vector<int64_t> buffer(query_mem_desc.getEntryCount() *
+                              get_row_bytes(query_mem_desc) / sizeof(int64_t));
+  initializeBuffer(reinterpret_cast<int8_t*>(buffer.data()), query_mem_desc);
+  if (partition.group_count) {
+    // Reducing into the empty hash table rehashes the groups.
+    run_reduction_code(*reduction_code_,
+                       reinterpret_cast<int8_t*>(buffer.data()),
+                       reinterpret_cast<const int8_t*>(partition.buffer.data()),
+                       0,
+                       entry_count,
+                       entry_count,
+                       &query_mem_desc,
+                       &partition.query_mem_desc,
+                       nullptr);
+  }
+  partition.buffer.swap(buffer);
+  partition.query_mem_desc = query_mem_desc;
+}
+
+void BaselineHashPartitions::initializeBuffer(
+    int8_t* buff,
+    const QueryMemoryDescriptor& query_mem_desc) const {
+  ResultSetStorage storage(targets_, query_mem_desc, buff, /*buff_is_provided=*/true);
+  storage.target_init_vals_ = target_init_vals_;
+  storage.initializeRowWise();
+}
+
+size_t BaselineHashPartitions::getGroupCount() const {
+  size_t group_count{0};
+  for (const auto& partition : partitions_) {
+    std::lock_guard<std::mutex> partition_lock(partition->mutex);
+    group_count += partition->group_count;
+  }
+  return group_count;
+}
+
+// The output only has the groups, packed: the hash tables of the partitions are released
+// one by one as their groups get copied. This is fine since a reduced buffer is only
+// iterated or rehashed afterwards, never probed for a key.
+std::shared_ptr<ResultSet> BaselineHashPartitions::finalize(
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const Executor* executor) {
+  const auto group_count = getGroupCount();
+  if (!group_count) {
+    return nullptr;
+  }
+  auto query_mem_desc = query_mem_desc_;
+  query_mem_desc.setEntryCount(group_count);
+  auto result = std::make_shared<ResultSet>(
+      targets_, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, executor);
+  auto result_buff = result->allocateStorage(target_init_vals_)->getUnderlyingBuffer();
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  for (auto& partition : partitions_) {
+    std::lock_guard<std::mutex> partition_lock(partition->mutex);
+    ResultSetStorage partition_storage(targets_,
+                                       partition->query_mem_desc,
+                                       reinterpret_cast<int8_t*>(partition->buffer.data()),
+                                       /*buff_is_provided=*/true);
+    for (size_t entry_idx = 0; entry_idx < partition->query_mem_desc.getEntryCount();
+         ++entry_idx) {
+      if (partition_storage.isEmptyEntry(entry_idx)) {
+        continue;
+      }
+      memcpy(result_buff,
+             row_ptr_rowwise(partition_storage.buff_, partition->query_mem_desc, entry_idx),
+             row_bytes);
+      result_buff += row_bytes;
+    }
+    std::vector<int64_t>().swap(partition->buffer);
+    partition->query_mem_desc.setEntryCount(0);
+    partition->group_count = 0;
+  }
+  return result;
+}
+
 std::shared_ptr<ResultSet> ResultSetManager::getOwnResultSet() {
   return rs_;
 }
@@ -1471,6 +1972,12 @@ void ResultSetStorage::reduceOneSlot(
         }
         break;
       }
+      case kAPPROX_PERCENTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        approx_percentile_merge(*reinterpret_cast<const int64_t*>(that_ptr1),
+                                *reinterpret_cast<const int64_t*>(this_ptr1));
+        break;
+      }
       default:
         CHECK(false);
     }
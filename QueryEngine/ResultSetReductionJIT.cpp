@@ -23,6 +23,7 @@
 #include "Execute.h"
 #include "IRCodegenUtils.h"
 #include "LLVMFunctionAttributesUtil.h"
+#include "TDigest.h"
 
 #include "Shared/likely.h"
 
@@ -456,6 +457,11 @@ extern "C" void count_distinct_set_union_jit_rt(const int64_t new_set_handle,
       new_set_handle, old_set_handle, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+extern "C" void approx_percentile_jit_rt(const int64_t new_tdigest_handle,
+                                        const int64_t old_tdigest_handle) {
+  approx_percentile_merge(new_tdigest_handle, old_tdigest_handle);
+}
+
 extern "C" void get_group_value_reduction_rt(int8_t* groups_buffer,
                                              const int8_t* key,
                                              const uint32_t key_count,
@@ -1167,6 +1173,11 @@ void ResultSetReductionJIT::reduceOneAggregateSlot(Value* this_ptr1,
                                         ir_reduce_one_entry);
       break;
     }
+    case kAPPROX_PERCENTILE: {
+      CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+      reduceOneApproxPercentileSlot(this_ptr1, that_ptr1, ir_reduce_one_entry);
+      break;
+    }
     default:
       LOG(FATAL) << "Invalid aggregate type";
   }
@@ -1194,6 +1205,19 @@ void ResultSetReductionJIT::reduceOneCountDistinctSlot(
       "");
 }
 
+void ResultSetReductionJIT::reduceOneApproxPercentileSlot(
+    Value* this_ptr1,
+    Value* that_ptr1,
+    Function* ir_reduce_one_entry) const {
+  const auto old_tdigest_handle = emit_load_i64(this_ptr1, ir_reduce_one_entry);
+  const auto new_tdigest_handle = emit_load_i64(that_ptr1, ir_reduce_one_entry);
+  ir_reduce_one_entry->add<ExternalCall>(
+      "approx_percentile_jit_rt",
+      Type::Void,
+      std::vector<const Value*>{new_tdigest_handle, old_tdigest_handle},
+      "");
+}
+
 ReductionCode ResultSetReductionJIT::finalizeReductionCode(
     ReductionCode reduction_code,
     const llvm::Function* ir_is_empty,
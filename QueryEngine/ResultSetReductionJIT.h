@@ -120,6 +120,11 @@ class ResultSetReductionJIT {
                                   const size_t target_logical_idx,
                                   Function* ir_reduce_one_entry) const;
 
+  // Generate reduction code for an approximate percentile slot.
+  void reduceOneApproxPercentileSlot(Value* this_ptr1,
+                                     Value* that_ptr1,
+                                     Function* ir_reduce_one_entry) const;
+
   ReductionCode finalizeReductionCode(ReductionCode reduction_code,
                                       const llvm::Function* ir_is_empty,
                                       const llvm::Function* ir_reduce_one_entry,
@@ -352,6 +352,37 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
              : 0;
 }
 
+// The bitmap of the inner rows matched by a FULL join is shared by all the kernels of the
+// probe pass, the bits are set atomically. Negative row ids stand for no match.
+extern "C" ALWAYS_INLINE void full_join_mark_matched_row(const int64_t matched_rows,
+                                                         const int64_t row_id) {
+  if (row_id < 0) {
+    return;
+  }
+  auto word = reinterpret_cast<uint32_t*>(matched_rows) + (row_id >> 5);
+  const uint32_t mask = 1u << (row_id & 31);
+  if (!(*word & mask)) {
+    __sync_fetch_and_or(word, mask);
+  }
+}
+
+// Same as above for a one to many hash join, the row id is only read on a match since
+// the position past the last matching row is not valid.
+extern "C" ALWAYS_INLINE void full_join_mark_matched_set_row(const int64_t matched_rows,
+                                                             const int32_t* row_id_ptr,
+                                                             const int8_t matched) {
+  if (matched) {
+    full_join_mark_matched_row(matched_rows, *row_id_ptr);
+  }
+}
+
+extern "C" ALWAYS_INLINE int8_t full_join_row_matched(const int64_t matched_rows,
+                                                      const int64_t row_id) {
+  return (reinterpret_cast<const uint32_t*>(matched_rows)[row_id >> 5] >>
+          (row_id & 31)) &
+         1;
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
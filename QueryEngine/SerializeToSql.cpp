@@ -134,6 +134,8 @@ std::string agg_type_to_string(const SQLAgg agg_type) {
       return "APPROX_COUNT_DISTINCT";
     case kSAMPLE:
       return "SAMPLE";
+    case kAPPROX_PERCENTILE:
+      return "APPROX_PERCENTILE";
     default:
       LOG(FATAL) << "Invalid aggregate type: " << agg_type;
       return "";
@@ -148,6 +150,11 @@ std::string agg_to_string(const Analyzer::AggExpr* agg_expr,
   const auto arg =
       agg_expr->get_arg() ? scalar_expr_to_sql.visit(agg_expr->get_arg()) : "*";
   const auto distinct = agg_expr->get_is_distinct() ? "DISTINCT " : "";
+  if (agg_expr->get_aggtype() == kAPPROX_PERCENTILE) {
+    CHECK(agg_expr->get_arg1());
+    const auto quantile = scalar_expr_to_sql.visit(agg_expr->get_arg1().get());
+    return agg_type + "(" + arg + "," + quantile + ")";
+  }
   return agg_type + "(" + distinct + arg + ")";
 }
 
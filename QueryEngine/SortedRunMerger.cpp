@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/SortedRunMerger.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Logger/Logger.h"
+
+SortedRunMerger::SortedRunMerger(const size_t key_bytes,
+                                 const size_t record_bytes,
+                                 const size_t block_bytes)
+    : key_bytes_(key_bytes)
+    , record_bytes_(record_bytes)
+    , block_records_(std::max(block_bytes / record_bytes, size_t(1)))
+    , record_count_(0)
+    , started_(false) {
+  CHECK_LE(key_bytes_, record_bytes_);
+}
+
+void SortedRunMerger::addRun(const int8_t* records, const size_t record_count) {
+  if (!record_count) {
+    return;
+  }
+  const auto file_id = spill_manager_.createFile();
+  spill_manager_.append(file_id, records, record_count * record_bytes_);
+  std::lock_guard<std::mutex> runs_lock(runs_mutex_);
+  CHECK(!started_);
+  runs_.push_back(Run{file_id, record_count, 0, {}, 0});
+  record_count_ += record_count;
+}
+
+size_t SortedRunMerger::getRunCount() const {
+  std::lock_guard<std::mutex> runs_lock(runs_mutex_);
+  return runs_.size();
+}
+
+size_t SortedRunMerger::getRecordCount() const {
+  std::lock_guard<std::mutex> runs_lock(runs_mutex_);
+  return record_count_;
+}
+
+const int8_t* SortedRunMerger::next() {
+  if (!started_) {
+    start();
+  }
+  const auto heap_compare = [this](const size_t lhs, const size_t rhs) {
+    return heapCompare(lhs, rhs);
+  };
+  while (!heap_.empty()) {
+    std::pop_heap(heap_.begin(), heap_.end(), heap_compare);
+    auto& run = runs_[heap_.back()];
+    if (run.block_pos == run.block.size()) {
+      // The last record returned ended the block of the run, which can move on now that
+      // the record isn't needed anymore.
+      if (run.read_records == run.record_count) {
+        std::vector<int8_t>().swap(run.block);
+        heap_.pop_back();
+        continue;
+      }
+      readBlock(run);
+      std::push_heap(heap_.begin(), heap_.end(), heap_compare);
+      continue;
+    }
+    const auto record = &run.block[run.block_pos];
+    run.block_pos += record_bytes_;
+    std::push_heap(heap_.begin(), heap_.end(), heap_compare);
+    return record;
+  }
+  return nullptr;
+}
+
+void SortedRunMerger::start() {
+  heap_.clear();
+  for (size_t run_idx = 0; run_idx < runs_.size(); ++run_idx) {
+    auto& run = runs_[run_idx];
+    run.read_records = 0;
+    readBlock(run);
+    heap_.push_back(run_idx);
+  }
+  std::make_heap(heap_.begin(), heap_.end(), [this](const size_t lhs, const size_t rhs) {
+    return heapCompare(lhs, rhs);
+  });
+  started_ = true;
+}
+
+void SortedRunMerger::readBlock(Run& run) {
+  const auto block_records =
+      std::min(block_records_, run.record_count - run.read_records);
+  CHECK_GT(block_records, size_t(0));
+  run.block.resize(block_records * record_bytes_);
+  spill_manager_.read(
+      run.file_id, run.read_records * record_bytes_, run.block.data(), run.block.size());
+  run.read_records += block_records;
+  run.block_pos = 0;
+}
+
+bool SortedRunMerger::heapCompare(const size_t lhs_run_idx,
+                                  const size_t rhs_run_idx) const {
+  const auto& lhs = runs_[lhs_run_idx];
+  const auto& rhs = runs_[rhs_run_idx];
+  // Runs done with their block go on top, to read their next block first
+  const bool lhs_block_done = lhs.block_pos == lhs.block.size();
+  const bool rhs_block_done = rhs.block_pos == rhs.block.size();
+  if (lhs_block_done || rhs_block_done) {
+    return rhs_block_done && !lhs_block_done;
+  }
+  return std::memcmp(&rhs.block[rhs.block_pos], &lhs.block[lhs.block_pos], key_bytes_) <
+         0;
+}
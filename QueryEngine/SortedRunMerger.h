@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SortedRunMerger.h
+ * @brief   K-way merge of sorted runs of fixed width records spilled to disk.
+ *
+ * Records start with a key which memcmp orders, followed by an opaque payload. Every run
+ * is written to a spill file as it gets added. The merge keeps one block of every run in
+ * memory and a heap of the runs ordered by their next record, so its memory is bounded
+ * by the number of runs times the block size rather than by the number of records. Runs
+ * can be added concurrently, the merge itself is single threaded.
+ */
+
+#pragma once
+
+#include "QueryEngine/SpillManager.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class SortedRunMerger {
+ public:
+  SortedRunMerger(const size_t key_bytes,
+                  const size_t record_bytes,
+                  const size_t block_bytes);
+
+  // Spills a run of record_count records sorted by their key. Thread safe.
+  void addRun(const int8_t* records, const size_t record_count);
+
+  size_t getRunCount() const;
+
+  // Number of records in all the runs.
+  size_t getRecordCount() const;
+
+  size_t getSpilledBytes() const { return spill_manager_.getSpilledBytes(); }
+
+  // Starts the merge over, from the first record in key order.
+  void reset() { started_ = false; }
+
+  // Returns the next record in key order, valid until the following call, or nullptr
+  // once all the records of the runs have been returned.
+  const int8_t* next();
+
+ private:
+  struct Run {
+    size_t file_id;
+    size_t record_count;
+    size_t read_records;
+    std::vector<int8_t> block;
+    size_t block_pos;
+  };
+
+  void start();
+
+  void readBlock(Run& run);
+
+  // Orders the heap such that the run with the smallest next record is on top.
+  bool heapCompare(const size_t lhs_run_idx, const size_t rhs_run_idx) const;
+
+  SpillManager spill_manager_;
+  const size_t key_bytes_;
+  const size_t record_bytes_;
+  const size_t block_records_;
+  mutable std::mutex runs_mutex_;
+  std::vector<Run> runs_;
+  size_t record_count_;
+  std::vector<size_t> heap_;
+  bool started_;
+};
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/SpillManager.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <numeric>
+#include <stdexcept>
+
+#include "Logger/Logger.h"
+
+std::string g_spill_path;
+
+SpillManager::SpillManager() {
+  const auto base_path = g_spill_path.empty()
+                             ? boost::filesystem::temp_directory_path()
+                             : boost::filesystem::path(g_spill_path);
+  path_ = base_path / boost::filesystem::unique_path("omnisci_spill_%%%%-%%%%-%%%%");
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(path_, ec);
+  if (ec || !boost::filesystem::is_directory(path_)) {
+    throw std::runtime_error("Could not create the spill directory " + path_.string() +
+                             (ec ? ": " + ec.message() : ""));
+  }
+  VLOG(1) << "Spilling to " << path_.string();
+}
+
+SpillManager::~SpillManager() {
+  for (auto file : files_) {
+    fclose(file);
+  }
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(path_, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not remove the spill directory " << path_.string() << ": "
+                 << ec.message();
+  }
+}
+
+size_t SpillManager::createFile() {
+  std::lock_guard<std::mutex> files_lock(files_mutex_);
+  const auto file_path = path_ / std::to_string(files_.size());
+  auto file = fopen(file_path.string().c_str(), "w+b");
+  if (!file) {
+    throw std::runtime_error("Could not create the spill file " + file_path.string());
+  }
+  files_.push_back(file);
+  file_sizes_.push_back(0);
+  return files_.size() - 1;
+}
+
+void SpillManager::append(const size_t file_id,
+                          const int8_t* data,
+                          const size_t num_bytes) {
+  std::lock_guard<std::mutex> files_lock(files_mutex_);
+  CHECK_LT(file_id, files_.size());
+  auto file = files_[file_id];
+  if (fseek(file, file_sizes_[file_id], SEEK_SET) ||
+      fwrite(data, 1, num_bytes, file) != num_bytes) {
+    throw std::runtime_error("Could not write " + std::to_string(num_bytes) +
+                             " bytes to the spill directory " + path_.string());
+  }
+  file_sizes_[file_id] += num_bytes;
+}
+
+void SpillManager::read(const size_t file_id,
+                        const size_t offset,
+                        int8_t* dest,
+                        const size_t num_bytes) const {
+  std::lock_guard<std::mutex> files_lock(files_mutex_);
+  CHECK_LT(file_id, files_.size());
+  CHECK_LE(offset + num_bytes, file_sizes_[file_id]);
+  auto file = files_[file_id];
+  if (fseek(file, offset, SEEK_SET) || fread(dest, 1, num_bytes, file) != num_bytes) {
+    throw std::runtime_error("Could not read " + std::to_string(num_bytes) +
+                             " bytes from the spill directory " + path_.string());
+  }
+}
+
+size_t SpillManager::getFileSize(const size_t file_id) const {
+  std::lock_guard<std::mutex> files_lock(files_mutex_);
+  CHECK_LT(file_id, file_sizes_.size());
+  return file_sizes_[file_id];
+}
+
+size_t SpillManager::getSpilledBytes() const {
+  std::lock_guard<std::mutex> files_lock(files_mutex_);
+  return std::accumulate(file_sizes_.begin(), file_sizes_.end(), size_t(0));
+}
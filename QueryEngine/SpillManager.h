@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SpillManager.h
+ * @brief   Temporary files for the intermediate results of a query which don't fit in
+ *          host memory.
+ *
+ * Every manager owns a directory of its own under g_spill_path, or under the system
+ * temporary directory if the path is empty, and removes it with all its files when it
+ * goes away, including when the query fails. Files are written by appending to them and
+ * read back at any offset. All the methods are thread safe.
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern std::string g_spill_path;
+
+class SpillManager {
+ public:
+  SpillManager();
+
+  ~SpillManager();
+
+  SpillManager(const SpillManager&) = delete;
+  SpillManager& operator=(const SpillManager&) = delete;
+
+  // Creates a new empty file and returns its id.
+  size_t createFile();
+
+  void append(const size_t file_id, const int8_t* data, const size_t num_bytes);
+
+  void read(const size_t file_id,
+            const size_t offset,
+            int8_t* dest,
+            const size_t num_bytes) const;
+
+  size_t getFileSize(const size_t file_id) const;
+
+  // Total number of bytes written to the files of this manager.
+  size_t getSpilledBytes() const;
+
+  std::string getPath() const { return path_.string(); }
+
+ private:
+  boost::filesystem::path path_;
+  mutable std::mutex files_mutex_;
+  std::vector<FILE*> files_;
+  std::vector<size_t> file_sizes_;
+};
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TDigest.h
+ * @brief   Merging t-digest (Dunning, "Computing Extremely Accurate Quantiles Using
+ *          t-Digests"), used by APPROX_PERCENTILE.
+ *
+ * Values are buffered and periodically merged into a sorted list of centroids whose
+ * sizes are bounded by the k1 scale function, so the digest stays small (on the order of
+ * the compression parameter) while quantiles close to 0 and 1 stay accurate. Digests
+ * built on disjoint inputs can be merged, which is what the result set reduction does.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Logger/Logger.h"
+#include "Shared/sqltypes.h"
+
+class TDigest {
+ public:
+  static constexpr double kDefaultCompression{100};
+
+  TDigest(const double quantile, const double compression = kDefaultCompression)
+      : quantile_(quantile)
+      , compression_(compression)
+      , min_(std::numeric_limits<double>::max())
+      , max_(std::numeric_limits<double>::lowest()) {
+    CHECK_GE(quantile_, 0.);
+    CHECK_LE(quantile_, 1.);
+    CHECK_GT(compression_, 0.);
+  }
+
+  void add(const double value) {
+    buffer_.push_back({value, 1});
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    if (buffer_.size() >= bufferCapacity()) {
+      flush();
+    }
+  }
+
+  void merge(const TDigest& that) {
+    CHECK_EQ(quantile_, that.quantile_);
+    buffer_.insert(buffer_.end(), that.centroids_.begin(), that.centroids_.end());
+    buffer_.insert(buffer_.end(), that.buffer_.begin(), that.buffer_.end());
+    min_ = std::min(min_, that.min_);
+    max_ = std::max(max_, that.max_);
+    if (buffer_.size() >= bufferCapacity()) {
+      flush();
+    }
+  }
+
+  bool empty() const { return centroids_.empty() && buffer_.empty(); }
+
+  // Estimates the value at the quantile the digest was created for. Leaves the digest as
+  // is, so that the result set can read it from several threads once it is reduced.
+  double quantile() const {
+    return buffer_.empty() ? quantile(centroids_) : quantile(mergeBuffer());
+  }
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  double quantile(const std::vector<Centroid>& centroids) const {
+    CHECK(!centroids.empty());
+    const auto& first = centroids.front();
+    const auto& last = centroids.back();
+    if (centroids.size() == 1) {
+      return first.mean;
+    }
+    double total_weight{0};
+    for (const auto& centroid : centroids) {
+      total_weight += centroid.weight;
+    }
+    const double index = quantile_ * total_weight;
+    // The extremes are known exactly, and every centroid is assumed to have half of its
+    // weight on either side of its mean.
+    if (index < 1) {
+      return min_;
+    }
+    if (index > total_weight - 1) {
+      return max_;
+    }
+    if (first.weight > 2 && index < first.weight / 2) {
+      return min_ + (index - 1) / (first.weight / 2 - 1) * (first.mean - min_);
+    }
+    if (last.weight > 2 && total_weight - index <= last.weight / 2) {
+      return max_ -
+             (total_weight - index - 1) / (last.weight / 2 - 1) * (max_ - last.mean);
+    }
+    double weight_so_far = first.weight / 2;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+      const auto& left = centroids[i];
+      const auto& right = centroids[i + 1];
+      const double delta_weight = (left.weight + right.weight) / 2;
+      if (weight_so_far + delta_weight > index) {
+        const double left_dist = index - weight_so_far;
+        const double right_dist = weight_so_far + delta_weight - index;
+        return (left.mean * right_dist + right.mean * left_dist) /
+               (left_dist + right_dist);
+      }
+      weight_so_far += delta_weight;
+    }
+    return last.mean;
+  }
+
+  size_t bufferCapacity() const { return static_cast<size_t>(5 * compression_); }
+
+  // k1 scale function, a centroid may span at most one unit of it.
+  double scale(const double q) const {
+    return compression_ / (2 * M_PI) * std::asin(2 * q - 1);
+  }
+
+  void flush() {
+    if (buffer_.empty()) {
+      return;
+    }
+    centroids_ = mergeBuffer();
+    buffer_.clear();
+  }
+
+  // The centroids of the digest with the buffered values merged in
+  std::vector<Centroid> mergeBuffer() const {
+    std::vector<Centroid> values(buffer_);
+    values.insert(values.end(), centroids_.begin(), centroids_.end());
+    std::sort(
+        values.begin(), values.end(), [](const Centroid& lhs, const Centroid& rhs) {
+          return lhs.mean < rhs.mean;
+        });
+    double total_weight{0};
+    for (const auto& centroid : values) {
+      total_weight += centroid.weight;
+    }
+    std::vector<Centroid> centroids;
+    double weight_so_far{0};
+    double k_left = scale(0);
+    auto current = values.front();
+    for (size_t i = 1; i < values.size(); ++i) {
+      const auto& next = values[i];
+      const double q_right =
+          (weight_so_far + current.weight + next.weight) / total_weight;
+      if (scale(q_right) - k_left <= 1) {
+        current.weight += next.weight;
+        current.mean += (next.mean - current.mean) * next.weight / current.weight;
+      } else {
+        weight_so_far += current.weight;
+        k_left = scale(weight_so_far / total_weight);
+        centroids.push_back(current);
+        current = next;
+      }
+    }
+    centroids.push_back(current);
+    return centroids;
+  }
+
+  double quantile_;
+  double compression_;
+  double min_;
+  double max_;
+  std::vector<Centroid> centroids_;
+  std::vector<Centroid> buffer_;
+};
+
+// Returns the value of an APPROX_PERCENTILE slot, NULL if no non-null value was added.
+inline double approx_percentile_value(const int64_t tdigest_handle) {
+  const auto tdigest = reinterpret_cast<const TDigest*>(tdigest_handle);
+  if (!tdigest || tdigest->empty()) {
+    return NULL_DOUBLE;
+  }
+  return tdigest->quantile();
+}
+
+// Merges the digest in a reduced APPROX_PERCENTILE slot into the one of the target slot.
+inline void approx_percentile_merge(const int64_t new_tdigest_handle,
+                                    const int64_t old_tdigest_handle) {
+  CHECK(new_tdigest_handle && old_tdigest_handle);
+  if (new_tdigest_handle == old_tdigest_handle) {
+    return;
+  }
+  reinterpret_cast<TDigest*>(old_tdigest_handle)
+      ->merge(*reinterpret_cast<const TDigest*>(new_tdigest_handle));
+}
@@ -67,6 +67,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"checked_single_agg_id"};
     case kSAMPLE:
       return {"agg_id"};
+    case kAPPROX_PERCENTILE:
+      return {"agg_approx_percentile"};
     default:
       UNREACHABLE() << "Unrecognized agg kind: " << std::to_string(target_info.agg_kind);
   }
@@ -122,7 +124,8 @@ void TargetExprCodegen::codegen(
   if (window_row_ptr) {
     agg_out_ptr_w_idx =
         std::make_tuple(window_row_ptr, std::get<1>(agg_out_ptr_w_idx_in));
-    if (window_function_is_aggregate(window_func->getKind())) {
+    if (window_function_is_aggregate(window_func->getKind()) &&
+        !window_function_is_framed_aggregate(window_func)) {
       out_row_idx = window_row_ptr;
     }
   }
@@ -408,6 +411,10 @@ void TargetExprCodegen::codegenAggregate(
       CHECK(!chosen_type.is_fp());
       group_by_and_agg->codegenCountDistinct(
           target_idx, target_expr, agg_args, query_mem_desc, co.device_type);
+    } else if (is_approx_percentile_target(target_info)) {
+      CHECK_EQ(agg_chosen_bytes, sizeof(int64_t));
+      group_by_and_agg->codegenApproxPercentile(
+          target_idx, target_expr, agg_args, query_mem_desc, co.device_type);
     } else {
       const auto& arg_ti = target_info.agg_arg_type;
       if (need_skip_null && !arg_ti.is_geometry()) {
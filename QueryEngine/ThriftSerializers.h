@@ -83,6 +83,7 @@ inline TAggKind::type agg_kind_to_thrift(const SQLAgg agg) {
     THRIFT_AGGKIND_CASE(SUM)
     THRIFT_AGGKIND_CASE(APPROX_COUNT_DISTINCT)
     THRIFT_AGGKIND_CASE(SAMPLE)
+    THRIFT_AGGKIND_CASE(APPROX_PERCENTILE)
     default:
       CHECK(false);
   }
@@ -104,6 +105,7 @@ inline SQLAgg agg_kind_from_thrift(const TAggKind::type agg) {
     UNTHRIFT_AGGKIND_CASE(SUM)
     UNTHRIFT_AGGKIND_CASE(APPROX_COUNT_DISTINCT)
     UNTHRIFT_AGGKIND_CASE(SAMPLE)
+    UNTHRIFT_AGGKIND_CASE(APPROX_PERCENTILE)
     default:
       CHECK(false);
   }
@@ -189,6 +191,7 @@ inline TCountDistinctImplType::type count_distinct_impl_type_to_thrift(
     THRIFT_COUNTDESCRIPTORIMPL_CASE(Invalid)
     THRIFT_COUNTDESCRIPTORIMPL_CASE(Bitmap)
     THRIFT_COUNTDESCRIPTORIMPL_CASE(StdSet)
+    THRIFT_COUNTDESCRIPTORIMPL_CASE(HllSketch)
     default:
       CHECK(false);
   }
@@ -224,6 +227,7 @@ inline CountDistinctImplType count_distinct_impl_type_from_thrift(
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(Invalid)
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(Bitmap)
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(StdSet)
+    UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(HllSketch)
     default:
       CHECK(false);
   }
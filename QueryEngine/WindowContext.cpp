@@ -16,7 +16,11 @@
 
 #include "QueryEngine/WindowContext.h"
 
+#include <atomic>
+#include <future>
+#include <limits>
 #include <numeric>
+#include <optional>
 
 #include "QueryEngine/Descriptors/CountDistinctDescriptor.h"
 #include "QueryEngine/Execute.h"
@@ -24,8 +28,13 @@
 #include "QueryEngine/ResultSetBufferAccessors.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "QueryEngine/TypePunning.h"
+#include "Shared/SqlTypesLayout.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/sql_window_function_to_string.h"
+#include "Shared/thread_count.h"
+
+bool g_enable_parallel_window_partition_compute{true};
+size_t g_window_function_parallel_sort_threshold{size_t(1) << 20};
 
 WindowFunctionContext::WindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
@@ -34,6 +43,7 @@ WindowFunctionContext::WindowFunctionContext(
     const ExecutorDeviceType device_type,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner)
     : window_func_(window_func)
+    , aggregate_column_(nullptr)
     , partitions_(partitions)
     , elem_count_(elem_count)
     , output_(nullptr)
@@ -55,6 +65,14 @@ void WindowFunctionContext::addOrderColumn(
   order_columns_.push_back(column);
 }
 
+void WindowFunctionContext::setAggregateColumn(
+    const int8_t* column,
+    const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  CHECK(window_function_is_framed_aggregate(window_func_));
+  aggregate_column_owner_ = chunks_owner;
+  aggregate_column_ = column;
+}
+
 namespace {
 
 // Converts the sorted indices to a mapping from row position to row number.
@@ -267,20 +285,127 @@ void apply_last_value_to_partition(const int32_t* original_indices,
       original_indices, original_indices + partition_size, output_for_partition_buff);
 }
 
+// Sets the bit for the given position. Partitions are computed concurrently and the
+// bytes at their boundaries are shared, hence the atomic update.
+void set_partition_end_bit(int8_t* partition_end, const size_t pos) {
+  __sync_fetch_and_or(&partition_end[pos >> 3], static_cast<int8_t>(1 << (pos & 7)));
+}
+
 void index_to_partition_end(
-    const int8_t* partition_end,
+    int8_t* partition_end,
     const size_t off,
     const int64_t* index,
     const size_t index_size,
     const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
-  int64_t partition_end_handle = reinterpret_cast<int64_t>(partition_end);
   for (size_t i = 0; i < index_size; ++i) {
     if (advance_current_rank(comparator, index, i)) {
-      agg_count_distinct_bitmap(&partition_end_handle, off + i - 1, 0);
+      set_partition_end_bit(partition_end, off + i - 1);
     }
   }
   CHECK(index_size);
-  agg_count_distinct_bitmap(&partition_end_handle, off + index_size - 1, 0);
+  set_partition_end_bit(partition_end, off + index_size - 1);
+}
+
+// Sorts the indices with thread_count threads: equal slices are sorted concurrently, then
+// adjacent sorted runs are merged pairwise, each round of merges in parallel.
+void parallel_sort_partition(int64_t* begin,
+                             int64_t* end,
+                             const WindowFunctionContext::Comparator& comparator,
+                             const size_t thread_count) {
+  const size_t size = end - begin;
+  const size_t slice_count = std::min(thread_count, size);
+  std::vector<int64_t*> run_bounds;
+  for (size_t i = 0; i <= slice_count; ++i) {
+    run_bounds.push_back(begin + size * i / slice_count);
+  }
+  std::vector<std::future<void>> sort_threads;
+  for (size_t i = 0; i + 1 < run_bounds.size(); ++i) {
+    sort_threads.push_back(std::async(std::launch::async, [&run_bounds, &comparator, i] {
+      std::sort(run_bounds[i], run_bounds[i + 1], comparator);
+    }));
+  }
+  for (auto& sort_thread : sort_threads) {
+    sort_thread.get();
+  }
+  while (run_bounds.size() > 2) {
+    std::vector<std::future<void>> merge_threads;
+    std::vector<int64_t*> merged_run_bounds;
+    size_t i = 0;
+    for (; i + 2 < run_bounds.size(); i += 2) {
+      merged_run_bounds.push_back(run_bounds[i]);
+      merge_threads.push_back(
+          std::async(std::launch::async, [&run_bounds, &comparator, i] {
+            std::inplace_merge(
+                run_bounds[i], run_bounds[i + 1], run_bounds[i + 2], comparator);
+          }));
+    }
+    for (; i < run_bounds.size(); ++i) {
+      merged_run_bounds.push_back(run_bounds[i]);
+    }
+    for (auto& merge_thread : merge_threads) {
+      merge_thread.get();
+    }
+    run_bounds.swap(merged_run_bounds);
+  }
+}
+
+// Sorts the indices of a partition, in parallel if more than one thread is given.
+void sort_partition(int64_t* output_for_partition_buff,
+                    const size_t partition_size,
+                    const WindowFunctionContext::Comparator& comparator,
+                    const size_t thread_count) {
+  if (thread_count > 1 && partition_size > 1) {
+    parallel_sort_partition(output_for_partition_buff,
+                            output_for_partition_buff + partition_size,
+                            comparator,
+                            thread_count);
+  } else {
+    std::sort(output_for_partition_buff,
+              output_for_partition_buff + partition_size,
+              comparator);
+  }
+}
+
+// Calls compute_partition(partition_idx, sort_thread_count) for every non-empty
+// partition. Partitions large enough for a parallel sort run one at a time with all the
+// threads. The other ones are spread over the threads, which claim the next partition
+// from a shared counter so that skewed partition sizes don't leave threads idle.
+void compute_partitions(
+    const int32_t* counts,
+    const size_t partition_count,
+    const std::function<void(const size_t, const size_t)>& compute_partition) {
+  const size_t thread_count = g_enable_parallel_window_partition_compute
+                                  ? static_cast<size_t>(std::max(cpu_threads(), 1))
+                                  : 1;
+  std::vector<size_t> small_partitions;
+  for (size_t i = 0; i < partition_count; ++i) {
+    const size_t partition_size = counts[i];
+    if (partition_size == 0) {
+      continue;
+    }
+    if (thread_count > 1 && partition_size >= g_window_function_parallel_sort_threshold) {
+      compute_partition(i, thread_count);
+    } else {
+      small_partitions.push_back(i);
+    }
+  }
+  std::atomic<size_t> next_partition{0};
+  const auto compute_small_partitions = [&small_partitions,
+                                         &next_partition,
+                                         &compute_partition]() {
+    for (size_t i = next_partition++; i < small_partitions.size(); i = next_partition++) {
+      compute_partition(small_partitions[i], 1);
+    }
+  };
+  const size_t worker_count = std::min(thread_count, small_partitions.size());
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < worker_count; ++i) {
+    workers.push_back(std::async(std::launch::async, compute_small_partitions));
+  }
+  compute_small_partitions();
+  for (auto& worker : workers) {
+    worker.get();
+  }
 }
 
 bool pos_is_set(const int64_t bitset, const int64_t pos) {
@@ -384,7 +509,8 @@ extern "C" void add_window_pending_output(void* pending_output, const int64_t ha
 // Returns true iff the aggregate window function requires special multiplicity handling
 // to ensure that peer rows have the same value for the window function.
 bool window_function_requires_peer_handling(const Analyzer::WindowFunction* window_func) {
-  if (!window_function_is_aggregate(window_func->getKind())) {
+  if (!window_function_is_aggregate(window_func->getKind()) ||
+      window_function_is_framed_aggregate(window_func)) {
     return false;
   }
   if (window_func->getOrderKeys().empty()) {
@@ -405,6 +531,10 @@ void WindowFunctionContext::compute() {
   CHECK(!output_);
   output_ = static_cast<int8_t*>(row_set_mem_owner_->allocate(
       elem_count_ * window_function_buffer_element_size(window_func_->getKind())));
+  if (window_function_is_framed_aggregate(window_func_)) {
+    computeFramedAggregate();
+    return;
+  }
   if (window_function_is_aggregate(window_func_->getKind())) {
     fillPartitionStart();
     if (window_function_requires_peer_handling(window_func_)) {
@@ -412,73 +542,92 @@ void WindowFunctionContext::compute() {
     }
   }
   std::unique_ptr<int64_t[]> scratchpad(new int64_t[elem_count_]);
-  int64_t off = 0;
-  for (size_t i = 0; i < partitionCount(); ++i) {
-    auto partition_size = counts()[i];
-    if (partition_size == 0) {
-      continue;
-    }
-    auto output_for_partition_buff = scratchpad.get() + offsets()[i];
-    std::iota(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              int64_t(0));
-    std::vector<Comparator> comparators;
-    const auto& order_keys = window_func_->getOrderKeys();
-    const auto& collation = window_func_->getCollation();
-    CHECK_EQ(order_keys.size(), collation.size());
-    for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
-         ++order_column_idx) {
-      auto order_column_buffer = order_columns_[order_column_idx];
-      const auto order_col =
-          dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
-      CHECK(order_col);
-      const auto& order_col_collation = collation[order_column_idx];
-      const auto asc_comparator = makeComparator(order_col,
-                                                 order_column_buffer,
-                                                 payload() + offsets()[i],
-                                                 order_col_collation.nulls_first);
-      auto comparator = asc_comparator;
-      if (order_col_collation.is_desc) {
-        comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
-          return asc_comparator(rhs, lhs);
-        };
-      }
-      comparators.push_back(comparator);
-    }
-    const auto col_tuple_comparator = [&comparators](const int64_t lhs,
-                                                     const int64_t rhs) {
-      for (const auto& comparator : comparators) {
-        if (comparator(lhs, rhs)) {
-          return true;
-        }
-      }
-      return false;
-    };
-    std::sort(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              col_tuple_comparator);
-    computePartition(output_for_partition_buff,
-                     partition_size,
-                     off,
-                     window_func_,
-                     col_tuple_comparator);
-    if (window_function_is_value(window_func_->getKind()) ||
-        window_function_is_aggregate(window_func_->getKind())) {
-      off += partition_size;
-    }
-  }
-  if (window_function_is_value(window_func_->getKind()) ||
-      window_function_is_aggregate(window_func_->getKind())) {
-    CHECK_EQ(static_cast<size_t>(off), elem_count_);
-  }
+  compute_partitions(
+      counts(),
+      partitionCount(),
+      [this, &scratchpad](const size_t partition_idx, const size_t sort_thread_count) {
+        sortAndComputePartition(partition_idx,
+                                scratchpad.get() + offsets()[partition_idx],
+                                sort_thread_count);
+      });
   auto output_i64 = reinterpret_cast<int64_t*>(output_);
   if (window_function_is_aggregate(window_func_->getKind())) {
     std::copy(scratchpad.get(), scratchpad.get() + elem_count_, output_i64);
-  } else {
-    for (size_t i = 0; i < elem_count_; ++i) {
+    return;
+  }
+  const size_t thread_count =
+      g_enable_parallel_window_partition_compute
+          ? std::min(static_cast<size_t>(std::max(cpu_threads(), 1)), elem_count_)
+          : 1;
+  const auto scatter_output = [this, &scratchpad, output_i64, thread_count](
+                                  const size_t thread_idx) {
+    const size_t begin = elem_count_ * thread_idx / thread_count;
+    const size_t end = elem_count_ * (thread_idx + 1) / thread_count;
+    for (size_t i = begin; i < end; ++i) {
       output_i64[payload()[i]] = scratchpad[i];
     }
+  };
+  std::vector<std::future<void>> scatter_threads;
+  for (size_t i = 1; i < thread_count; ++i) {
+    scatter_threads.push_back(std::async(std::launch::async, scatter_output, i));
+  }
+  if (thread_count) {
+    scatter_output(0);
   }
+  for (auto& scatter_thread : scatter_threads) {
+    scatter_thread.get();
+  }
+}
+
+void WindowFunctionContext::sortAndComputePartition(const size_t partition_idx,
+                                                    int64_t* output_for_partition_buff,
+                                                    const size_t sort_thread_count) {
+  const size_t partition_size = counts()[partition_idx];
+  std::iota(
+      output_for_partition_buff, output_for_partition_buff + partition_size, int64_t(0));
+  const auto col_tuple_comparator = makePartitionComparator(partition_idx);
+  sort_partition(
+      output_for_partition_buff, partition_size, col_tuple_comparator, sort_thread_count);
+  computePartition(output_for_partition_buff,
+                   partition_size,
+                   offsets()[partition_idx],
+                   window_func_,
+                   col_tuple_comparator);
+}
+
+WindowFunctionContext::Comparator WindowFunctionContext::makePartitionComparator(
+    const size_t partition_idx) const {
+  std::vector<Comparator> comparators;
+  const auto& order_keys = window_func_->getOrderKeys();
+  const auto& collation = window_func_->getCollation();
+  CHECK_EQ(order_keys.size(), collation.size());
+  for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
+       ++order_column_idx) {
+    auto order_column_buffer = order_columns_[order_column_idx];
+    const auto order_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
+    CHECK(order_col);
+    const auto& order_col_collation = collation[order_column_idx];
+    const auto asc_comparator = makeComparator(order_col,
+                                               order_column_buffer,
+                                               payload() + offsets()[partition_idx],
+                                               order_col_collation.nulls_first);
+    auto comparator = asc_comparator;
+    if (order_col_collation.is_desc) {
+      comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
+        return asc_comparator(rhs, lhs);
+      };
+    }
+    comparators.push_back(comparator);
+  }
+  return [comparators](const int64_t lhs, const int64_t rhs) {
+    for (const auto& comparator : comparators) {
+      if (comparator(lhs, rhs)) {
+        return true;
+      }
+    }
+    return false;
+  };
 }
 
 const Analyzer::WindowFunction* WindowFunctionContext::getWindowFunction() const {
@@ -720,7 +869,7 @@ void WindowFunctionContext::computePartition(
       const auto partition_row_offsets = payload() + off;
       if (window_function_requires_peer_handling(window_func)) {
         index_to_partition_end(
-            partitionEnd(), off, output_for_partition_buff, partition_size, comparator);
+            partition_end_, off, output_for_partition_buff, partition_size, comparator);
       }
       apply_permutation_to_partition(
           output_for_partition_buff, partition_row_offsets, partition_size);
@@ -776,6 +925,448 @@ void WindowFunctionContext::fillPartitionEnd() {
   }
 }
 
+namespace {
+
+// Rows [begin, end) of a partition, in window order, an aggregate is evaluated over.
+struct WindowFrameRange {
+  size_t begin;
+  size_t end;
+};
+
+// Returns true for the types of the aggregated columns of framed aggregates.
+bool is_supported_frame_aggregate_type(const SQLTypeInfo& ti) {
+  return (ti.is_integer() || ti.is_decimal() || ti.is_boolean() || ti.is_fp() ||
+          ti.is_time()) &&
+         ti.get_compression() != kENCODING_DATE_IN_DAYS;
+}
+
+// Reads an integer, decimal, boolean or time value, std::nullopt for nulls.
+std::optional<int64_t> get_int_column_value(const int8_t* column,
+                                            const SQLTypeInfo& ti,
+                                            const int64_t row) {
+  int64_t val{0};
+  switch (ti.get_size()) {
+    case 8: {
+      val = reinterpret_cast<const int64_t*>(column)[row];
+      break;
+    }
+    case 4: {
+      val = reinterpret_cast<const int32_t*>(column)[row];
+      break;
+    }
+    case 2: {
+      val = reinterpret_cast<const int16_t*>(column)[row];
+      break;
+    }
+    case 1: {
+      val = column[row];
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid type size: " << ti.get_size();
+    }
+  }
+  if (val == inline_fixed_encoding_null_val(ti)) {
+    return std::nullopt;
+  }
+  return val;
+}
+
+// Reads a floating point value, std::nullopt for nulls.
+std::optional<double> get_fp_column_value(const int8_t* column,
+                                          const SQLTypeInfo& ti,
+                                          const int64_t row) {
+  const double val = ti.get_type() == kFLOAT
+                         ? reinterpret_cast<const float*>(column)[row]
+                         : reinterpret_cast<const double*>(column)[row];
+  if (val == inline_fp_null_val(ti)) {
+    return std::nullopt;
+  }
+  return val;
+}
+
+// Reads a numeric value with decimals scaled down, std::nullopt for nulls.
+std::optional<double> get_numeric_column_value(const int8_t* column,
+                                               const SQLTypeInfo& ti,
+                                               const int64_t row) {
+  if (ti.is_fp()) {
+    return get_fp_column_value(column, ti, row);
+  }
+  const auto val = get_int_column_value(column, ti, row);
+  if (!val) {
+    return std::nullopt;
+  }
+  return ti.is_decimal() ? static_cast<double>(*val) / exp_to_scale(ti.get_scale())
+                         : static_cast<double>(*val);
+}
+
+// Computes the peer group of every row of a partition sorted by the comparator.
+std::vector<WindowFrameRange> index_to_peer_ranges(
+    const int64_t* index,
+    const size_t index_size,
+    const WindowFunctionContext::Comparator& comparator) {
+  std::vector<WindowFrameRange> peers(index_size);
+  size_t peers_begin = 0;
+  for (size_t i = 1; i <= index_size; ++i) {
+    if (i == index_size || comparator(index[i - 1], index[i])) {
+      std::fill(peers.begin() + peers_begin,
+                peers.begin() + i,
+                WindowFrameRange{peers_begin, i});
+      peers_begin = i;
+    }
+  }
+  return peers;
+}
+
+// Computes the frame of every row of a partition sorted by the comparator. RANGE frames
+// with offsets need the order key of every row, negated for descending order so that
+// preceding rows always have smaller keys.
+std::vector<WindowFrameRange> index_to_frame_ranges(
+    const Analyzer::WindowFrame& frame,
+    const int64_t* index,
+    const size_t index_size,
+    const WindowFunctionContext::Comparator& comparator,
+    const std::vector<std::optional<double>>& range_keys) {
+  using BoundType = Analyzer::WindowFrameBound::Type;
+  std::vector<WindowFrameRange> frames(index_size);
+  const auto set_frame =
+      [&frames](const size_t i, const int64_t begin, const int64_t end) {
+        frames[i] = begin < end ? WindowFrameRange{static_cast<size_t>(begin),
+                                                   static_cast<size_t>(end)}
+                                : WindowFrameRange{0, 0};
+      };
+  const auto partition_size = static_cast<int64_t>(index_size);
+  if (frame.is_rows) {
+    // Returns the row of the bound, not clamped to the partition.
+    const auto row_bound = [partition_size](const Analyzer::WindowFrameBound& bound,
+                                            const int64_t row) {
+      const auto offset = static_cast<int64_t>(
+          std::min(bound.offset, static_cast<double>(partition_size)));
+      switch (bound.type) {
+        case BoundType::UnboundedPreceding: {
+          return int64_t(0);
+        }
+        case BoundType::Preceding: {
+          return row - offset;
+        }
+        case BoundType::Following: {
+          return row + offset;
+        }
+        case BoundType::UnboundedFollowing: {
+          return partition_size - 1;
+        }
+        default: {
+          return row;
+        }
+      }
+    };
+    for (int64_t i = 0; i < partition_size; ++i) {
+      set_frame(i,
+                std::max(row_bound(frame.lower, i), int64_t(0)),
+                std::min(row_bound(frame.upper, i) + 1, partition_size));
+    }
+    return frames;
+  }
+  const auto peers = index_to_peer_ranges(index, index_size, comparator);
+  // Rows with a null order key are contiguous, the offsets only apply to the others.
+  auto keys_begin = range_keys.begin();
+  while (keys_begin != range_keys.end() && !*keys_begin) {
+    ++keys_begin;
+  }
+  auto keys_end = keys_begin;
+  while (keys_end != range_keys.end() && *keys_end) {
+    ++keys_end;
+  }
+  const auto range_bound = [&](const Analyzer::WindowFrameBound& bound,
+                               const size_t row,
+                               const bool is_lower) -> int64_t {
+    switch (bound.type) {
+      case BoundType::UnboundedPreceding: {
+        return 0;
+      }
+      case BoundType::UnboundedFollowing: {
+        return partition_size;
+      }
+      case BoundType::CurrentRow: {
+        return is_lower ? peers[row].begin : peers[row].end;
+      }
+      default: {
+        break;
+      }
+    }
+    CHECK_EQ(range_keys.size(), index_size);
+    if (!range_keys[row]) {
+      // Rows with a null order key are only within an offset of each other.
+      return is_lower ? peers[row].begin : peers[row].end;
+    }
+    const double key = bound.type == BoundType::Preceding
+                           ? *range_keys[row] - bound.offset
+                           : *range_keys[row] + bound.offset;
+    const auto bound_it =
+        is_lower ? std::partition_point(keys_begin,
+                                        keys_end,
+                                        [key](const std::optional<double>& range_key) {
+                                          return *range_key < key;
+                                        })
+                 : std::partition_point(keys_begin,
+                                        keys_end,
+                                        [key](const std::optional<double>& range_key) {
+                                          return *range_key <= key;
+                                        });
+    return bound_it - range_keys.begin();
+  };
+  for (size_t i = 0; i < index_size; ++i) {
+    set_frame(i, range_bound(frame.lower, i, true), range_bound(frame.upper, i, false));
+  }
+  return frames;
+}
+
+// Segment tree over the values of a partition in window order, aggregates any range of
+// consecutive rows in O(log n). The combine function must be commutative.
+template <class T, class Combine>
+class SegmentTree {
+ public:
+  SegmentTree(const std::vector<T>& leaves, const T identity, Combine combine)
+      : leaf_count_(leaves.size())
+      , identity_(identity)
+      , combine_(combine)
+      , nodes_(2 * leaves.size(), identity) {
+    std::copy(leaves.begin(), leaves.end(), nodes_.begin() + leaf_count_);
+    for (size_t i = leaf_count_ ? leaf_count_ - 1 : 0; i > 0; --i) {
+      nodes_[i] = combine_(nodes_[2 * i], nodes_[2 * i + 1]);
+    }
+  }
+
+  // Returns the aggregate of the leaves in [begin, end).
+  T query(size_t begin, size_t end) const {
+    T result = identity_;
+    for (begin += leaf_count_, end += leaf_count_; begin < end; begin /= 2, end /= 2) {
+      if (begin & 1) {
+        result = combine_(result, nodes_[begin++]);
+      }
+      if (end & 1) {
+        result = combine_(result, nodes_[--end]);
+      }
+    }
+    return result;
+  }
+
+ private:
+  const size_t leaf_count_;
+  const T identity_;
+  const Combine combine_;
+  std::vector<T> nodes_;
+};
+
+// Aggregates the non-null values within every frame, std::nullopt for frames without any.
+template <class T, class Combine>
+std::vector<std::optional<T>> aggregate_frames(
+    const std::vector<std::optional<T>>& values,
+    const std::vector<size_t>& value_count_prefix,
+    const std::vector<WindowFrameRange>& frames,
+    const T identity,
+    Combine combine) {
+  std::vector<T> leaves(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    leaves[i] = values[i] ? *values[i] : identity;
+  }
+  const SegmentTree<T, Combine> tree(leaves, identity, combine);
+  std::vector<std::optional<T>> aggregates(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const auto& frame = frames[i];
+    if (value_count_prefix[frame.end] != value_count_prefix[frame.begin]) {
+      aggregates[i] = tree.query(frame.begin, frame.end);
+    }
+  }
+  return aggregates;
+}
+
+template <class T>
+void write_framed_output(int64_t* output, const int32_t row, const T val) {
+  output[row] = val;
+}
+
+template <>
+void write_framed_output<double>(int64_t* output, const int32_t row, const double val) {
+  *reinterpret_cast<double*>(may_alias_ptr(&output[row])) = val;
+}
+
+// Evaluates the aggregate over the frame of every row of a partition, given the
+// aggregated values in window order, and writes the results to the rows of the output.
+template <class T>
+void apply_framed_aggregate_to_partition(const Analyzer::WindowFunction* window_func,
+                                         const std::vector<std::optional<T>>& values,
+                                         const std::vector<WindowFrameRange>& frames,
+                                         const double value_scale,
+                                         const int32_t* original_indices,
+                                         const int64_t* index,
+                                         int64_t* output) {
+  std::vector<size_t> value_count_prefix(values.size() + 1, 0);
+  for (size_t i = 0; i < values.size(); ++i) {
+    value_count_prefix[i + 1] = value_count_prefix[i] + (values[i] ? 1 : 0);
+  }
+  const auto value_count = [&value_count_prefix](const WindowFrameRange& frame) {
+    return value_count_prefix[frame.end] - value_count_prefix[frame.begin];
+  };
+  const auto kind = window_func->getKind();
+  if (kind == SqlWindowFunctionKind::COUNT) {
+    for (size_t i = 0; i < frames.size(); ++i) {
+      output[original_indices[index[i]]] = value_count(frames[i]);
+    }
+    return;
+  }
+  std::vector<std::optional<T>> aggregates;
+  switch (kind) {
+    case SqlWindowFunctionKind::MIN: {
+      aggregates = aggregate_frames(
+          values,
+          value_count_prefix,
+          frames,
+          std::numeric_limits<T>::max(),
+          [](const T lhs, const T rhs) { return std::min(lhs, rhs); });
+      break;
+    }
+    case SqlWindowFunctionKind::MAX: {
+      aggregates = aggregate_frames(
+          values,
+          value_count_prefix,
+          frames,
+          std::numeric_limits<T>::lowest(),
+          [](const T lhs, const T rhs) { return std::max(lhs, rhs); });
+      break;
+    }
+    case SqlWindowFunctionKind::AVG:
+    case SqlWindowFunctionKind::SUM:
+    case SqlWindowFunctionKind::SUM_INTERNAL: {
+      aggregates = aggregate_frames(values,
+                                    value_count_prefix,
+                                    frames,
+                                    T(0),
+                                    [](const T lhs, const T rhs) { return lhs + rhs; });
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid window function kind";
+    }
+  }
+  const auto& window_func_ti = window_func->get_type_info();
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const auto row = original_indices[index[i]];
+    const auto& aggregate = aggregates[i];
+    if (kind == SqlWindowFunctionKind::AVG) {
+      write_framed_output<double>(output,
+                                  row,
+                                  aggregate ? static_cast<double>(*aggregate) /
+                                                  value_scale / value_count(frames[i])
+                                            : inline_fp_null_val(window_func_ti));
+    } else if (aggregate || kind == SqlWindowFunctionKind::SUM_INTERNAL) {
+      write_framed_output<T>(output, row, aggregate ? *aggregate : T(0));
+    } else if (window_func_ti.is_fp()) {
+      write_framed_output<double>(output, row, inline_fp_null_val(window_func_ti));
+    } else {
+      write_framed_output<int64_t>(output, row, inline_int_null_val(window_func_ti));
+    }
+  }
+}
+
+}  // namespace
+
+void WindowFunctionContext::computeFramedAggregate() {
+  const auto& args = window_func_->getArgs();
+  if (!args.empty()) {
+    CHECK(aggregate_column_);
+    if (!is_supported_frame_aggregate_type(args.front()->get_type_info())) {
+      throw std::runtime_error("Type not supported yet");
+    }
+  }
+  std::unique_ptr<int64_t[]> scratchpad(new int64_t[elem_count_]);
+  compute_partitions(
+      counts(),
+      partitionCount(),
+      [this, &scratchpad](const size_t partition_idx, const size_t sort_thread_count) {
+        computeFramedAggregatePartition(partition_idx,
+                                        scratchpad.get() + offsets()[partition_idx],
+                                        sort_thread_count);
+      });
+}
+
+void WindowFunctionContext::computeFramedAggregatePartition(
+    const size_t partition_idx,
+    int64_t* output_for_partition_buff,
+    const size_t sort_thread_count) {
+  const size_t partition_size = counts()[partition_idx];
+  std::iota(
+      output_for_partition_buff, output_for_partition_buff + partition_size, int64_t(0));
+  const auto comparator = makePartitionComparator(partition_idx);
+  sort_partition(
+      output_for_partition_buff, partition_size, comparator, sort_thread_count);
+  const auto partition_row_offsets = payload() + offsets()[partition_idx];
+  const auto& frame = *window_func_->getFrame();
+  std::vector<std::optional<double>> range_keys;
+  if (!frame.is_rows && frame.hasOffset()) {
+    const auto& order_keys = window_func_->getOrderKeys();
+    CHECK_EQ(order_keys.size(), size_t(1));
+    CHECK_EQ(order_columns_.size(), size_t(1));
+    const auto& order_key_ti = order_keys.front()->get_type_info();
+    if (!is_supported_frame_aggregate_type(order_key_ti)) {
+      throw std::runtime_error("Type not supported yet");
+    }
+    const bool is_desc = window_func_->getCollation().front().is_desc;
+    range_keys.reserve(partition_size);
+    for (size_t i = 0; i < partition_size; ++i) {
+      auto range_key =
+          get_numeric_column_value(order_columns_.front(),
+                                   order_key_ti,
+                                   partition_row_offsets[output_for_partition_buff[i]]);
+      if (range_key && is_desc) {
+        range_key = -*range_key;
+      }
+      range_keys.push_back(range_key);
+    }
+  }
+  const auto frames = index_to_frame_ranges(
+      frame, output_for_partition_buff, partition_size, comparator, range_keys);
+  auto output = reinterpret_cast<int64_t*>(output_);
+  const auto& args = window_func_->getArgs();
+  if (args.empty()) {
+    CHECK(window_func_->getKind() == SqlWindowFunctionKind::COUNT);
+    for (size_t i = 0; i < partition_size; ++i) {
+      output[partition_row_offsets[output_for_partition_buff[i]]] =
+          frames[i].end - frames[i].begin;
+    }
+    return;
+  }
+  const auto& arg_ti = args.front()->get_type_info();
+  if (arg_ti.is_fp()) {
+    std::vector<std::optional<double>> values(partition_size);
+    for (size_t i = 0; i < partition_size; ++i) {
+      values[i] = get_fp_column_value(
+          aggregate_column_, arg_ti, partition_row_offsets[output_for_partition_buff[i]]);
+    }
+    apply_framed_aggregate_to_partition(window_func_,
+                                        values,
+                                        frames,
+                                        1,
+                                        partition_row_offsets,
+                                        output_for_partition_buff,
+                                        output);
+    return;
+  }
+  std::vector<std::optional<int64_t>> values(partition_size);
+  for (size_t i = 0; i < partition_size; ++i) {
+    values[i] = get_int_column_value(
+        aggregate_column_, arg_ti, partition_row_offsets[output_for_partition_buff[i]]);
+  }
+  apply_framed_aggregate_to_partition(
+      window_func_,
+      values,
+      frames,
+      arg_ti.is_decimal() ? exp_to_scale(arg_ti.get_scale()) : 1,
+      partition_row_offsets,
+      output_for_partition_buff,
+      output);
+}
+
 const int32_t* WindowFunctionContext::payload() const {
   return reinterpret_cast<const int32_t*>(
       partitions_->getJoinHashBuffer(device_type_, 0) + partitions_->payloadBufferOff());
@@ -55,14 +55,21 @@ inline bool window_function_is_aggregate(const SqlWindowFunctionKind kind) {
   }
 }
 
+// Returns true for aggregate window functions over an explicit frame.
+inline bool window_function_is_framed_aggregate(
+    const Analyzer::WindowFunction* window_func) {
+  return window_function_is_aggregate(window_func->getKind()) &&
+         window_func->getFrame().has_value();
+}
+
 class Executor;
 
 // Per-window function context which encapsulates the logic for computing the various
 // window function kinds and keeps ownership of buffers which contain the results. For
-// rank functions, the code generated for the projection simply reads the values and
-// writes them to the result set. For value and aggregate functions, only the iteration
-// order is written to the buffer, the rest is handled by generating code in a similar way
-// we do for non-window queries.
+// rank functions and aggregates over an explicit frame, the code generated for the
+// projection simply reads the values and writes them to the result set. For value and
+// other aggregate functions, only the iteration order is written to the buffer, the rest
+// is handled by generating code in a similar way we do for non-window queries.
 class WindowFunctionContext {
  public:
   WindowFunctionContext(const Analyzer::WindowFunction* window_func,
@@ -82,7 +89,16 @@ class WindowFunctionContext {
                       const Analyzer::ColumnVar* col_var,
                       const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
+  // Adds the buffer of the aggregated column of a framed aggregate to the context and
+  // keeps ownership of it.
+  void setAggregateColumn(
+      const int8_t* column,
+      const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
   // Computes the window function result to be used during the actual projection query.
+  // Partitions are sorted and evaluated concurrently; partitions with at least
+  // g_window_function_parallel_sort_threshold rows are processed one at a time instead,
+  // with all the threads sorting them.
   void compute();
 
   // Returns a pointer to the window function associated with this context.
@@ -131,6 +147,16 @@ class WindowFunctionContext {
                                    const int32_t* partition_indices,
                                    const bool nulls_first);
 
+  // Returns the comparator which orders the rows of the given partition, identified by
+  // their index in the partition, by the order keys.
+  Comparator makePartitionComparator(const size_t partition_idx) const;
+
+  // Sorts the given partition with up to sort_thread_count threads and evaluates the
+  // window function over it.
+  void sortAndComputePartition(const size_t partition_idx,
+                               int64_t* output_for_partition_buff,
+                               const size_t sort_thread_count);
+
   void computePartition(
       int64_t* output_for_partition_buff,
       const size_t partition_size,
@@ -138,6 +164,13 @@ class WindowFunctionContext {
       const Analyzer::WindowFunction* window_func,
       const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator);
 
+  // Evaluates an aggregate over an explicit frame for every row.
+  void computeFramedAggregate();
+
+  void computeFramedAggregatePartition(const size_t partition_idx,
+                                       int64_t* output_for_partition_buff,
+                                       const size_t sort_thread_count);
+
   void fillPartitionStart();
 
   void fillPartitionEnd();
@@ -155,6 +188,10 @@ class WindowFunctionContext {
   std::vector<std::vector<std::shared_ptr<Chunk_NS::Chunk>>> order_columns_owner_;
   // Order column buffers.
   std::vector<const int8_t*> order_columns_;
+  // Keeps ownership of the aggregated column of a framed aggregate.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> aggregate_column_owner_;
+  // Aggregated column buffer of a framed aggregate, null for COUNT(*).
+  const int8_t* aggregate_column_;
   // Hash table which contains the partitions specified by the window.
   std::shared_ptr<JoinHashTableInterface> partitions_;
   // The number of elements in the table.
@@ -59,6 +59,22 @@ llvm::Value* Executor::codegenWindowFunction(const size_t target_index,
     case SqlWindowFunctionKind::MAX:
     case SqlWindowFunctionKind::SUM:
     case SqlWindowFunctionKind::COUNT: {
+      if (window_function_is_framed_aggregate(window_func)) {
+        // Computed upfront for every row, same as the rank functions.
+        const auto output_lv = cgen_state_->llInt(
+            reinterpret_cast<const int64_t>(window_func_context->output()));
+        const auto& window_func_ti = window_func->get_type_info();
+        if (!window_func_ti.is_fp()) {
+          return cgen_state_->emitCall("row_number_window_func",
+                                       {output_lv, code_generator.posArg(nullptr)});
+        }
+        const auto double_lv = cgen_state_->emitCall(
+            "percent_window_func", {output_lv, code_generator.posArg(nullptr)});
+        return window_func_ti.get_type() == kFLOAT
+                   ? cgen_state_->ir_builder_.CreateFPTrunc(
+                         double_lv, llvm::Type::getFloatTy(cgen_state_->context_))
+                   : double_lv;
+      }
       return codegenWindowFunctionAggregate(co);
     }
     default: {
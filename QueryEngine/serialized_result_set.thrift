@@ -23,7 +23,8 @@ struct TColSlotContext {
 enum TCountDistinctImplType {
   Invalid,
   Bitmap,
-  StdSet
+  StdSet,
+  HllSketch
 }
 
 struct TCountDistinctDescriptor {
@@ -54,7 +55,7 @@ struct TResultSetBufferDescriptor {
 }
 
 enum TAggKind {
-  AVG, MIN, MAX, SUM, COUNT, APPROX_COUNT_DISTINCT, SAMPLE
+  AVG, MIN, MAX, SUM, COUNT, APPROX_COUNT_DISTINCT, SAMPLE, APPROX_PERCENTILE
 }
 
 struct TTargetInfo {
@@ -596,12 +596,11 @@ std::shared_ptr<ExecutionResult> QueryRunner::runSelectQuery(
   return result;
 }
 
-const std::shared_ptr<std::vector<int32_t>>& QueryRunner::getCachedJoinHashTable(
-    size_t idx) {
+std::shared_ptr<std::vector<int32_t>> QueryRunner::getCachedJoinHashTable(size_t idx) {
   return JoinHashTable::getCachedHashTable(idx);
 };
 
-const std::shared_ptr<std::vector<int8_t>>& QueryRunner::getCachedBaselineHashTable(
+std::shared_ptr<std::vector<int8_t>> QueryRunner::getCachedBaselineHashTable(
     size_t idx) {
   return BaselineJoinHashTable::getCachedHashTable(idx);
 };
@@ -201,6 +201,47 @@ bool BloscCompressor::decompressOrMemcpy(const uint8_t* compressed_buffer,
   return false;
 }
 
+int64_t BloscCompressor::compressWithContext(const uint8_t* buffer,
+                                             const size_t buffer_size,
+                                             uint8_t* compressed_buffer,
+                                             const size_t compressed_buffer_size,
+                                             const size_t type_size,
+                                             const char* compressor_name,
+                                             const int compression_level) {
+  if (compressed_buffer_size < BLOSC_MIN_HEADER_LENGTH) {
+    return 0;
+  }
+  const auto compressed_len = blosc_compress_ctx(compression_level,
+                                                 BLOSC_SHUFFLE,
+                                                 type_size,
+                                                 buffer_size,
+                                                 buffer,
+                                                 compressed_buffer,
+                                                 compressed_buffer_size,
+                                                 compressor_name,
+                                                 0,
+                                                 1);
+  if (compressed_len < 0) {
+    throw CompressionFailedError(std::string("failed to compress buffer of length ") +
+                                 std::to_string(buffer_size) + " with " +
+                                 compressor_name);
+  }
+  return compressed_len;
+}
+
+size_t BloscCompressor::decompressWithContext(const uint8_t* compressed_buffer,
+                                              uint8_t* decompressed_buffer,
+                                              const size_t decompressed_buffer_size) {
+  const auto decompressed_len = blosc_decompress_ctx(
+      compressed_buffer, decompressed_buffer, decompressed_buffer_size, 1);
+  if (decompressed_len <= 0) {
+    throw CompressionFailedError(
+        std::string("failed to decompress buffer into a buffer of length ") +
+        std::to_string(decompressed_buffer_size));
+  }
+  return decompressed_len;
+}
+
 void BloscCompressor::getBloscBufferSizes(const uint8_t* data_ptr,
                                           size_t* num_bytes_compressed,
                                           size_t* num_bytes_uncompressed,
@@ -77,6 +77,22 @@ class BloscCompressor {
                            size_t* num_bytes_uncompressed,
                            size_t* block_size);
 
+  // Compress and decompress with a context of their own: they neither use nor change the
+  // global state of the library, like the compressor set with setCompressor, and can run
+  // concurrently. compressWithContext shuffles the bytes of the elements of type_size
+  // bytes of the buffer, and returns 0 if the compressed buffer doesn't fit in
+  // compressed_buffer_size bytes.
+  static int64_t compressWithContext(const uint8_t* buffer,
+                                     const size_t buffer_size,
+                                     uint8_t* compressed_buffer,
+                                     const size_t compressed_buffer_size,
+                                     const size_t type_size,
+                                     const char* compressor_name,
+                                     const int compression_level);
+  static size_t decompressWithContext(const uint8_t* compressed_buffer,
+                                      uint8_t* decompressed_buffer,
+                                      const size_t decompressed_buffer_size);
+
   int setThreads(size_t num_threads);
 
   int setCompressor(std::string& compressor);
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    EncodedChunkLayout.h
+ * @brief   Chunk buffer layouts for run-length (RL) and frame-of-reference (DIFF)
+ *          encoded columns, shared by the encoders, ChunkIter and the runtime decoders.
+ *
+ * An RL chunk is a RunLengthChunkHeader followed by num_runs RunLengthEntry<T> records,
+ * where T is the storage type of the column (1 to 8 bytes). Runs are sorted by their
+ * exclusive end row, so the value of row `pos` is the value of the first run whose
+ * run_end is greater than `pos`. Nulls are stored as the null sentinel of T. A chunk
+ * whose runs would take more space than one T per row stores one T per row instead,
+ * like FIXED encoding, which its header marks with num_runs == kRunLengthPlainChunk.
+ *
+ * A DIFF chunk is a FrameOfReferenceChunkHeader followed by one fixed width delta per
+ * row. The value of a row is base + delta; the minimum value of the delta type is
+ * reserved for nulls, like for FIXED encoding.
+ */
+
+#ifndef SHARED_ENCODEDCHUNKLAYOUT_H
+#define SHARED_ENCODEDCHUNKLAYOUT_H
+
+#include "funcannotations.h"
+
+#include <cstdint>
+
+// num_runs of a chunk which stores one value per row instead of runs.
+constexpr int64_t kRunLengthPlainChunk{-1};
+
+// A chunk keeps its runs while it has fewer rows than this, so that the first small
+// appends of a column with long runs don't turn it into a plain chunk for good.
+constexpr int64_t kRunLengthMinRowsForPlain{4096};
+
+struct RunLengthChunkHeader {
+  int64_t num_runs;
+  int64_t num_rows;
+};
+
+template <typename T>
+struct RunLengthEntry {
+  T value;
+  int32_t run_end;
+};
+
+struct FrameOfReferenceChunkHeader {
+  int64_t base;
+};
+
+DEVICE inline const RunLengthChunkHeader* rle_chunk_header(const int8_t* chunk) {
+  return reinterpret_cast<const RunLengthChunkHeader*>(chunk);
+}
+
+DEVICE inline bool rle_chunk_is_plain(const int8_t* chunk) {
+  return rle_chunk_header(chunk)->num_runs == kRunLengthPlainChunk;
+}
+
+template <typename T>
+DEVICE inline const RunLengthEntry<T>* rle_chunk_runs(const int8_t* chunk) {
+  return reinterpret_cast<const RunLengthEntry<T>*>(chunk + sizeof(RunLengthChunkHeader));
+}
+
+template <typename T>
+DEVICE inline const T* rle_chunk_plain_values(const int8_t* chunk) {
+  return reinterpret_cast<const T*>(chunk + sizeof(RunLengthChunkHeader));
+}
+
+// Returns the index of the run containing row `pos`, which must be in range. The search
+// starts from the run `pos` would fall in if all runs had the same length and gallops
+// from there, so it only touches a couple of runs when run lengths are regular.
+template <typename T>
+DEVICE inline int64_t rle_find_run(const int8_t* chunk, const int64_t pos) {
+  const auto header = rle_chunk_header(chunk);
+  const auto runs = rle_chunk_runs<T>(chunk);
+  const int64_t last = header->num_runs - 1;
+  int64_t guess = pos * header->num_runs / header->num_rows;
+  guess = guess < last ? guess : last;
+  int64_t lo = guess;
+  int64_t hi = guess;
+  int64_t step = 1;
+  if (runs[guess].run_end <= pos) {
+    lo = hi = guess + 1;
+    while (hi < last && runs[hi].run_end <= pos) {
+      lo = hi + 1;
+      hi += step;
+      step *= 2;
+    }
+    hi = hi < last ? hi : last;
+  } else {
+    while (lo > 0 && runs[lo - 1].run_end > pos) {
+      hi = lo - 1;
+      lo = hi > step ? hi - step : 0;
+      step *= 2;
+    }
+  }
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    if (runs[mid].run_end <= pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename T>
+DEVICE inline int64_t rle_decode_typed_at(const int8_t* chunk, const int64_t pos) {
+  if (rle_chunk_is_plain(chunk)) {
+    return rle_chunk_plain_values<T>(chunk)[pos];
+  }
+  return rle_chunk_runs<T>(chunk)[rle_find_run<T>(chunk, pos)].value;
+}
+
+// Decodes row `pos` of a chunk whose values are byte_width wide, nulls come out as the
+// sign-extended null sentinel of the storage type, which is the one of the logical type.
+DEVICE inline int64_t rle_decode_at(const int8_t* chunk,
+                                    const int32_t byte_width,
+                                    const int64_t pos) {
+  switch (byte_width) {
+    case 1:
+      return rle_decode_typed_at<int8_t>(chunk, pos);
+    case 2:
+      return rle_decode_typed_at<int16_t>(chunk, pos);
+    case 4:
+      return rle_decode_typed_at<int32_t>(chunk, pos);
+    default:
+      return rle_decode_typed_at<int64_t>(chunk, pos);
+  }
+}
+
+DEVICE inline int64_t for_decode_at(const int8_t* chunk,
+                                    const int32_t byte_width,
+                                    const int64_t null_val,
+                                    const int64_t ret_null_val,
+                                    const int64_t pos) {
+  const auto deltas = chunk + sizeof(FrameOfReferenceChunkHeader);
+  int64_t delta;
+  switch (byte_width) {
+    case 1:
+      delta = deltas[pos];
+      break;
+    case 2:
+      delta = reinterpret_cast<const int16_t*>(deltas)[pos];
+      break;
+    case 4:
+      delta = reinterpret_cast<const int32_t*>(deltas)[pos];
+      break;
+    default:
+      delta = reinterpret_cast<const int64_t*>(deltas)[pos];
+      break;
+  }
+  if (delta == null_val) {
+    return ret_null_val;
+  }
+  return reinterpret_cast<const FrameOfReferenceChunkHeader*>(chunk)->base + delta;
+}
+
+#endif  // SHARED_ENCODEDCHUNKLAYOUT_H
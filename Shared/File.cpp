@@ -32,6 +32,8 @@
 #include <stdexcept>
 #include <string>
 
+#include <unistd.h>
+
 #include "Logger/Logger.h"
 
 namespace File_Namespace {
@@ -122,6 +124,24 @@ size_t read(FILE* f, const size_t offset, const size_t size, int8_t* buf) {
   return bytesRead;
 }
 
+size_t positionalRead(FILE* f, const size_t offset, const size_t size, int8_t* buf) {
+  const int fd = fileno(f);
+  size_t bytesRead = 0;
+  while (bytesRead < size) {
+    const ssize_t ret =
+        ::pread(fd, buf + bytesRead, size - bytesRead, offset + bytesRead);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      LOG(FATAL) << "Error trying to read from file (during pread) the error was: "
+                 << (ret < 0 ? std::strerror(errno) : "unexpected end of file");
+    }
+    bytesRead += ret;
+  }
+  return bytesRead;
+}
+
 size_t write(FILE* f, const size_t offset, const size_t size, int8_t* buf) {
   // write size bytes from the buffer to the offset location in the file
   if (fseek(f, static_cast<long>(offset), SEEK_SET) != 0) {
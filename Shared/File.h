@@ -80,6 +80,22 @@ bool removeFile(const std::string basePath, const std::string filename);
  */
 size_t read(FILE* f, const size_t offset, const size_t size, int8_t* buf);
 
+/**
+ * @brief Reads the specified number of bytes from the offset position in file f into buf
+ * with pread, without moving the position of the stream.
+ *
+ * Concurrent positional reads of the same file don't need to be synchronized. They go
+ * around the buffer of the stream though, data written to f is only visible to them once
+ * the stream has been flushed.
+ *
+ * @param f Pointer to the FILE.
+ * @param offset The location within the file from which to read.
+ * @param size The number of bytes to be read.
+ * @param buf The destination buffer to where data is being read from the file.
+ * @return size_t The number of bytes read.
+ */
+size_t positionalRead(FILE* f, const size_t offset, const size_t size, int8_t* buf);
+
 /**
  * @brief Writes the specified number of bytes to the offset position in file f from buf.
  *
@@ -118,7 +118,8 @@ inline int64_t inline_fixed_encoding_null_val(const SQL_TYPE_INFO& ti) {
 #endif
     }
   }
-  CHECK_EQ(kENCODING_FIXED, ti.get_compression());
+  CHECK(ti.get_compression() == kENCODING_FIXED ||
+        ti.get_compression() == kENCODING_DIFF);
   CHECK(ti.is_integer() || ti.is_time() || ti.is_decimal());
   CHECK_EQ(0, ti.get_comp_param() % 8);
   return -(1L << (ti.get_comp_param() - 1));
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 
 struct SystemParameters {
@@ -63,6 +64,8 @@ struct SystemParameters {
       5000;  // calcite send/receive timeout (connect timeout hard coded to 2s)
   size_t calcite_keepalive = false;  // calcite keepalive connection
   int num_executors = 1;
+  // dispatch priority of the queries of a user, higher runs first; unlisted users get 0
+  std::map<std::string, int> user_query_priorities;
 
   SystemParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
 };
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__x86_64))
+#include <nmmintrin.h>
+#define CRC32C_HAS_SSE42_PATH
+#endif
+
+namespace {
+
+// Reflected polynomial of CRC32C
+constexpr uint32_t kPolynomial{0x82f63b78};
+
+constexpr std::array<uint32_t, 256> make_table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr auto kTable = make_table();
+
+#ifdef CRC32C_HAS_SSE42_PATH
+
+__attribute__((target("sse4.2"))) uint32_t crc32c_sse42(uint32_t crc,
+                                                        const uint8_t* data,
+                                                        size_t size) {
+  uint64_t crc64 = crc;
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size; --size, ++data) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+
+// The cpu model has to be initialized explicitly during static initialization
+const bool g_has_sse42 = [] {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.2");
+}();
+
+#endif  // CRC32C_HAS_SSE42_PATH
+
+}  // namespace
+
+uint32_t crc32c_sw(const uint32_t crc, const void* data, const size_t size) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  uint32_t result = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    result = kTable[(result ^ bytes[i]) & 0xff] ^ (result >> 8);
+  }
+  return ~result;
+}
+
+uint32_t crc32c(const uint32_t crc, const void* data, const size_t size) {
+#ifdef CRC32C_HAS_SSE42_PATH
+  if (g_has_sse42) {
+    return ~crc32c_sse42(~crc, static_cast<const uint8_t*>(data), size);
+  }
+#endif
+  return crc32c_sw(crc, data, size);
+}
+
+bool crc32c_is_hw_accelerated() {
+#ifdef CRC32C_HAS_SSE42_PATH
+  return g_has_sse42;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Extends crc, the CRC32C (Castagnoli) checksum of some bytes, to the size bytes at data
+ * following them. The checksum of no bytes is 0, so that
+ * crc32c(crc32c(0, a, a_size), b, b_size) is the checksum of a followed by b.
+ *
+ * Uses the crc32 instruction of SSE4.2 when the CPU supports it.
+ */
+uint32_t crc32c(const uint32_t crc, const void* data, const size_t size);
+
+// The portable implementation, always used if the CPU doesn't support SSE4.2.
+uint32_t crc32c_sw(const uint32_t crc, const void* data, const size_t size);
+
+bool crc32c_is_hw_accelerated();
@@ -268,7 +268,8 @@ class SQLTypeInfo {
   HOST DEVICE inline int get_comp_param() const { return comp_param; }
   HOST DEVICE inline int get_size() const { return size; }
   inline int get_logical_size() const {
-    if (compression == kENCODING_FIXED || compression == kENCODING_DATE_IN_DAYS) {
+    if (compression == kENCODING_FIXED || compression == kENCODING_DATE_IN_DAYS ||
+        compression == kENCODING_RL || compression == kENCODING_DIFF) {
       SQLTypeInfo ti(type, dimension, scale, notnull, kENCODING_NONE, 0, subtype);
       return ti.get_size();
     }
@@ -674,13 +675,12 @@ class SQLTypeInfo {
       case kSMALLINT:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
             return sizeof(int16_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
-            return comp_param / 8;
-          case kENCODING_RL:
           case kENCODING_DIFF:
-            break;
+            return comp_param / 8;
           default:
             assert(false);
         }
@@ -688,13 +688,12 @@ class SQLTypeInfo {
       case kINT:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
             return sizeof(int32_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
-            return comp_param / 8;
-          case kENCODING_RL:
           case kENCODING_DIFF:
-            break;
+            return comp_param / 8;
           default:
             assert(false);
         }
@@ -704,13 +703,12 @@ class SQLTypeInfo {
       case kDECIMAL:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
             return sizeof(int64_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
-            return comp_param / 8;
-          case kENCODING_RL:
           case kENCODING_DIFF:
-            break;
+            return comp_param / 8;
           default:
             assert(false);
         }
@@ -757,7 +755,9 @@ class SQLTypeInfo {
             }
             return comp_param / 8;
           case kENCODING_RL:
+            return sizeof(int64_t);
           case kENCODING_DIFF:
+            return comp_param / 8;
           case kENCODING_SPARSE:
             assert(false);
             break;
@@ -818,7 +818,8 @@ int64_t convert_decimal_value_to_scale(const int64_t decimal_value,
 
 inline SQLTypeInfo get_logical_type_info(const SQLTypeInfo& type_info) {
   EncodingType encoding = type_info.get_compression();
-  if (encoding == kENCODING_DATE_IN_DAYS ||
+  if (encoding == kENCODING_DATE_IN_DAYS || encoding == kENCODING_RL ||
+      encoding == kENCODING_DIFF ||
       (encoding == kENCODING_FIXED && type_info.get_type() != kARRAY)) {
     encoding = kENCODING_NONE;
   }
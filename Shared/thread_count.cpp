@@ -17,3 +17,4 @@
 #include "thread_count.h"
 
 unsigned g_cpu_threads_override{0};
+thread_local std::shared_ptr<const CpuThreadBudget> g_query_cpu_thread_budget;
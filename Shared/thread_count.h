@@ -17,11 +17,62 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <thread>
+#include <utility>
+
+// CPU thread budget of a query, shared by all the threads the query runs on. The query
+// dispatch queue updates it as other queries start and finish.
+using CpuThreadBudget = std::atomic<unsigned>;
 
 extern unsigned g_cpu_threads_override;
+// Thread budget of the query running on this thread, null if it runs without one.
+extern thread_local std::shared_ptr<const CpuThreadBudget> g_query_cpu_thread_budget;
 
 inline int cpu_threads() {
   auto ov = g_cpu_threads_override;
-  return (ov <= 0) ? std::max(2 * std::thread::hardware_concurrency(), 1U) : ov;
+  const int threads =
+      (ov <= 0) ? std::max(2 * std::thread::hardware_concurrency(), 1U) : ov;
+  return g_query_cpu_thread_budget
+             ? std::min(threads,
+                        std::max(static_cast<int>(g_query_cpu_thread_budget->load()), 1))
+             : threads;
+}
+
+/**
+ * Limits cpu_threads() on the calling thread to the given budget for the lifetime of the
+ * object. Used by the query dispatch queue, so that the parallel sections of a query
+ * share the machine with the other queries running at the same time. A parallel section
+ * reads the budget when it starts, so a change only affects the sections started after
+ * it. The budget is per thread: the threads a query spawns start without one, see
+ * with_cpu_thread_budget().
+ */
+class ScopedCpuThreadBudget {
+ public:
+  ScopedCpuThreadBudget(std::shared_ptr<const CpuThreadBudget> budget)
+      : parent_budget_(std::move(g_query_cpu_thread_budget)) {
+    g_query_cpu_thread_budget = std::move(budget);
+  }
+  // A fixed budget, for a parallel section which splits the budget of its query.
+  ScopedCpuThreadBudget(const unsigned budget)
+      : ScopedCpuThreadBudget(std::make_shared<const CpuThreadBudget>(budget)) {}
+  ~ScopedCpuThreadBudget() { g_query_cpu_thread_budget = std::move(parent_budget_); }
+
+  ScopedCpuThreadBudget(const ScopedCpuThreadBudget&) = delete;
+  ScopedCpuThreadBudget& operator=(const ScopedCpuThreadBudget&) = delete;
+
+ private:
+  std::shared_ptr<const CpuThreadBudget> parent_budget_;
+};
+
+// Wraps func so that it runs with the thread budget of the calling thread, for the tasks
+// which a query spawns on other threads and which call cpu_threads() themselves.
+template <typename F>
+auto with_cpu_thread_budget(F func) {
+  return [budget = g_query_cpu_thread_budget, func](auto&&... args) {
+    ScopedCpuThreadBudget scoped_budget(budget);
+    return std::invoke(func, std::forward<decltype(args)>(args)...);
+  };
 }
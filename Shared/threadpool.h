@@ -24,6 +24,8 @@
 #include <iostream>
 #include <type_traits>
 
+#include "Shared/thread_count.h"
+
 namespace threadpool {
 
 template <typename T>
@@ -31,7 +33,8 @@ class FuturesThreadPoolBase {
  public:
   template <class Function, class... Args>
   void spawn(Function&& f, Args&&... args) {
-    threads_.push_back(std::async(std::launch::async, f, args...));
+    threads_.push_back(
+        std::async(std::launch::async, with_cpu_thread_budget(f), args...));
   }
 
  protected:
@@ -86,7 +89,7 @@ class TbbThreadPool : public TbbThreadPoolBase {
 
   template <class Function, class... Args>
   void spawn(Function&& f, Args&&... args) {
-    tasks_.run([f, args...] { f(args...); });
+    tasks_.run([f = with_cpu_thread_budget(f), args...] { f(args...); });
   }
 
   void join() { tasks_.wait(); }
@@ -102,7 +105,9 @@ class TbbThreadPool<T, std::enable_if_t<std::is_object<T>::value>>
   void spawn(Function&& f, Args&&... args) {
     const size_t result_idx = results_.size();
     results_.emplace_back(T{});
-    tasks_.run([this, result_idx, f, args...] { results_[result_idx] = f(args...); });
+    tasks_.run([this, result_idx, f = with_cpu_thread_budget(f), args...] {
+      results_[result_idx] = f(args...);
+    });
   }
 
   auto join() {
@@ -29,11 +29,13 @@
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/JoinHashTable/JoinHashTable.h"
 #include "QueryEngine/MurmurHash1Inl.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryEngine/UDFCompiler.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Shared/SystemParameters.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
 namespace po = boost::program_options;
@@ -42,6 +44,8 @@ namespace po = boost::program_options;
 #define BASE_PATH "./tmp"
 #endif
 
+extern size_t g_hash_table_cache_max_bytes;
+
 using namespace Catalog_Namespace;
 using namespace TestHelpers;
 
@@ -627,6 +631,49 @@ TEST(Truncate, JoinCacheInvalidationTest) {
   }
 }
 
+TEST(Truncate, JoinCacheInvalidationTest_OuterTable) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+
+    run_ddl_statement("DROP TABLE IF EXISTS cache_invalid_t1;");
+    run_ddl_statement("DROP TABLE IF EXISTS cache_invalid_t2;");
+
+    run_ddl_statement("create table cache_invalid_t1 (k1 text encoding dict(32));");
+    run_ddl_statement("create table cache_invalid_t2 (k2 text encoding dict(32));");
+    for (const auto& value : {"1", "2", "3", "4", "5"}) {
+      run_query("insert into cache_invalid_t1 values ('" + std::string(value) + "');",
+                ExecutorDeviceType::CPU);
+    }
+    for (const auto& value : {"0", "0", "0", "0", "0", "1", "2", "3", "4", "5"}) {
+      run_query("insert into cache_invalid_t2 values ('" + std::string(value) + "');",
+                ExecutorDeviceType::CPU);
+    }
+
+    auto res_before_truncate = QR::get()->runSQL(
+        "select * from cache_invalid_t1, cache_invalid_t2 where k1 = k2;", dt);
+    ASSERT_EQ(static_cast<uint32_t>(5), res_before_truncate->rowCount());
+    CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+    // the hashtable is built on cache_invalid_t1, its values are translated to the ids
+    // of the dictionary of cache_invalid_t2, which truncate resets
+    run_ddl_statement("truncate table cache_invalid_t2;");
+    CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)0);
+
+    // the strings get other ids in the new dictionary
+    for (const auto& value : {"5", "4", "3", "9", "9", "9", "9", "9", "9", "9"}) {
+      run_query("insert into cache_invalid_t2 values ('" + std::string(value) + "');",
+                ExecutorDeviceType::CPU);
+    }
+    auto res_after_truncate = QR::get()->runSQL(
+        "select * from cache_invalid_t1, cache_invalid_t2 where k1 = k2;", dt);
+    ASSERT_EQ(static_cast<uint32_t>(3), res_after_truncate->rowCount());
+    CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+    run_ddl_statement("DROP TABLE cache_invalid_t1;");
+    run_ddl_statement("DROP TABLE cache_invalid_t2;");
+  }
+}
+
 TEST(Update, JoinCacheInvalidationTest) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -720,8 +767,6 @@ TEST(Delete, JoinCacheInvalidationTest) {
 }
 
 TEST(Delete, JoinCacheInvalidationTest_DropTable) {
-  // todo: when we support per-table cached hashtable invalidation,
-  // then this test should be changed either
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
 
@@ -755,8 +800,8 @@ TEST(Delete, JoinCacheInvalidationTest_DropTable) {
     // add and drop dummy table
     run_ddl_statement("create table cache_invalid_t3 (dummy text encoding dict(32));");
     run_ddl_statement("DROP TABLE IF EXISTS cache_invalid_t3;");
-    // we should have no cached hashtable after dropping a table
-    CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)0);
+    // dropping an unrelated table keeps the cached hashtable
+    CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
 
     auto res_v2 = QR::get()->runSQL(
         "select * from cache_invalid_t1, cache_invalid_t2 where k1 = k2;", dt);
@@ -768,6 +813,69 @@ TEST(Delete, JoinCacheInvalidationTest_DropTable) {
   }
 }
 
+TEST(Insert, JoinCacheInvalidationTest) {
+  import_tables_cache_invalidation_for_CPU_one_to_one_join(false);
+
+  // the perfect hashtable is built on cache_invalid_t1, see the tests above
+  run_query(
+      "SELECT t1.id1, t2.id1 FROM cache_invalid_t1 t1 join cache_invalid_t2 t2 on "
+      "t1.id1 = t2.id1;",
+      ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+  run_query("INSERT INTO cache_invalid_t2 VALUES (1, 1, 'row-3');",
+            ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+  run_query("INSERT INTO cache_invalid_t1 VALUES (2, 2, 'row-2');",
+            ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)0);
+
+  run_ddl_statement("DROP TABLE cache_invalid_t1;");
+  run_ddl_statement("DROP TABLE cache_invalid_t2;");
+}
+
+TEST(Eviction, JoinCacheByteBudget) {
+  const auto max_bytes = g_hash_table_cache_max_bytes;
+  ScopeGuard reset = [max_bytes] { g_hash_table_cache_max_bytes = max_bytes; };
+  import_tables_cache_invalidation_for_CPU_one_to_one_join(false);
+  const auto stats_before = JoinHashTable::getCacheStats();
+
+  const std::string join_on_id1{
+      "SELECT t1.id1, t2.id1 FROM cache_invalid_t1 t1 join cache_invalid_t2 t2 on "
+      "t1.id1 = t2.id1;"};
+  run_query(join_on_id1, ExecutorDeviceType::CPU);
+  run_query(join_on_id1, ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+  auto stats = JoinHashTable::getCacheStats();
+  ASSERT_GT(stats.size_bytes, size_t(0));
+  ASSERT_GT(stats.hits, stats_before.hits);
+  const auto hash_table_bytes = stats.size_bytes;
+
+  // only one of the two hashtables fits
+  g_hash_table_cache_max_bytes = hash_table_bytes;
+  run_query(
+      "SELECT t1.id1, t2.id1 FROM cache_invalid_t1 t1 join cache_invalid_t2 t2 on "
+      "t1.id2 = t2.id2;",
+      ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+  stats = JoinHashTable::getCacheStats();
+  ASSERT_EQ(stats.evictions, stats_before.evictions + 1);
+  ASSERT_LE(stats.size_bytes, g_hash_table_cache_max_bytes);
+
+  // a hashtable larger than the budget isn't cached at all
+  run_ddl_statement("DROP TABLE cache_invalid_t1;");
+  run_ddl_statement("DROP TABLE cache_invalid_t2;");
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)0);
+  import_tables_cache_invalidation_for_CPU_one_to_one_join(false);
+  g_hash_table_cache_max_bytes = hash_table_bytes - 1;
+  run_query(join_on_id1, ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)0);
+
+  run_ddl_statement("DROP TABLE cache_invalid_t1;");
+  run_ddl_statement("DROP TABLE cache_invalid_t2;");
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -15,6 +15,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
@@ -27,6 +28,7 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/IRCodegenUtils.h"
 #include "QueryEngine/LLVMGlobalContext.h"
+#include "QueryEngine/PersistentCodeCache.h"
 #include "TestHelpers.h"
 
 TEST(CodeGeneratorTest, IntegerConstant) {
@@ -137,6 +139,91 @@ TEST(CodeGeneratorTest, IntegerExpr) {
   ASSERT_EQ(out, 100);
 }
 
+class PersistentCodeCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    cache_path_ = boost::filesystem::temp_directory_path() /
+                  boost::filesystem::unique_path("jit_code_cache_test_%%%%-%%%%");
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(cache_path_); }
+
+  static std::unique_ptr<llvm::MemoryBuffer> makeObject(const std::string& contents) {
+    return llvm::MemoryBuffer::getMemBufferCopy(contents);
+  }
+
+  boost::filesystem::path cache_path_;
+};
+
+TEST_F(PersistentCodeCacheTest, RoundTrip) {
+  const CodeCacheKey key{"define i32 @query_func()", "define i32 @row_func()"};
+  {
+    PersistentCodeCache cache(cache_path_.string(), 1 << 20);
+    ASSERT_EQ(cache.get(key), nullptr);
+    cache.put(key, makeObject("object code")->getMemBufferRef());
+    ASSERT_EQ(cache.getHits(), size_t(0));
+    ASSERT_EQ(cache.getMisses(), size_t(1));
+  }
+  // A new instance over the same directory, as after a restart.
+  PersistentCodeCache cache(cache_path_.string(), 1 << 20);
+  ASSERT_GT(cache.getSizeBytes(), size_t(0));
+  const auto object = cache.get(key);
+  ASSERT_NE(object, nullptr);
+  ASSERT_EQ(object->getBuffer().str(), "object code");
+  ASSERT_EQ(cache.getHits(), size_t(1));
+  ASSERT_EQ(cache.getMisses(), size_t(0));
+
+  // Keys differing in how the parts are split must not alias.
+  ASSERT_EQ(cache.get({"define i32 @query_func()define i32 @row_func()"}), nullptr);
+  ASSERT_EQ(cache.getMisses(), size_t(1));
+}
+
+TEST_F(PersistentCodeCacheTest, ObjectCacheStoresCompiledObject) {
+  PersistentCodeCache cache(cache_path_.string(), 1 << 20);
+  const CodeCacheKey key{"define i32 @query_func()"};
+  {
+    PersistentObjectCache object_cache(cache, key);
+    ASSERT_FALSE(object_cache.hasCachedObject());
+    ASSERT_EQ(object_cache.getObject(nullptr), nullptr);
+    object_cache.notifyObjectCompiled(nullptr,
+                                      makeObject("object code")->getMemBufferRef());
+  }
+  PersistentObjectCache object_cache(cache, key);
+  ASSERT_TRUE(object_cache.hasCachedObject());
+  ASSERT_EQ(object_cache.getObject(nullptr)->getBuffer().str(), "object code");
+}
+
+TEST_F(PersistentCodeCacheTest, EvictsLeastRecentlyUsed) {
+  const std::string object_code(1024, 'x');
+  const CodeCacheKey first_key{"key_1"};
+  const CodeCacheKey second_key{"key_2"};
+  const CodeCacheKey third_key{"key_3"};
+  size_t entry_size{0};
+  {
+    PersistentCodeCache cache(cache_path_.string(), 1 << 20);
+    cache.put(first_key, makeObject(object_code)->getMemBufferRef());
+    entry_size = cache.getSizeBytes();
+  }
+  // Room for two entries out of three, all keys have the same length.
+  const size_t max_size = 2 * entry_size + entry_size / 2;
+  PersistentCodeCache cache(cache_path_.string(), max_size);
+  cache.put(second_key, makeObject(object_code)->getMemBufferRef());
+  ASSERT_EQ(cache.getEvictions(), size_t(0));
+  // Make the first entry the oldest one on disk.
+  boost::filesystem::directory_iterator it(cache_path_);
+  for (; it != boost::filesystem::directory_iterator(); ++it) {
+    boost::filesystem::last_write_time(it->path(), time(nullptr) - 3600);
+  }
+  ASSERT_NE(cache.get(second_key), nullptr);
+
+  cache.put(third_key, makeObject(object_code)->getMemBufferRef());
+  ASSERT_EQ(cache.getEvictions(), size_t(1));
+  ASSERT_LE(cache.getSizeBytes(), max_size);
+  ASSERT_EQ(cache.get(first_key), nullptr);
+  ASSERT_NE(cache.get(second_key), nullptr);
+  ASSERT_NE(cache.get(third_key), nullptr);
+}
+
 #ifdef HAVE_CUDA
 void free_param_pointers(const std::vector<void*>& param_ptrs,
                          CudaMgr_Namespace::CudaMgr* cuda_mgr) {
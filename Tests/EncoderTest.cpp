@@ -26,12 +26,15 @@
 #include "DataMgr/Encoder.h"
 #include "DataMgr/MemoryLevel.h"
 #include "Shared/DatumFetchers.h"
+#include "Shared/EncodedChunkLayout.h"
 #include "TestHelpers.h"
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
 #endif
 
+extern bool g_enable_chunk_value_filters;
+
 using AbstractBuffer = Data_Namespace::AbstractBuffer;
 using MemoryLevel = Data_Namespace::MemoryLevel;
 
@@ -763,6 +766,400 @@ TYPED_TEST(FixedLengthArrayNoneEncoderUpdateStatsTest, TypedTest) {
   TestFixture::runTest();
 }
 
+class InMemoryTestBuffer : public AbstractBuffer {
+ public:
+  InMemoryTestBuffer(const SQLTypeInfo sql_type) : AbstractBuffer(0, sql_type) {}
+
+  void read(int8_t* const dst,
+            const size_t num_bytes,
+            const size_t offset,
+            const MemoryLevel dst_buffer_type,
+            const int dst_device_id) override {
+    CHECK_LE(offset + num_bytes, size_);
+    memcpy(dst, data_.data() + offset, num_bytes);
+  }
+
+  void write(int8_t* src,
+             const size_t num_bytes,
+             const size_t offset,
+             const MemoryLevel src_buffer_type,
+             const int src_device_id) override {
+    if (offset < size_) {
+      setUpdated();
+    }
+    if (offset + num_bytes > size_) {
+      data_.resize(offset + num_bytes);
+      size_ = data_.size();
+      setAppended();
+    }
+    memcpy(data_.data() + offset, src, num_bytes);
+  }
+
+  void reserve(size_t num_bytes) override { data_.reserve(num_bytes); }
+
+  void append(int8_t* src,
+              const size_t num_bytes,
+              const MemoryLevel src_buffer_type,
+              const int device_id) override {
+    // Like the buffer pool buffers, appends go after size_ which setSize() may shrink.
+    data_.resize(size_);
+    data_.insert(data_.end(), src, src + num_bytes);
+    size_ = data_.size();
+    setAppended();
+  }
+
+  int8_t* getMemoryPtr() override { return data_.data(); }
+
+  size_t pageCount() const override { return 1; }
+
+  size_t pageSize() const override { return data_.size(); }
+
+  size_t reservedSize() const override { return data_.capacity(); }
+
+  MemoryLevel getType() const override { return Data_Namespace::CPU_LEVEL; }
+
+ private:
+  std::vector<int8_t> data_;
+};
+
+class EncodedChunkTest : public testing::Test {
+ protected:
+  void TearDown() override { buffer_.reset(); }
+
+  void createBuffer(const SQLTypeInfo& type) {
+    buffer_.reset(new InMemoryTestBuffer(type));
+  }
+
+  template <typename T>
+  void append(std::vector<T> data) {
+    auto src = reinterpret_cast<int8_t*>(data.data());
+    buffer_->getEncoder()->appendData(src, data.size(), buffer_->getSqlType());
+  }
+
+  template <typename T>
+  void assertExpectedStats(const T& min, const T& max, const bool has_nulls) {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    buffer_->getEncoder()->getMetadata(chunk_metadata);
+    const auto& chunk_stats = chunk_metadata->chunkStats;
+    ASSERT_EQ(DatumFetcher::getDatumVal<T>(chunk_stats.min), min);
+    ASSERT_EQ(DatumFetcher::getDatumVal<T>(chunk_stats.max), max);
+    ASSERT_EQ(chunk_stats.has_nulls, has_nulls);
+  }
+
+  std::unique_ptr<InMemoryTestBuffer> buffer_;
+};
+
+TEST_F(EncodedChunkTest, RunLengthAppendAndDecode) {
+  createBuffer(SQLTypeInfo(kINT, false, kENCODING_RL));
+  const auto null_val = inline_int_null_value<int32_t>();
+  std::vector<int32_t> first = {1, 1, 1, 2, 2, null_val, null_val, 3};
+  std::vector<int32_t> second = {3, 3, 4};
+  append(first);
+  append(second);
+
+  const auto chunk = buffer_->getMemoryPtr();
+  // 1, 2, NULL, 3 (extended by the second append) and 4
+  ASSERT_EQ(rle_chunk_header(chunk)->num_runs, 5);
+  ASSERT_EQ(rle_chunk_header(chunk)->num_rows, 11);
+  ASSERT_EQ(buffer_->getEncoder()->getNumElems(), size_t(11));
+  ASSERT_EQ(buffer_->size(),
+            sizeof(RunLengthChunkHeader) + 5 * sizeof(RunLengthEntry<int32_t>));
+
+  std::vector<int32_t> expected(first);
+  expected.insert(expected.end(), second.begin(), second.end());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(rle_decode_at(chunk, sizeof(int32_t), i), expected[i]) << "row " << i;
+  }
+  assertExpectedStats<int32_t>(1, 4, true);
+}
+
+TEST_F(EncodedChunkTest, RunLengthFindRun) {
+  createBuffer(SQLTypeInfo(kTINYINT, false, kENCODING_RL));
+  // Runs of 1 to 64 rows, so that the interpolated guess misses in both directions.
+  std::vector<int8_t> data;
+  for (int8_t run = 0; run < 64; ++run) {
+    data.insert(data.end(), (run * 37) % 64 + 1, run);
+  }
+  append(data);
+
+  const auto chunk = buffer_->getMemoryPtr();
+  ASSERT_FALSE(rle_chunk_is_plain(chunk));
+  ASSERT_EQ(rle_chunk_header(chunk)->num_runs, 64);
+  for (size_t i = 0; i < data.size(); ++i) {
+    ASSERT_EQ(rle_decode_at(chunk, sizeof(int8_t), i), data[i]) << "row " << i;
+  }
+}
+
+TEST_F(EncodedChunkTest, RunLengthShortRunsStoredPlain) {
+  createBuffer(SQLTypeInfo(kBOOLEAN, false, kENCODING_RL));
+  const auto null_val = inline_int_null_value<int8_t>();
+  // Long runs first, which the chunk keeps as runs.
+  std::vector<int8_t> first(kRunLengthMinRowsForPlain, 1);
+  first.back() = null_val;
+  append(first);
+  const auto runs_chunk = buffer_->getMemoryPtr();
+  ASSERT_FALSE(rle_chunk_is_plain(runs_chunk));
+  ASSERT_EQ(rle_chunk_header(runs_chunk)->num_runs, 2);
+
+  // Alternating values make runs larger than the values themselves.
+  std::vector<int8_t> second(kRunLengthMinRowsForPlain);
+  for (size_t i = 0; i < second.size(); ++i) {
+    second[i] = i % 2;
+  }
+  append(second);
+  std::vector<int8_t> third = {0, 0, 1};
+  append(third);
+
+  const auto chunk = buffer_->getMemoryPtr();
+  ASSERT_TRUE(rle_chunk_is_plain(chunk));
+  std::vector<int8_t> expected(first);
+  expected.insert(expected.end(), second.begin(), second.end());
+  expected.insert(expected.end(), third.begin(), third.end());
+  ASSERT_EQ(rle_chunk_header(chunk)->num_rows, static_cast<int64_t>(expected.size()));
+  ASSERT_EQ(buffer_->size(), sizeof(RunLengthChunkHeader) + expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(rle_decode_at(chunk, sizeof(int8_t), i), expected[i]) << "row " << i;
+  }
+  assertExpectedStats<int8_t>(0, 1, true);
+}
+
+TEST_F(EncodedChunkTest, RunLengthAppendAfterPlain) {
+  createBuffer(SQLTypeInfo(kINT, false, kENCODING_RL));
+  // Alternating values from the start turn the chunk plain on the first append.
+  std::vector<int32_t> first(kRunLengthMinRowsForPlain);
+  for (size_t i = 0; i < first.size(); ++i) {
+    first[i] = i % 2 ? -20 : 11;
+  }
+  append(first);
+  ASSERT_TRUE(rle_chunk_is_plain(buffer_->getMemoryPtr()));
+  ASSERT_EQ(buffer_->size(),
+            sizeof(RunLengthChunkHeader) + first.size() * sizeof(int32_t));
+
+  std::vector<int32_t> expected(first);
+  const auto null_val = inline_int_null_value<int32_t>();
+  for (const auto& data : std::vector<std::vector<int32_t>>{
+           {7, 7, 7}, {null_val}, {-11, 1, 1, 5}}) {
+    append(data);
+    expected.insert(expected.end(), data.begin(), data.end());
+  }
+
+  const auto chunk = buffer_->getMemoryPtr();
+  ASSERT_TRUE(rle_chunk_is_plain(chunk));
+  ASSERT_EQ(rle_chunk_header(chunk)->num_rows, static_cast<int64_t>(expected.size()));
+  ASSERT_EQ(buffer_->size(),
+            sizeof(RunLengthChunkHeader) + expected.size() * sizeof(int32_t));
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(rle_decode_at(chunk, sizeof(int32_t), i), expected[i]) << "row " << i;
+  }
+  assertExpectedStats<int32_t>(-20, 11, true);
+}
+
+TEST_F(EncodedChunkTest, RunLengthUpdateStats) {
+  createBuffer(SQLTypeInfo(kBIGINT, false, kENCODING_RL));
+  std::vector<int64_t> data = {-1, 2, 3, inline_int_null_value<int64_t>()};
+  buffer_->getEncoder()->updateStats(reinterpret_cast<const int8_t*>(data.data()),
+                                     data.size());
+  assertExpectedStats<int64_t>(-1, 3, true);
+}
+
+TEST_F(EncodedChunkTest, DiffAppendAndDecode) {
+  SQLTypeInfo ti(kTIMESTAMP, false, kENCODING_DIFF);
+  ti.set_comp_param(16);
+  ti.set_fixed_size();
+  createBuffer(ti);
+  const auto null_val = inline_int_null_value<int64_t>();
+  std::vector<int64_t> first = {1600000000, 1600000001, null_val, 1600000100};
+  std::vector<int64_t> second = {1600060000, 1600000000};
+  append(first);
+  append(second);
+
+  ASSERT_EQ(buffer_->size(),
+            sizeof(FrameOfReferenceChunkHeader) + 6 * sizeof(int16_t));
+  std::vector<int64_t> expected(first);
+  expected.insert(expected.end(), second.begin(), second.end());
+  const auto chunk = buffer_->getMemoryPtr();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(for_decode_at(chunk,
+                            sizeof(int16_t),
+                            inline_int_null_value<int16_t>(),
+                            null_val,
+                            i),
+              expected[i])
+        << "row " << i;
+  }
+  assertExpectedStats<int64_t>(1600000000, 1600060000, true);
+}
+
+TEST_F(EncodedChunkTest, DiffOverflowLeavesChunkUnchanged) {
+  SQLTypeInfo ti(kINT, false, kENCODING_DIFF);
+  ti.set_comp_param(8);
+  ti.set_fixed_size();
+  createBuffer(ti);
+  append(std::vector<int32_t>{100, 101});
+  const auto size_before = buffer_->size();
+  // 8-bit deltas cover 254 values above the smallest one
+  EXPECT_THROW(append(std::vector<int32_t>{102, 100 + 255}), std::runtime_error);
+  EXPECT_THROW(append(std::vector<int32_t>{101 - 255}), std::runtime_error);
+  ASSERT_EQ(buffer_->size(), size_before);
+  ASSERT_EQ(buffer_->getEncoder()->getNumElems(), size_t(2));
+}
+
+TEST_F(EncodedChunkTest, DiffRebaseOnSmallerValues) {
+  SQLTypeInfo ti(kINT, false, kENCODING_DIFF);
+  ti.set_comp_param(8);
+  ti.set_fixed_size();
+  createBuffer(ti);
+  const auto null_val = inline_int_null_value<int32_t>();
+  std::vector<int32_t> first = {100, null_val, 101};
+  std::vector<int32_t> second = {102, 99, -100};
+  append(first);
+  append(second);
+
+  std::vector<int32_t> expected(first);
+  expected.insert(expected.end(), second.begin(), second.end());
+  const auto chunk = buffer_->getMemoryPtr();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(for_decode_at(chunk,
+                            sizeof(int8_t),
+                            inline_int_null_value<int8_t>(),
+                            null_val,
+                            i),
+              expected[i])
+        << "row " << i;
+  }
+  assertExpectedStats<int32_t>(-100, 102, true);
+}
+
+class ChunkValueFilterTest : public EncodedChunkTest {
+ protected:
+  void SetUp() override { g_enable_chunk_value_filters = true; }
+
+  void TearDown() override {
+    g_enable_chunk_value_filters = false;
+    EncodedChunkTest::TearDown();
+  }
+
+  std::shared_ptr<const ChunkValueFilter> getValueFilter() {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    buffer_->getEncoder()->getMetadata(chunk_metadata);
+    return chunk_metadata->chunkStats.value_filter;
+  }
+};
+
+TEST_F(ChunkValueFilterTest, DistinctValues) {
+  createBuffer(SQLTypeInfo(kINT, false));
+  append(std::vector<int32_t>{5, 7, inline_int_null_value<int32_t>(), 5, -3});
+  const auto value_filter = getValueFilter();
+  ASSERT_TRUE(value_filter);
+  ASSERT_EQ(value_filter->getRowCount(), size_t(5));
+  for (const int64_t val : {5, 7, -3}) {
+    ASSERT_TRUE(value_filter->mayContain(val)) << val;
+  }
+  // Within the min/max range, but not in the chunk
+  for (const int64_t val : {0, 6, 4}) {
+    ASSERT_FALSE(value_filter->mayContain(val)) << val;
+  }
+}
+
+TEST_F(ChunkValueFilterTest, BloomFilter) {
+  createBuffer(SQLTypeInfo(kBIGINT, false));
+  std::vector<int64_t> data;
+  for (int64_t i = 0; i < 1000; ++i) {
+    data.push_back(i * 2);
+  }
+  append(data);
+  const auto value_filter = getValueFilter();
+  ASSERT_TRUE(value_filter);
+  ASSERT_FALSE(value_filter->isSaturated());
+  for (const auto val : data) {
+    ASSERT_TRUE(value_filter->mayContain(val)) << val;
+  }
+  size_t false_positives{0};
+  for (const auto val : data) {
+    false_positives += value_filter->mayContain(val + 1);
+  }
+  ASSERT_LT(false_positives, data.size() / 10);
+}
+
+TEST_F(ChunkValueFilterTest, BloomFilterLayers) {
+  // The filter grows with the distinct values, the false positive rate stays low
+  createBuffer(SQLTypeInfo(kBIGINT, false));
+  std::vector<int64_t> data;
+  for (int64_t i = 0; i < 200000; ++i) {
+    data.push_back(i * 2);
+  }
+  append(data);
+  const auto value_filter = getValueFilter();
+  ASSERT_TRUE(value_filter);
+  ASSERT_FALSE(value_filter->isSaturated());
+  size_t false_positives{0};
+  for (const auto val : data) {
+    ASSERT_TRUE(value_filter->mayContain(val)) << val;
+    false_positives += value_filter->mayContain(val + 1);
+  }
+  ASSERT_LT(false_positives, data.size() / 10);
+}
+
+TEST_F(ChunkValueFilterTest, Saturated) {
+  createBuffer(SQLTypeInfo(kBIGINT, false));
+  std::vector<int64_t> data;
+  for (int64_t i = 0; i < 500000; ++i) {
+    data.push_back(i);
+  }
+  append(data);
+  const auto value_filter = getValueFilter();
+  ASSERT_TRUE(value_filter);
+  ASSERT_TRUE(value_filter->isSaturated());
+  ASSERT_TRUE(value_filter->mayContain(-1));
+}
+
+TEST_F(ChunkValueFilterTest, UnsupportedTypes) {
+  createBuffer(SQLTypeInfo(kDOUBLE, false));
+  append(std::vector<double>{1.5, 2.5});
+  ASSERT_FALSE(buffer_->getEncoder()->hasValueFilter());
+  ASSERT_FALSE(getValueFilter());
+}
+
+TEST_F(ChunkValueFilterTest, MissingRows) {
+  createBuffer(SQLTypeInfo(kINT, false));
+  append(std::vector<int32_t>{1, 3});
+  ASSERT_TRUE(getValueFilter());
+  // Rows the filter hasn't seen could hold any value, the filter must not be used
+  buffer_->getEncoder()->setNumElems(3);
+  ASSERT_FALSE(getValueFilter());
+}
+
+TEST_F(ChunkValueFilterTest, WriteAndRead) {
+  for (const size_t value_count :
+       {size_t(10), size_t(1000), size_t(100000), size_t(500000)}) {
+    createBuffer(SQLTypeInfo(kBIGINT, false));
+    std::vector<int64_t> data;
+    for (size_t i = 0; i < value_count; ++i) {
+      data.push_back(i * 3);
+    }
+    append(data);
+    std::vector<int8_t> serialized;
+    buffer_->getEncoder()->writeValueFilter(serialized);
+    ASSERT_LE(serialized.size(), ChunkValueFilter::kMaxBloomFilterBits / 8 + 1024);
+    const auto expected = getValueFilter();
+    buffer_->getEncoder()->clearValueFilter();
+    ASSERT_FALSE(getValueFilter());
+    ASSERT_TRUE(buffer_->getEncoder()->readValueFilter(serialized));
+    const auto actual = getValueFilter();
+    ASSERT_TRUE(actual);
+    ASSERT_EQ(actual->getRowCount(), expected->getRowCount());
+    ASSERT_EQ(actual->isSaturated(), expected->isSaturated());
+    for (int64_t val = -10; val < static_cast<int64_t>(3 * value_count); ++val) {
+      ASSERT_EQ(actual->mayContain(val), expected->mayContain(val)) << val;
+    }
+
+    // A truncated filter isn't read, nor used
+    serialized.pop_back();
+    ASSERT_FALSE(buffer_->getEncoder()->readValueFilter(serialized));
+    ASSERT_FALSE(getValueFilter());
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -16,6 +16,7 @@
 
 #include "TestHelpers.h"
 
+#include "../DataMgr/ChunkValueFilter.h"
 #include "../ImportExport/Importer.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ArrowResultSet.h"
@@ -48,6 +49,13 @@ bool g_aggregator{false};
 
 extern int g_test_against_columnId_gap;
 extern bool g_enable_smem_group_by;
+extern bool g_enable_async_jit;
+extern bool g_enable_morsel_scheduling;
+extern size_t g_morsel_size_rows;
+extern size_t g_window_function_parallel_sort_threshold;
+extern bool g_enable_sparse_hll;
+extern bool g_enable_chunk_value_filters;
+extern size_t g_hash_join_build_partition_bytes;
 extern bool g_allow_cpu_retry;
 extern bool g_enable_watchdog;
 extern bool g_skip_intermediate_count;
@@ -62,6 +70,14 @@ extern bool g_enable_calcite_view_optimize;
 extern bool g_enable_bump_allocator;
 extern bool g_enable_interop;
 extern bool g_enable_union;
+extern size_t g_hash_semi_join_threshold;
+extern size_t g_max_cpu_group_by_buffer_bytes;
+extern size_t g_spilled_rows_block_bytes;
+extern bool g_enable_baseline_preaggregation;
+extern size_t g_baseline_preaggregation_entry_count;
+extern bool g_enable_normalized_sort_keys;
+extern bool g_enable_chunk_prefetch;
+extern bool g_enable_run_length_aggregates;
 
 extern size_t g_leaf_count;
 extern bool g_cluster;
@@ -1305,6 +1321,78 @@ TEST(Select, FilterAndSimpleAggregation) {
   }
 }
 
+TEST(Select, AsyncJit) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto enable_async_jit = g_enable_async_jit;
+  ScopeGuard reset = [enable_async_jit] { g_enable_async_jit = enable_async_jit; };
+  g_enable_async_jit = true;
+  // Query shapes no other test compiles, so both miss the code cache. The first run
+  // executes unoptimized code, the later ones the code generated in the background once
+  // it has replaced the code cache entry.
+  const std::vector<std::string> queries{
+      "SELECT x, SUM(y * 7 - z * 3), COUNT(*) FROM test WHERE t > 1003 GROUP BY x "
+      "ORDER BY x;",
+      "SELECT COUNT(*) FROM test WHERE x * 5 > y - 19 AND z < 103 AND t <> 1004;"};
+  for (const auto& query : queries) {
+    const auto installs = Executor::waitForAsyncCodegen();
+    c(query, ExecutorDeviceType::CPU);
+    const auto optimized_installs = Executor::waitForAsyncCodegen();
+    ASSERT_LT(installs, optimized_installs);
+    for (size_t i = 0; i < 2; ++i) {
+      c(query, ExecutorDeviceType::CPU);
+    }
+    // Cache hits on the optimized code, nothing left to generate.
+    ASSERT_EQ(optimized_installs, Executor::waitForAsyncCodegen());
+  }
+}
+
+TEST(Select, MorselScheduling) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto enable_morsel_scheduling = g_enable_morsel_scheduling;
+  const auto morsel_size_rows = g_morsel_size_rows;
+  ScopeGuard reset = [enable_morsel_scheduling, morsel_size_rows] {
+    g_enable_morsel_scheduling = enable_morsel_scheduling;
+    g_morsel_size_rows = morsel_size_rows;
+    run_ddl_statement("DROP TABLE IF EXISTS morsel_test;");
+  };
+  g_enable_morsel_scheduling = true;
+  // Single row morsels, every fragment of the test tables gets split, except for the
+  // group by whose output buffer is too large next to the morsels.
+  g_morsel_size_rows = 1;
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT COUNT(*), SUM(x), MIN(y), MAX(z) FROM test;", dt);
+  c("SELECT COUNT(*) FROM test WHERE x * 2 > y - 17 AND z < 102;", dt);
+  c("SELECT x, y FROM test WHERE z > 100 ORDER BY x, y;", dt);
+  c("SELECT x, SUM(y * 3 - z), COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+  c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x = b.x;", dt);
+
+  // Two fragments of 256 rows, x from 0 to 511 and y = x % 4.
+  run_ddl_statement("DROP TABLE IF EXISTS morsel_test;");
+  run_ddl_statement("CREATE TABLE morsel_test (x INT, y INT) WITH (fragment_size=256);");
+  for (int i = 0; i < 4; i++) {
+    run_multiple_agg("INSERT INTO morsel_test VALUES(" + std::to_string(i) + ", " +
+                         std::to_string(i) + ");",
+                     dt);
+  }
+  for (int offset = 4; offset < 512; offset *= 2) {
+    run_ddl_statement("INSERT INTO morsel_test SELECT x + " + std::to_string(offset) +
+                      ", y FROM morsel_test;");
+  }
+  // The four groups fit in morsels of 64 rows, each fragment is split in four.
+  g_morsel_size_rows = 64;
+  const auto rows =
+      run_multiple_agg("SELECT y, COUNT(*), SUM(x) FROM morsel_test GROUP BY y;", dt);
+  EXPECT_EQ(size_t(8), rows->getMorselKernels());
+  ASSERT_EQ(size_t(4), rows->rowCount());
+  for (size_t i = 0; i < rows->rowCount(); i++) {
+    const auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(size_t(3), crt_row.size());
+    const auto y = v<int64_t>(crt_row[0]);
+    EXPECT_EQ(int64_t(128), v<int64_t>(crt_row[1]));
+    EXPECT_EQ(32512 + 128 * y, v<int64_t>(crt_row[2]));
+  }
+}
+
 TEST(Select, AggregateOnEmptyDecimalColumn) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -1902,6 +1990,92 @@ TEST(Select, Having) {
   }
 }
 
+TEST(Select, ChunkValueFilters) {
+  SKIP_ALL_ON_AGGREGATOR();
+  ScopeGuard reset = [] {
+    g_enable_chunk_value_filters = false;
+    run_ddl_statement("DROP TABLE IF EXISTS value_filter_test;");
+  };
+  // The filters are built when the chunks are written.
+  g_enable_chunk_value_filters = true;
+  run_ddl_statement("DROP TABLE IF EXISTS value_filter_test;");
+  run_ddl_statement(
+      "CREATE TABLE value_filter_test (x INT, s TEXT ENCODING DICT) WITH "
+      "(fragment_size=4);");
+  // Every fragment covers a range of x with gaps and a subset of the strings.
+  for (int i = 0; i < 20; i++) {
+    run_multiple_agg("INSERT INTO value_filter_test VALUES(" + std::to_string(i * 2) +
+                         ", 's" + std::to_string(i % 5) + "');",
+                     ExecutorDeviceType::CPU);
+  }
+  // Fragments whose range of x holds val, which only their value filter can skip.
+  const auto fragments_skipped_by_filter = [](const int64_t val) {
+    auto& cat = QR::get()->getSession()->getCatalog();
+    const auto td = cat.getMetadataForTable("value_filter_test");
+    CHECK(td);
+    const auto cd = cat.getMetadataForColumn(td->tableId, "x");
+    CHECK(cd);
+    size_t skipped = 0;
+    for (const auto& fragment : td->fragmenter->getFragmentsForQuery().fragments) {
+      const auto& chunk_stats =
+          fragment.getChunkMetadataMap().at(cd->columnId)->chunkStats;
+      if (chunk_stats.min.intval <= val && val <= chunk_stats.max.intval &&
+          chunk_stats.value_filter && !chunk_stats.value_filter->mayContain(val)) {
+        ++skipped;
+      }
+    }
+    return skipped;
+  };
+  // The first fragment holds 0, 2, 4 and 6.
+  EXPECT_EQ(size_t(1), fragments_skipped_by_filter(3));
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(int64_t(0),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x = 3;", dt)));
+    EXPECT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x = 12;", dt)));
+    EXPECT_EQ(int64_t(2),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x IN (2, 5, 8);", dt)));
+    EXPECT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x = 7 OR x = 30;", dt)));
+    EXPECT_EQ(int64_t(4),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE s = 's4';", dt)));
+    EXPECT_EQ(int64_t(8),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM value_filter_test WHERE s "
+                                        "IN ('s1', 's3', 'missing');",
+                                        dt)));
+    EXPECT_EQ(int64_t(0),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE s = 'missing';", dt)));
+  }
+
+  // The first fragment now holds 1, 3, 5 and 7, the update only reports the new min and
+  // max so its filter is dropped. The other fragments keep theirs.
+  run_multiple_agg("UPDATE value_filter_test SET x = x + 1 WHERE x < 8;",
+                   ExecutorDeviceType::CPU);
+  EXPECT_EQ(size_t(0), fragments_skipped_by_filter(3));
+  EXPECT_EQ(size_t(0), fragments_skipped_by_filter(5));
+  EXPECT_EQ(size_t(1), fragments_skipped_by_filter(11));
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x = 3;", dt)));
+    EXPECT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x = 5;", dt)));
+    EXPECT_EQ(int64_t(0),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM value_filter_test WHERE x = 11;", dt)));
+  }
+}
+
 TEST(Select, CountWithLimitAndOffset) {
   SKIP_ALL_ON_AGGREGATOR();
   run_ddl_statement("DROP TABLE IF EXISTS count_test;");
@@ -2239,6 +2413,172 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxPercentile) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // The extremes are exact, and inputs this small keep every value in its own centroid.
+    c("SELECT APPROX_PERCENTILE(x, 0) FROM test;", "SELECT MIN(x) FROM test;", dt);
+    c("SELECT APPROX_PERCENTILE(x, 1) FROM test;", "SELECT MAX(x) FROM test;", dt);
+    c("SELECT APPROX_PERCENTILE(x, 0.5) FROM test WHERE y = 42;",
+      "SELECT MIN(x) FROM test WHERE y = 42;",
+      dt);
+    c("SELECT APPROX_PERCENTILE(d, 0.0) FROM test;", "SELECT MIN(d) FROM test;", dt);
+    c("SELECT APPROX_PERCENTILE(dd, 1.0) FROM test;", "SELECT MAX(dd) FROM test;", dt);
+    c("SELECT APPROX_PERCENTILE(fn, 1) FROM test;", "SELECT MAX(fn) FROM test;", dt);
+    c("SELECT APPROX_PERCENTILE(x, 0.5) FROM test_empty;",
+      "SELECT MIN(x) FROM test_empty;",
+      dt);
+    c("SELECT APPROX_PERCENTILE(fn, 0.5) FROM test WHERE fn IS NULL;",
+      "SELECT MIN(fn) FROM test WHERE fn IS NULL;",
+      dt);
+    c("SELECT y, APPROX_PERCENTILE(x, 0), APPROX_PERCENTILE(x, 1) FROM test GROUP BY y "
+      "ORDER BY y;",
+      "SELECT y, MIN(x), MAX(x) FROM test GROUP BY y ORDER BY y;",
+      dt);
+    c("SELECT str, APPROX_PERCENTILE(dn, 0) FROM test GROUP BY str ORDER BY str;",
+      "SELECT str, MIN(dn) FROM test GROUP BY str ORDER BY str;",
+      dt);
+    c("SELECT y, COUNT(*), APPROX_PERCENTILE(t, 1) AS p FROM test GROUP BY y ORDER BY p "
+      "DESC, y LIMIT 1;",
+      "SELECT y, COUNT(*), MAX(t) AS p FROM test GROUP BY y ORDER BY p DESC, y LIMIT 1;",
+      dt);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, 1.5) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, -0.1) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
+TEST(Select, ApproxPercentileMultiFragment) {
+  SKIP_ALL_ON_AGGREGATOR();
+  ScopeGuard reset = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS approx_percentile_test;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS approx_percentile_test;");
+  run_ddl_statement(
+      "CREATE TABLE approx_percentile_test (x INT) WITH (fragment_size=100);");
+  for (int i = 1; i <= 100; i++) {
+    run_multiple_agg(
+        "INSERT INTO approx_percentile_test VALUES(" + std::to_string(i) + ");",
+        ExecutorDeviceType::CPU);
+  }
+  // 1 to 1600 in 16 fragments, every kernel fills a digest of its own
+  for (const int offset : {100, 200, 400, 800}) {
+    run_ddl_statement("INSERT INTO approx_percentile_test SELECT x + " +
+                      std::to_string(offset) + " FROM approx_percentile_test;");
+  }
+  // Within 1% of the range of the values
+  const double tolerance{16};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_NEAR(800.5,
+                v<double>(run_simple_agg(
+                    "SELECT APPROX_PERCENTILE(x, 0.5) FROM approx_percentile_test;", dt)),
+                tolerance);
+    EXPECT_NEAR(1440.5,
+                v<double>(run_simple_agg(
+                    "SELECT APPROX_PERCENTILE(x, 0.9) FROM approx_percentile_test;", dt)),
+                tolerance);
+    const auto rows = run_multiple_agg(
+        "SELECT MOD(x, 2) AS r, APPROX_PERCENTILE(x, 0.5), APPROX_PERCENTILE(x, 0.9) "
+        "FROM approx_percentile_test GROUP BY r ORDER BY r;",
+        dt);
+    ASSERT_EQ(size_t(2), rows->rowCount());
+    // Even values from 2 to 1600, then odd values from 1 to 1599
+    for (const auto& expected :
+         {std::make_pair(801., 1441.), std::make_pair(800., 1440.)}) {
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(3), crt_row.size());
+      EXPECT_NEAR(expected.first, v<double>(crt_row[1]), tolerance);
+      EXPECT_NEAR(expected.second, v<double>(crt_row[2]), tolerance);
+    }
+  }
+}
+
+TEST(Select, ApproxCountDistinctSparseSketch) {
+  const auto enable_sparse_hll = g_enable_sparse_hll;
+  ScopeGuard reset = [enable_sparse_hll] { g_enable_sparse_hll = enable_sparse_hll; };
+  for (const bool enable : {true, false}) {
+    g_enable_sparse_hll = enable;
+    const auto dt = ExecutorDeviceType::CPU;
+    c("SELECT y, APPROX_COUNT_DISTINCT(x) AS n FROM test GROUP BY y ORDER BY y;",
+      "SELECT y, COUNT(distinct x) AS n FROM test GROUP BY y ORDER BY y;",
+      dt);
+    c("SELECT z, APPROX_COUNT_DISTINCT(str, 2) AS n FROM test GROUP BY z ORDER BY z;",
+      "SELECT z, COUNT(distinct str) AS n FROM test GROUP BY z ORDER BY z;",
+      dt);
+    c("SELECT x, APPROX_COUNT_DISTINCT(null_str) AS n, APPROX_COUNT_DISTINCT(d) FROM "
+      "test GROUP BY x ORDER BY x;",
+      "SELECT x, COUNT(distinct null_str) AS n, COUNT(distinct d) FROM test GROUP BY x "
+      "ORDER BY x;",
+      dt);
+    c("SELECT APPROX_COUNT_DISTINCT(x) FROM test;",
+      "SELECT COUNT(distinct x) FROM test;",
+      dt);
+  }
+}
+
+TEST(Select, ApproxCountDistinctSketchRollup) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto enable_sparse_hll = g_enable_sparse_hll;
+  ScopeGuard reset = [enable_sparse_hll] {
+    g_enable_sparse_hll = enable_sparse_hll;
+    run_ddl_statement("DROP TABLE IF EXISTS hll_events;");
+    run_ddl_statement("DROP TABLE IF EXISTS hll_sketches;");
+  };
+  // The sketches stored as rows give the estimates of dense APPROX_COUNT_DISTINCT.
+  g_enable_sparse_hll = false;
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS hll_events;");
+  run_ddl_statement("DROP TABLE IF EXISTS hll_sketches;");
+  run_ddl_statement("CREATE TABLE hll_events (g INT, k BIGINT);");
+  for (int i = 0; i < 3; i++) {
+    run_multiple_agg("INSERT INTO hll_events VALUES(" + std::to_string(i) + ", " +
+                         std::to_string(i) + ");",
+                     dt);
+  }
+  // 6144 rows, 2048 keys per group and 6144 keys overall.
+  for (int offset = 3; offset < 6144; offset *= 2) {
+    run_ddl_statement("INSERT INTO hll_events SELECT g, k + " + std::to_string(offset) +
+                      " FROM hll_events;");
+  }
+  run_ddl_statement(
+      "CREATE TABLE hll_sketches AS SELECT g, hll_register(k, 11) AS reg, "
+      "MAX(hll_rank(k, 11)) AS rnk FROM hll_events GROUP BY 1, 2;");
+
+  const auto expected_rows = run_multiple_agg(
+      "SELECT g, APPROX_COUNT_DISTINCT(k) FROM hll_events GROUP BY g ORDER BY g;", dt);
+  const auto rows = run_multiple_agg(
+      "SELECT g, hll_estimate(SUM(POWER(2, -rnk)), COUNT(*), 11) FROM hll_sketches "
+      "GROUP BY g ORDER BY g;",
+      dt);
+  ASSERT_EQ(size_t(3), rows->rowCount());
+  ASSERT_EQ(expected_rows->rowCount(), rows->rowCount());
+  for (size_t i = 0; i < rows->rowCount(); ++i) {
+    const auto expected_row = expected_rows->getNextRow(true, true);
+    const auto row = rows->getNextRow(true, true);
+    ASSERT_EQ(v<int64_t>(expected_row[0]), v<int64_t>(row[0]));
+    ASSERT_EQ(v<int64_t>(expected_row[1]), v<int64_t>(row[1]));
+  }
+
+  // Rolling the groups up merges their sketches register by register.
+  ASSERT_EQ(
+      v<int64_t>(run_simple_agg("SELECT APPROX_COUNT_DISTINCT(k) FROM hll_events;", dt)),
+      v<int64_t>(run_simple_agg(
+          "SELECT hll_estimate(SUM(POWER(2, -rnk)), COUNT(*), 11) FROM (SELECT reg, "
+          "MAX(rnk) AS rnk FROM hll_sketches GROUP BY reg);",
+          dt)));
+
+  // The precision must be a literal between 4 and 16.
+  EXPECT_NO_THROW(run_multiple_agg("SELECT hll_register(k, 4) FROM hll_events;", dt));
+  EXPECT_NO_THROW(run_multiple_agg("SELECT hll_rank(k, 16) FROM hll_events;", dt));
+  EXPECT_ANY_THROW(run_multiple_agg("SELECT hll_register(k, 3) FROM hll_events;", dt));
+  EXPECT_ANY_THROW(run_multiple_agg("SELECT hll_rank(k, 17) FROM hll_events;", dt));
+  EXPECT_ANY_THROW(run_multiple_agg("SELECT hll_rank(k, g) FROM hll_events;", dt));
+  EXPECT_ANY_THROW(run_multiple_agg(
+      "SELECT hll_estimate(SUM(POWER(2, -rnk)), COUNT(*), 0) FROM hll_sketches;", dt));
+}
+
 TEST(Select, ScanNoAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2403,6 +2743,127 @@ TEST(Select, OrderBy) {
   }
 }
 
+TEST(Select, OrderByNormalizedKeys) {
+  const auto normalized_sort_keys_state = g_enable_normalized_sort_keys;
+  ScopeGuard reset = [normalized_sort_keys_state] {
+    g_enable_normalized_sort_keys = normalized_sort_keys_state;
+  };
+  for (const bool enable_normalized_sort_keys : {true, false}) {
+    g_enable_normalized_sort_keys = enable_normalized_sort_keys;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT x, y, f, d FROM test ORDER BY x DESC, y, f, d;", dt);
+      c("SELECT str, fn, ofd FROM test ORDER BY str, fn NULLS FIRST, ofd NULLS FIRST;",
+        "SELECT str, fn, ofd FROM test ORDER BY str, fn, ofd;",
+        dt);
+      c("SELECT x, w, z FROM test ORDER BY w DESC NULLS LAST, z, x;",
+        "SELECT x, w, z FROM test ORDER BY w DESC, z, x;",
+        dt);
+      c("SELECT ofq, dd, COUNT(*) AS n FROM test GROUP BY ofq, dd ORDER BY ofq DESC "
+        "NULLS LAST, dd DESC NULLS LAST;",
+        "SELECT ofq, dd, COUNT(*) AS n FROM test GROUP BY ofq, dd ORDER BY ofq DESC, dd "
+        "DESC;",
+        dt);
+      c("SELECT b, m, COUNT(*) AS n FROM test GROUP BY b, m ORDER BY b NULLS FIRST, m "
+        "DESC;",
+        "SELECT b, m, COUNT(*) AS n FROM test GROUP BY b, m ORDER BY b, m DESC;",
+        dt);
+      c("SELECT str, COUNT(*) AS n FROM test GROUP BY str ORDER BY n DESC, str;", dt);
+    }
+  }
+}
+
+TEST(Select, RunLengthAggregates) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  run_ddl_statement("DROP TABLE IF EXISTS rl_agg;");
+  run_ddl_statement(
+      "CREATE TABLE rl_agg (b TINYINT ENCODING RL, i INT ENCODING RL, x BIGINT ENCODING "
+      "RL, d DECIMAL(10,2) ENCODING RL) WITH (fragment_size=4);");
+  ScopeGuard drop_table = [] { run_ddl_statement("DROP TABLE IF EXISTS rl_agg;"); };
+  const auto run_length_aggregates_state = g_enable_run_length_aggregates;
+  ScopeGuard reset_run_length_aggregates = [run_length_aggregates_state] {
+    g_enable_run_length_aggregates = run_length_aggregates_state;
+  };
+  // Runs cross the fragments of 4 rows.
+  for (int i = 0; i < 3; ++i) {
+    run_multiple_agg("INSERT INTO rl_agg VALUES (1, 10, 100, 1.5);",
+                     ExecutorDeviceType::CPU);
+  }
+  for (int i = 0; i < 2; ++i) {
+    run_multiple_agg("INSERT INTO rl_agg VALUES (NULL, NULL, NULL, NULL);",
+                     ExecutorDeviceType::CPU);
+  }
+  for (int i = 0; i < 4; ++i) {
+    run_multiple_agg("INSERT INTO rl_agg VALUES (2, -5, 2000000000000, 2.25);",
+                     ExecutorDeviceType::CPU);
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_run_length_aggregates : {true, false}) {
+      g_enable_run_length_aggregates = enable_run_length_aggregates;
+      const auto rows = run_multiple_agg(
+          "SELECT COUNT(*), COUNT(i), SUM(i), MIN(i), MAX(b), SUM(x), MIN(x), SUM(d) "
+          "FROM rl_agg;",
+          dt);
+      ASSERT_EQ(size_t(1), rows->rowCount());
+      const auto row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(8), row.size());
+      ASSERT_EQ(int64_t(9), v<int64_t>(row[0]));
+      ASSERT_EQ(int64_t(7), v<int64_t>(row[1]));
+      ASSERT_EQ(int64_t(10), v<int64_t>(row[2]));
+      ASSERT_EQ(int64_t(-5), v<int64_t>(row[3]));
+      ASSERT_EQ(int64_t(2), v<int64_t>(row[4]));
+      ASSERT_EQ(int64_t(8000000000300), v<int64_t>(row[5]));
+      ASSERT_EQ(int64_t(100), v<int64_t>(row[6]));
+      ASSERT_NEAR(double(13.5), v<double>(row[7]), double(0.001));
+      ASSERT_EQ(int64_t(3),
+                v<int64_t>(run_simple_agg("SELECT COUNT(i) FROM rl_agg WHERE i > 0;", dt)));
+      ASSERT_EQ(
+          inline_int_null_value<int64_t>(),
+          v<int64_t>(run_simple_agg("SELECT SUM(x) FROM rl_agg WHERE b IS NULL;", dt)));
+    }
+  }
+}
+
+TEST(Select, OrderByDuplicateNullKeys) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto normalized_sort_keys_state = g_enable_normalized_sort_keys;
+  ScopeGuard reset = [normalized_sort_keys_state] {
+    g_enable_normalized_sort_keys = normalized_sort_keys_state;
+    run_ddl_statement("DROP TABLE IF EXISTS order_by_null_test;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS order_by_null_test;");
+  run_ddl_statement("CREATE TABLE order_by_null_test (a INT, b INT);");
+  for (const auto& values : {"NULL, 3", "1, 5", "NULL, 1", "NULL, 2", "1, 4"}) {
+    run_multiple_agg("INSERT INTO order_by_null_test VALUES(" + std::string(values) +
+                         ");",
+                     ExecutorDeviceType::CPU);
+  }
+  // Rows which are both null on a are ordered by b, with and without a limit
+  const std::vector<int64_t> expected_b{3, 2, 1, 5, 4};
+  for (const bool enable_normalized_sort_keys : {true, false}) {
+    g_enable_normalized_sort_keys = enable_normalized_sort_keys;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      for (const size_t limit : {size_t(0), size_t(4)}) {
+        const auto rows = run_multiple_agg(
+            "SELECT a, b FROM order_by_null_test ORDER BY a NULLS FIRST, b DESC" +
+                (limit ? " LIMIT " + std::to_string(limit) : std::string()) + ";",
+            dt);
+        const auto row_count = limit ? limit : expected_b.size();
+        ASSERT_EQ(row_count, rows->rowCount());
+        for (size_t i = 0; i < row_count; ++i) {
+          const auto crt_row = rows->getNextRow(true, true);
+          ASSERT_EQ(size_t(2), crt_row.size());
+          ASSERT_EQ(expected_b[i], v<int64_t>(crt_row[1])) << "row " << i;
+        }
+      }
+    }
+  }
+}
+
 TEST(Select, VariableLengthOrderBy) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7400,6 +7861,139 @@ TEST(Select, GroupByBaselineHash) {
   }
 }
 
+TEST(Select, GroupBySpill) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  // Smaller than the buffer of the default entry count guess, fits that of a partition
+  const auto max_cpu_group_by_buffer_bytes = g_max_cpu_group_by_buffer_bytes;
+  ScopeGuard reset = [max_cpu_group_by_buffer_bytes] {
+    g_max_cpu_group_by_buffer_bytes = max_cpu_group_by_buffer_bytes;
+  };
+  g_max_cpu_group_by_buffer_bytes = 16384 * 8;
+
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT x, d, COUNT(*), SUM(y) FROM test GROUP BY x, d ORDER BY x, d;", dt);
+  c("SELECT str, d, COUNT(*), MIN(t), MAX(dd), AVG(y) FROM test GROUP BY str, d ORDER "
+    "BY str, d;",
+    dt);
+  {
+    std::string query(
+        "SELECT ofd, d, COUNT(*), SUM(ofq) FROM test GROUP BY ofd, d ORDER BY ofd ASC");
+    c(query + " NULLS FIRST, d;", query + ", d;", dt);
+  }
+  c("SELECT x1, x2, x3, x4, COUNT(*), MIN(x5) FROM random_test "
+    "GROUP BY x1, x2, x3, x4 ORDER BY x1, x2, x3, x4;",
+    dt);
+  EXPECT_THROW(
+      run_multiple_agg("SELECT x, d, COUNT(DISTINCT y) FROM test GROUP BY x, d;", dt),
+      std::runtime_error);
+}
+
+TEST(Select, GroupBySpillStreaming) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto dt = ExecutorDeviceType::CPU;
+  const std::string query{"SELECT x, d, COUNT(*), SUM(y) FROM test GROUP BY x, d;"};
+  const auto get_groups = [&query, dt](size_t& row_count) {
+    const auto rows = run_multiple_agg(query, dt);
+    row_count = rows->rowCount();
+    std::multiset<std::vector<int64_t>> groups;
+    while (true) {
+      const auto crt_row = rows->getNextRow(true, true);
+      if (crt_row.empty()) {
+        break;
+      }
+      groups.insert({v<int64_t>(crt_row[0]),
+                     static_cast<int64_t>(v<double>(crt_row[1]) * 100),
+                     v<int64_t>(crt_row[2]),
+                     v<int64_t>(crt_row[3])});
+    }
+    return groups;
+  };
+  size_t expected_row_count{0};
+  const auto expected_groups = get_groups(expected_row_count);
+
+  const auto max_cpu_group_by_buffer_bytes = g_max_cpu_group_by_buffer_bytes;
+  const auto spilled_rows_block_bytes = g_spilled_rows_block_bytes;
+  ScopeGuard reset = [max_cpu_group_by_buffer_bytes, spilled_rows_block_bytes] {
+    g_max_cpu_group_by_buffer_bytes = max_cpu_group_by_buffer_bytes;
+    g_spilled_rows_block_bytes = spilled_rows_block_bytes;
+  };
+  g_max_cpu_group_by_buffer_bytes = 16384 * 8;
+  // One spilled row read back at a time
+  g_spilled_rows_block_bytes = 1;
+  size_t row_count{0};
+  const auto groups = get_groups(row_count);
+  ASSERT_EQ(expected_row_count, row_count);
+  ASSERT_EQ(expected_row_count, groups.size());
+  ASSERT_EQ(expected_groups, groups);
+}
+
+TEST(Select, GroupByBaselinePreaggregation) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto dt = ExecutorDeviceType::CPU;
+  const std::string query{
+      "SELECT x, d, COUNT(*), SUM(y), MIN(y), MAX(z) FROM test GROUP BY x, d;"};
+  const auto get_groups = [&query, dt]() {
+    const auto rows = run_multiple_agg(query, dt);
+    std::multiset<std::vector<int64_t>> groups;
+    while (true) {
+      const auto crt_row = rows->getNextRow(true, true);
+      if (crt_row.empty()) {
+        break;
+      }
+      groups.insert({v<int64_t>(crt_row[0]),
+                     static_cast<int64_t>(v<double>(crt_row[1]) * 100),
+                     v<int64_t>(crt_row[2]),
+                     v<int64_t>(crt_row[3]),
+                     v<int64_t>(crt_row[4]),
+                     v<int64_t>(crt_row[5])});
+    }
+    return groups;
+  };
+  const auto expected_groups = get_groups();
+
+  const auto enable_baseline_preaggregation = g_enable_baseline_preaggregation;
+  const auto baseline_preaggregation_entry_count = g_baseline_preaggregation_entry_count;
+  ScopeGuard reset = [enable_baseline_preaggregation,
+                      baseline_preaggregation_entry_count] {
+    g_enable_baseline_preaggregation = enable_baseline_preaggregation;
+    g_baseline_preaggregation_entry_count = baseline_preaggregation_entry_count;
+  };
+  g_enable_baseline_preaggregation = true;
+  // Tiny buffers, flushed to the partitions and resumed over and over
+  g_baseline_preaggregation_entry_count = 2;
+  ASSERT_EQ(expected_groups, get_groups());
+}
+
+TEST(Select, ChunkPrefetch) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_chunk_prefetch = g_enable_chunk_prefetch;
+  ScopeGuard reset = [enable_chunk_prefetch] {
+    g_enable_chunk_prefetch = enable_chunk_prefetch;
+  };
+
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const bool enable : {false, true}) {
+    g_enable_chunk_prefetch = enable;
+    // Every fragment of the table has to be read from disk again
+    QR::get()->clearCpuMemory();
+    const auto rows = run_multiple_agg(
+        "SELECT COUNT(*), SUM(x), MIN(y), MAX(z) FROM gpu_sort_test WHERE t > 0;", dt);
+    const auto prefetch_lookups = rows->getPrefetchHits() + rows->getPrefetchMisses();
+    if (enable) {
+      EXPECT_GT(prefetch_lookups, size_t(0));
+    } else {
+      EXPECT_EQ(prefetch_lookups, size_t(0));
+    }
+    c("SELECT COUNT(*), SUM(x), MIN(y), MAX(z) FROM gpu_sort_test WHERE t > 0;", dt);
+    QR::get()->clearCpuMemory();
+    c("SELECT x, y, z, t FROM gpu_sort_test ORDER BY x, y, z, t;", dt);
+  }
+}
+
 TEST(Select, GroupByConstrainedByInQueryRewrite) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7857,6 +8451,37 @@ TEST(Select, Subqueries) {
   }
 }
 
+TEST(Select, InSubqueryHashSemiJoin) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto hash_semi_join_threshold = g_hash_semi_join_threshold;
+  ScopeGuard reset = [hash_semi_join_threshold] {
+    g_hash_semi_join_threshold = hash_semi_join_threshold;
+  };
+  g_hash_semi_join_threshold = 1;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test WHERE y > 42);", dt);
+    c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM join_test);", dt);
+    c("SELECT x, COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner) AND y > 0 "
+      "GROUP BY x ORDER BY x;",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE x NOT IN (SELECT x FROM test_inner);", dt);
+    c("SELECT COUNT(*) FROM test WHERE y NOT IN (SELECT y FROM test_inner);", dt);
+    c("SELECT COUNT(*) FROM test WHERE str IN (SELECT str FROM test GROUP BY str);", dt);
+    c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner) AND y IN (SELECT "
+      "y FROM test_inner);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE (x, y) IN (SELECT x, y FROM test_inner);", dt);
+    c("SELECT COUNT(*) FROM test WHERE (x, str) IN (SELECT x, str FROM test WHERE y > "
+      "42);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE (x, y) IN (SELECT x, y FROM test WHERE x < 0);",
+      dt);
+  }
+}
+
 TEST(Select, Joins_Arrays) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -15572,6 +16197,47 @@ TEST(Delete, IntraFragment) {
   }
 }
 
+TEST(Delete, VacuumEncodedColumns) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+
+    run_ddl_statement("drop table if exists vacuum_encoded;");
+    run_ddl_statement(build_create_table_statement(
+        "i1 integer, r1 integer encoding rl, d1 bigint encoding diff(16), t1 text",
+        "vacuum_encoded",
+        {"", 0},
+        {},
+        10,
+        g_use_temporary_tables,
+        false,
+        false));
+    ScopeGuard drop_table = [] {
+      run_ddl_statement("DROP TABLE IF EXISTS vacuum_encoded;");
+    };
+
+    for (int i = 0; i < 8; ++i) {
+      run_multiple_agg("insert into vacuum_encoded values(" + std::to_string(i) + ", " +
+                           std::to_string(i / 3) + ", " + std::to_string(1000 + i) +
+                           ", '" + std::to_string(i) + "');",
+                       dt);
+    }
+    run_multiple_agg("delete from vacuum_encoded where i1 = 2 or i1 = 5;", dt);
+
+    ASSERT_EQ(int64_t(6),
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM vacuum_encoded;", dt)));
+    ASSERT_EQ(int64_t(0 + 0 + 1 + 1 + 2 + 2),
+              v<int64_t>(run_simple_agg("SELECT SUM(r1) FROM vacuum_encoded;", dt)));
+    ASSERT_EQ(int64_t(1000 + 1001 + 1003 + 1004 + 1006 + 1007),
+              v<int64_t>(run_simple_agg("SELECT SUM(d1) FROM vacuum_encoded;", dt)));
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT r1 FROM vacuum_encoded WHERE i1 = 4;", dt)));
+    ASSERT_EQ(int64_t(1006),
+              v<int64_t>(run_simple_agg(
+                  "SELECT d1 FROM vacuum_encoded WHERE i1 = 6;", dt)));
+  }
+}
+
 TEST(Join, InnerJoin_TwoTables) {
   SKIP_ALL_ON_AGGREGATOR();
 
@@ -15927,6 +16593,57 @@ TEST(Join, LeftJoin_Filters) {
   }
 }
 
+TEST(Join, RightOuterJoin) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT test.x, test_inner.x FROM test_inner RIGHT OUTER JOIN test ON test.x = "
+      "test_inner.x ORDER BY test.x ASC, test_inner.x ASC NULLS FIRST;",
+      "SELECT test.x, test_inner.x FROM test LEFT OUTER JOIN test_inner ON test.x = "
+      "test_inner.x ORDER BY test.x ASC, test_inner.x ASC;",
+      dt);
+    c("SELECT COUNT(*) FROM test b RIGHT JOIN test_inner a ON a.x = b.x;",
+      "SELECT COUNT(*) FROM test_inner a LEFT JOIN test b ON a.x = b.x;",
+      dt);
+    c("SELECT a.x, b.str FROM test b RIGHT JOIN join_test a ON a.x = b.x WHERE b.y > 40 "
+      "OR b.y IS NULL ORDER BY a.x, b.str NULLS FIRST;",
+      "SELECT a.x, b.str FROM join_test a LEFT JOIN test b ON a.x = b.x WHERE b.y > 40 "
+      "OR b.y IS NULL ORDER BY a.x, b.str;",
+      dt);
+  }
+}
+
+TEST(Join, FullOuterJoin) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  // The FULL join as a LEFT join followed by the unmatched rows of the right side.
+  const std::string sqlite_full_join{
+      "(SELECT a.x AS ax, a.str AS astr, b.x AS bx, b.str AS bstr FROM join_test a LEFT "
+      "JOIN test_inner b ON a.x = b.x UNION ALL SELECT NULL, NULL, b.x, b.str FROM "
+      "test_inner b WHERE NOT EXISTS (SELECT 1 FROM join_test a WHERE a.x = b.x))"};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT a.x, b.x FROM join_test a FULL OUTER JOIN test_inner b ON a.x = b.x ORDER "
+      "BY a.x NULLS FIRST, b.x NULLS FIRST;",
+      "SELECT ax, bx FROM " + sqlite_full_join + " ORDER BY ax, bx;",
+      dt);
+    c("SELECT a.str, b.str FROM join_test a FULL JOIN test_inner b ON a.x = b.x ORDER BY "
+      "a.str NULLS FIRST, b.str NULLS FIRST;",
+      "SELECT astr, bstr FROM " + sqlite_full_join + " ORDER BY astr, bstr;",
+      dt);
+    c("SELECT COUNT(*), COUNT(a.x), COUNT(b.x) FROM join_test a FULL JOIN test_inner b "
+      "ON a.x = b.x;",
+      "SELECT COUNT(*), COUNT(ax), COUNT(bx) FROM " + sqlite_full_join + ";",
+      dt);
+    c("SELECT a.x, b.x FROM join_test a FULL JOIN test_inner b ON a.x = b.x WHERE b.x IS "
+      "NULL OR a.x IS NULL ORDER BY a.x NULLS FIRST, b.x NULLS FIRST;",
+      "SELECT ax, bx FROM " + sqlite_full_join +
+          " WHERE bx IS NULL OR ax IS NULL ORDER BY ax, bx;",
+      dt);
+  }
+}
+
 TEST(Join, MultiCompositeColumns) {
   SKIP_ALL_ON_AGGREGATOR();
 
@@ -15964,6 +16681,126 @@ TEST(Join, MultiCompositeColumns) {
   }
 }
 
+TEST(Join, PartitionedBuild) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto partition_bytes = g_hash_join_build_partition_bytes;
+  ScopeGuard reset = [partition_bytes] {
+    g_hash_join_build_partition_bytes = partition_bytes;
+    QR::get()->clearCpuMemory();
+  };
+  // Split even the small keyed hash tables of the test tables into many partitions, the
+  // cached hash tables have been built directly.
+  g_hash_join_build_partition_bytes = 16;
+  QR::get()->clearCpuMemory();
+
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT a.z, b.str FROM test a JOIN join_test b ON a.y = b.y AND a.x = b.x ORDER "
+    "BY a.z, b.str;",
+    dt);
+  c("SELECT a.z, b.str FROM test a JOIN test_inner b ON a.y = b.y AND a.x = b.x ORDER "
+    "BY a.z, b.str;",
+    dt);
+  c("SELECT COUNT(*) FROM test a JOIN join_test b ON a.x = b.x AND a.y = b.x JOIN "
+    "test_inner c ON a.x = c.x WHERE c.str <> 'foo';",
+    dt);
+  c("SELECT COUNT(*) FROM test, join_test WHERE (test.x = join_test.x OR (test.x IS "
+    "NULL AND join_test.x IS NULL)) AND (test.y = join_test.y OR (test.y IS NULL AND "
+    "join_test.y IS NULL));",
+    dt);
+}
+
+TEST(Join, InnerJoinKeyFragmentSkipping) {
+  SKIP_ALL_ON_AGGREGATOR();
+  ScopeGuard reset = [] {
+    g_enable_chunk_value_filters = false;
+    run_ddl_statement("DROP TABLE IF EXISTS join_skip_fact;");
+    run_ddl_statement("DROP TABLE IF EXISTS join_skip_dim;");
+  };
+  g_enable_chunk_value_filters = true;
+  run_ddl_statement("DROP TABLE IF EXISTS join_skip_fact;");
+  run_ddl_statement("DROP TABLE IF EXISTS join_skip_dim;");
+  run_ddl_statement(
+      "CREATE TABLE join_skip_fact (k INT, s TEXT ENCODING DICT(32), v INT) WITH "
+      "(fragment_size=4);");
+  run_ddl_statement(
+      "CREATE TABLE join_skip_dim (k INT, s TEXT ENCODING DICT(32), name TEXT ENCODING "
+      "DICT(32));");
+  // The first five fragments of the fact table hold the keys 0 to 19, the next ones the
+  // even keys from 60 on.
+  for (int i = 0; i < 40; i++) {
+    const auto k = i < 20 ? i : 20 + 2 * i;
+    run_multiple_agg("INSERT INTO join_skip_fact VALUES(" + std::to_string(k) + ", 's" +
+                         std::to_string(k % 13) + "', " + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("INSERT INTO join_skip_dim VALUES(5, 's5', 'a');",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO join_skip_dim VALUES(6, 's40', 'a');",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO join_skip_dim VALUES(61, 's12', 'b');",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO join_skip_dim VALUES(62, 's3', 'b');",
+                   ExecutorDeviceType::CPU);
+  const auto skipped_fragments = [](const std::string& query,
+                                    const ExecutorDeviceType dt) {
+    return run_multiple_agg(query, dt)->getJoinKeySkippedFragments();
+  };
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // Only the fragments holding 4 to 7 and 60 to 66 have a key of the dimension table,
+    // the range of the keys rules out the first one and the last four, the value filters
+    // the three in between.
+    EXPECT_EQ(size_t(8),
+              skipped_fragments("SELECT COUNT(*) FROM join_skip_fact f JOIN "
+                                "join_skip_dim d ON f.k = d.k;",
+                                dt));
+    EXPECT_EQ(size_t(10),
+              skipped_fragments("SELECT COUNT(*) FROM join_skip_fact f JOIN (SELECT k "
+                                "FROM join_skip_dim WHERE name = 'c') d ON f.k = d.k;",
+                                dt));
+    EXPECT_EQ(size_t(0),
+              skipped_fragments("SELECT COUNT(*) FROM join_skip_fact f LEFT JOIN (SELECT "
+                                "k FROM join_skip_dim WHERE name = 'c') d ON f.k = d.k;",
+                                dt));
+    // The keyed hash table of a composite key summarizes every component.
+    EXPECT_EQ(size_t(8),
+              skipped_fragments("SELECT COUNT(*) FROM join_skip_fact f JOIN "
+                                "join_skip_dim d ON f.k = d.k AND f.s = d.s;",
+                                dt));
+    EXPECT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM join_skip_fact f JOIN join_skip_dim d ON f.k = "
+                  "d.k AND f.s = d.s;",
+                  dt)));
+    EXPECT_EQ(int64_t(3),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM join_skip_fact f JOIN join_skip_dim d ON f.k = "
+                  "d.k;",
+                  dt)));
+    EXPECT_EQ(int64_t(11),
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(f.v) FROM join_skip_fact f JOIN join_skip_dim d ON f.k = "
+                  "d.k WHERE d.name = 'a';",
+                  dt)));
+    EXPECT_EQ(int64_t(0),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM join_skip_fact f JOIN (SELECT k FROM "
+                  "join_skip_dim WHERE name = 'c') d ON f.k = d.k;",
+                  dt)));
+    EXPECT_EQ(int64_t(11),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM join_skip_fact f JOIN join_skip_dim d ON f.s = "
+                  "d.s;",
+                  dt)));
+    EXPECT_EQ(int64_t(4),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM join_skip_fact f LEFT JOIN (SELECT k FROM "
+                  "join_skip_dim WHERE name = 'c') d ON f.k = d.k WHERE f.k < 4;",
+                  dt)));
+  }
+}
+
 TEST(Join, BuildHashTable) {
   SKIP_ALL_ON_AGGREGATOR();
 
@@ -19210,6 +20047,90 @@ TEST(Select, WindowFunctionAggregateNoOrder) {
   }
 }
 
+TEST(Select, WindowFunctionAggregateFrame) {
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  for (const auto& frame : {"ROWS BETWEEN 1 PRECEDING AND 1 FOLLOWING",
+                            "ROWS BETWEEN UNBOUNDED PRECEDING AND 2 FOLLOWING",
+                            "ROWS BETWEEN 2 PRECEDING AND UNBOUNDED FOLLOWING",
+                            "ROWS BETWEEN 3 PRECEDING AND 1 PRECEDING",
+                            "ROWS BETWEEN 1 FOLLOWING AND 20 FOLLOWING"}) {
+    const std::string window = std::string("(PARTITION BY y ORDER BY t ") + frame + ")";
+    const std::string query = "SELECT t, SUM(x) OVER " + window + ", AVG(x) OVER " +
+                              window + ", MIN(f) OVER " + window + ", MAX(dd) OVER " +
+                              window + ", COUNT(x) OVER " + window +
+                              ", COUNT(*) OVER " + window +
+                              " FROM test_window_func ORDER BY t ASC;";
+    c(query, query, dt);
+  }
+  {
+    const std::string query =
+        "SELECT t, SUM(x) OVER (ORDER BY t DESC ROWS BETWEEN 2 PRECEDING AND CURRENT "
+        "ROW) FROM test_window_func ORDER BY t ASC;";
+    c(query, query, dt);
+  }
+  // The bundled sqlite doesn't support RANGE frames with offsets, check the results
+  // directly: partition 'bbb' has x = 3, 6, 6, 9, 9, 9, 10 and NULL keys only frame
+  // their peers.
+  const auto check_range_frame = [dt](const std::string& window,
+                                      const std::vector<int64_t>& expected) {
+    const auto rows = run_multiple_agg("SELECT t, SUM(t) OVER " + window +
+                                           " FROM test_window_func ORDER BY t ASC;",
+                                       dt);
+    ASSERT_EQ(expected.size(), rows->rowCount());
+    for (const auto expected_sum : expected) {
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(2), crt_row.size());
+      ASSERT_EQ(expected_sum, v<int64_t>(crt_row[1]));
+    }
+  };
+  check_range_frame(
+      "(PARTITION BY y ORDER BY x RANGE BETWEEN 1 PRECEDING AND 1 FOLLOWING)",
+      {9, 9, 6, 42, 8, 20, 42, 20, 42, 42, 14});
+  check_range_frame(
+      "(PARTITION BY y ORDER BY x DESC RANGE BETWEEN CURRENT ROW AND 3 FOLLOWING)",
+      {9, 5, 6, 42, 8, 28, 55, 28, 55, 55, 14});
+}
+
+TEST(Select, WindowFunctionParallelSort) {
+  const auto parallel_sort_threshold = g_window_function_parallel_sort_threshold;
+  ScopeGuard reset = [parallel_sort_threshold] {
+    g_window_function_parallel_sort_threshold = parallel_sort_threshold;
+  };
+  // Every partition with more than one row gets sorted by all the threads.
+  g_window_function_parallel_sort_threshold = 2;
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  {
+    std::string part1 =
+        "SELECT x, y, ROW_NUMBER() OVER (PARTITION BY y ORDER BY x ASC) r1, RANK() OVER "
+        "(PARTITION BY y ORDER BY x ASC) r2, DENSE_RANK() OVER (PARTITION BY y ORDER BY "
+        "x DESC) r3 FROM test_window_func ORDER BY x ASC";
+    std::string part2 = ", y ASC, r1 ASC, r2 ASC, r3 ASC;";
+    c(part1 + " NULLS FIRST" + part2, part1 + part2, dt);
+  }
+  {
+    std::string part1 =
+        "SELECT x, y, LAG(x + 5) OVER (PARTITION BY y ORDER BY x ASC) l FROM "
+        "test_window_func ORDER BY x ASC";
+    std::string part2 = ", y ASC, l ASC";
+    c(part1 + " NULLS FIRST" + part2 + " NULLS FIRST;", part1 + part2 + ";", dt);
+  }
+  {
+    std::string part1 =
+        "SELECT x, y, SUM(x) OVER (PARTITION BY y ORDER BY x ASC) s, COUNT(x) OVER "
+        "(PARTITION BY y ORDER BY x ASC) c FROM test_window_func ORDER BY x ASC";
+    std::string part2 = "s ASC, c ASC;";
+    c(part1 + " NULLS FIRST, y ASC NULLS FIRST, " + part2,
+      part1 + ", y ASC, " + part2,
+      dt);
+  }
+  {
+    const std::string query =
+        "SELECT t, SUM(x) OVER (PARTITION BY y ORDER BY t ROWS BETWEEN 1 PRECEDING AND 1 "
+        "FOLLOWING) FROM test_window_func ORDER BY t ASC;";
+    c(query, query, dt);
+  }
+}
+
 TEST(Select, WindowFunctionSum) {
   const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
   c("SELECT total FROM (SELECT SUM(n) OVER (PARTITION BY y) AS total FROM (SELECT y, "
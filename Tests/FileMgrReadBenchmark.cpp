@@ -0,0 +1,197 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    FileMgrReadBenchmark.cpp
+ * @brief   Scans of chunks stored by the FileMgr, with a cold or a warm page cache, with
+ *          or without page compression and page checksums.
+ *
+ * The data files are written under the system temporary directory, point TMPDIR to the
+ * device to measure for the cold scans to be meaningful.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DataMgr/FileMgr/GlobalFileMgr.h"
+#include "Shared/crc32c.h"
+#include "Tests/TestHelpers.h"
+
+namespace {
+
+constexpr size_t kChunkCount{4};
+constexpr size_t kChunkBytes{size_t(1) << 28};
+
+boost::filesystem::path g_data_path;
+
+struct PageFormat {
+  File_Namespace::PageCompression compression;
+  bool checksums;
+};
+
+// Every page format has its own table
+const std::vector<PageFormat> kPageFormats{{File_Namespace::PageCompression::NONE, false},
+                                           {File_Namespace::PageCompression::NONE, true},
+                                           {File_Namespace::PageCompression::LZ4, false},
+                                           {File_Namespace::PageCompression::LZ4, true},
+                                           {File_Namespace::PageCompression::ZSTD, true}};
+
+std::string to_string(const PageFormat& page_format) {
+  return File_Namespace::to_string(page_format.compression) +
+         (page_format.checksums ? "/CRC32C" : "");
+}
+
+ChunkKey get_chunk_key(const size_t format_idx, const size_t chunk_idx) {
+  return {1, static_cast<int>(format_idx) + 1, static_cast<int>(chunk_idx) + 1, 0};
+}
+
+// Ascending integers with some noise, their high bytes compress well once shuffled
+void write_chunks() {
+  File_Namespace::GlobalFileMgr gfm(0, g_data_path.string());
+  std::vector<int32_t> data(kChunkBytes / sizeof(int32_t));
+  for (size_t format_idx = 0; format_idx < kPageFormats.size(); ++format_idx) {
+    const auto table_key = get_chunk_key(format_idx, 0);
+    gfm.setTablePageCompression(
+        table_key[0], table_key[1], kPageFormats[format_idx].compression);
+    auto fm = dynamic_cast<File_Namespace::FileMgr*>(
+        gfm.getFileMgr(table_key[0], table_key[1]));
+    CHECK(fm);
+    fm->setPageChecksums(kPageFormats[format_idx].checksums);
+    std::mt19937 rng(1);
+    for (size_t chunk_idx = 0; chunk_idx < kChunkCount; ++chunk_idx) {
+      for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int32_t>((chunk_idx * data.size() + i) / 64 + rng() % 256);
+      }
+      auto buffer = gfm.createBuffer(get_chunk_key(format_idx, chunk_idx));
+      buffer->initEncoder(SQLTypeInfo(kINT, false));
+      buffer->append(reinterpret_cast<int8_t*>(data.data()), kChunkBytes);
+    }
+    gfm.checkpoint(table_key[0], table_key[1]);
+  }
+}
+
+// Evicts the data files from the page cache, they are clean after the checkpoint.
+void drop_page_cache() {
+  for (const auto& entry : boost::filesystem::recursive_directory_iterator(g_data_path)) {
+    if (!boost::filesystem::is_regular_file(entry.path())) {
+      continue;
+    }
+    const int fd = open(entry.path().c_str(), O_RDONLY);
+    CHECK_GE(fd, 0);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+}
+
+}  // namespace
+
+/**
+ * Reads all the chunks of a table into host memory, one after the other, with
+ * state.range(0) reader threads. The page cache is dropped before every iteration if
+ * state.range(1) is set. The pages of the table have the format
+ * kPageFormats[state.range(2)].
+ */
+class ScanFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    gfm_ = std::make_unique<File_Namespace::GlobalFileMgr>(
+        0, g_data_path.string(), state.range(0));
+  }
+
+  void TearDown(const ::benchmark::State& state) override { gfm_.reset(); }
+
+ protected:
+  std::unique_ptr<File_Namespace::GlobalFileMgr> gfm_;
+};
+
+BENCHMARK_DEFINE_F(ScanFixture, Scan)(benchmark::State& state) {
+  std::vector<int8_t> dst(kChunkBytes);
+  for (auto _ : state) {
+    if (state.range(1)) {
+      state.PauseTiming();
+      drop_page_cache();
+      state.ResumeTiming();
+    }
+    for (size_t chunk_idx = 0; chunk_idx < kChunkCount; ++chunk_idx) {
+      auto buffer = gfm_->getBuffer(get_chunk_key(state.range(2), chunk_idx));
+      buffer->read(dst.data(), kChunkBytes);
+      benchmark::DoNotOptimize(dst.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * kChunkCount * kChunkBytes);
+  state.SetLabel(to_string(kPageFormats[state.range(2)]));
+}
+
+void threads_cold_cache_and_format(benchmark::internal::Benchmark* b) {
+  for (int64_t format_idx = 0; format_idx < static_cast<int64_t>(kPageFormats.size());
+       ++format_idx) {
+    for (int64_t cold_cache : {1, 0}) {
+      for (int64_t threads : {1, 2, 4, 8, 16, 32}) {
+        b->Args({threads, cold_cache, format_idx});
+      }
+    }
+  }
+}
+
+BENCHMARK_REGISTER_F(ScanFixture, Scan)
+    ->Apply(threads_cold_cache_and_format)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Checksum of a page worth of bytes, with the crc32 instruction of SSE4.2 if
+ * state.range(0) is set and the CPU supports it, with the portable implementation
+ * otherwise.
+ */
+static void Crc32c(benchmark::State& state) {
+  std::vector<uint8_t> data(size_t(2) << 20);
+  std::mt19937 rng(1);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  const bool hw = state.range(0) && crc32c_is_hw_accelerated();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hw ? crc32c(0, data.data(), data.size())
+                                : crc32c_sw(0, data.data(), data.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+  state.SetLabel(hw ? "SSE4.2" : "portable");
+}
+
+BENCHMARK(Crc32c)->Arg(1)->Arg(0);
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  g_data_path = boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("omnisci_scan_%%%%-%%%%-%%%%");
+  write_chunks();
+  ::benchmark::RunSpecifiedBenchmarks();
+  boost::filesystem::remove_all(g_data_path);
+  return 0;
+}
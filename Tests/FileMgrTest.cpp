@@ -20,11 +20,21 @@
  */
 
 #include <gtest/gtest.h>
+#include <array>
+#include <boost/filesystem.hpp>
+#include <numeric>
 #include "DBHandlerTestHelpers.h"
 #include "DataMgr/FileMgr/FileMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
+#include "DataMgr/FileMgr/PageScrubber.h"
+#include "Shared/crc32c.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
+extern bool g_enable_chunk_value_filters;
+extern bool g_enable_file_mgr_index;
+extern bool g_enable_page_checksums;
+
 class FileMgrTest : public DBHandlerTestFixture {
  protected:
   std::string table_name;
@@ -138,6 +148,273 @@ TEST_F(FileMgrTest, putBuffer_append) {
   compareBuffersAndMetadata(source_buffer, file_buffer, 8);
 }
 
+TEST_F(FileMgrTest, openFromIndex) {
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+  const auto index_path = table_file_mgr->getFileMgrBasePath() + "/index";
+  // Written by the checkpoint of the insert
+  ASSERT_TRUE(boost::filesystem::exists(index_path));
+  {
+    File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+    ASSERT_EQ(file_mgr.getNumChunks(), table_file_mgr->getNumChunks());
+    compareBuffersAndMetadata(
+        table_file_mgr->getBuffer(chunk_key), file_mgr.getBuffer(chunk_key), 4);
+  }
+  ASSERT_TRUE(boost::filesystem::exists(index_path));
+
+  // The header scan gets the same chunks, and removes the index file
+  g_enable_file_mgr_index = false;
+  ScopeGuard reset = [] { g_enable_file_mgr_index = true; };
+  {
+    File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+    ASSERT_EQ(file_mgr.getNumChunks(), table_file_mgr->getNumChunks());
+    compareBuffersAndMetadata(
+        table_file_mgr->getBuffer(chunk_key), file_mgr.getBuffer(chunk_key), 4);
+  }
+  ASSERT_FALSE(boost::filesystem::exists(index_path));
+}
+
+TEST_F(FileMgrTest, indexInvalidatedByWrite) {
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+  const auto index_path = table_file_mgr->getFileMgrBasePath() + "/index";
+  ASSERT_TRUE(boost::filesystem::exists(index_path));
+  int8_t temp_array[4] = {1, 2, 3, 4};
+  table_file_mgr->getBuffer(chunk_key)->write(temp_array, 4);
+  ASSERT_FALSE(boost::filesystem::exists(index_path));
+  table_file_mgr->checkpoint();
+  ASSERT_TRUE(boost::filesystem::exists(index_path));
+  File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+  compareBuffersAndMetadata(
+      table_file_mgr->getBuffer(chunk_key), file_mgr.getBuffer(chunk_key), 4);
+}
+
+TEST_F(FileMgrTest, compressedPages) {
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+  table_file_mgr->setPageCompression(File_Namespace::PageCompression::LZ4);
+  ScopeGuard reset = [table_file_mgr] {
+    table_file_mgr->setPageCompression(File_Namespace::PageCompression::NONE);
+  };
+  const ChunkKey compressed_key{chunk_key[0], chunk_key[1], chunk_key[2], 1};
+  auto buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+      table_file_mgr->createBuffer(compressed_key));
+  ASSERT_TRUE(buffer);
+  ASSERT_EQ(buffer->pageCompression(), File_Namespace::PageCompression::LZ4);
+  buffer->initEncoder(SQLTypeInfo(kINT, false));
+
+  // Three pages and a half, appended in two parts
+  const size_t page_values = buffer->pageDataSize() / sizeof(int32_t);
+  std::vector<int32_t> values(3 * page_values + page_values / 2);
+  std::iota(values.begin(), values.end(), 0);
+  const size_t first_part = page_values + 10;
+  buffer->append(reinterpret_cast<int8_t*>(values.data()), first_part * sizeof(int32_t));
+  buffer->append(reinterpret_cast<int8_t*>(&values[first_part]),
+                 (values.size() - first_part) * sizeof(int32_t));
+  table_file_mgr->checkpoint();
+
+  // Overwrite values around the boundary of the second and third pages, in new versions
+  // of the pages
+  const size_t first_written = 2 * page_values - 5;
+  for (size_t i = first_written; i < first_written + 10; ++i) {
+    values[i] = -values[i];
+  }
+  buffer->write(reinterpret_cast<int8_t*>(&values[first_written]),
+                10 * sizeof(int32_t),
+                first_written * sizeof(int32_t));
+  std::vector<int32_t> read_values(values.size());
+  buffer->read(reinterpret_cast<int8_t*>(read_values.data()),
+               values.size() * sizeof(int32_t));
+  ASSERT_EQ(values, read_values);
+  std::vector<int32_t> part(20);
+  buffer->read(reinterpret_cast<int8_t*>(part.data()),
+               part.size() * sizeof(int32_t),
+               (first_written - 5) * sizeof(int32_t));
+  ASSERT_TRUE(std::equal(part.begin(), part.end(), values.begin() + first_written - 5));
+  table_file_mgr->checkpoint();
+
+  // The compression of the chunk comes from its metadata
+  table_file_mgr->setPageCompression(File_Namespace::PageCompression::NONE);
+  File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+  auto reopened_buffer =
+      dynamic_cast<File_Namespace::FileBuffer*>(file_mgr.getBuffer(compressed_key));
+  ASSERT_TRUE(reopened_buffer);
+  ASSERT_EQ(reopened_buffer->pageCompression(), File_Namespace::PageCompression::LZ4);
+  ASSERT_EQ(reopened_buffer->size(), values.size() * sizeof(int32_t));
+  std::fill(read_values.begin(), read_values.end(), 0);
+  reopened_buffer->read(reinterpret_cast<int8_t*>(read_values.data()),
+                        values.size() * sizeof(int32_t));
+  ASSERT_EQ(values, read_values);
+}
+
+TEST_F(FileMgrTest, pageChecksums) {
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+  table_file_mgr->setPageChecksums(true);
+  ScopeGuard reset = [table_file_mgr] {
+    table_file_mgr->setPageChecksums(g_enable_page_checksums);
+  };
+  const ChunkKey checksummed_key{chunk_key[0], chunk_key[1], chunk_key[2], 1};
+  auto buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+      table_file_mgr->createBuffer(checksummed_key));
+  ASSERT_TRUE(buffer);
+  ASSERT_TRUE(buffer->hasPageChecksums());
+  buffer->initEncoder(SQLTypeInfo(kINT, false));
+
+  // Two pages and a half, appended in two parts, the checksum of the second page is
+  // extended by the second one
+  const size_t page_values = buffer->pageDataSize() / sizeof(int32_t);
+  std::vector<int32_t> values(2 * page_values + page_values / 2);
+  std::iota(values.begin(), values.end(), 0);
+  const size_t first_part = page_values + 10;
+  buffer->append(reinterpret_cast<int8_t*>(values.data()), first_part * sizeof(int32_t));
+  buffer->append(reinterpret_cast<int8_t*>(&values[first_part]),
+                 (values.size() - first_part) * sizeof(int32_t));
+  table_file_mgr->checkpoint();
+
+  // Overwrite values around the boundary of the first and second pages
+  const size_t first_written = page_values - 5;
+  for (size_t i = first_written; i < first_written + 10; ++i) {
+    values[i] = -values[i];
+  }
+  buffer->write(reinterpret_cast<int8_t*>(&values[first_written]),
+                10 * sizeof(int32_t),
+                first_written * sizeof(int32_t));
+  std::vector<int32_t> read_values(values.size());
+  buffer->read(reinterpret_cast<int8_t*>(read_values.data()),
+               values.size() * sizeof(int32_t));
+  ASSERT_EQ(values, read_values);
+  table_file_mgr->checkpoint();
+
+  std::vector<int8_t> stored;
+  File_Namespace::PageVerification verification;
+  for (size_t page_num = 0; page_num < buffer->pageCount(); ++page_num) {
+    ASSERT_TRUE(
+        table_file_mgr->verifyPage(checksummed_key, page_num, stored, verification));
+    ASSERT_EQ(verification.check, File_Namespace::PageCheck::VERIFIED);
+  }
+  ASSERT_FALSE(table_file_mgr->verifyPage(
+      checksummed_key, buffer->pageCount(), stored, verification));
+
+  // The page format of the chunk comes from its metadata
+  table_file_mgr->setPageChecksums(false);
+  {
+    File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+    auto reopened_buffer =
+        dynamic_cast<File_Namespace::FileBuffer*>(file_mgr.getBuffer(checksummed_key));
+    ASSERT_TRUE(reopened_buffer);
+    ASSERT_TRUE(reopened_buffer->hasPageChecksums());
+    std::fill(read_values.begin(), read_values.end(), 0);
+    reopened_buffer->read(reinterpret_cast<int8_t*>(read_values.data()),
+                          values.size() * sizeof(int32_t));
+    ASSERT_EQ(values, read_values);
+  }
+
+  // Flip a byte of the data of the last page, the scrubber finds it
+  const auto page = verification.page;
+  auto file_info = table_file_mgr->getFileInfoForFileId(page.fileId);
+  const size_t byte_offset = page.pageNum * buffer->pageSize() +
+                             buffer->reservedHeaderSize() +
+                             File_Namespace::PAGE_CHECKSUM_SIZE + 7;
+  int8_t byte;
+  ASSERT_EQ(file_info->read(byte_offset, 1, &byte), size_t(1));
+  byte = ~byte;
+  ASSERT_EQ(file_info->write(byte_offset, 1, &byte), size_t(1));
+  ASSERT_TRUE(table_file_mgr->verifyPage(
+      checksummed_key, buffer->pageCount() - 1, stored, verification));
+  ASSERT_EQ(verification.check, File_Namespace::PageCheck::CORRUPT);
+
+  File_Namespace::PageScrubber scrubber(gfm, 0);
+  scrubber.scrubPass();
+  const auto stats = scrubber.getStats();
+  ASSERT_EQ(stats.passes, size_t(1));
+  ASSERT_EQ(stats.corrupt_pages, size_t(1));
+  ASSERT_EQ(stats.corrupt_page_descriptions.size(), size_t(1));
+  ASSERT_GE(stats.verified_pages, buffer->pageCount() - 1);
+
+  byte = ~byte;
+  ASSERT_EQ(file_info->write(byte_offset, 1, &byte), size_t(1));
+
+  // A checksum which matches the first bytes of the page only doesn't verify the others
+  const size_t checksum_offset =
+      page.pageNum * buffer->pageSize() + buffer->reservedHeaderSize();
+  File_Namespace::PageChecksum checksum;
+  auto checksum_bytes = reinterpret_cast<int8_t*>(&checksum);
+  ASSERT_EQ(file_info->read(checksum_offset, sizeof(checksum), checksum_bytes),
+            sizeof(checksum));
+  const auto valid_checksum = checksum;
+  std::array<int8_t, 8> first_bytes;
+  ASSERT_EQ(file_info->read(checksum_offset + File_Namespace::PAGE_CHECKSUM_SIZE,
+                            first_bytes.size(),
+                            first_bytes.data()),
+            first_bytes.size());
+  checksum = {static_cast<uint32_t>(first_bytes.size()),
+              crc32c(0, first_bytes.data(), first_bytes.size())};
+  ASSERT_EQ(file_info->write(checksum_offset, sizeof(checksum), checksum_bytes),
+            sizeof(checksum));
+  ASSERT_TRUE(table_file_mgr->verifyPage(
+      checksummed_key, buffer->pageCount() - 1, stored, verification));
+  ASSERT_EQ(verification.check, File_Namespace::PageCheck::CORRUPT);
+
+  checksum = valid_checksum;
+  ASSERT_EQ(file_info->write(checksum_offset, sizeof(checksum), checksum_bytes),
+            sizeof(checksum));
+  ASSERT_TRUE(table_file_mgr->verifyPage(
+      checksummed_key, buffer->pageCount() - 1, stored, verification));
+  ASSERT_EQ(verification.check, File_Namespace::PageCheck::VERIFIED);
+}
+
+TEST_F(FileMgrTest, valueFilterPages) {
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+  g_enable_chunk_value_filters = true;
+  ScopeGuard reset = [] { g_enable_chunk_value_filters = false; };
+  const ChunkKey filtered_key{chunk_key[0], chunk_key[1], chunk_key[2], 1};
+  auto buffer = table_file_mgr->createBuffer(filtered_key);
+  const SQLTypeInfo ti(kBIGINT, false);
+  buffer->initEncoder(ti);
+  ASSERT_TRUE(buffer->getEncoder()->hasValueFilter());
+
+  // Far more distinct values than a metadata page could hold the filter of
+  std::vector<int64_t> values(100000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = 3 * i;
+  }
+  auto data = reinterpret_cast<int8_t*>(values.data());
+  buffer->getEncoder()->appendData(data, values.size(), ti);
+  table_file_mgr->checkpoint();
+
+  const auto check_value_filter = [&](AbstractBuffer* reopened_buffer) {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    reopened_buffer->getEncoder()->getMetadata(chunk_metadata);
+    const auto value_filter = chunk_metadata->chunkStats.value_filter;
+    ASSERT_TRUE(value_filter);
+    ASSERT_FALSE(value_filter->isSaturated());
+    ASSERT_EQ(value_filter->getRowCount(), values.size());
+    size_t false_positives{0};
+    for (const auto val : values) {
+      ASSERT_TRUE(value_filter->mayContain(val)) << val;
+      false_positives += value_filter->mayContain(val + 1);
+    }
+    ASSERT_LT(false_positives, values.size() / 10);
+  };
+  {
+    File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+    check_value_filter(file_mgr.getBuffer(filtered_key));
+  }
+  g_enable_file_mgr_index = false;
+  ScopeGuard reset_index = [] { g_enable_file_mgr_index = true; };
+  {
+    File_Namespace::FileMgr file_mgr(0, gfm, file_mgr_key);
+    check_value_filter(file_mgr.getBuffer(filtered_key));
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -21,6 +21,7 @@
 #include "../QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
 #include "../QueryEngine/Execute.h"
 #include "../QueryRunner/QueryRunner.h"
+#include "../Shared/threadpool.h"
 
 #include <array>
 #include <future>
@@ -599,6 +600,194 @@ TEST_F(UpdateDeleteTestEnv, UpdateDelete_TwoTables) {
   }
 }
 
+TEST(QueryDispatchQueue, Priority) {
+  QueryDispatchQueue dispatch_queue(1);
+  std::promise<void> release_worker;
+  auto blocker = std::make_shared<QueryDispatchQueue::Task>(
+      [worker_released = release_worker.get_future().share()](const size_t) {
+        worker_released.wait();
+      });
+  dispatch_queue.submit(blocker, /*is_update_delete=*/false);
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  std::vector<std::shared_ptr<QueryDispatchQueue::Task>> tasks;
+  auto submit = [&](const std::string& name,
+                    const int priority,
+                    const std::string& owner) {
+    tasks.push_back(std::make_shared<QueryDispatchQueue::Task>(
+        [&order_mutex, &order, name](const size_t) {
+          EXPECT_GE(cpu_threads(), 1);
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(name);
+        }));
+    dispatch_queue.submit(tasks.back(), /*is_update_delete=*/false, priority, owner);
+  };
+  submit("low", -1, "alice");
+  submit("alice_1", 0, "alice");
+  submit("alice_2", 0, "alice");
+  submit("bob", 0, "bob");
+  submit("high", 5, "bob");
+  release_worker.set_value();
+  for (auto& task : tasks) {
+    task->get_future().get();
+  }
+  blocker->get_future().get();
+
+  // A single worker runs one query at a time, so within a priority the tasks run in
+  // submission order; higher priorities run first and the lowest one last.
+  const std::vector<std::string> expected{"high", "alice_1", "alice_2", "bob", "low"};
+  EXPECT_EQ(expected, order);
+}
+
+TEST(QueryDispatchQueue, ThreadBudget) {
+  const auto all_threads = cpu_threads();
+  const auto half_threads = std::max(all_threads / 2, 1);
+  QueryDispatchQueue dispatch_queue(2);
+  std::promise<void> release_worker;
+  std::promise<void> first_started;
+  std::promise<void> second_checked;
+  std::promise<void> first_checked;
+  auto first = std::make_shared<QueryDispatchQueue::Task>(
+      [all_threads,
+       half_threads,
+       &first_started,
+       second_started = second_checked.get_future().share(),
+       &first_checked,
+       worker_released = release_worker.get_future().share()](const size_t) {
+        EXPECT_EQ(cpu_threads(), all_threads);
+        first_started.set_value();
+        // The budget of a running query shrinks when another one starts...
+        second_started.wait();
+        EXPECT_EQ(cpu_threads(), half_threads);
+        first_checked.set_value();
+        // ...and grows back once it finishes. The worker of the second query rebalances
+        // the budgets after its task has returned, wait for it.
+        worker_released.wait();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (cpu_threads() != all_threads &&
+               std::chrono::steady_clock::now() < deadline) {
+          std::this_thread::yield();
+        }
+        EXPECT_EQ(cpu_threads(), all_threads);
+      });
+  dispatch_queue.submit(first, /*is_update_delete=*/false);
+  first_started.get_future().wait();
+
+  // The second query starts while the first one runs, it gets half of the threads, and
+  // so do the threads it spawns.
+  auto second = std::make_shared<QueryDispatchQueue::Task>(
+      [half_threads,
+       &second_checked,
+       first_done = first_checked.get_future().share()](const size_t) {
+        EXPECT_EQ(cpu_threads(), half_threads);
+        threadpool::ThreadPool<void> thread_pool;
+        thread_pool.spawn([half_threads] { EXPECT_EQ(cpu_threads(), half_threads); });
+        thread_pool.join();
+        second_checked.set_value();
+        first_done.wait();
+      });
+  dispatch_queue.submit(second, /*is_update_delete=*/false);
+  second->get_future().get();
+  release_worker.set_value();
+  first->get_future().get();
+  EXPECT_EQ(cpu_threads(), all_threads);
+}
+
+TEST(QueryDispatchQueue, OwnerFairness) {
+  QueryDispatchQueue dispatch_queue(2);
+  // Every worker runs a query, of alice and of carol, until released
+  const std::vector<std::string> blocker_owners{"alice", "carol"};
+  std::vector<std::promise<void>> started(blocker_owners.size());
+  std::vector<std::promise<void>> releases(blocker_owners.size());
+  std::vector<std::shared_ptr<QueryDispatchQueue::Task>> blockers;
+  for (size_t i = 0; i < blocker_owners.size(); ++i) {
+    blockers.push_back(std::make_shared<QueryDispatchQueue::Task>(
+        [&started, i, worker_released = releases[i].get_future().share()](
+            const size_t) {
+          started[i].set_value();
+          worker_released.wait();
+        }));
+    dispatch_queue.submit(
+        blockers.back(), /*is_update_delete=*/false, 0, blocker_owners[i]);
+    started[i].get_future().wait();
+  }
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  std::vector<std::shared_ptr<QueryDispatchQueue::Task>> tasks;
+  for (const auto& owner : {"alice", "bob"}) {
+    tasks.push_back(std::make_shared<QueryDispatchQueue::Task>(
+        [&order_mutex, &order, name = std::string(owner)](const size_t) {
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(name);
+        }));
+    dispatch_queue.submit(tasks.back(), /*is_update_delete=*/false, 0, owner);
+  }
+  // Frees the worker of carol while alice still has a query running: bob goes first
+  // even though the query of alice was submitted before.
+  releases[1].set_value();
+  for (auto& task : tasks) {
+    task->get_future().get();
+  }
+  releases[0].set_value();
+  for (auto& blocker : blockers) {
+    blocker->get_future().get();
+  }
+  const std::vector<std::string> expected{"bob", "alice"};
+  EXPECT_EQ(expected, order);
+}
+
+TEST(QueryDispatchQueue, PriorityAging) {
+  // The waiting time of the queries is measured on a clock only the test advances.
+  const std::chrono::milliseconds aging_interval{50};
+  std::mutex clock_mutex;
+  auto now = std::chrono::steady_clock::time_point();
+  QueryDispatchQueue dispatch_queue(1, aging_interval, [&clock_mutex, &now] {
+    std::lock_guard<std::mutex> lock(clock_mutex);
+    return now;
+  });
+  std::promise<void> release_worker;
+  std::promise<void> worker_blocked;
+  auto blocker = std::make_shared<QueryDispatchQueue::Task>(
+      [&worker_blocked,
+       worker_released = release_worker.get_future().share()](const size_t) {
+        worker_blocked.set_value();
+        worker_released.wait();
+      });
+  dispatch_queue.submit(blocker, /*is_update_delete=*/false);
+  worker_blocked.get_future().wait();
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  std::vector<std::shared_ptr<QueryDispatchQueue::Task>> tasks;
+  auto submit = [&](const std::string& name, const int priority) {
+    tasks.push_back(std::make_shared<QueryDispatchQueue::Task>(
+        [&order_mutex, &order, name](const size_t) {
+          std::lock_guard<std::mutex> lock(order_mutex);
+          order.push_back(name);
+        }));
+    dispatch_queue.submit(tasks.back(), /*is_update_delete=*/false, priority, name);
+  };
+  submit("low", 0);
+  // Waiting for more than two aging intervals lifts the low priority query above the
+  // ones submitted later with priority 1, but not above priority 5.
+  {
+    std::lock_guard<std::mutex> lock(clock_mutex);
+    now += aging_interval * 2 + aging_interval / 2;
+  }
+  submit("mid", 1);
+  submit("high", 5);
+  release_worker.set_value();
+  for (auto& task : tasks) {
+    task->get_future().get();
+  }
+  blocker->get_future().get();
+
+  const std::vector<std::string> expected{"high", "low", "mid"};
+  EXPECT_EQ(expected, order);
+}
+
 int main(int argc, char* argv[]) {
   g_is_test_env = true;
 
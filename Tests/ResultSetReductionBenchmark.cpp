@@ -0,0 +1,149 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Tests/ResultSetTestUtils.h"
+
+#include <benchmark/benchmark.h>
+
+#include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ResultSet.h"
+#include "Shared/thread_count.h"
+#include "Tests/TestHelpers.h"
+
+extern bool g_enable_tree_reduction;
+extern bool g_enable_partitioned_baseline_reduction;
+
+namespace {
+
+constexpr size_t kKernelCount{64};
+constexpr size_t kEntryCount{1 << 16};
+
+std::vector<TargetInfo> get_target_infos() {
+  return generate_custom_agg_target_infos({8},
+                                          {kSUM, kCOUNT, kMIN, kMAX},
+                                          {kBIGINT, kBIGINT, kBIGINT, kBIGINT},
+                                          {kBIGINT, kBIGINT, kBIGINT, kBIGINT});
+}
+
+}  // namespace
+
+/**
+ * Reduces the outputs of kKernelCount kernels of kEntryCount entries each, with the CPU
+ * threads limited to state.range(0) and the parallel reduction paths enabled if
+ * state.range(1) is set. The kernel outputs are filled again before every iteration,
+ * outside of the timed region, since the reduction overwrites them.
+ */
+class ReductionFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    cpu_threads_override_ = g_cpu_threads_override;
+    tree_reduction_state_ = g_enable_tree_reduction;
+    partitioned_baseline_reduction_state_ = g_enable_partitioned_baseline_reduction;
+    g_cpu_threads_override = state.range(0);
+    g_enable_tree_reduction = state.range(1);
+    g_enable_partitioned_baseline_reduction = state.range(1);
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    g_cpu_threads_override = cpu_threads_override_;
+    g_enable_tree_reduction = tree_reduction_state_;
+    g_enable_partitioned_baseline_reduction = partitioned_baseline_reduction_state_;
+  }
+
+ protected:
+  void runReduction(benchmark::State& state,
+                    const std::vector<TargetInfo>& target_infos,
+                    const QueryMemoryDescriptor& query_mem_desc) {
+    for (auto _ : state) {
+      state.PauseTiming();
+      const auto row_set_mem_owner =
+          std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+      std::vector<std::unique_ptr<ResultSet>> result_sets;
+      std::vector<ResultSet*> storage_set;
+      for (size_t i = 0; i < kKernelCount; ++i) {
+        result_sets.emplace_back(std::make_unique<ResultSet>(target_infos,
+                                                             ExecutorDeviceType::CPU,
+                                                             query_mem_desc,
+                                                             row_set_mem_owner,
+                                                             nullptr));
+        const auto storage = result_sets.back()->allocateStorage();
+        // Every kernel sees a different subset of the groups
+        EvenNumberGenerator generator;
+        fill_storage_buffer(storage->getUnderlyingBuffer(),
+                            target_infos,
+                            query_mem_desc,
+                            generator,
+                            i % 3 + 1);
+        storage_set.push_back(result_sets.back().get());
+      }
+      state.ResumeTiming();
+      ResultSetManager rs_manager;
+      benchmark::DoNotOptimize(rs_manager.reduce(storage_set));
+    }
+  }
+
+ private:
+  unsigned cpu_threads_override_;
+  bool tree_reduction_state_;
+  bool partitioned_baseline_reduction_state_;
+};
+
+void threads_and_parallel_reduction(benchmark::internal::Benchmark* b) {
+  for (int64_t parallel_reduction : {0, 1}) {
+    for (int64_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+      b->Args({threads, parallel_reduction});
+    }
+  }
+}
+
+//! Perfect hash group by, goes through the tree reduction
+BENCHMARK_DEFINE_F(ReductionFixture, PerfectHash)(benchmark::State& state) {
+  const auto target_infos = get_target_infos();
+  const auto query_mem_desc =
+      perfect_hash_one_col_desc(target_infos, 8, 0, kEntryCount - 1);
+  runReduction(state, target_infos, query_mem_desc);
+}
+
+BENCHMARK_REGISTER_F(ReductionFixture, PerfectHash)
+    ->Apply(threads_and_parallel_reduction)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Baseline hash group by, goes through the partitioned reduction
+BENCHMARK_DEFINE_F(ReductionFixture, BaselineHash)(benchmark::State& state) {
+  const auto target_infos = get_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(kEntryCount);
+  runReduction(state, target_infos, query_mem_desc);
+}
+
+BENCHMARK_REGISTER_F(ReductionFixture, BaselineHash)
+    ->Apply(threads_and_parallel_reduction)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Tests/ResultSetTestUtils.h"
+
+#include <benchmark/benchmark.h>
+
+#include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ResultSet.h"
+#include "Tests/TestHelpers.h"
+
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_run_rows;
+
+namespace {
+
+// Number of runs the external sort splits the entries in.
+constexpr size_t kRunCount{16};
+
+std::vector<TargetInfo> get_target_infos() {
+  return generate_custom_agg_target_infos({8, 8},
+                                          {kSUM, kMIN, kMAX},
+                                          {kBIGINT, kBIGINT, kBIGINT},
+                                          {kBIGINT, kBIGINT, kBIGINT});
+}
+
+}  // namespace
+
+/**
+ * Sorts a baseline group by result of state.range(0) entries, half of them empty, on one
+ * of its aggregates and fetches all its rows. The external sort is used if
+ * state.range(1) is set, with kRunCount runs, the in-memory sort otherwise. Fetching is
+ * part of the timed region since the external sort merges its runs as the rows are
+ * fetched. The result is filled again before every iteration, outside of the timed
+ * region, since a result can only be sorted once.
+ */
+class SortFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    external_sort_state_ = g_enable_external_sort;
+    external_sort_run_rows_ = g_external_sort_run_rows;
+    g_enable_external_sort = state.range(1);
+    g_external_sort_run_rows = state.range(0) / kRunCount;
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    g_enable_external_sort = external_sort_state_;
+    g_external_sort_run_rows = external_sort_run_rows_;
+  }
+
+ private:
+  bool external_sort_state_;
+  size_t external_sort_run_rows_;
+};
+
+void entries_and_external_sort(benchmark::internal::Benchmark* b) {
+  for (int64_t external_sort : {0, 1}) {
+    for (int64_t entry_count : {1 << 20, 1 << 22, 1 << 24}) {
+      b->Args({entry_count, external_sort});
+    }
+  }
+}
+
+BENCHMARK_DEFINE_F(SortFixture, BaselineHash)(benchmark::State& state) {
+  const auto target_infos = get_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(state.range(0));
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(3, true, false);
+  for (auto _ : state) {
+    state.PauseTiming();
+    const auto row_set_mem_owner =
+        std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+    ResultSet rs(target_infos,
+                 ExecutorDeviceType::CPU,
+                 query_mem_desc,
+                 row_set_mem_owner,
+                 nullptr);
+    const auto storage = rs.allocateStorage();
+    EvenNumberGenerator generator;
+    fill_storage_buffer(
+        storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+    state.ResumeTiming();
+    rs.sort(order_entries, 0);
+    size_t row_count{0};
+    while (!rs.getNextRow(false, false).empty()) {
+      ++row_count;
+    }
+    benchmark::DoNotOptimize(row_count);
+  }
+}
+
+BENCHMARK_REGISTER_F(SortFixture, BaselineHash)
+    ->Apply(entries_and_external_sort)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
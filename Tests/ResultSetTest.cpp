@@ -28,6 +28,7 @@
 #include "QueryEngine/ResultSet.h"
 #include "QueryEngine/ResultSetReductionJIT.h"
 #include "QueryEngine/RuntimeFunctions.h"
+#include "Shared/scope.h"
 #include "StringDictionary/StringDictionary.h"
 #include "Tests/TestHelpers.h"
 
@@ -37,6 +38,11 @@
 #include <random>
 
 extern bool g_is_test_env;
+extern bool g_enable_partitioned_baseline_reduction;
+extern bool g_enable_tree_reduction;
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_run_rows;
+extern size_t g_external_sort_max_concurrent_runs;
 
 TEST(Construct, Allocate) {
   std::vector<TargetInfo> target_infos;
@@ -1092,6 +1098,72 @@ void test_reduce(const std::vector<TargetInfo>& target_infos,
   }
 }
 
+// Reduces result_set_count result sets, the i-th one filled with every (i + 1)-th group,
+// and returns the rows of the result as integers.
+std::vector<std::vector<int64_t>> reduce_many(const std::vector<TargetInfo>& target_infos,
+                                              const QueryMemoryDescriptor& query_mem_desc,
+                                              const size_t result_set_count) {
+  const auto row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  std::vector<std::unique_ptr<ResultSet>> result_sets;
+  std::vector<ResultSet*> storage_set;
+  for (size_t i = 0; i < result_set_count; ++i) {
+    result_sets.emplace_back(std::make_unique<ResultSet>(target_infos,
+                                                         ExecutorDeviceType::CPU,
+                                                         query_mem_desc,
+                                                         row_set_mem_owner,
+                                                         nullptr));
+    const auto storage = result_sets.back()->allocateStorage();
+    EvenNumberGenerator generator;
+    fill_storage_buffer(
+        storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, i + 1);
+    storage_set.push_back(result_sets.back().get());
+  }
+  ResultSetManager rs_manager;
+  const auto result_rs = rs_manager.reduce(storage_set);
+  std::vector<std::vector<int64_t>> result;
+  for (size_t row_idx = 0; row_idx < result_rs->rowCount(); ++row_idx) {
+    const auto row = result_rs->getRowAtNoTranslations(row_idx);
+    std::vector<int64_t> int_row;
+    for (const auto& val : row) {
+      int_row.push_back(v<int64_t>(val));
+    }
+    result.push_back(int_row);
+  }
+  return result;
+}
+
+std::vector<std::vector<int64_t>> get_int_rows(const ResultSet& rs) {
+  std::vector<std::vector<int64_t>> result;
+  while (true) {
+    const auto row = rs.getNextRow(false, false);
+    if (row.empty()) {
+      break;
+    }
+    std::vector<int64_t> int_row;
+    for (const auto& val : row) {
+      int_row.push_back(v<int64_t>(val));
+    }
+    result.push_back(int_row);
+  }
+  return result;
+}
+
+std::unique_ptr<ResultSet> sort_rows(
+    const std::vector<TargetInfo>& target_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner,
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  auto rs = std::make_unique<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = rs->allocateStorage();
+  EvenNumberGenerator generator;
+  fill_storage_buffer(
+      storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 3);
+  rs->sort(order_entries, 0);
+  return rs;
+}
+
 void test_reduce_random_groups(const std::vector<TargetInfo>& target_infos,
                                const QueryMemoryDescriptor& query_mem_desc,
                                NumberGenerator& generator1,
@@ -1788,6 +1860,63 @@ TEST(Reduce, BaselineHash) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
 }
 
+TEST(Reduce, BaselineHashPartitioned) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  // Large enough for the reduction to go through the partitioned path
+  query_mem_desc.setEntryCount(1 << 17);
+  const auto random_groups_target_infos = generate_random_groups_target_infos();
+  auto random_groups_query_mem_desc =
+      baseline_hash_two_col_desc_large(random_groups_target_infos, 8);
+  random_groups_query_mem_desc.setEntryCount(1 << 17);
+  const auto partitioned_reduction_state = g_enable_partitioned_baseline_reduction;
+  ScopeGuard reset_state = [&partitioned_reduction_state] {
+    g_enable_partitioned_baseline_reduction = partitioned_reduction_state;
+  };
+  for (const bool enable_partitioned_reduction : {true, false}) {
+    g_enable_partitioned_baseline_reduction = enable_partitioned_reduction;
+    {
+      EvenNumberGenerator generator1;
+      ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+      test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
+    }
+    {
+      EvenNumberGenerator generator1;
+      EvenNumberGenerator generator2;
+      test_reduce_random_groups(random_groups_target_infos,
+                                random_groups_query_mem_desc,
+                                generator1,
+                                generator2,
+                                50,
+                                50,
+                                true);
+    }
+  }
+}
+
+TEST(Reduce, PerfectHashTree) {
+  const auto target_infos =
+      generate_custom_agg_target_infos({8},
+                                       {kSUM, kCOUNT, kMIN, kMAX},
+                                       {kBIGINT, kBIGINT, kBIGINT, kBIGINT},
+                                       {kBIGINT, kBIGINT, kBIGINT, kBIGINT});
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, (1 << 16) - 1);
+  const auto tree_reduction_state = g_enable_tree_reduction;
+  ScopeGuard reset_state = [&tree_reduction_state] {
+    g_enable_tree_reduction = tree_reduction_state;
+  };
+  for (const bool output_columnar : {false, true}) {
+    query_mem_desc.setOutputColumnar(output_columnar);
+    // An odd number of result sets, so that the last one sits out a round
+    g_enable_tree_reduction = true;
+    const auto tree_result = reduce_many(target_infos, query_mem_desc, 5);
+    g_enable_tree_reduction = false;
+    const auto serial_result = reduce_many(target_infos, query_mem_desc, 5);
+    ASSERT_FALSE(tree_result.empty());
+    ASSERT_EQ(serial_result, tree_result);
+  }
+}
+
 TEST(Reduce, BaselineHashColumnar) {
   const auto target_infos = generate_test_target_infos();
   auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
@@ -1797,6 +1926,62 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
 }
 
+TEST(Sort, ExternalBaselineHash) {
+  const auto target_infos =
+      generate_custom_agg_target_infos({8, 8},
+                                       {kSUM, kMIN, kMAX},
+                                       {kBIGINT, kBIGINT, kBIGINT},
+                                       {kBIGINT, kBIGINT, kBIGINT});
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(1000);
+  const auto row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  const auto external_sort_state = g_enable_external_sort;
+  const auto external_sort_run_rows = g_external_sort_run_rows;
+  const auto external_sort_max_concurrent_runs = g_external_sort_max_concurrent_runs;
+  ScopeGuard reset_state =
+      [&external_sort_state, &external_sort_run_rows, &external_sort_max_concurrent_runs] {
+        g_enable_external_sort = external_sort_state;
+        g_external_sort_run_rows = external_sort_run_rows;
+        g_external_sort_max_concurrent_runs = external_sort_max_concurrent_runs;
+      };
+  // Small runs, the last one shorter than the others, fewer sorted at a time than runs
+  g_external_sort_run_rows = 64;
+  g_external_sort_max_concurrent_runs = 2;
+  for (const bool is_desc : {false, true}) {
+    std::list<Analyzer::OrderEntry> order_entries;
+    order_entries.emplace_back(3, is_desc, false);
+    g_enable_external_sort = false;
+    const auto in_memory_rs =
+        sort_rows(target_infos, query_mem_desc, row_set_mem_owner, order_entries);
+    const auto in_memory_result = get_int_rows(*in_memory_rs);
+    ASSERT_EQ(size_t(334), in_memory_result.size());
+    g_enable_external_sort = true;
+    const auto external_rs =
+        sort_rows(target_infos, query_mem_desc, row_set_mem_owner, order_entries);
+    // The merge streams the spilled rows, the storage only holds the last one
+    ASSERT_EQ(size_t(334), external_rs->rowCount());
+    ASSERT_EQ(in_memory_result, get_int_rows(*external_rs));
+    external_rs->moveToBegin();
+    ASSERT_EQ(in_memory_result, get_int_rows(*external_rs));
+    // Random access loads the merged rows into the storage, in sort order
+    external_rs->moveToBegin();
+    for (size_t i = 0; i < 10; ++i) {
+      external_rs->getNextRow(false, false);
+    }
+    ASSERT_EQ(size_t(334), external_rs->entryCount());
+    ASSERT_TRUE(external_rs->isPermutationBufferEmpty());
+    const auto remaining_result = get_int_rows(*external_rs);
+    ASSERT_EQ(std::vector<std::vector<int64_t>>(in_memory_result.begin() + 10,
+                                                in_memory_result.end()),
+              remaining_result);
+    for (size_t i = 0; i < in_memory_result.size(); ++i) {
+      const auto row = external_rs->getRowAt(i);
+      ASSERT_EQ(in_memory_result[i][2], v<int64_t>(row[2]));
+    }
+  }
+}
+
 #ifndef HAVE_TSAN
 // The large buffers tests allocate too much memory to instrument under TSAN
 TEST(ReduceLargeBuffers, PerfectHashOne_Overflow32) {
@@ -15,6 +15,7 @@
  */
 
 #include "Shared/Intervals.h"
+#include "Shared/crc32c.h"
 #include "TestHelpers.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
@@ -25,6 +26,8 @@
 #include <array>
 #include <atomic>
 #include <future>
+#include <string>
+#include <vector>
 
 // for (auto const interval : makeIntervals(0, M, n_workers)) {...}
 // iterates over interval={begin,end} pairs which satisfy:
@@ -147,6 +150,28 @@ TEST(Shared, IntervalsInvalidBounds) {
   EXPECT_TRUE(loop_body_executed);
 }
 
+TEST(Shared, Crc32c) {
+  const std::string check_input{"123456789"};
+  ASSERT_EQ(crc32c(0, check_input.data(), check_input.size()), 0xe3069283u);
+  ASSERT_EQ(crc32c_sw(0, check_input.data(), check_input.size()), 0xe3069283u);
+  ASSERT_EQ(crc32c(0, nullptr, 0), 0u);
+
+  // Unaligned inputs of every length up to a few words, whole or in two parts
+  std::vector<uint8_t> data(67);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+  for (size_t begin = 0; begin < 8; ++begin) {
+    for (size_t size = 0; begin + size <= data.size(); ++size) {
+      const auto crc = crc32c_sw(0, &data[begin], size);
+      ASSERT_EQ(crc32c(0, &data[begin], size), crc);
+      const size_t split = size / 3;
+      const auto split_crc = crc32c(0, &data[begin], split);
+      ASSERT_EQ(crc32c(split_crc, &data[begin + split], size - split), crc);
+    }
+  }
+}
+
 TEST(Utils, StringLike) {
   ASSERT_TRUE(string_like("abc", 3, "abc", 3, '\\'));
   ASSERT_FALSE(string_like("abc", 3, "ABC", 3, '\\'));
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+#include "../ImportExport/Importer.h"
+#include "../Logger/Logger.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/thread_count.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+extern bool g_enable_window_functions;
+
+using QR = QueryRunner::QueryRunner;
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+  QR::init(BASE_PATH);
+  g_enable_window_functions = true;
+}
+
+inline void run_ddl_statement(const std::string& create_table_stmt) {
+  QR::get()->runDDLStatement(create_table_stmt);
+}
+
+std::shared_ptr<ResultSet> run_multiple_agg(const std::string& query_str,
+                                            const ExecutorDeviceType device_type) {
+  return QR::get()->runSQL(
+      query_str, device_type, /*hoist_literals=*/true, /*allow_loop_joins=*/true);
+}
+
+TargetValue run_simple_agg(const std::string& query_str,
+                           const ExecutorDeviceType device_type) {
+  auto rows = QR::get()->runSQL(query_str, device_type, /*allow_loop_joins=*/true);
+  auto crt_row = rows->getNextRow(true, true);
+  CHECK_EQ(size_t(1), crt_row.size()) << query_str;
+  return crt_row[0];
+}
+
+/**
+ * Loads window_bench with state.range(0) rows and limits the CPU threads to
+ * state.range(1) for the duration of the benchmark, so the same query can be timed at
+ * increasing core counts. The table has a column with 1000 partition keys (p), a single
+ * partition key (one) and a pseudo random order key (x). Window functions only support
+ * single fragment tables, hence the fragment size.
+ */
+class WindowFunctionFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    cpu_threads_override_ = g_cpu_threads_override;
+    g_cpu_threads_override = state.range(1);
+    if (loaded_row_count_ == state.range(0)) {
+      return;
+    }
+
+    run_ddl_statement("DROP TABLE IF EXISTS window_bench;");
+    run_ddl_statement(
+        "CREATE TABLE window_bench (x BIGINT, p INT, one INT) WITH "
+        "(FRAGMENT_SIZE=32000000);");
+
+    auto cat = QR::get()->getCatalog();
+    const auto td = cat->getMetadataForTable("window_bench");
+    CHECK(td);
+    auto loader = QR::get()->getLoader(td);
+    CHECK(loader);
+
+    auto col_descs = loader->get_column_descs();
+    std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+    for (auto cd : col_descs) {
+      import_buffers.push_back(std::unique_ptr<import_export::TypedImportBuffer>(
+          new import_export::TypedImportBuffer(cd, loader->getStringDict(cd))));
+    }
+
+    for (int64_t i = 0; i < state.range(0); i++) {
+      std::vector<std::string> values{
+          std::to_string((i * 2654435761) % 1000003), std::to_string(i % 1000), "1"};
+      size_t index = 0;
+      for (auto cd : col_descs) {
+        CHECK_LT(index, values.size());
+        CHECK_LT(index, import_buffers.size());
+        import_buffers[index]->add_value(
+            cd, values[index], /*is_null=*/false, import_export::CopyParams());
+        index++;
+      }
+    }
+
+    loader->load(import_buffers, state.range(0));
+    loaded_row_count_ = state.range(0);
+
+    CHECK_EQ(static_cast<int64_t>(state.range(0)),
+             TestHelpers::v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM window_bench;",
+                                                    ExecutorDeviceType::CPU)));
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    g_cpu_threads_override = cpu_threads_override_;
+  }
+
+ private:
+  static int64_t loaded_row_count_;
+  unsigned cpu_threads_override_;
+};
+
+int64_t WindowFunctionFixture::loaded_row_count_{-1};
+
+void row_count_and_threads(benchmark::internal::Benchmark* b) {
+  for (int64_t row_count : {1 << 20, 1 << 24}) {
+    for (int64_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+      b->Args({row_count, threads});
+    }
+  }
+}
+
+//! ROW_NUMBER over 1000 partitions, the partitions are sorted concurrently
+BENCHMARK_DEFINE_F(WindowFunctionFixture, RowNumberManyPartitions)
+(benchmark::State& state) {
+  for (auto _ : state) {
+    run_multiple_agg(
+        "SELECT COUNT(*) FROM (SELECT ROW_NUMBER() OVER (PARTITION BY p ORDER BY x) AS "
+        "rn FROM window_bench) WHERE rn = 1;",
+        ExecutorDeviceType::CPU);
+  }
+}
+
+BENCHMARK_REGISTER_F(WindowFunctionFixture, RowNumberManyPartitions)
+    ->Apply(row_count_and_threads)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! ROW_NUMBER over a single partition, which goes through the parallel sort
+BENCHMARK_DEFINE_F(WindowFunctionFixture, RowNumberSinglePartition)
+(benchmark::State& state) {
+  for (auto _ : state) {
+    run_multiple_agg(
+        "SELECT COUNT(*) FROM (SELECT ROW_NUMBER() OVER (PARTITION BY one ORDER BY x) AS "
+        "rn FROM window_bench) WHERE rn = 1;",
+        ExecutorDeviceType::CPU);
+  }
+}
+
+BENCHMARK_REGISTER_F(WindowFunctionFixture, RowNumberSinglePartition)
+    ->Apply(row_count_and_threads)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Running sum over 1000 partitions
+BENCHMARK_DEFINE_F(WindowFunctionFixture, CumulativeSumManyPartitions)
+(benchmark::State& state) {
+  for (auto _ : state) {
+    run_multiple_agg(
+        "SELECT MAX(s) FROM (SELECT SUM(x) OVER (PARTITION BY p ORDER BY x) AS s FROM "
+        "window_bench);",
+        ExecutorDeviceType::CPU);
+  }
+}
+
+BENCHMARK_REGISTER_F(WindowFunctionFixture, CumulativeSumManyPartitions)
+    ->Apply(row_count_and_threads)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
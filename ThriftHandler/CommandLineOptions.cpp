@@ -36,6 +36,39 @@ bool g_enable_thrift_logs{false};
 
 extern bool g_use_table_device_offset;
 extern float g_fraction_code_cache_to_evict;
+extern bool g_enable_async_jit;
+extern std::string g_jit_code_disk_cache_path;
+extern size_t g_jit_code_disk_cache_max_size;
+extern bool g_enable_morsel_scheduling;
+extern bool g_enable_sparse_hll;
+extern size_t g_morsel_size_rows;
+extern bool g_enable_parallel_window_partition_compute;
+extern size_t g_window_function_parallel_sort_threshold;
+extern bool g_enable_chunk_value_filters;
+extern size_t g_hash_table_cache_max_bytes;
+extern bool g_enable_partitioned_hash_join_build;
+extern size_t g_hash_join_build_partition_bytes;
+extern size_t g_hash_semi_join_threshold;
+extern bool g_enable_partitioned_baseline_reduction;
+extern bool g_enable_baseline_preaggregation;
+extern size_t g_baseline_preaggregation_entry_count;
+extern bool g_enable_tree_reduction;
+extern bool g_enable_group_by_spill;
+extern size_t g_group_by_spill_partition_count;
+extern size_t g_max_cpu_group_by_buffer_bytes;
+extern std::string g_spill_path;
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_run_rows;
+extern size_t g_external_sort_max_concurrent_runs;
+extern size_t g_spilled_rows_block_bytes;
+extern bool g_enable_normalized_sort_keys;
+extern bool g_enable_run_length_aggregates;
+extern bool g_enable_chunk_prefetch;
+extern size_t g_chunk_prefetch_look_ahead_bytes;
+extern bool g_enable_file_mgr_index;
+extern bool g_enable_page_checksums;
+extern bool g_enable_page_scrubber;
+extern size_t g_page_scrubber_bytes_per_second;
 extern bool g_cache_string_hash;
 
 extern int64_t g_large_ndv_threshold;
@@ -223,6 +256,13 @@ void CommandLineOptions::fillOptions() {
           ->default_value(g_hll_precision_bits)
           ->implicit_value(g_hll_precision_bits),
       "Number of bits used from the hash value used to specify the bucket number.");
+  developer_desc.add_options()(
+      "enable-sparse-hll",
+      po::value<bool>(&g_enable_sparse_hll)
+          ->default_value(g_enable_sparse_hll)
+          ->implicit_value(true),
+      "Use HyperLogLog sketches which start out sparse for APPROX_COUNT_DISTINCT in "
+      "CPU group by queries, instead of a dense register array per group.");
   if (!dist_v5_) {
     help_desc.add_options()("http-port",
                             po::value<int>(&http_port)->default_value(http_port),
@@ -374,6 +414,166 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->implicit_value(true),
       "Enable additional calcite (query plan) optimizations when a view is part of the "
       "query.");
+  developer_desc.add_options()(
+      "hash-table-cache-max-bytes",
+      po::value<size_t>(&g_hash_table_cache_max_bytes)
+          ->default_value(g_hash_table_cache_max_bytes),
+      "Maximum size in bytes of each of the perfect and baseline join hash table caches, "
+      "least recently used hash tables get evicted beyond it.");
+  developer_desc.add_options()(
+      "enable-partitioned-hash-join-build",
+      po::value<bool>(&g_enable_partitioned_hash_join_build)
+          ->default_value(g_enable_partitioned_hash_join_build)
+          ->implicit_value(true),
+      "Build large keyed join hash tables on CPU one cache sized partition at a time.");
+  developer_desc.add_options()(
+      "hash-join-build-partition-bytes",
+      po::value<size_t>(&g_hash_join_build_partition_bytes)
+          ->default_value(g_hash_join_build_partition_bytes),
+      "Size in bytes of the part of a keyed join hash table covered by each partition of "
+      "a partitioned build, should fit in the L2 cache.");
+  developer_desc.add_options()(
+      "hash-semi-join-threshold",
+      po::value<size_t>(&g_hash_semi_join_threshold)
+          ->default_value(g_hash_semi_join_threshold),
+      "Minimum number of rows of an IN sub-query result for the filter to run as a hash "
+      "semi join against it instead of an IN list, 0 to disable.");
+  developer_desc.add_options()(
+      "enable-partitioned-baseline-reduction",
+      po::value<bool>(&g_enable_partitioned_baseline_reduction)
+          ->default_value(g_enable_partitioned_baseline_reduction)
+          ->implicit_value(true),
+      "Reduce large baseline hash group by results in parallel, one hash table per "
+      "partition of the keys.");
+  developer_desc.add_options()(
+      "enable-baseline-preaggregation",
+      po::value<bool>(&g_enable_baseline_preaggregation)
+          ->default_value(g_enable_baseline_preaggregation)
+          ->implicit_value(true),
+      "Run baseline hash group by CPU kernels with small buffers which get flushed to "
+      "shared partitions of the keys when full, so the memory grows with the number of "
+      "groups rather than the number of kernels.");
+  developer_desc.add_options()(
+      "baseline-preaggregation-entry-count",
+      po::value<size_t>(&g_baseline_preaggregation_entry_count)
+          ->default_value(g_baseline_preaggregation_entry_count),
+      "Maximum number of entries of the buffer of a kernel with baseline hash group by "
+      "pre-aggregation, 0 to keep the entry count of the group by.");
+  developer_desc.add_options()(
+      "enable-tree-reduction",
+      po::value<bool>(&g_enable_tree_reduction)
+          ->default_value(g_enable_tree_reduction)
+          ->implicit_value(true),
+      "Merge the results of the kernels pairwise and concurrently instead of into the "
+      "first result one at a time.");
+  developer_desc.add_options()(
+      "enable-group-by-spill",
+      po::value<bool>(&g_enable_group_by_spill)
+          ->default_value(g_enable_group_by_spill)
+          ->implicit_value(true),
+      "Execute group bys which run out of host memory in partitions of the group keys, "
+      "spilling the groups of every partition to disk.");
+  developer_desc.add_options()(
+      "group-by-spill-partition-count",
+      po::value<size_t>(&g_group_by_spill_partition_count)
+          ->default_value(g_group_by_spill_partition_count),
+      "Number of partitions of the group keys tried first by a group by which ran out of "
+      "host memory.");
+  developer_desc.add_options()(
+      "max-cpu-group-by-buffer-bytes",
+      po::value<size_t>(&g_max_cpu_group_by_buffer_bytes)
+          ->default_value(g_max_cpu_group_by_buffer_bytes),
+      "Maximum size of a baseline group by buffer on CPU, larger ones fail as if the "
+      "host had run out of memory (0 for no limit).");
+  developer_desc.add_options()(
+      "spill-path",
+      po::value<std::string>(&g_spill_path)->default_value(g_spill_path),
+      "Directory for the temporary files of the queries which don't fit in host memory, "
+      "the system temporary directory if empty.");
+  developer_desc.add_options()(
+      "spilled-rows-block-bytes",
+      po::value<size_t>(&g_spilled_rows_block_bytes)
+          ->default_value(g_spilled_rows_block_bytes),
+      "Number of bytes of spilled group by rows read back into host memory at a time as "
+      "the result is fetched.");
+  developer_desc.add_options()(
+      "enable-external-sort",
+      po::value<bool>(&g_enable_external_sort)
+          ->default_value(g_enable_external_sort)
+          ->implicit_value(true),
+      "Sort large row-wise results without a limit in runs of rows spilled to disk "
+      "with their normalized sort keys. The result buffers are released once the runs "
+      "are spilled, the runs are merged as the rows are fetched.");
+  developer_desc.add_options()(
+      "external-sort-run-rows",
+      po::value<size_t>(&g_external_sort_run_rows)
+          ->default_value(g_external_sort_run_rows),
+      "Number of entries in a run of the external sort, results with at most as many "
+      "entries are sorted in memory.");
+  developer_desc.add_options()(
+      "external-sort-max-concurrent-runs",
+      po::value<size_t>(&g_external_sort_max_concurrent_runs)
+          ->default_value(g_external_sort_max_concurrent_runs),
+      "Maximum number of runs of the external sort sorted at the same time.");
+  developer_desc.add_options()(
+      "enable-normalized-sort-keys",
+      po::value<bool>(&g_enable_normalized_sort_keys)
+          ->default_value(g_enable_normalized_sort_keys)
+          ->implicit_value(true),
+      "Encode the order by keys of every row once into keys compared with memcmp, "
+      "instead of decoding them for every comparison of a sort.");
+  developer_desc.add_options()(
+      "enable-run-length-aggregates",
+      po::value<bool>(&g_enable_run_length_aggregates)
+          ->default_value(g_enable_run_length_aggregates)
+          ->implicit_value(true),
+      "Compute COUNT, SUM, MIN and MAX without a group by or a filter over run-length "
+      "encoded columns from the runs of the chunks instead of from every row.");
+  developer_desc.add_options()(
+      "enable-chunk-prefetch",
+      po::value<bool>(&g_enable_chunk_prefetch)
+          ->default_value(g_enable_chunk_prefetch)
+          ->implicit_value(true),
+      "Load the chunks the execution kernels of a query are going to scan into the CPU "
+      "buffer pool in the background, ahead of the kernels.");
+  developer_desc.add_options()(
+      "chunk-prefetch-look-ahead-bytes",
+      po::value<size_t>(&g_chunk_prefetch_look_ahead_bytes)
+          ->default_value(g_chunk_prefetch_look_ahead_bytes),
+      "Maximum number of bytes of prefetched chunks whose kernels haven't started yet.");
+  developer_desc.add_options()(
+      "enable-table-index-file",
+      po::value<bool>(&g_enable_file_mgr_index)
+          ->default_value(g_enable_file_mgr_index)
+          ->implicit_value(true),
+      "Write the pages and the chunk metadata of every table to an index file at "
+      "checkpoints and open tables from it, instead of reading the headers of all their "
+      "pages.");
+  developer_desc.add_options()(
+      "enable-page-checksums",
+      po::value<bool>(&g_enable_page_checksums)
+          ->default_value(g_enable_page_checksums)
+          ->implicit_value(true),
+      "Store a CRC32C checksum in every data page of the chunks created and verify it "
+      "when the page is read.");
+  developer_desc.add_options()(
+      "enable-page-scrubber",
+      po::value<bool>(&g_enable_page_scrubber)
+          ->default_value(g_enable_page_scrubber)
+          ->implicit_value(true),
+      "Verify the checksums of the data pages of the opened tables in the background.");
+  developer_desc.add_options()(
+      "page-scrubber-bytes-per-second",
+      po::value<size_t>(&g_page_scrubber_bytes_per_second)
+          ->default_value(g_page_scrubber_bytes_per_second),
+      "Maximum number of bytes per second read by the page scrubber, 0 for no limit.");
+  developer_desc.add_options()(
+      "enable-chunk-value-filters",
+      po::value<bool>(&g_enable_chunk_value_filters)
+          ->default_value(g_enable_chunk_value_filters)
+          ->implicit_value(true),
+      "Build a distinct value set or bloom filter for every chunk written and use it to "
+      "skip fragments on equality and IN predicates.");
   developer_desc.add_options()(
       "enable-columnar-output",
       po::value<bool>(&g_enable_columnar_output)
@@ -401,6 +601,11 @@ void CommandLineOptions::fillAdvancedOptions() {
                                po::value<int>(&system_parameters.num_executors)
                                    ->default_value(system_parameters.num_executors),
                                "Number of executors to run in parallel.");
+  developer_desc.add_options()(
+      "user-query-priority",
+      po::value<std::vector<std::string>>(&user_query_priorities)->multitoken(),
+      "Dispatch priority of the queries of a user, as <user>:<priority>. Queued queries "
+      "with a higher priority run first, the default priority is 0.");
   developer_desc.add_options()(
       "gpu-shared-mem-threshold",
       po::value<size_t>(&g_gpu_smem_threshold)->default_value(g_gpu_smem_threshold),
@@ -436,6 +641,18 @@ void CommandLineOptions::fillAdvancedOptions() {
                                    ->default_value(g_enable_window_functions)
                                    ->implicit_value(true),
                                "Enable experimental window function support.");
+  developer_desc.add_options()(
+      "enable-parallel-window-partition-compute",
+      po::value<bool>(&g_enable_parallel_window_partition_compute)
+          ->default_value(g_enable_parallel_window_partition_compute)
+          ->implicit_value(true),
+      "Sort and evaluate the partitions of a window function on all CPU threads.");
+  developer_desc.add_options()(
+      "window-function-parallel-sort-threshold",
+      po::value<size_t>(&g_window_function_parallel_sort_threshold)
+          ->default_value(g_window_function_parallel_sort_threshold),
+      "Window function partitions with at least this many rows are sorted with all the "
+      "CPU threads, one partition at a time.");
   developer_desc.add_options()("enable-table-functions",
                                po::value<bool>(&g_enable_table_functions)
                                    ->default_value(g_enable_table_functions)
@@ -537,6 +754,37 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_fraction_code_cache_to_evict),
       "Percentage of the GPU code cache to evict if an out of memory error is "
       "encountered while attempting to place generated code on the GPU.");
+  developer_desc.add_options()(
+      "enable-async-jit",
+      po::value<bool>(&g_enable_async_jit)
+          ->default_value(g_enable_async_jit)
+          ->implicit_value(true),
+      "Run the first execution of a new query shape on CPU code generated without "
+      "machine code optimizations, while the optimized code is generated in the "
+      "background and replaces it in the code cache.");
+  developer_desc.add_options()(
+      "jit-code-disk-cache-path",
+      po::value<std::string>(&g_jit_code_disk_cache_path)
+          ->default_value(g_jit_code_disk_cache_path),
+      "Directory in which to persist the CPU code generated for queries, so that it "
+      "can be reused after a restart. Empty (default) disables the on-disk cache.");
+  developer_desc.add_options()(
+      "jit-code-disk-cache-max-size",
+      po::value<size_t>(&g_jit_code_disk_cache_max_size)
+          ->default_value(g_jit_code_disk_cache_max_size),
+      "Maximum size (in bytes) of the on-disk JIT code cache. The least recently used "
+      "entries are evicted once it is exceeded.");
+  developer_desc.add_options()(
+      "enable-morsel-scheduling",
+      po::value<bool>(&g_enable_morsel_scheduling)
+          ->default_value(g_enable_morsel_scheduling)
+          ->implicit_value(true),
+      "Split large fragments into row range morsels for CPU execution and run the "
+      "kernels on a fixed set of worker threads which pick up unclaimed morsels.");
+  developer_desc.add_options()(
+      "morsel-size-rows",
+      po::value<size_t>(&g_morsel_size_rows)->default_value(g_morsel_size_rows),
+      "Number of rows in a morsel when morsel scheduling is enabled.");
 
   developer_desc.add_options()("ssl-cert",
                                po::value<std::string>(&system_parameters.ssl_cert_file)
@@ -722,6 +970,27 @@ void CommandLineOptions::validate() {
     license_path = base_path + "/omnisci.license";
   }
 
+  for (const auto& user_query_priority : user_query_priorities) {
+    const auto separator_pos = user_query_priority.rfind(':');
+    size_t parsed_chars{0};
+    int priority{0};
+    try {
+      if (separator_pos != std::string::npos && separator_pos > 0) {
+        priority =
+            std::stoi(user_query_priority.substr(separator_pos + 1), &parsed_chars);
+      }
+    } catch (const std::exception&) {
+      parsed_chars = 0;
+    }
+    if (!parsed_chars ||
+        separator_pos + 1 + parsed_chars != user_query_priority.size()) {
+      throw std::runtime_error("Invalid user query priority '" + user_query_priority +
+                               "', expected <user>:<priority>.");
+    }
+    system_parameters.user_query_priorities[user_query_priority.substr(
+        0, separator_pos)] = priority;
+  }
+
   // add all parameters to be displayed on startup
   LOG(INFO) << "OmniSci started with data directory at '" << base_path << "'";
   if (vm.count("license-path")) {
@@ -110,6 +110,7 @@ class CommandLineOptions {
   std::string udf_file_name = {""};
   std::string udf_compiler_path = {""};
   std::vector<std::string> udf_compiler_options;
+  std::vector<std::string> user_query_priorities;
 
 #ifdef ENABLE_GEOS
   std::string libgeos_so_filename = {"libgeos_c.so"};
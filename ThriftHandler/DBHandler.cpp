@@ -40,6 +40,7 @@
 
 #include "Catalog/Catalog.h"
 #include "Catalog/DdlCommandExecutor.h"
+#include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "DataMgr/ForeignStorage/ArrowCsvForeignStorage.h"
 #include "DataMgr/ForeignStorage/DummyForeignStorage.h"
 #include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
@@ -58,6 +59,7 @@
 #include "QueryEngine/CalciteAdapter.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
+#include "QueryEngine/ExternalCacheInvalidators.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/JoinFilterPushDown.h"
 #include "QueryEngine/JsonAccessors.h"
@@ -669,6 +671,47 @@ void DBHandler::interrupt(const TSessionId& query_session,
   }
 }
 
+namespace {
+
+// Counters of the caches of the join hash tables built on CPU.
+std::vector<TJoinHashTableCacheInfo> get_join_hash_table_cache_info() {
+  const auto to_thrift = [](const std::string& cache_name,
+                            const HashTableCacheStats& stats) {
+    TJoinHashTableCacheInfo cache_info;
+    cache_info.cache_name = cache_name;
+    cache_info.num_entries = stats.entry_count;
+    cache_info.size_bytes = stats.size_bytes;
+    cache_info.max_size_bytes = stats.max_size_bytes;
+    cache_info.hits = stats.hits;
+    cache_info.misses = stats.misses;
+    cache_info.evictions = stats.evictions;
+    cache_info.invalidations = stats.invalidations;
+    return cache_info;
+  };
+  return {to_thrift("perfect", JoinHashTable::getCacheStats()),
+          to_thrift("baseline", BaselineJoinHashTable::getCacheStats())};
+}
+
+// Pages verified by the page scrubber of the local tables.
+TPageScrubberInfo get_page_scrubber_info(const Data_Namespace::DataMgr& data_mgr) {
+  TPageScrubberInfo scrubber_info;
+  const auto page_scrubber = data_mgr.getGlobalFileMgr()->getPageScrubber();
+  scrubber_info.enabled = page_scrubber != nullptr;
+  if (page_scrubber) {
+    const auto stats = page_scrubber->getStats();
+    scrubber_info.passes = stats.passes;
+    scrubber_info.verified_pages = stats.verified_pages;
+    scrubber_info.unchecked_pages = stats.unchecked_pages;
+    scrubber_info.corrupt_pages = stats.corrupt_pages;
+    scrubber_info.bytes_read = stats.bytes_read;
+    scrubber_info.corrupt_page_descriptions.assign(
+        stats.corrupt_page_descriptions.begin(), stats.corrupt_page_descriptions.end());
+  }
+  return scrubber_info;
+}
+
+}  // namespace
+
 void DBHandler::get_server_status(TServerStatus& _return, const TSessionId& session) {
   auto stdlog = STDLOG(get_session_ptr(session));
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
@@ -680,6 +723,8 @@ void DBHandler::get_server_status(TServerStatus& _return, const TSessionId& sess
   _return.start_time = start_time_;
   _return.edition = MAPD_EDITION;
   _return.host_name = omnisci::get_hostname();
+  _return.join_hash_table_caches = get_join_hash_table_cache_info();
+  _return.page_scrubber = get_page_scrubber_info(*data_mgr_);
 }
 
 void DBHandler::get_status(std::vector<TServerStatus>& _return,
@@ -695,6 +740,8 @@ void DBHandler::get_status(std::vector<TServerStatus>& _return,
   ret.start_time = start_time_;
   ret.edition = MAPD_EDITION;
   ret.host_name = omnisci::get_hostname();
+  ret.join_hash_table_caches = get_join_hash_table_cache_info();
+  ret.page_scrubber = get_page_scrubber_info(*data_mgr_);
 
   // TSercivePort tcp_port{}
 
@@ -2320,6 +2367,10 @@ void DBHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
       md.is_free = gpu.memStatus == Buffer_Namespace::MemStatus::FREE;
       nodeInfo.node_memory_data.push_back(md);
     }
+    if (mem_level == Data_Namespace::MemoryLevel::CPU_LEVEL) {
+      // The cached hash tables live outside of the buffer pool.
+      nodeInfo.join_hash_table_caches = get_join_hash_table_cache_info();
+    }
     _return.push_back(nodeInfo);
   }
   if (leaf_aggregator_.leafCount() > 0) {
@@ -2370,6 +2421,12 @@ void check_table_not_sharded(const TableDescriptor* td) {
   }
 }
 
+// Hash tables built on the table before the load don't cover the new rows.
+void invalidate_caches_for_load(import_export::Loader& loader) {
+  InsertTriggeredCacheInvalidator::invalidateCachesByTable(
+      loader.getCatalog().getCurrentDB().dbId, loader.getTableDesc()->tableId);
+}
+
 }  // namespace
 
 void DBHandler::load_table_binary(const TSessionId& session,
@@ -2432,6 +2489,7 @@ void DBHandler::load_table_binary(const TSessionId& session,
     auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
         session_ptr->getCatalog(), table_name);
     loader->load(import_buffers, rows.size());
+    invalidate_caches_for_load(*loader);
   } catch (const std::exception& e) {
     THROW_MAPD_EXCEPTION("Exception: " + std::string(e.what()));
   }
@@ -2567,6 +2625,7 @@ void DBHandler::load_table_binary_columnar(const TSessionId& session,
     THROW_MAPD_EXCEPTION(oss.str());
   }
   loader->load(import_buffers, numRows);
+  invalidate_caches_for_load(*loader);
 }
 
 using RecordBatchVector = std::vector<std::shared_ptr<arrow::RecordBatch>>;
@@ -2658,6 +2717,7 @@ void DBHandler::load_table_binary_arrow(const TSessionId& session,
     THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
   }
   loader->load(import_buffers, numRows);
+  invalidate_caches_for_load(*loader);
 }
 
 void DBHandler::load_table(const TSessionId& session,
@@ -2773,6 +2833,7 @@ void DBHandler::load_table(const TSessionId& session,
     auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
         session_ptr->getCatalog(), table_name);
     loader->load(import_buffers, rows_completed);
+    invalidate_caches_for_load(*loader);
   } catch (const std::exception& e) {
     THROW_MAPD_EXCEPTION("Exception: " + std::string(e.what()));
   }
@@ -4713,6 +4774,24 @@ void DBHandler::set_execution_mode_nolock(Catalog_Namespace::SessionInfo* sessio
   }
 }
 
+namespace {
+
+// Adds the stats the executor gathered for the last step of the query to its stdlog.
+void log_execution_stats(QueryStateProxy query_state_proxy, const ResultSet& rows) {
+  query_state_proxy.getQueryState().appendNameValuePairs(
+      "kernel_idle_time_ms", rows.getKernelIdleTime(), "morsels", rows.getMorselKernels());
+  query_state_proxy.getQueryState().appendNameValuePairs("prefetched_chunks",
+                                                         rows.getPrefetchedChunks(),
+                                                         "prefetch_hits",
+                                                         rows.getPrefetchHits(),
+                                                         "prefetch_misses",
+                                                         rows.getPrefetchMisses());
+  query_state_proxy.getQueryState().appendNameValuePairs(
+      "join_key_skipped_fragments", rows.getJoinKeySkippedFragments());
+}
+
+}  // namespace
+
 std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
     TQueryResult& _return,
     QueryStateProxy query_state_proxy,
@@ -4777,6 +4856,7 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
   });
   // reduce execution time by the time spent during queue waiting
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  log_execution_stats(query_state_proxy, *result.getRows());
   VLOG(1) << cat.getDataMgr().getSystemMemoryUsage();
   const auto& filter_push_down_info = result.getPushedDownFilterInfo();
   if (!filter_push_down_info.empty()) {
@@ -4847,6 +4927,7 @@ void DBHandler::execute_rel_alg_df(TDataFrame& _return,
   _return.execution_time_ms += measure<>::execution(
       [&]() { result = ra_executor.executeRelAlgQuery(co, eo, false, nullptr); });
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  log_execution_stats(query_state_proxy, *result.getRows());
   const auto rs = result.getRows();
   const auto converter =
       std::make_unique<ArrowResultSetConverter>(rs,
@@ -5190,8 +5271,13 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
     }
     const auto explain_info = pw.getExplainInfo();
     std::vector<PushedDownFilterInfo> filter_push_down_requests;
+    // Records the time spent waiting for an executor in the query state. Timers must not
+    // be moved, hence the direct initialization on the heap.
+    std::unique_ptr<query_state::Timer> dispatch_queue_timer(
+        new query_state::Timer(query_state_proxy.createTimer("dispatch_queue_wait")));
     auto execute_rel_alg_task = std::make_shared<QueryDispatchQueue::Task>(
         [this,
+         &dispatch_queue_timer,
          &filter_push_down_requests,
          &_return,
          &query_state_proxy,
@@ -5204,6 +5290,7 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
          executor_device_type,
          first_n,
          at_most_n](const size_t executor_index) {
+          dispatch_queue_timer.reset();
           filter_push_down_requests = execute_rel_alg(
               _return,
               query_state_proxy,
@@ -5245,10 +5332,16 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
             convert_explain(_return, ResultSet(query_ra), true);
           }
         });
+    const auto& user_name = session_ptr->get_currentUser().userName;
+    const auto priority_it = system_parameters_.user_query_priorities.find(user_name);
     CHECK(dispatch_queue_);
     dispatch_queue_->submit(execute_rel_alg_task,
                             pw.getDMLType() == ParserWrapper::DMLType::Update ||
-                                pw.getDMLType() == ParserWrapper::DMLType::Delete);
+                                pw.getDMLType() == ParserWrapper::DMLType::Delete,
+                            priority_it == system_parameters_.user_query_priorities.end()
+                                ? 0
+                                : priority_it->second,
+                            user_name);
     auto result_future = execute_rel_alg_task->get_future();
     result_future.get();
     return;
@@ -5729,6 +5822,8 @@ void DBHandler::insert_data(const TSessionId& session,
     ChunkKey chunkKey = {insert_data.databaseId, insert_data.tableId};
     auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(chunkKey);
     td->fragmenter->insertDataNoCheckpoint(insert_data);
+    InsertTriggeredCacheInvalidator::invalidateCachesByTable(insert_data.databaseId,
+                                                             insert_data.tableId);
   } catch (const std::exception& e) {
     THROW_MAPD_EXCEPTION("Exception: " + std::string(e.what()));
   }
@@ -87,6 +87,11 @@ std::shared_ptr<Catalog_Namespace::SessionInfo const> QueryState::getConstSessio
   }
 }
 
+std::list<std::string> QueryState::getNameValuePairs() const {
+  std::lock_guard<std::mutex> lock(events_mutex_);
+  return name_value_pairs_;
+}
+
 // Assumes query_state_ is not null, and events_mutex_ is locked for this.
 void QueryState::logCallStack(std::stringstream& ss,
                               unsigned const depth,
@@ -221,6 +226,13 @@ void StdLog::log(logger::Severity severity, char const* label) {
         ss << (nvalues ? ',' : '{') << std::quoted(*itr, '"', '"');
         values << (nvalues++ ? ',' : '{') << std::quoted(*++itr, '"', '"');
       }
+      if (query_state_) {
+        const auto query_nv = query_state_->getNameValuePairs();
+        for (auto itr = query_nv.cbegin(); itr != query_nv.cend(); ++itr) {
+          ss << (nvalues ? ',' : '{') << std::quoted(*itr, '"', '"');
+          values << (nvalues++ ? ',' : '{') << std::quoted(*++itr, '"', '"');
+        }
+      }
       ss << "} " << values.rdbuf() << '}';
     }
     BOOST_LOG_SEV(logger::gSeverityLogger::get(), severity) << ss.rdbuf();
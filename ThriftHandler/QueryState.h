@@ -128,6 +128,7 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   std::string const query_str_;
   Events events_;
   mutable std::mutex events_mutex_;
+  std::list<std::string> name_value_pairs_;  // guarded by events_mutex_
   std::atomic<bool> logged_;
   void logCallStack(std::stringstream&, unsigned const depth, Events::iterator parent);
 
@@ -147,7 +148,9 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   QueryStateProxy createQueryStateProxy();
   QueryStateProxy createQueryStateProxy(Events::iterator parent);
   Timer createTimer(char const* event_name, Events::iterator parent);
-  inline bool emptyLog() const { return events_.empty() && query_str_.empty(); }
+  inline bool emptyLog() const {
+    return events_.empty() && query_str_.empty() && name_value_pairs_.empty();
+  }
   inline Id getId() const { return id_; }
   inline std::string const& getQueryStr() const { return query_str_; }
   // Will throw exception if session_data_.session_info.expired().
@@ -156,6 +159,17 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   inline bool isLogged() const { return logged_.load(); }
   void logCallStack(std::stringstream&);
   inline void setLogged(bool logged) { logged_.store(logged); }
+  // Name/value pairs logged by the stdlog of the query after its own, e.g. the stats of
+  // the executor.
+  template <typename... Pairs>
+  void appendNameValuePairs(Pairs&&... pairs) {
+    static_assert(sizeof...(Pairs) % 2 == 0,
+                  "appendNameValuePairs() requires an even number of parameters.");
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    name_value_pairs_.splice(name_value_pairs_.cend(),
+                             {to_string(std::forward<Pairs>(pairs))...});
+  }
+  std::list<std::string> getNameValuePairs() const;
   friend class QueryStates;
 };
 
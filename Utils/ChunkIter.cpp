@@ -20,6 +20,7 @@
  */
 
 #include "ChunkIter.h"
+#include "../Shared/EncodedChunkLayout.h"
 
 #include <cstdlib>
 
@@ -140,6 +141,68 @@ DEVICE static void decompress(const SQLTypeInfo& ti,
   result->is_null = ti.is_null(*datum);
 }
 
+DEVICE static bool is_row_encoded(const SQLTypeInfo& ti) {
+  return ti.get_compression() == kENCODING_RL || ti.get_compression() == kENCODING_DIFF;
+}
+
+// Run-length and DIFF encoded chunks aren't addressable by byte offset. For those the
+// iterator positions only track the row index and values are decoded from second_buf.
+DEVICE static void decode_row(const ChunkIter* it,
+                              const int8_t* pos,
+                              VarlenDatum* result,
+                              Datum* datum) {
+  const auto& ti = it->type_info;
+  const int64_t row = (pos - it->second_buf) / it->skip_size;
+  int64_t val;
+  if (ti.get_compression() == kENCODING_RL) {
+    val = rle_decode_at(it->second_buf, ti.get_size(), row);
+  } else {
+    const int32_t byte_width = ti.get_comp_param() / 8;
+    const int64_t null_val = -(int64_t(1) << (ti.get_comp_param() - 1));
+    int64_t ret_null_val;
+    switch (ti.get_type()) {
+      case kSMALLINT:
+        ret_null_val = NULL_SMALLINT;
+        break;
+      case kINT:
+        ret_null_val = NULL_INT;
+        break;
+      default:
+        ret_null_val = NULL_BIGINT;
+        break;
+    }
+    val = for_decode_at(it->second_buf, byte_width, null_val, ret_null_val, row);
+  }
+  switch (ti.get_type()) {
+    case kBOOLEAN:
+      datum->boolval = static_cast<int8_t>(val);
+      result->length = sizeof(int8_t);
+      result->pointer = (int8_t*)&datum->boolval;
+      break;
+    case kTINYINT:
+      datum->tinyintval = static_cast<int8_t>(val);
+      result->length = sizeof(int8_t);
+      result->pointer = (int8_t*)&datum->tinyintval;
+      break;
+    case kSMALLINT:
+      datum->smallintval = static_cast<int16_t>(val);
+      result->length = sizeof(int16_t);
+      result->pointer = (int8_t*)&datum->smallintval;
+      break;
+    case kINT:
+      datum->intval = static_cast<int32_t>(val);
+      result->length = sizeof(int32_t);
+      result->pointer = (int8_t*)&datum->intval;
+      break;
+    default:
+      datum->bigintval = val;
+      result->length = sizeof(int64_t);
+      result->pointer = (int8_t*)&datum->bigintval;
+      break;
+  }
+  result->is_null = ti.is_null(*datum);
+}
+
 void ChunkIter_reset(ChunkIter* it) {
   it->current_pos = it->start_pos;
 }
@@ -159,7 +222,9 @@ DEVICE void ChunkIter_get_next(ChunkIter* it,
 
   if (it->skip_size > 0) {
     // for fixed-size
-    if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
+    if (is_row_encoded(it->type_info)) {
+      decode_row(it, it->current_pos, result, &it->datum);
+    } else if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
       decompress(it->type_info, it->current_pos, result, &it->datum);
     } else {
       result->length = static_cast<size_t>(it->skip_size);
@@ -195,7 +260,9 @@ DEVICE void ChunkIter_get_nth(ChunkIter* it,
   if (it->skip_size > 0) {
     // for fixed-size
     int8_t* current_pos = it->start_pos + n * it->skip_size;
-    if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
+    if (is_row_encoded(it->type_info)) {
+      decode_row(it, current_pos, result, &it->datum);
+    } else if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
       decompress(it->type_info, current_pos, result, &it->datum);
     } else {
       result->length = static_cast<size_t>(it->skip_size);
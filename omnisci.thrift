@@ -226,6 +226,27 @@ struct TDashboard {
   8: bool is_dash_shared
 }
 
+struct TJoinHashTableCacheInfo {
+  1: string cache_name
+  2: i64 num_entries
+  3: i64 size_bytes
+  4: i64 max_size_bytes
+  5: i64 hits
+  6: i64 misses
+  7: i64 evictions
+  8: i64 invalidations
+}
+
+struct TPageScrubberInfo {
+  1: bool enabled
+  2: i64 passes
+  3: i64 verified_pages
+  4: i64 unchecked_pages
+  5: i64 corrupt_pages
+  6: i64 bytes_read
+  7: list<string> corrupt_page_descriptions
+}
+
 struct TServerStatus {
   1: bool read_only
   2: string version
@@ -235,6 +256,8 @@ struct TServerStatus {
   6: string host_name
   7: bool poly_rendering_enabled
   8: TRole role
+  9: list<TJoinHashTableCacheInfo> join_hash_table_caches
+  10: TPageScrubberInfo page_scrubber
 }
 
 struct TPixel {
@@ -298,6 +321,7 @@ struct TNodeMemoryInfo {
   4: i64 num_pages_allocated
   5: bool is_allocation_capped
   6: list<TMemoryData> node_memory_data
+  7: list<TJoinHashTableCacheInfo> join_hash_table_caches
 }
 
 struct TTableMeta {